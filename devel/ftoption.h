@@ -243,6 +243,32 @@ FT_TS_BEGIN_HEADER
 #define FT_TS_CONFIG_OPTION_USE_BZIP2
 
 
+  /**************************************************************************
+   *
+   * Compressed stream cache.
+   *
+   *   The gzip, LZW, and bzip2 components can't seek backwards in a
+   *   compressed stream; they have to restart decompression from the
+   *   beginning of the file instead.  Since the PCF driver frequently seeks
+   *   backwards, loading glyphs from compressed PCF files gets very slow
+   *   with large fonts.
+   *
+   *   If this macro is defined, the data uncompressed so far is kept in
+   *   memory, so that all backward seeks can be served from there.  If the
+   *   uncompressed size is known, the buffer is allocated in one go.
+   *
+   *   `FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE` gives the maximum size
+   *   of the cache per stream in bytes; if the uncompressed data gets
+   *   larger, the component discards the cache and falls back to
+   *   restarting decompression.
+   */
+#define FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+
+#ifndef FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE
+#define FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE  ( 16 * 1024 * 1024L )
+#endif
+
+
   /**************************************************************************
    *
    * Define to disable the use of file stream functions and types, `FILE`,
@@ -552,6 +578,43 @@ FT_TS_BEGIN_HEADER
 #define TT_CONFIG_OPTION_EMBEDDED_BITMAPS
 
 
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE` to keep decoded
+   * elements of compound embedded bitmaps (glyph formats~8 and~9 of the
+   * 'EBDT' and 'bdat' tables) in memory.  CJK bitmap fonts often build
+   * many glyphs from a small set of radicals; with the cache, an element
+   * needed again is copied instead of being located and decoded anew.
+   *
+   * The cache never exceeds `TT_CONFIG_SBIT_COMPONENT_CACHE_MAX_SIZE`
+   * bytes per face.
+   */
+#define TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+
+#ifndef TT_CONFIG_SBIT_COMPONENT_CACHE_MAX_SIZE
+#define TT_CONFIG_SBIT_COMPONENT_CACHE_MAX_SIZE  ( 256 * 1024L )
+#endif
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_SBIT_PNG_CACHE` to keep decoded PNG images of
+   * color bitmap glyphs ('CBDT' and 'sbix' tables) in memory.  Decoding
+   * PNG data with 'libpng' is by far the most expensive part of loading
+   * such a glyph; with the cache, an emoji displayed again is copied from
+   * the already decoded image.
+   *
+   * The cache keeps the most recently used images that fit into
+   * `TT_CONFIG_SBIT_PNG_CACHE_MAX_SIZE` bytes per face.  This option has no
+   * effect if `FT_TS_CONFIG_OPTION_USE_PNG` is not defined.
+   */
+#define TT_CONFIG_OPTION_SBIT_PNG_CACHE
+
+#ifndef TT_CONFIG_SBIT_PNG_CACHE_MAX_SIZE
+#define TT_CONFIG_SBIT_PNG_CACHE_MAX_SIZE  ( 4 * 1024 * 1024L )
+#endif
+
+
   /**************************************************************************
    *
    * Define `TT_CONFIG_OPTION_COLOR_LAYERS` if you want to support colored
@@ -561,6 +624,28 @@ FT_TS_BEGIN_HEADER
 #define TT_CONFIG_OPTION_COLOR_LAYERS
 
 
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_COLRV1_RENDERING` to make @FT_TS_Render_Glyph
+   * draw 'COLR' version~1 glyphs (paint graphs with gradients, transforms,
+   * and composition modes) if @FT_TS_LOAD_COLOR is set, producing the same
+   * BGRA bitmaps as for embedded color bitmaps.  The layers of 'COLR'
+   * version~0 glyphs are then rasterized directly into the final bitmap,
+   * too, instead of being rendered and blended one by one.  Without this
+   * option only version~0 glyphs are supported.
+   *
+   * The result of 'PaintColrLayers' tables is cached per face, keeping the
+   * most recently used images that fit into
+   * `TT_CONFIG_COLRV1_CACHE_MAX_SIZE` bytes.  This option needs
+   * `TT_CONFIG_OPTION_COLOR_LAYERS` and a 64-bit integer type.
+   */
+#define TT_CONFIG_OPTION_COLRV1_RENDERING
+
+#ifndef TT_CONFIG_COLRV1_CACHE_MAX_SIZE
+#define TT_CONFIG_COLRV1_CACHE_MAX_SIZE  ( 4 * 1024 * 1024L )
+#endif
+
+
   /**************************************************************************
    *
    * Define `TT_CONFIG_OPTION_POSTSCRIPT_NAMES` if you want to be able to
@@ -608,6 +693,94 @@ FT_TS_BEGIN_HEADER
 #define TT_CONFIG_CMAP_FORMAT_14
 
 
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_CMAP_ACCELERATOR` to speed up character code
+   * lookups in cmap subtables of format~4, 12, and~13.  The first time a
+   * glyph index is requested from such a subtable, a flat two-level
+   * (page/offset) lookup table is built from it so that all subsequent
+   * calls to `FT_TS_Get_Char_Index` take constant time instead of doing a
+   * binary search over the raw segment data.
+   *
+   * The lookup table needs two bytes for each page of 256~character codes
+   * up to the highest character code covered by the subtable, plus
+   * 512~bytes for each page that contains mapped characters.  If this sum
+   * exceeds `TT_CONFIG_CMAP_ACCELERATOR_MAX_SIZE` bytes, no lookup table is
+   * built and the subtable is searched directly.  Since lookup tables are
+   * only created on demand, this is normally the memory budget per face:
+   * only the selected charmap is queried.
+   *
+   * A typical CJK font needs between 100 and 200~KByte.
+   */
+#define TT_CONFIG_OPTION_CMAP_ACCELERATOR
+
+#ifndef TT_CONFIG_CMAP_ACCELERATOR_MAX_SIZE
+#define TT_CONFIG_CMAP_ACCELERATOR_MAX_SIZE  ( 256 * 1024L )
+#endif
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_WOFF_LAZY_TABLES` to decompress the tables of
+   * a WOFF font only when they are accessed for the first time, instead of
+   * all tables when the font is opened.  Tables never used by a face (for
+   * example, the `glyf` table if no glyph gets loaded) then cost neither
+   * time nor memory.  Decompressed tables are kept until the face gets
+   * closed; uncompressed tables are read directly from the WOFF data.
+   *
+   * Note that errors in compressed table data are reported only when the
+   * table gets accessed.
+   *
+   * This option has no effect if `FT_TS_CONFIG_OPTION_USE_ZLIB` is not
+   * defined.
+   */
+#define TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_WOFF2_CACHE` to make the `sfnt` module keep
+   * the SFNT data reconstructed from recently opened WOFF2 fonts.  Opening
+   * a font with exactly the same WOFF2 data (and the same face index in a
+   * collection) again skips Brotli decompression and the reconstruction of
+   * the `glyf`, `loca`, and `hmtx` tables; all faces opened from the same
+   * data share a single copy of the SFNT data.
+   *
+   * The cached SFNT data (and the WOFF2 data kept to identify it) never
+   * take more than `TT_CONFIG_WOFF2_CACHE_MAX_SIZE` bytes per module
+   * (i.e., per library); least recently used entries are discarded first.
+   * Data still used by a face is freed when the face gets closed.
+   *
+   * This option has no effect if `FT_TS_CONFIG_OPTION_USE_BROTLI` is not
+   * defined.
+   */
+#define TT_CONFIG_OPTION_WOFF2_CACHE
+
+#ifndef TT_CONFIG_WOFF2_CACHE_MAX_SIZE
+#define TT_CONFIG_WOFF2_CACHE_MAX_SIZE  ( 8 * 1024 * 1024L )
+#endif
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_WOFF2_LAZY_GLYF` to reconstruct the glyphs of
+   * a transformed `glyf` table in a WOFF2 font only when they get loaded,
+   * instead of all glyphs when the font is opened.  This makes opening
+   * large fonts (e.g., CJK web fonts) much faster and saves the memory of
+   * the reconstructed table, at the cost of decoding a glyph each time it
+   * is loaded.
+   *
+   * The synthesized `glyf` table reserves an upper bound of space for each
+   * glyph, padded with zero bytes; its table checksum is not computed.
+   * If the glyph offsets would not fit into the font's `loca` format, the
+   * table is reconstructed when the font gets opened.
+   *
+   * This option has no effect if `FT_TS_CONFIG_OPTION_USE_BROTLI` is not
+   * defined.
+   */
+#define TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+
+
   /*************************************************************************/
   /*************************************************************************/
   /****                                                                 ****/
@@ -719,6 +892,52 @@ FT_TS_BEGIN_HEADER
 #define TT_CONFIG_OPTION_GX_VAR_SUPPORT
 
 
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_GVAR_CACHE` to keep the decoded 'gvar' data
+   * of glyphs in memory after they have been loaded once.  Subsequent
+   * loads of the same glyph only need to recompute the tuple scalars if
+   * the design coordinates have changed, then scale and sum the cached
+   * deltas, instead of parsing the packed point numbers and deltas again.
+   *
+   * A cached glyph needs roughly four bytes per point and tuple.  The
+   * cache is filled on demand and never exceeds
+   * `TT_CONFIG_GVAR_CACHE_MAX_SIZE` bytes per face; glyphs loaded after
+   * the limit has been reached are decoded on every access.
+   *
+   * This option has no effect if `TT_CONFIG_OPTION_GX_VAR_SUPPORT` is not
+   * defined.
+   */
+#define TT_CONFIG_OPTION_GVAR_CACHE
+
+#ifndef TT_CONFIG_GVAR_CACHE_MAX_SIZE
+#define TT_CONFIG_GVAR_CACHE_MAX_SIZE  ( 4 * 1024 * 1024L )
+#endif
+
+
+  /**************************************************************************
+   *
+   * Define `TT_CONFIG_OPTION_COMPONENT_CACHE` to keep the scaled outlines
+   * of composite glyph components in memory.  Accented characters and
+   * similar composites usually share a small set of base glyphs and
+   * marks; with the cache, a component needed again for the same size,
+   * load flags, and design coordinates is copied instead of being parsed
+   * and scaled once more.
+   *
+   * Only unhinted loads use the cache.  Glyph programs may change the CVT
+   * and the storage area of a size, thus the result of hinting a component
+   * can depend on the glyphs loaded before.
+   *
+   * The cache never exceeds `TT_CONFIG_COMPONENT_CACHE_MAX_SIZE` bytes per
+   * size object.
+   */
+#define TT_CONFIG_OPTION_COMPONENT_CACHE
+
+#ifndef TT_CONFIG_COMPONENT_CACHE_MAX_SIZE
+#define TT_CONFIG_COMPONENT_CACHE_MAX_SIZE  ( 256 * 1024L )
+#endif
+
+
   /**************************************************************************
    *
    * Define `TT_CONFIG_OPTION_BDF` if you want to include support for an
@@ -809,6 +1028,24 @@ FT_TS_BEGIN_HEADER
 #define T1_CONFIG_OPTION_OLD_ENGINE
 
 
+  /**************************************************************************
+   *
+   * Define `T1_CONFIG_OPTION_DICT_CACHE` to make the Type~1 driver keep the
+   * decrypted private dictionaries of recently opened fonts, including the
+   * decrypted subroutines and charstrings.  Reopening a font with exactly
+   * the same data then skips the `eexec` and charstring decryption.
+   *
+   * The cached dictionaries (and the font data kept to identify them) never
+   * take more than `T1_CONFIG_DICT_CACHE_MAX_SIZE` bytes per driver; least
+   * recently used entries are discarded first.
+   */
+#define T1_CONFIG_OPTION_DICT_CACHE
+
+#ifndef T1_CONFIG_DICT_CACHE_MAX_SIZE
+#define T1_CONFIG_DICT_CACHE_MAX_SIZE  ( 4 * 1024 * 1024L )
+#endif
+
+
   /*************************************************************************/
   /*************************************************************************/
   /****                                                                 ****/
@@ -851,6 +1088,26 @@ FT_TS_BEGIN_HEADER
 #define CFF_CONFIG_OPTION_OLD_ENGINE
 
 
+  /**************************************************************************
+   *
+   * Define `CFF_CONFIG_OPTION_SUBR_CACHE` to make the CFF engine keep
+   * decoded copies of the subroutines of CFF and CFF2 fonts, with all
+   * operands already converted to numbers.  A subroutine gets decoded the
+   * first time it is called; subsequent calls, usually from many different
+   * glyphs in subroutinized CJK fonts, no longer need to parse the
+   * charstring bytes.
+   *
+   * The decoded subroutines of a face never take more than
+   * `CFF_CONFIG_SUBR_CACHE_MAX_SIZE` bytes; further subroutines are
+   * interpreted from the font data as usual.
+   */
+#define CFF_CONFIG_OPTION_SUBR_CACHE
+
+#ifndef CFF_CONFIG_SUBR_CACHE_MAX_SIZE
+#define CFF_CONFIG_SUBR_CACHE_MAX_SIZE  ( 2 * 1024 * 1024L )
+#endif
+
+
   /*************************************************************************/
   /*************************************************************************/
   /****                                                                 ****/
@@ -878,6 +1135,52 @@ FT_TS_BEGIN_HEADER
 #define PCF_CONFIG_OPTION_LONG_FAMILY_NAMES
 
 
+  /**************************************************************************
+   *
+   * Define `PCF_CONFIG_OPTION_LAZY_METRICS` to make the 'pcf' driver keep
+   * the glyph metrics and bitmap offsets in their on-disk form, decoding
+   * them only when a glyph gets loaded.  For memory-based streams (in
+   * particular, memory-mapped font files) this data is not copied at all,
+   * and glyph bitmaps that need no bit or byte order conversion are
+   * returned directly from the stream's memory.  This reduces the memory
+   * footprint of a PCF face to a small fraction, which helps applications
+   * that keep many PCF fonts open.
+   */
+#define PCF_CONFIG_OPTION_LAZY_METRICS
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /****                                                                 ****/
+  /****         B D F   D R I V E R    C O N F I G U R A T I O N        ****/
+  /****                                                                 ****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /**************************************************************************
+   *
+   * Define `BDF_CONFIG_OPTION_FONT_CACHE` to make the 'bdf' driver keep
+   * recently opened fonts in parsed form.  Opening a font with exactly the
+   * same data again skips parsing the text and decoding the bitmaps, which
+   * takes quite a while for large fonts like GNU Unifont.  The parsed font
+   * (properties, metrics, and bitmaps) is stored in a single compact block
+   * of memory that all faces opened from the same data share.
+   *
+   * Each cached font keeps a copy of its data to identify it.  The cached
+   * fonts, together with these copies, never take more than
+   * `BDF_CONFIG_FONT_CACHE_MAX_SIZE` bytes per driver (i.e., per
+   * library); least recently used fonts are discarded first.  A font still used by a face is freed when the face
+   * gets closed.  Fonts that are not memory-mapped are only cached if
+   * their size is within the same limit.
+   */
+#define BDF_CONFIG_OPTION_FONT_CACHE
+
+#ifndef BDF_CONFIG_FONT_CACHE_MAX_SIZE
+#define BDF_CONFIG_FONT_CACHE_MAX_SIZE  ( 16 * 1024 * 1024L )
+#endif
+
+
   /*************************************************************************/
   /*************************************************************************/
   /****                                                                 ****/
@@ -753,6 +753,18 @@
 #define FT_TS_GASP_H  <freetype/ftgasp.h>
 
 
+  /**************************************************************************
+   *
+   * @macro:
+   *   FT_TS_COVERAGE_H
+   *
+   * @description:
+   *   A macro used in `#include` statements to name the file containing the
+   *   FreeType~2 API which handles character coverage sets.
+   */
+#define FT_TS_COVERAGE_H  <freetype/ftcover.h>
+
+
   /**************************************************************************
    *
    * @macro:
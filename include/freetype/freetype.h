@@ -237,6 +237,7 @@ FT_TS_BEGIN_HEADER
    *   FT_TS_Get_Transform
    *   FT_TS_Load_Glyph
    *   FT_TS_Get_Char_Index
+   *   FT_TS_Get_Char_Indices
    *   FT_TS_Get_First_Char
    *   FT_TS_Get_Next_Char
    *   FT_TS_Get_Name_Index
@@ -3053,6 +3054,14 @@ FT_TS_BEGIN_HEADER
    *     @FT_TS_Palette_Select instead of setting @FT_TS_LOAD_COLOR for rendering
    *     so that the client application can handle blending by itself.
    *
+   *     If the configuration option `TT_CONFIG_OPTION_COLRV1_RENDERING` is
+   *     active, glyphs with a 'COLR' version~1 paint graph are rendered as
+   *     well, taking precedence over version~0 layers.  The bitmap covers
+   *     the glyph's clip box if the font provides one.  Render modes other
+   *     than color are ignored for such glyphs.  Version~0 layers are then
+   *     rasterized straight into the final bitmap, which is considerably
+   *     faster than rendering and blending each layer separately.
+   *
    *   FT_TS_LOAD_COMPUTE_METRICS ::
    *     [Since 2.6.1] Compute glyph metrics from the glyph data, without the
    *     use of bundled metrics tables (for example, the 'hdmx' table in
@@ -3874,6 +3883,52 @@ FT_TS_BEGIN_HEADER
                      FT_TS_ULong  charcode );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Get_Char_Indices
+   *
+   * @description:
+   *   Return the glyph indices of an array of character codes, using the
+   *   currently selected charmap.  This gives the same results as calling
+   *   @FT_TS_Get_Char_Index for each element, but is considerably faster
+   *   for whole strings.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the source face object.
+   *
+   *   charcodes ::
+   *     An array of `count` character codes.
+   *
+   *   count ::
+   *     The number of elements in `charcodes` and `gindices`.
+   *
+   * @output:
+   *   gindices ::
+   *     An array of `count` glyph indices, to be filled by this function.
+   *     0~means 'undefined character code'.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   If no charmap is selected, all glyph indices are set to zero.
+   *
+   *   The character codes don't need to be sorted; however, consecutive
+   *   characters from the same script (or the ASCII and Latin-1 ranges)
+   *   are mapped faster.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Get_Char_Indices( FT_TS_Face           face,
+                       const FT_TS_UInt32*  charcodes,
+                       FT_TS_UInt           count,
+                       FT_TS_UInt*          gindices );
+
+
   /**************************************************************************
    *
    * @function:
@@ -126,6 +126,7 @@ FT_TS_BEGIN_HEADER
    *   FTC_CMapCache
    *   FTC_CMapCache_New
    *   FTC_CMapCache_Lookup
+   *   FTC_CMapCache_LookupIndices
    *
    *************************************************************************/
 
@@ -636,6 +637,58 @@ FT_TS_BEGIN_HEADER
                         FT_TS_UInt32      char_code );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_CMapCache_LookupIndices
+   *
+   * @description:
+   *   Translate an array of character codes into glyph indices, using the
+   *   charmap cache.  This is the batch version of @FTC_CMapCache_Lookup.
+   *
+   * @input:
+   *   cache ::
+   *     A charmap cache handle.
+   *
+   *   face_id ::
+   *     The source face ID.
+   *
+   *   cmap_index ::
+   *     The index of the charmap in the source face.  Any negative value
+   *     means to use the cache @FT_TS_Face's default charmap.
+   *
+   *   char_codes ::
+   *     An array of `count` character codes (in the corresponding
+   *     charmap).
+   *
+   *   count ::
+   *     The number of elements in `char_codes` and `gindices`.
+   *
+   * @output:
+   *   gindices ::
+   *     An array of `count` glyph indices, to be filled by this function.
+   *     0~means 'no glyph'.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  In case of error, the
+   *   remaining elements of `gindices` are set to zero.
+   *
+   * @note:
+   *   Cache misses are resolved with @FT_TS_Get_Char_Indices for a whole
+   *   block of consecutive character codes at once.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_CMapCache_LookupIndices( FTC_CMapCache        cache,
+                               FTC_FaceID           face_id,
+                               FT_TS_Int            cmap_index,
+                               const FT_TS_UInt32*  char_codes,
+                               FT_TS_UInt           count,
+                               FT_TS_UInt*          gindices );
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*************************************************************************/
@@ -113,6 +113,7 @@
    *
    * @sections:
    *   computations
+   *   coverage_sets
    *   list_processing
    *   outline_processing
    *   quick_advance
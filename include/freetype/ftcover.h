@@ -0,0 +1,364 @@
+/****************************************************************************
+ *
+ * ftcover.h
+ *
+ *   FreeType API for character coverage sets (specification).
+ *
+ * Copyright (C) 2021 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#ifndef FTCOVER_H_
+#define FTCOVER_H_
+
+#include <freetype/freetype.h>
+
+#ifdef FREETYPE_H
+#error "freetype.h of FreeType 1 has been loaded!"
+#error "Please fix the directory search order for header files"
+#error "so that freetype.h of FreeType 2 is found first."
+#endif
+
+
+FT_TS_BEGIN_HEADER
+
+
+  /**************************************************************************
+   *
+   * @section:
+   *   coverage_sets
+   *
+   * @title:
+   *   Coverage Sets
+   *
+   * @abstract:
+   *   Compact sets of character codes supported by a face.
+   *
+   * @description:
+   *   A coverage set holds all character codes of a face's selected
+   *   charmap that map to a glyph.  It is built once with
+   *   @FT_TS_Coverage_New and can then be queried without touching the face
+   *   again; in particular, it can be saved to a buffer with
+   *   @FT_TS_Coverage_Save and restored later with @FT_TS_Coverage_Load,
+   *   avoiding the need to open the font file at all.
+   *
+   *   This is mainly useful for font fallback: given coverage sets for a
+   *   list of faces, @FT_TS_Coverage_Find_First returns, for a whole array
+   *   of character codes, the first face that supports each of them.
+   *
+   *   Internally, character codes are split into blocks of 65536 elements
+   *   each; a block is stored either as a sorted array of 16-bit values
+   *   (if it is sparse) or as a bitmap (if it is dense).
+   *
+   * @order:
+   *   FT_TS_Coverage
+   *
+   *   FT_TS_Coverage_New
+   *   FT_TS_Coverage_Done
+   *   FT_TS_Coverage_Has_Char
+   *   FT_TS_Coverage_Count
+   *   FT_TS_Coverage_Find_First
+   *   FT_TS_Coverage_Intersect
+   *   FT_TS_Coverage_Save
+   *   FT_TS_Coverage_Load
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FT_TS_Coverage
+   *
+   * @description:
+   *   A handle to a character coverage set.
+   *
+   * @since:
+   *   2.11.2
+   */
+  typedef struct FT_TS_CoverageRec_*  FT_TS_Coverage;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_New
+   *
+   * @description:
+   *   Create a coverage set from the active charmap of a face.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the source face object.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The set contains all character codes for which @FT_TS_Get_Char_Index
+   *   returns a non-zero glyph index.  It is created by iterating over the
+   *   charmap with @FT_TS_Get_First_Char and @FT_TS_Get_Next_Char; character
+   *   codes larger than 0xFFFFFFFF are ignored.
+   *
+   *   The coverage set is independent of `face`; it can be used after the
+   *   face has been destroyed, but not after its library.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Coverage_New( FT_TS_Face       face,
+                      FT_TS_Coverage  *acoverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Done
+   *
+   * @description:
+   *   Destroy a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.  Can be `NULL`.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( void )
+  FT_TS_Coverage_Done( FT_TS_Coverage  coverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Has_Char
+   *
+   * @description:
+   *   Check whether a character code is part of a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   *   charcode ::
+   *     The character code.
+   *
+   * @return:
+   *   1~if `charcode` is covered, 0~otherwise (or if `coverage` is `NULL`).
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Bool )
+  FT_TS_Coverage_Has_Char( FT_TS_Coverage  coverage,
+                           FT_TS_ULong     charcode );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Count
+   *
+   * @description:
+   *   Return the number of character codes in a coverage set.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   * @return:
+   *   The number of covered character codes; 0~if `coverage` is `NULL`.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_ULong )
+  FT_TS_Coverage_Count( FT_TS_Coverage  coverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Find_First
+   *
+   * @description:
+   *   For each element of an array of character codes, find the first
+   *   coverage set in a list that contains it.
+   *
+   * @input:
+   *   coverages ::
+   *     An array of coverage set handles, usually in fallback order.
+   *     `NULL` elements are skipped.
+   *
+   *   num_coverages ::
+   *     The number of elements in `coverages`.
+   *
+   *   charcodes ::
+   *     An array of character codes.
+   *
+   *   count ::
+   *     The number of elements in `charcodes`.
+   *
+   * @output:
+   *   indices ::
+   *     An array of `count` elements, receiving for each character code the
+   *     index of the first coverage set that contains it, or -1 if none
+   *     does.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The sets are processed one after the other, each one only being
+   *   probed for character codes not found in a previous set.  The search
+   *   stops as soon as all character codes have been resolved.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Coverage_Find_First( const FT_TS_Coverage*  coverages,
+                             FT_TS_UInt             num_coverages,
+                             const FT_TS_UInt32*    charcodes,
+                             FT_TS_UInt             count,
+                             FT_TS_Int*             indices );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Intersect
+   *
+   * @description:
+   *   Create a new coverage set holding the character codes contained in
+   *   both of two given sets.
+   *
+   * @input:
+   *   coverage1 ::
+   *     A handle to the first coverage set.
+   *
+   *   coverage2 ::
+   *     A handle to the second coverage set.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.  It uses the memory manager of
+   *     `coverage1`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Use @FT_TS_Coverage_Count on the result to get the size of the
+   *   intersection.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Coverage_Intersect( FT_TS_Coverage   coverage1,
+                            FT_TS_Coverage   coverage2,
+                            FT_TS_Coverage  *acoverage );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Save
+   *
+   * @description:
+   *   Serialize a coverage set into a buffer.
+   *
+   * @input:
+   *   coverage ::
+   *     A handle to the coverage set.
+   *
+   *   buffer ::
+   *     The target buffer.  If `NULL`, only the needed buffer size is
+   *     returned.
+   *
+   * @inout:
+   *   alength ::
+   *     On input, the size of `buffer` in bytes (ignored if `buffer` is
+   *     `NULL`).  On output, the number of bytes needed to serialize the
+   *     set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  If `buffer` is too small,
+   *   nothing gets written and the error `Invalid_Argument` is returned.
+   *
+   * @note:
+   *   The serialized data is platform independent; all values are stored
+   *   in big-endian byte order.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Coverage_Save( FT_TS_Coverage  coverage,
+                       FT_TS_Byte*     buffer,
+                       FT_TS_ULong    *alength );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Coverage_Load
+   *
+   * @description:
+   *   Create a coverage set from data written by @FT_TS_Coverage_Save.
+   *
+   * @input:
+   *   library ::
+   *     A handle to the library resource.
+   *
+   *   data ::
+   *     The serialized coverage set.
+   *
+   *   length ::
+   *     The size of `data` in bytes.
+   *
+   * @output:
+   *   acoverage ::
+   *     A handle to the new coverage set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The data is fully validated; the error `Unknown_File_Format` is
+   *   returned if it wasn't created by @FT_TS_Coverage_Save, and
+   *   `Invalid_File_Format` if it is corrupt.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Coverage_Load( FT_TS_Library       library,
+                       const FT_TS_Byte*  data,
+                       FT_TS_ULong        length,
+                       FT_TS_Coverage    *acoverage );
+
+  /* */
+
+
+FT_TS_END_HEADER
+
+#endif /* FTCOVER_H_ */
+
+
+/* END */
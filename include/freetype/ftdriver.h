@@ -55,8 +55,8 @@ FT_TS_BEGIN_HEADER
    *   Available properties are @increase-x-height, @no-stem-darkening
    *   (experimental), @darkening-parameters (experimental),
    *   @glyph-to-script-map (experimental), @fallback-script (experimental),
-   *   and @default-script (experimental), as documented in the @properties
-   *   section.
+   *   @default-script (experimental), and @face-globals (experimental), as
+   *   documented in the @properties section.
    *
    */
 
@@ -1156,6 +1156,105 @@ FT_TS_BEGIN_HEADER
   } FT_TS_Prop_IncreaseXHeight;
 
 
+  /**************************************************************************
+   *
+   * @property:
+   *   face-globals
+   *
+   * @description:
+   *   **Experimental only**
+   *
+   *   Before the first glyph of a face gets auto-hinted, the auto-hinter
+   *   examines the whole Unicode character map to assign scripts to glyphs
+   *   (see @glyph-to-script-map) and analyzes sample glyph outlines to
+   *   compute blue zones and standard stem widths for each script.  For
+   *   applications that open many fonts this can take a noticeable amount
+   *   of time.
+   *
+   *   With @FT_TS_Property_Get, this property returns the result of the
+   *   analysis as an opaque, relocatable byte string; all scripts used by
+   *   the face are analyzed first if necessary.  The data stays valid until
+   *   the face is destroyed or the property is queried again.
+   *
+   *   An application can store the data (say, in a cache file keyed by
+   *   the font file's name, size, and modification time) and use
+   *   @FT_TS_Property_Set in a later session to install it for a freshly
+   *   opened face instead of having the auto-hinter redo the analysis.
+   *   The data is checked for consistency; if it was created for a
+   *   different face, a different named or variation instance, by a
+   *   different FreeType version, or with different values of the
+   *   @fallback-script and @default-script properties, the error
+   *   `FT_TS_Err_Invalid_Argument` is returned and nothing is changed.
+   *
+   *   Setting the property discards any previously computed auto-hinter
+   *   data of the face, including a value set with @increase-x-height.
+   *
+   * @example:
+   *   ```
+   *     FT_TS_Library           library;
+   *     FT_TS_Face              face;
+   *     FT_TS_Prop_FaceGlobals  prop;
+   *
+   *
+   *     FT_TS_Init_FreeType( &library );
+   *     FT_TS_New_Face( library, "foo.ttf", 0, &face );
+   *
+   *     prop.face = face;
+   *     prop.data = ... // data from an earlier `FT_TS_Property_Get' call
+   *     prop.size = ...
+   *
+   *     if ( FT_TS_Property_Set( library, "autofitter",
+   *                                    "face-globals", &prop ) )
+   *     {
+   *       // data was rejected; after hinting some glyphs
+   *       // store the result for the next session
+   *       FT_TS_Property_Get( library, "autofitter",
+   *                                 "face-globals", &prop );
+   *       ...
+   *     }
+   *   ```
+   *
+   * @since:
+   *   2.11.2
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_TS_Prop_FaceGlobals
+   *
+   * @description:
+   *   **Experimental only**
+   *
+   *   The data exchange structure for the @face-globals property.
+   *
+   * @fields:
+   *   face ::
+   *     The face.
+   *
+   *   data ::
+   *     The serialized auto-hinter data.  Owned by the face if returned
+   *     by @FT_TS_Property_Get; not needed after @FT_TS_Property_Set
+   *     returns.
+   *
+   *   size ::
+   *     The size of `data` in bytes.
+   *
+   * @since:
+   *   2.11.2
+   *
+   */
+  typedef struct  FT_TS_Prop_FaceGlobals_
+  {
+    FT_TS_Face         face;
+    const FT_TS_Byte*  data;
+    FT_TS_ULong        size;
+
+  } FT_TS_Prop_FaceGlobals;
+
+
   /**************************************************************************
    *
    * @property:
@@ -741,6 +741,145 @@ FT_TS_BEGIN_HEADER
   FT_TS_Set_Named_Instance( FT_TS_Face  face,
                          FT_TS_UInt  instance_index );
 
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FT_TS_Var_Instance
+   *
+   * @description:
+   *   A handle to a variation instance of a face, created with
+   *   @FT_TS_New_Var_Instance.
+   *
+   *   A variation instance holds a set of design coordinates together with
+   *   all data derived from them: the varied control value table, the
+   *   advance width and height deltas computed so far, and the
+   *   auto-hinter's global metrics.  The parsed font tables are not copied
+   *   but shared with the face.
+   *
+   *   Applications that render the same variation font with several sets
+   *   of coordinates (for example, to display different weights side by
+   *   side) can create an instance for each set and switch between them
+   *   with @FT_TS_Set_Var_Instance.  This is much cheaper than calling
+   *   @FT_TS_Set_Var_Design_Coordinates repeatedly, since the derived data
+   *   need not be recomputed each time.
+   *
+   * @since:
+   *   2.11.2
+   */
+  typedef struct FT_TS_Var_InstanceRec_*  FT_TS_Var_Instance;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_New_Var_Instance
+   *
+   * @description:
+   *   Create a new variation instance of a face.
+   *
+   *   This function currently works with TrueType GX and OpenType variation
+   *   fonts only.
+   *
+   * @input:
+   *   face ::
+   *     A handle to the source face.
+   *
+   *   num_coords ::
+   *     The number of available design coordinates.  If it is larger than
+   *     the number of axes, ignore the excess values.  If it is smaller than
+   *     the number of axes, use default values for the remaining axes.
+   *
+   *   coords ::
+   *     An array of design coordinates.
+   *
+   * @output:
+   *   ainstance ::
+   *     A handle to the new instance.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The coordinates are interpreted exactly as by
+   *   @FT_TS_Set_Var_Design_Coordinates.  Creating an instance doesn't
+   *   change the face.
+   *
+   *   All instances of a face are automatically destroyed together with
+   *   the face.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_New_Var_Instance( FT_TS_Face           face,
+                          FT_TS_UInt           num_coords,
+                          FT_TS_Fixed*         coords,
+                          FT_TS_Var_Instance  *ainstance );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Set_Var_Instance
+   *
+   * @description:
+   *   Make a face use the design coordinates of a variation instance.
+   *
+   * @inout:
+   *   face ::
+   *     A handle to the source face.
+   *
+   * @input:
+   *   instance ::
+   *     A handle to an instance created for `face`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The effect is the same as calling @FT_TS_Set_Var_Design_Coordinates
+   *   with the instance's coordinates.  However, data computed while the
+   *   previously active instance (if any) was in use is stored in that
+   *   instance, and data previously stored in `instance` gets reused.
+   *
+   *   Calling any other function that changes the design coordinates of
+   *   `face` (like @FT_TS_Set_Var_Design_Coordinates) deactivates the
+   *   current instance.
+   *
+   *   A face is still a single object; in particular, glyphs of different
+   *   instances of the same face can't be loaded in parallel from
+   *   different threads.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Set_Var_Instance( FT_TS_Face          face,
+                          FT_TS_Var_Instance  instance );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Done_Var_Instance
+   *
+   * @description:
+   *   Destroy a variation instance.
+   *
+   * @input:
+   *   instance ::
+   *     A handle to the instance.  Can be `NULL`.
+   *
+   * @note:
+   *   If `instance` is active, the face keeps its design coordinates.
+   *
+   * @since:
+   *   2.11.2
+   */
+  FT_TS_EXPORT( void )
+  FT_TS_Done_Var_Instance( FT_TS_Var_Instance  instance );
+
   /* */
 
 
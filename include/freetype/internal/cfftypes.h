@@ -405,6 +405,16 @@ FT_TS_BEGIN_HEADER
     /* since version 2.9 */
     PS_FontExtraRec*  font_extra;
 
+    /* since version 2.11.2 */
+    /* blend vectors of all item variation data for `blend_NDV', */
+    /* built on demand by `cff_blend_build_vector'                */
+    FT_TS_UInt       blend_lenNDV;
+    FT_TS_Fixed*     blend_NDV;
+    FT_TS_Int32**    blend_vectors;
+
+    /* glyph name to index map, built on demand by the glyph dict service */
+    FT_TS_Hash       glyph_names_hash;
+
   } CFF_FontRec;
 
 
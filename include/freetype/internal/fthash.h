@@ -126,6 +126,83 @@ FT_TS_BEGIN_HEADER
                       FT_TS_Hash  hash );
 
 
+  /* return the name of element `idx` of `object`, or NULL if it has none */
+  typedef const char*
+  (*FT_TS_Hash_NameFunc)( void*       object,
+                          FT_TS_UInt  idx );
+
+  FT_TS_Long
+  ft_hash_name_index( FT_TS_Hash*          ahash,
+                      const char*          name,
+                      FT_TS_UInt           count,
+                      FT_TS_Hash_NameFunc  get_name,
+                      void*                object,
+                      FT_TS_Memory         memory );
+
+
+  /* a hash value of `len` bytes at `data`, computed from (at most) */
+  /* 64 evenly spaced bytes and the length; `hash` is the seed      */
+  FT_TS_UInt32
+  ft_hash_data( FT_TS_UInt32       hash,
+                const FT_TS_Byte*  data,
+                FT_TS_ULong        len );
+
+
+  /*
+   * A list of cached items, the most recently used first, whose total
+   * size is limited.  An `FT_TS_MruNodeRec` must be the first field of
+   * each item; the owner of the list sets its `hash` and `size` fields
+   * and supplies the functions to compare and free items.
+   */
+
+  typedef struct  FT_TS_MruNodeRec_
+  {
+    struct FT_TS_MruNodeRec_*  next;
+
+    FT_TS_UInt32  hash;   /* preselects candidates for comparison */
+    FT_TS_ULong   size;   /* memory used by the item              */
+
+  } FT_TS_MruNodeRec, *FT_TS_MruNode;
+
+
+  typedef struct  FT_TS_MruListRec_
+  {
+    FT_TS_MruNode  nodes;   /* most recently used first  */
+    FT_TS_ULong    size;    /* total size of all items   */
+
+  } FT_TS_MruListRec, *FT_TS_MruList;
+
+
+  /* return true if `node` is the item for `key` */
+  typedef FT_TS_Bool
+  (*FT_TS_Mru_CompareFunc)( FT_TS_MruNode  node,
+                            const void*    key );
+
+  /* free an item that has been removed from the list */
+  typedef void
+  (*FT_TS_Mru_FreeFunc)( FT_TS_MruNode  node,
+                         FT_TS_Memory   memory );
+
+
+  FT_TS_MruNode
+  ft_mru_lookup( FT_TS_MruList          list,
+                 FT_TS_UInt32           hash,
+                 FT_TS_Mru_CompareFunc  compare,
+                 const void*            key );
+
+  void
+  ft_mru_add( FT_TS_MruList       list,
+              FT_TS_MruNode       node,
+              FT_TS_ULong         max_size,
+              FT_TS_Mru_FreeFunc  node_free,
+              FT_TS_Memory        memory );
+
+  void
+  ft_mru_done( FT_TS_MruList       list,
+               FT_TS_Mru_FreeFunc  node_free,
+               FT_TS_Memory        memory );
+
+
 FT_TS_END_HEADER
 
 
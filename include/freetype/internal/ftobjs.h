@@ -205,6 +205,13 @@ FT_TS_BEGIN_HEADER
                                   FT_TS_UInt32  variant_selector );
 
 
+  typedef void
+  (*FT_TS_CMap_CharIndicesFunc)( FT_TS_CMap           cmap,
+                              const FT_TS_UInt32*  char_codes,
+                              FT_TS_UInt           count,
+                              FT_TS_UInt*          gindices );
+
+
   typedef struct  FT_TS_CMap_ClassRec_
   {
     FT_TS_ULong               size;
@@ -223,6 +230,11 @@ FT_TS_BEGIN_HEADER
     FT_TS_CMap_CharVariantListFunc   charvariant_list;
     FT_TS_CMap_VariantCharListFunc   variantchar_list;
 
+    /* Optional; map an array of character codes in one go.  If not set, */
+    /* `char_index' is called for each element.                          */
+
+    FT_TS_CMap_CharIndicesFunc       char_indices;
+
   } FT_TS_CMap_ClassRec;
 
 
@@ -240,7 +252,8 @@ FT_TS_BEGIN_HEADER
           char_var_default_,        \
           variant_list_,            \
           charvariant_list_,        \
-          variantchar_list_ )       \
+          variantchar_list_,        \
+          char_indices_ )           \
   FT_TS_CALLBACK_TABLE_DEF             \
   const FT_TS_CMap_ClassRec  class_ =  \
   {                                 \
@@ -253,7 +266,8 @@ FT_TS_BEGIN_HEADER
     char_var_default_,              \
     variant_list_,                  \
     charvariant_list_,              \
-    variantchar_list_               \
+    variantchar_list_,              \
+    char_indices_                   \
   };
 
 
@@ -288,6 +302,15 @@ FT_TS_BEGIN_HEADER
 
 #endif /* FT_TS_CONFIG_OPTION_SUBPIXEL_RENDERING */
 
+
+  /* 'COLR' v1 rendering (in `ftcolor.c') relies on 64-bit arithmetic */
+#if defined( TT_CONFIG_OPTION_COLOR_LAYERS )     && \
+    defined( TT_CONFIG_OPTION_COLRV1_RENDERING ) && \
+    defined( FT_TS_INT64 )
+#define FT_TS_COLRV1_RENDERING
+#endif
+
+
   /**************************************************************************
    *
    * @struct:
@@ -353,6 +376,16 @@ FT_TS_BEGIN_HEADER
    *     created.  @FT_TS_Reference_Face increments this counter, and
    *     @FT_TS_Done_Face only destroys a face if the counter is~1, otherwise it
    *     simply decrements it.
+   *
+   *   var_instance ::
+   *     The variation instance last activated with @FT_TS_Set_Var_Instance,
+   *     or `NULL` if the design coordinates have been changed otherwise
+   *     since then.
+   *
+   *   colr_cache ::
+   *     Images of 'COLR' v1 layer groups rendered by
+   *     `ft_glyphslot_render_colr`.  This field exists only if
+   *     `TT_CONFIG_OPTION_COLRV1_RENDERING` is in effect.
    */
   typedef struct  FT_TS_Face_InternalRec_
   {
@@ -376,6 +409,12 @@ FT_TS_BEGIN_HEADER
 
     FT_TS_Int  refcount;
 
+    struct FT_TS_Var_InstanceRec_*  var_instance;
+
+#ifdef FT_TS_COLRV1_RENDERING
+    struct FT_TS_ColrCacheRec_*  colr_cache;
+#endif
+
   } FT_TS_Face_InternalRec;
 
 
@@ -452,8 +491,31 @@ FT_TS_BEGIN_HEADER
    *   autohint_metrics ::
    *     Metrics used by the auto-hinter.
    *
+   *   advance_pages ::
+   *     Scaled advances computed by @FT_TS_Get_Advances, in pages of
+   *     `FT_TS_ADVANCE_PAGE_SIZE` glyphs each.  Allocated on demand.
+   *
+   *   num_advance_pages ::
+   *     The number of elements in `advance_pages`.
+   *
+   *   advance_scale ::
+   *     The scaling value used for the cached advances.
+   *
+   *   advance_flags ::
+   *     The load flags used for the cached advances.
+   *
    */
 
+#define FT_TS_ADVANCE_PAGE_SIZE  256
+
+  typedef struct  FT_TS_AdvancePageRec_
+  {
+    FT_TS_UInt32  valid[FT_TS_ADVANCE_PAGE_SIZE / 32];
+    FT_TS_Fixed   advances[FT_TS_ADVANCE_PAGE_SIZE];
+
+  } FT_TS_AdvancePageRec, *FT_TS_AdvancePage;
+
+
   typedef struct  FT_TS_Size_InternalRec_
   {
     void*  module_data;
@@ -461,6 +523,11 @@ FT_TS_BEGIN_HEADER
     FT_TS_Render_Mode   autohint_mode;
     FT_TS_Size_Metrics  autohint_metrics;
 
+    FT_TS_AdvancePage*  advance_pages;
+    FT_TS_UInt          num_advance_pages;
+    FT_TS_Fixed         advance_scale;
+    FT_TS_Int32         advance_flags;
+
   } FT_TS_Size_InternalRec;
 
 
@@ -719,6 +786,22 @@ FT_TS_BEGIN_HEADER
                            FT_TS_Byte*      buffer );
 
 
+#ifdef FT_TS_COLRV1_RENDERING
+
+  /* Render the 'COLR' v1 paint graph or the 'COLR' v0 layers of the    */
+  /* glyph in `slot' into a BGRA bitmap.  Return `Cannot_Render_Glyph'   */
+  /* if the glyph has neither.                                           */
+  FT_TS_BASE( FT_TS_Error )
+  ft_glyphslot_render_colr( FT_TS_GlyphSlot  slot );
+
+
+  /* Free the 'COLR' v1 image cache of a face. */
+  FT_TS_BASE( void )
+  ft_face_done_colr( FT_TS_Face  face );
+
+#endif
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*************************************************************************/
@@ -97,6 +97,33 @@ FT_TS_BEGIN_HEADER
                                   FT_TS_Fixed*  weight_vector );
 
 
+  /*
+   * The driver-independent part of a variation instance; drivers supporting
+   * `FT_TS_New_Var_Instance' embed it as the first field of their own
+   * instance records.
+   */
+  typedef struct  FT_TS_Var_InstanceRec_
+  {
+    FT_TS_Face     face;
+    FT_TS_Generic  autohint;   /* auto-hinter data while inactive */
+
+  } FT_TS_Var_InstanceRec;
+
+
+  typedef FT_TS_Error
+  (*FT_TS_New_Var_Instance_Func)( FT_TS_Face           face,
+                                  FT_TS_UInt           num_coords,
+                                  FT_TS_Fixed*         coords,
+                                  FT_TS_Var_Instance  *ainstance );
+
+  typedef FT_TS_Error
+  (*FT_TS_Set_Var_Instance_Func)( FT_TS_Face          face,
+                                  FT_TS_Var_Instance  instance );
+
+  typedef void
+  (*FT_TS_Done_Var_Instance_Func)( FT_TS_Var_Instance  instance );
+
+
   FT_TS_DEFINE_SERVICE( MultiMasters )
   {
     FT_TS_Get_MM_Func               get_mm;
@@ -109,6 +136,9 @@ FT_TS_BEGIN_HEADER
     FT_TS_Set_Instance_Func         set_instance;
     FT_TS_Set_MM_WeightVector_Func  set_mm_weightvector;
     FT_TS_Get_MM_WeightVector_Func  get_mm_weightvector;
+    FT_TS_New_Var_Instance_Func     new_var_instance;
+    FT_TS_Set_Var_Instance_Func     set_var_instance;
+    FT_TS_Done_Var_Instance_Func    done_var_instance;
 
     /* for internal use; only needed for code sharing between modules */
     FT_TS_Get_Var_Blend_Func  get_var_blend;
@@ -127,6 +157,9 @@ FT_TS_BEGIN_HEADER
                                            set_instance_,     \
                                            set_weightvector_, \
                                            get_weightvector_, \
+                                           new_var_instance_, \
+                                           set_var_instance_, \
+                                           done_var_instance_,\
                                            get_var_blend_,    \
                                            done_blend_ )      \
   static const FT_TS_Service_MultiMastersRec  class_ =           \
@@ -141,6 +174,9 @@ FT_TS_BEGIN_HEADER
     set_instance_,                                            \
     set_weightvector_,                                        \
     get_weightvector_,                                        \
+    new_var_instance_,                                        \
+    set_var_instance_,                                        \
+    done_var_instance_,                                       \
     get_var_blend_,                                           \
     done_blend_                                               \
   };
@@ -114,6 +114,7 @@ FT_TS_BEGIN_HEADER
 
     FT_TS_Int           num_glyphs;
     FT_TS_String**      glyph_names;       /* array of glyph names       */
+    FT_TS_Hash          glyph_names_hash;  /* glyph name to index map    */
     FT_TS_Byte**        charstrings;       /* array of glyph charstrings */
     FT_TS_UInt*         charstrings_len;
 
@@ -23,6 +23,7 @@
 
 #include <freetype/tttables.h>
 #include <freetype/internal/ftobjs.h>
+#include <freetype/internal/fthash.h>
 #include <freetype/ftcolor.h>
 
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
@@ -721,6 +722,90 @@ FT_TS_BEGIN_HEADER
   } TT_SBit_ComponentRec, *TT_SBit_Component;
 
 
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   TT_SBit_CachedRec
+   *
+   * @description:
+   *   A decoded compound sbit element, kept in the face's sbit component
+   *   cache.
+   *
+   * @fields:
+   *   next ::
+   *     The next element in the face's list of cached elements.
+   *
+   *   metrics ::
+   *     The element's metrics.
+   *
+   *   pitch ::
+   *     The number of bytes per row of `buffer`.
+   *
+   *   buffer ::
+   *     The element's image, with rows padded to full bytes and the bit
+   *     depth of its strike.
+   */
+  typedef struct  TT_SBit_CachedRec_
+  {
+    struct TT_SBit_CachedRec_*  next;
+
+    TT_SBit_MetricsRec  metrics;
+    FT_TS_UInt             pitch;
+    FT_TS_Byte*            buffer;
+
+  } TT_SBit_CachedRec, *TT_SBit_Cached;
+
+#endif /* TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE */
+
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   TT_SBit_PngRec
+   *
+   * @description:
+   *   A decoded PNG image of a color bitmap glyph, kept in the face's PNG
+   *   cache.
+   *
+   * @fields:
+   *   node ::
+   *     The image's node in the face's PNG cache; its hash is `offset`.
+   *
+   *   offset ::
+   *     The offset of the PNG data in the bitmap data table ('CBDT' or
+   *     'sbix').
+   *
+   *   size ::
+   *     The size of the PNG data.
+   *
+   *   width ::
+   *     The image width in pixels.
+   *
+   *   rows ::
+   *     The image height in pixels.
+   *
+   *   buffer ::
+   *     The image in premultiplied BGRA format, without row padding.
+   */
+  typedef struct  TT_SBit_PngRec_
+  {
+    FT_TS_MruNodeRec  node;
+
+    FT_TS_ULong       offset;
+    FT_TS_ULong       size;
+    FT_TS_UInt        width;
+    FT_TS_UInt        rows;
+    FT_TS_Byte*       buffer;
+
+  } TT_SBit_PngRec, *TT_SBit_Png;
+
+#endif /* TT_CONFIG_OPTION_SBIT_PNG_CACHE */
+
+
   /**************************************************************************
    *
    * @struct:
@@ -849,6 +934,10 @@ FT_TS_BEGIN_HEADER
    *
    *   format_25 ::
    *     The sub-table used for format 2.5.
+   *
+   *   name_index ::
+   *     A hash table mapping glyph names to glyph indices, built on demand
+   *     by @FT_TS_Get_Name_Index.  Since version 2.11.2.
    */
   typedef struct  TT_Post_NamesRec_
   {
@@ -861,6 +950,8 @@ FT_TS_BEGIN_HEADER
 
     } names;
 
+    FT_TS_Hash  name_index;
+
   } TT_Post_NamesRec, *TT_Post_Names;
 
 
@@ -1445,6 +1536,19 @@ FT_TS_BEGIN_HEADER
    *   vert_metrics_offset ::
    *     The file offset of the 'vmtx' table.
    *
+   *   horz_metrics ::
+   *     The decoded 'hmtx' table, with one entry per glyph.  Built on
+   *     demand by the `get_metrics` function of the 'sfnt' module.
+   *
+   *   vert_metrics ::
+   *     The decoded 'vmtx' table, with one entry per glyph.
+   *
+   *   horz_metrics_loaded ::
+   *     Set if `horz_metrics` has been built (or if this failed).
+   *
+   *   vert_metrics_loaded ::
+   *     Set if `vert_metrics` has been built (or if this failed).
+   *
    *   sph_found_func_flags ::
    *     Flags identifying special bytecode functions (used by the v38
    *     implementation of the bytecode interpreter).
@@ -1458,6 +1562,20 @@ FT_TS_BEGIN_HEADER
    *
    *   ebdt_size ::
    *     The size of the sbit data table.
+   *
+   *   sbit_components ::
+   *     A hash mapping strike and glyph indices of decoded compound sbit
+   *     elements to their @TT_SBit_CachedRec structures.
+   *
+   *   sbit_component_list ::
+   *     A list of all elements in `sbit_components`, for freeing them.
+   *
+   *   sbit_components_size ::
+   *     The number of bytes used by the elements in `sbit_components`.
+   *
+   *   sbit_pngs ::
+   *     The decoded PNG images of color bitmap glyphs (of type
+   *     `TT_SBit_PngRec`), most recently used first.
    */
   typedef struct  TT_FaceRec_
   {
@@ -1627,6 +1745,12 @@ FT_TS_BEGIN_HEADER
     FT_TS_ULong              horz_metrics_offset;
     FT_TS_ULong              vert_metrics_offset;
 
+    /* since 2.11.2 */
+    TT_LongMetrics        horz_metrics;
+    TT_LongMetrics        vert_metrics;
+    FT_TS_Bool               horz_metrics_loaded;
+    FT_TS_Bool               vert_metrics_loaded;
+
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_INFINALITY
     /* since 2.4.12 */
     FT_TS_ULong              sph_found_func_flags; /* special functions found */
@@ -1640,6 +1764,18 @@ FT_TS_BEGIN_HEADER
     FT_TS_ULong              ebdt_size;
 #endif
 
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+    /* since 2.11.2 */
+    FT_TS_Hash               sbit_components;
+    TT_SBit_Cached        sbit_component_list;
+    FT_TS_ULong              sbit_components_size;
+#endif
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+    /* since 2.11.2 */
+    FT_TS_MruListRec      sbit_pngs;
+#endif
+
     /* since 2.10 */
     void*                 cpal;
     void*                 colr;
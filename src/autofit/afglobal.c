@@ -21,6 +21,10 @@
 #include "afshaper.h"
 #include "afws-decl.h"
 #include <freetype/internal/ftdebug.h>
+#include <freetype/internal/ftstream.h>
+#include <freetype/internal/ftserv.h>
+#include <freetype/ftmm.h>
+#include <freetype/internal/services/svmm.h>
 
 
   /**************************************************************************
@@ -323,10 +327,12 @@
   }
 
 
-  FT_TS_LOCAL_DEF( FT_TS_Error )
-  af_face_globals_new( FT_TS_Face          face,
-                       AF_FaceGlobals  *aglobals,
-                       AF_Module        module )
+  /* Allocate and set up an empty face globals object. */
+
+  static FT_TS_Error
+  af_face_globals_alloc( FT_TS_Face          face,
+                         AF_FaceGlobals  *aglobals,
+                         AF_Module        module )
   {
     FT_TS_Error        error;
     FT_TS_Memory       memory;
@@ -354,19 +360,40 @@
     globals->standard_horizontal_width = 0;
     globals->scale_down_factor         = 0;
 
+    globals->increase_x_height         = AF_PROP_INCREASE_X_HEIGHT_MAX;
+
+    af_glyph_hints_init( &globals->hints, memory );
+
 #ifdef FT_TS_CONFIG_OPTION_USE_HARFBUZZ
     globals->hb_font = hb_ft_font_create( face, NULL );
     globals->hb_buf  = hb_buffer_create();
 #endif
 
+  Exit:
+    *aglobals = globals;
+    return error;
+  }
+
+
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  af_face_globals_new( FT_TS_Face          face,
+                       AF_FaceGlobals  *aglobals,
+                       AF_Module        module )
+  {
+    FT_TS_Error        error;
+    AF_FaceGlobals  globals = NULL;
+
+
+    error = af_face_globals_alloc( face, &globals, module );
+    if ( error )
+      goto Exit;
+
     error = af_face_globals_compute_style_coverage( globals );
     if ( error )
     {
       af_face_globals_free( globals );
       globals = NULL;
     }
-    else
-      globals->increase_x_height = AF_PROP_INCREASE_X_HEIGHT_MAX;
 
   Exit:
     *aglobals = globals;
@@ -405,6 +432,10 @@
       hb_buffer_destroy( globals->hb_buf );
 #endif
 
+      af_glyph_hints_done( &globals->hints );
+
+      FT_TS_FREE( globals->saved_data );
+
       /* no need to free `globals->glyph_styles'; */
       /* it is part of the `globals' array        */
       FT_TS_FREE( globals );
@@ -506,4 +537,719 @@
   }
 
 
+  /**************************************************************************
+   *
+   * Serialization of face globals.
+   *
+   * The style coverage and the per-style metrics computed by the
+   * writing-system `init' functions depend only on the font and on this
+   * build of the auto-hinter; they can thus be stored by the client (for
+   * example, in a cache file keyed by the font's path and modification
+   * time) and loaded back into a fresh face, avoiding both the cmap scan
+   * and the metrics computation.  All values that depend on the scaling
+   * are recomputed as usual.
+   *
+   * The format is big-endian:
+   *
+   *   magic             4 bytes   `AFGL'
+   *   format version    ushort
+   *   FreeType version  3 bytes   major, minor, patch
+   *   reserved          byte
+   *   config signature  ulong     style classes and array limits
+   *   face signature    ulong     font identity and variation coordinates
+   *   glyph count       ulong
+   *   glyph styles      ushort[glyph count]
+   *   metrics count     ushort
+   *   metrics records   (see `af_face_globals_write_metrics')
+   *   checksum          ulong     over all preceding bytes
+   *
+   */
+
+#define AF_GLOBALS_MAGIC    0x4146474CUL  /* `AFGL' */
+#define AF_GLOBALS_VERSION  1
+
+#define AF_GLOBALS_HEADER_SIZE  22
+
+
+#define WRITE_BYTE( p, v )                 \
+          do                               \
+          {                                \
+            *(p)++ = (FT_TS_Byte)( v );    \
+                                           \
+          } while ( 0 )
+
+#define WRITE_USHORT( p, v )                   \
+          do                                   \
+          {                                    \
+            *(p)++ = (FT_TS_Byte)( (v) >> 8 ); \
+            *(p)++ = (FT_TS_Byte)( (v) >> 0 ); \
+                                               \
+          } while ( 0 )
+
+#define WRITE_ULONG( p, v )                     \
+          do                                    \
+          {                                     \
+            *(p)++ = (FT_TS_Byte)( (v) >> 24 ); \
+            *(p)++ = (FT_TS_Byte)( (v) >> 16 ); \
+            *(p)++ = (FT_TS_Byte)( (v) >>  8 ); \
+            *(p)++ = (FT_TS_Byte)( (v) >>  0 ); \
+                                                \
+          } while ( 0 )
+
+  /* font units always fit into 32 bits */
+#define WRITE_POS( p, v )  WRITE_ULONG( p, (FT_TS_UInt32)(v) )
+
+
+  /* FNV-1a */
+
+  static FT_TS_UInt32
+  af_hash_bytes( FT_TS_UInt32       hash,
+                 const FT_TS_Byte*  p,
+                 FT_TS_ULong        len )
+  {
+    for ( ; len > 0; len--, p++ )
+    {
+      hash ^= *p;
+      hash *= 16777619UL;
+    }
+
+    return hash;
+  }
+
+
+  static FT_TS_UInt32
+  af_hash_ulong( FT_TS_UInt32  hash,
+                 FT_TS_ULong   v )
+  {
+    FT_TS_Byte   buf[4];
+    FT_TS_Byte*  p = buf;
+
+
+    WRITE_ULONG( p, v );
+
+    return af_hash_bytes( hash, buf, 4 );
+  }
+
+
+  static FT_TS_UInt32
+  af_hash_string( FT_TS_UInt32       hash,
+                  const FT_TS_String*  s )
+  {
+    if ( s )
+      hash = af_hash_bytes( hash,
+                            (const FT_TS_Byte*)s,
+                            (FT_TS_ULong)ft_strlen( s ) );
+
+    /* a terminator so that `ab'+`c' differs from `a'+`bc' */
+    return af_hash_ulong( hash, 0 );
+  }
+
+
+  /* Identify the auto-hinter configuration that produced the data. */
+
+  static FT_TS_UInt32
+  af_face_globals_config_signature( AF_Module  module )
+  {
+    FT_TS_UInt32  hash = 2166136261UL;
+    FT_TS_UInt    ss;
+
+
+    hash = af_hash_ulong( hash, AF_STYLE_MAX );
+    hash = af_hash_ulong( hash, AF_BLUE_STRINGSET_MAX );
+    hash = af_hash_ulong( hash, AF_LATIN_MAX_WIDTHS );
+    hash = af_hash_ulong( hash, AF_CJK_MAX_WIDTHS );
+
+    for ( ss = 0; af_style_classes[ss]; ss++ )
+    {
+      AF_StyleClass  style_class = af_style_classes[ss];
+
+
+      hash = af_hash_ulong( hash, (FT_TS_ULong)style_class->style );
+      hash = af_hash_ulong( hash, (FT_TS_ULong)style_class->writing_system );
+      hash = af_hash_ulong( hash, (FT_TS_ULong)style_class->script );
+      hash = af_hash_ulong( hash, (FT_TS_ULong)style_class->blue_stringset );
+      hash = af_hash_ulong( hash, (FT_TS_ULong)style_class->coverage );
+    }
+
+    /* the coverage depends on these module properties */
+    hash = af_hash_ulong( hash, module->fallback_style );
+    hash = af_hash_ulong( hash, module->default_script );
+
+#ifdef FT_TS_CONFIG_OPTION_USE_HARFBUZZ
+    hash = af_hash_ulong( hash, 1 );
+#else
+    hash = af_hash_ulong( hash, 0 );
+#endif
+
+    return hash;
+  }
+
+
+  /*
+   * Identify the font.  This is not meant to detect arbitrary changes of
+   * the font file (the client has to key its storage by file identity
+   * anyway) but to catch blobs that get applied to the wrong face or to
+   * a different named or variation instance.
+   */
+
+  static FT_TS_UInt32
+  af_face_globals_face_signature( FT_TS_Face  face )
+  {
+    FT_TS_UInt32  hash = 2166136261UL;
+
+
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->num_glyphs );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->face_index );
+    /* the variation coordinates are handled below */
+    hash = af_hash_ulong( hash,
+                          (FT_TS_ULong)( face->face_flags &
+                                         ~FT_TS_FACE_FLAG_VARIATION ) );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->style_flags );
+    hash = af_hash_ulong( hash, face->units_per_EM );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->bbox.xMin );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->bbox.yMin );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->bbox.xMax );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->bbox.yMax );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->ascender );
+    hash = af_hash_ulong( hash, (FT_TS_ULong)face->descender );
+    hash = af_hash_string( hash, face->family_name );
+    hash = af_hash_string( hash, face->style_name );
+
+    if ( FT_TS_HAS_MULTIPLE_MASTERS( face ) )
+    {
+      FT_TS_Service_MultiMasters  mm;
+      FT_TS_UInt                  num_coords = 0;
+      FT_TS_UInt                  nn;
+
+
+      FT_TS_FACE_FIND_SERVICE( face, mm, MULTI_MASTERS );
+
+      if ( mm && mm->get_var_blend )
+      {
+        FT_TS_Fixed*  coords = NULL;
+
+
+        /* Use normalized coordinates and skip default values so that */
+        /* a face explicitly set to the default instance still        */
+        /* matches a pristine one.                                    */
+        mm->get_var_blend( face, &num_coords, NULL, &coords, NULL );
+        if ( !coords )
+          num_coords = 0;
+
+        for ( nn = 0; nn < num_coords; nn++ )
+        {
+          if ( coords[nn] )
+          {
+            hash = af_hash_ulong( hash, nn );
+            hash = af_hash_ulong( hash, (FT_TS_ULong)coords[nn] );
+          }
+        }
+
+        num_coords = 0;
+      }
+      else if ( mm && mm->get_mm_blend )
+      {
+        /* Type 1 multiple masters have at most four axes */
+        FT_TS_Fixed  coords[4];
+
+
+        if ( !mm->get_mm_blend( face, 4, coords ) )
+          num_coords = 4;
+
+        for ( nn = 0; nn < num_coords; nn++ )
+          hash = af_hash_ulong( hash, (FT_TS_ULong)coords[nn] );
+      }
+
+      hash = af_hash_ulong( hash, num_coords );
+    }
+
+    return hash;
+  }
+
+
+  static FT_TS_ULong
+  af_face_globals_metrics_size( AF_StyleMetrics  metrics )
+  {
+    FT_TS_ULong  size = 2 + 1;   /* style, digits flag */
+    FT_TS_UInt   dim;
+
+
+    switch ( metrics->style_class->writing_system )
+    {
+    case AF_WRITING_SYSTEM_LATIN:
+      {
+        AF_LatinMetrics  m = (AF_LatinMetrics)metrics;
+
+
+        size += 4;
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+          size += 2 + 4 * m->axis[dim].width_count + 4 + 4 + 1 +
+                  2 + 20 * m->axis[dim].blue_count;
+      }
+      break;
+
+    case AF_WRITING_SYSTEM_CJK:
+    case AF_WRITING_SYSTEM_INDIC:
+      {
+        AF_CJKMetrics  m = (AF_CJKMetrics)metrics;
+
+
+        size += 4;
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+          size += 2 + 4 * m->axis[dim].width_count + 4 + 4 + 1 + 1 +
+                  2 + 12 * m->axis[dim].blue_count;
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    return size;
+  }
+
+
+  /*
+   * A metrics record holds the style index and the values computed by
+   * the writing system's `init' function in font units.  The dummy
+   * writing system has no data of its own.
+   */
+
+  static FT_TS_Byte*
+  af_face_globals_write_metrics( AF_StyleMetrics  metrics,
+                                 FT_TS_Byte*         p )
+  {
+    FT_TS_UInt  dim, nn;
+
+
+    WRITE_USHORT( p, metrics->style_class->style );
+    WRITE_BYTE( p, metrics->digits_have_same_width );
+
+    switch ( metrics->style_class->writing_system )
+    {
+    case AF_WRITING_SYSTEM_LATIN:
+      {
+        AF_LatinMetrics  m = (AF_LatinMetrics)metrics;
+
+
+        WRITE_ULONG( p, m->units_per_em );
+
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+        {
+          AF_LatinAxis  axis = &m->axis[dim];
+
+
+          WRITE_USHORT( p, axis->width_count );
+          for ( nn = 0; nn < axis->width_count; nn++ )
+            WRITE_POS( p, axis->widths[nn].org );
+
+          WRITE_POS( p, axis->edge_distance_threshold );
+          WRITE_POS( p, axis->standard_width );
+          WRITE_BYTE( p, axis->extra_light );
+
+          WRITE_USHORT( p, axis->blue_count );
+          for ( nn = 0; nn < axis->blue_count; nn++ )
+          {
+            AF_LatinBlue  blue = &axis->blues[nn];
+
+
+            WRITE_POS( p, blue->ref.org );
+            WRITE_POS( p, blue->shoot.org );
+            WRITE_POS( p, blue->ascender );
+            WRITE_POS( p, blue->descender );
+            WRITE_ULONG( p, blue->flags & ~AF_LATIN_BLUE_ACTIVE );
+          }
+        }
+      }
+      break;
+
+    case AF_WRITING_SYSTEM_CJK:
+    case AF_WRITING_SYSTEM_INDIC:
+      {
+        AF_CJKMetrics  m = (AF_CJKMetrics)metrics;
+
+
+        WRITE_ULONG( p, m->units_per_em );
+
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+        {
+          AF_CJKAxis  axis = &m->axis[dim];
+
+
+          WRITE_USHORT( p, axis->width_count );
+          for ( nn = 0; nn < axis->width_count; nn++ )
+            WRITE_POS( p, axis->widths[nn].org );
+
+          WRITE_POS( p, axis->edge_distance_threshold );
+          WRITE_POS( p, axis->standard_width );
+          WRITE_BYTE( p, axis->extra_light );
+          WRITE_BYTE( p, axis->control_overshoot );
+
+          WRITE_USHORT( p, axis->blue_count );
+          for ( nn = 0; nn < axis->blue_count; nn++ )
+          {
+            AF_CJKBlue  blue = &axis->blues[nn];
+
+
+            WRITE_POS( p, blue->ref.org );
+            WRITE_POS( p, blue->shoot.org );
+            WRITE_ULONG( p, blue->flags & ~AF_CJK_BLUE_ACTIVE );
+          }
+        }
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    return p;
+  }
+
+
+  /* Read a metrics record; `limit' is the end of the metrics data. */
+
+  static FT_TS_Error
+  af_face_globals_read_metrics( AF_StyleMetrics  metrics,
+                                FT_TS_Byte*     *ap,
+                                FT_TS_Byte*      limit )
+  {
+    FT_TS_Byte*  p = *ap;
+    FT_TS_UInt   dim, nn;
+
+
+    if ( limit - p < 1 )
+      goto Fail;
+
+    metrics->digits_have_same_width = FT_TS_BOOL( FT_TS_NEXT_BYTE( p ) );
+
+    switch ( metrics->style_class->writing_system )
+    {
+    case AF_WRITING_SYSTEM_LATIN:
+      {
+        AF_LatinMetrics  m = (AF_LatinMetrics)metrics;
+
+
+        if ( limit - p < 4 )
+          goto Fail;
+
+        m->units_per_em = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+        if ( m->units_per_em != metrics->globals->face->units_per_EM )
+          goto Fail;
+
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+        {
+          AF_LatinAxis  axis = &m->axis[dim];
+
+
+          if ( limit - p < 2 )
+            goto Fail;
+
+          axis->width_count = FT_TS_NEXT_USHORT( p );
+          if ( axis->width_count > AF_LATIN_MAX_WIDTHS                 ||
+               limit - p < 4 * (FT_TS_Long)axis->width_count + 4 + 4 + 1 + 2 )
+            goto Fail;
+
+          for ( nn = 0; nn < axis->width_count; nn++ )
+            axis->widths[nn].org = FT_TS_NEXT_LONG( p );
+
+          axis->edge_distance_threshold = FT_TS_NEXT_LONG( p );
+          axis->standard_width          = FT_TS_NEXT_LONG( p );
+          axis->extra_light             = FT_TS_BOOL( FT_TS_NEXT_BYTE( p ) );
+
+          axis->blue_count = FT_TS_NEXT_USHORT( p );
+          if ( axis->blue_count > AF_BLUE_STRINGSET_MAX          ||
+               limit - p < 20 * (FT_TS_Long)axis->blue_count )
+            goto Fail;
+
+          for ( nn = 0; nn < axis->blue_count; nn++ )
+          {
+            AF_LatinBlue  blue = &axis->blues[nn];
+
+
+            blue->ref.org   = FT_TS_NEXT_LONG( p );
+            blue->shoot.org = FT_TS_NEXT_LONG( p );
+            blue->ascender  = FT_TS_NEXT_LONG( p );
+            blue->descender = FT_TS_NEXT_LONG( p );
+            blue->flags     = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+          }
+        }
+      }
+      break;
+
+    case AF_WRITING_SYSTEM_CJK:
+    case AF_WRITING_SYSTEM_INDIC:
+      {
+        AF_CJKMetrics  m = (AF_CJKMetrics)metrics;
+
+
+        if ( limit - p < 4 )
+          goto Fail;
+
+        m->units_per_em = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+        if ( m->units_per_em != metrics->globals->face->units_per_EM )
+          goto Fail;
+
+        for ( dim = 0; dim < AF_DIMENSION_MAX; dim++ )
+        {
+          AF_CJKAxis  axis = &m->axis[dim];
+
+
+          if ( limit - p < 2 )
+            goto Fail;
+
+          axis->width_count = FT_TS_NEXT_USHORT( p );
+          if ( axis->width_count > AF_CJK_MAX_WIDTHS                       ||
+               limit - p < 4 * (FT_TS_Long)axis->width_count + 4 + 4 + 1 + 1 + 2 )
+            goto Fail;
+
+          for ( nn = 0; nn < axis->width_count; nn++ )
+            axis->widths[nn].org = FT_TS_NEXT_LONG( p );
+
+          axis->edge_distance_threshold = FT_TS_NEXT_LONG( p );
+          axis->standard_width          = FT_TS_NEXT_LONG( p );
+          axis->extra_light             = FT_TS_BOOL( FT_TS_NEXT_BYTE( p ) );
+          axis->control_overshoot       = FT_TS_BOOL( FT_TS_NEXT_BYTE( p ) );
+
+          axis->blue_count = FT_TS_NEXT_USHORT( p );
+          if ( axis->blue_count > AF_BLUE_STRINGSET_MAX          ||
+               limit - p < 12 * (FT_TS_Long)axis->blue_count )
+            goto Fail;
+
+          for ( nn = 0; nn < axis->blue_count; nn++ )
+          {
+            AF_CJKBlue  blue = &axis->blues[nn];
+
+
+            blue->ref.org   = FT_TS_NEXT_LONG( p );
+            blue->shoot.org = FT_TS_NEXT_LONG( p );
+            blue->flags     = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+          }
+        }
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    *ap = p;
+    return FT_TS_Err_Ok;
+
+  Fail:
+    return FT_TS_THROW( Invalid_Argument );
+  }
+
+
+  /*
+   * Compute the metrics of all styles used by the face, then serialize
+   * everything into `globals->saved_data'.  The buffer stays valid until
+   * the next call or until the globals get destroyed.
+   */
+
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  af_face_globals_save( AF_FaceGlobals  globals )
+  {
+    FT_TS_Error   error  = FT_TS_Err_Ok;
+    FT_TS_Memory  memory = globals->face->memory;
+    FT_TS_Byte    tried[AF_STYLE_MAX];
+    FT_TS_Long    gidx;
+    FT_TS_UInt    nn, count;
+    FT_TS_ULong   size;
+    FT_TS_Byte*   p;
+
+
+    FT_TS_MEM_ZERO( tried, sizeof ( tried ) );
+
+    /* Metrics computation might reassign glyphs to another style    */
+    /* (if no blue zones are found), so check the current style of   */
+    /* every glyph again.                                            */
+    for ( gidx = 0; gidx < globals->glyph_count; gidx++ )
+    {
+      FT_TS_UInt       style = globals->glyph_styles[gidx] & AF_STYLE_MASK;
+      AF_StyleMetrics  metrics;
+
+
+      if ( style >= AF_STYLE_MAX || tried[style] )
+        continue;
+
+      tried[style] = 1;
+
+      error = af_face_globals_get_metrics( globals,
+                                           (FT_TS_UInt)gidx,
+                                           0,
+                                           &metrics );
+      if ( error )
+        goto Exit;
+    }
+
+    size  = AF_GLOBALS_HEADER_SIZE +
+            2 * (FT_TS_ULong)globals->glyph_count + 2 + 4;
+    count = 0;
+    for ( nn = 0; nn < AF_STYLE_MAX; nn++ )
+    {
+      if ( globals->metrics[nn] )
+      {
+        size += af_face_globals_metrics_size( globals->metrics[nn] );
+        count++;
+      }
+    }
+
+    FT_TS_FREE( globals->saved_data );
+    globals->saved_size = 0;
+
+    if ( FT_TS_QALLOC( globals->saved_data, size ) )
+      goto Exit;
+
+    p = globals->saved_data;
+
+    WRITE_ULONG( p, AF_GLOBALS_MAGIC );
+    WRITE_USHORT( p, AF_GLOBALS_VERSION );
+    WRITE_BYTE( p, FREETYPE_MAJOR );
+    WRITE_BYTE( p, FREETYPE_MINOR );
+    WRITE_BYTE( p, FREETYPE_PATCH );
+    WRITE_BYTE( p, 0 );
+    WRITE_ULONG( p, af_face_globals_config_signature( globals->module ) );
+    WRITE_ULONG( p, af_face_globals_face_signature( globals->face ) );
+    WRITE_ULONG( p, globals->glyph_count );
+
+    for ( gidx = 0; gidx < globals->glyph_count; gidx++ )
+      WRITE_USHORT( p, globals->glyph_styles[gidx] );
+
+    WRITE_USHORT( p, count );
+    for ( nn = 0; nn < AF_STYLE_MAX; nn++ )
+    {
+      if ( globals->metrics[nn] )
+        p = af_face_globals_write_metrics( globals->metrics[nn], p );
+    }
+
+    WRITE_ULONG( p, af_hash_bytes( 2166136261UL,
+                                   globals->saved_data,
+                                   size - 4 ) );
+
+    globals->saved_size = size;
+
+  Exit:
+    return error;
+  }
+
+
+  /*
+   * Create face globals from data returned by `af_face_globals_save'.
+   * Data that doesn't belong to `face' or to this build is rejected with
+   * `Invalid_Argument'.
+   */
+
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  af_face_globals_load( FT_TS_Face          face,
+                        const FT_TS_Byte*   data,
+                        FT_TS_ULong         size,
+                        AF_FaceGlobals  *aglobals,
+                        AF_Module        module )
+  {
+    FT_TS_Error        error;
+    FT_TS_Memory       memory  = face->memory;
+    AF_FaceGlobals  globals = NULL;
+    FT_TS_Byte*        p       = (FT_TS_Byte*)data;
+    FT_TS_Byte*        limit;
+    FT_TS_Long         gidx;
+    FT_TS_UInt         count;
+
+
+    *aglobals = NULL;
+
+    if ( !data                                                 ||
+         size < AF_GLOBALS_HEADER_SIZE + 2 + 4                 ||
+         af_hash_bytes( 2166136261UL, data, size - 4 ) !=
+           FT_TS_PEEK_ULONG( data + size - 4 )                 )
+      goto Invalid;
+
+    limit = p + size - 4;
+
+    if ( FT_TS_NEXT_ULONG( p )  != AF_GLOBALS_MAGIC   ||
+         FT_TS_NEXT_USHORT( p ) != AF_GLOBALS_VERSION ||
+         FT_TS_NEXT_BYTE( p )   != FREETYPE_MAJOR     ||
+         FT_TS_NEXT_BYTE( p )   != FREETYPE_MINOR     ||
+         FT_TS_NEXT_BYTE( p )   != FREETYPE_PATCH     )
+      goto Invalid;
+
+    p++;  /* reserved */
+
+    if ( FT_TS_NEXT_ULONG( p ) != af_face_globals_config_signature( module ) ||
+         FT_TS_NEXT_ULONG( p ) != af_face_globals_face_signature( face )     ||
+         FT_TS_NEXT_ULONG( p ) != (FT_TS_ULong)face->num_glyphs              )
+      goto Invalid;
+
+    if ( limit - p < 2 * face->num_glyphs + 2 )
+      goto Invalid;
+
+    error = af_face_globals_alloc( face, &globals, module );
+    if ( error )
+      goto Exit;
+
+    for ( gidx = 0; gidx < globals->glyph_count; gidx++ )
+    {
+      FT_TS_UShort  gstyle = FT_TS_NEXT_USHORT( p );
+
+
+      if ( ( gstyle & AF_STYLE_MASK ) >= AF_STYLE_MAX )
+        goto Invalid;
+
+      globals->glyph_styles[gidx] = gstyle;
+    }
+
+    count = FT_TS_NEXT_USHORT( p );
+    if ( count > AF_STYLE_MAX )
+      goto Invalid;
+
+    for ( ; count > 0; count-- )
+    {
+      AF_StyleMetrics        metrics;
+      AF_StyleClass          style_class;
+      AF_WritingSystemClass  writing_system_class;
+      FT_TS_UInt             style;
+
+
+      if ( limit - p < 2 )
+        goto Invalid;
+
+      style = FT_TS_NEXT_USHORT( p );
+      if ( style >= AF_STYLE_MAX || globals->metrics[style] )
+        goto Invalid;
+
+      style_class          = af_style_classes[style];
+      writing_system_class = af_writing_system_classes
+                               [style_class->writing_system];
+
+      if ( FT_TS_ALLOC( metrics, writing_system_class->style_metrics_size ) )
+        goto Fail;
+
+      metrics->style_class = style_class;
+      metrics->globals     = globals;
+
+      globals->metrics[style] = metrics;
+
+      error = af_face_globals_read_metrics( metrics, &p, limit );
+      if ( error )
+        goto Fail;
+    }
+
+    if ( p != limit )
+      goto Invalid;
+
+    *aglobals = globals;
+
+  Exit:
+    return error;
+
+  Invalid:
+    FT_TS_TRACE2(( "af_face_globals_load: invalid or mismatching data\n" ));
+    error = FT_TS_THROW( Invalid_Argument );
+
+  Fail:
+    af_face_globals_free( globals );
+    goto Exit;
+  }
+
+
 /* END */
@@ -22,6 +22,7 @@
 
 
 #include "aftypes.h"
+#include "afhints.h"
 #include "afmodule.h"
 #include "afshaper.h"
 
@@ -136,6 +137,15 @@ FT_TS_BEGIN_HEADER
     FT_TS_Fixed         scale_down_factor;
     AF_Module        module;         /* to access global properties */
 
+    /* Working data for hinting a glyph.  It is kept here so that its */
+    /* arrays, once grown to the size of the face's largest glyph,    */
+    /* get reused instead of being allocated for every glyph.         */
+    AF_GlyphHintsRec  hints;
+
+    /* serialized form handed out by the `face-globals' property */
+    FT_TS_Byte*         saved_data;
+    FT_TS_ULong         saved_size;
+
   } AF_FaceGlobalsRec;
 
 
@@ -162,6 +172,16 @@ FT_TS_BEGIN_HEADER
   af_face_globals_is_digit( AF_FaceGlobals  globals,
                             FT_TS_UInt         gindex );
 
+  FT_TS_LOCAL( FT_TS_Error )
+  af_face_globals_save( AF_FaceGlobals  globals );
+
+  FT_TS_LOCAL( FT_TS_Error )
+  af_face_globals_load( FT_TS_Face          face,
+                        const FT_TS_Byte*   data,
+                        FT_TS_ULong         size,
+                        AF_FaceGlobals  *aglobals,
+                        AF_Module        module );
+
   /* */
 
 
@@ -62,6 +62,11 @@
       }
     }
 
+    /* unless the caller provides its own hints object we use the one */
+    /* of the face, which keeps its arrays from glyph to glyph        */
+    if ( !error && !loader->hints )
+      loader->hints = &loader->globals->hints;
+
     return error;
   }
 
@@ -221,7 +226,7 @@
     FT_TS_Slot_Internal  slot_internal = slot->internal;
     FT_TS_GlyphLoader    gloader       = slot_internal->loader;
 
-    AF_GlyphHints          hints         = loader->hints;
+    AF_GlyphHints          hints;
     AF_ScalerRec           scaler;
     AF_StyleMetrics        style_metrics;
     FT_TS_UInt                style_options = AF_STYLE_NONE_DFLT;
@@ -297,6 +302,8 @@
     if ( error )
       goto Exit;
 
+    hints = loader->hints;
+
     /*
      * Glyphs (really code points) are assigned to scripts.  Script
      * analysis is done lazily: For each glyph that passes through here,
@@ -190,6 +190,38 @@
 
       return error;
     }
+    else if ( !ft_strcmp( property_name, "face-globals" ) )
+    {
+      FT_TS_Prop_FaceGlobals*  prop;
+      AF_FaceGlobals        globals;
+      FT_TS_Face               face;
+
+
+#ifdef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+        return FT_TS_THROW( Invalid_Argument );
+#endif
+
+      prop = (FT_TS_Prop_FaceGlobals*)value;
+      face = prop->face;
+      if ( !face )
+        return FT_TS_THROW( Invalid_Face_Handle );
+
+      error = af_face_globals_load( face, prop->data, prop->size,
+                                    &globals, module );
+      if ( error )
+        return error;
+
+      if ( face->autohint.finalizer )
+        face->autohint.finalizer( face->autohint.data );
+
+      face->autohint.data =
+        (FT_TS_Pointer)globals;
+      face->autohint.finalizer =
+        (FT_TS_Generic_Finalizer)af_face_globals_free;
+
+      return error;
+    }
     else if ( !ft_strcmp( property_name, "darkening-parameters" ) )
     {
       FT_TS_Int*  darken_params;
@@ -307,6 +339,23 @@
 
       return error;
     }
+    else if ( !ft_strcmp( property_name, "face-globals" ) )
+    {
+      FT_TS_Prop_FaceGlobals*  prop = (FT_TS_Prop_FaceGlobals*)value;
+      AF_FaceGlobals        globals;
+
+
+      error = af_property_get_face_globals( prop->face, &globals, module );
+      if ( !error )
+        error = af_face_globals_save( globals );
+      if ( !error )
+      {
+        prop->data = globals->saved_data;
+        prop->size = globals->saved_size;
+      }
+
+      return error;
+    }
     else if ( !ft_strcmp( property_name, "fallback-script" ) )
     {
       FT_TS_UInt*  val = (FT_TS_UInt*)value;
@@ -477,20 +526,19 @@
 
 #else /* !FT_TS_DEBUG_AUTOFIT */
 
-    AF_GlyphHintsRec  hints[1];
-    AF_LoaderRec      loader[1];
+    AF_LoaderRec  loader[1];
 
     FT_TS_UNUSED( size );
+    FT_TS_UNUSED( memory );
 
 
-    af_glyph_hints_init( hints, memory );
-    af_loader_init( loader, hints );
+    /* the loader picks up the hints object of the face globals */
+    af_loader_init( loader, NULL );
 
     error = af_loader_load_glyph( loader, module, slot->face,
                                   glyph_index, load_flags );
 
     af_loader_done( loader );
-    af_glyph_hints_done( hints );
 
     return error;
 
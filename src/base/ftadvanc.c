@@ -22,6 +22,40 @@
 #include <freetype/internal/ftobjs.h>
 
 
+  /* this must be the same scaling as to get linear{Hori,Vert}Advance */
+  /* (see `FT_TS_Load_Glyph' implementation in src/base/ftobjs.c), */
+  /* i.e., `FT_TS_MulDiv( advance, scale, 64 )'                       */
+
+  static void
+  ft_scale_advances( FT_TS_Fixed*  advances,
+                     FT_TS_UInt    count,
+                     FT_TS_Fixed   scale )
+  {
+    FT_TS_UInt  nn;
+
+
+#ifdef FT_TS_INT64
+
+    /* a branch-free loop the compiler can vectorize; */
+    /* `scale' is never negative                      */
+    for ( nn = 0; nn < count; nn++ )
+    {
+      FT_TS_Int64  v = (FT_TS_Int64)advances[nn] * scale;
+
+
+      advances[nn] = (FT_TS_Fixed)( v < 0 ? -( ( -v + 32 ) >> 6 )
+                                          : ( v + 32 ) >> 6 );
+    }
+
+#else /* !FT_TS_INT64 */
+
+    for ( nn = 0; nn < count; nn++ )
+      advances[nn] = FT_TS_MulDiv( advances[nn], scale, 64 );
+
+#endif /* !FT_TS_INT64 */
+  }
+
+
   static FT_TS_Error
   _ft_face_scale_advances( FT_TS_Face    face,
                            FT_TS_Fixed*  advances,
@@ -29,7 +63,6 @@
                            FT_TS_Int32   flags )
   {
     FT_TS_Fixed  scale;
-    FT_TS_UInt   nn;
 
 
     if ( flags & FT_TS_LOAD_NO_SCALE )
@@ -43,13 +76,145 @@
     else
       scale = face->size->metrics.x_scale;
 
-    /* this must be the same scaling as to get linear{Hori,Vert}Advance */
-    /* (see `FT_TS_Load_Glyph' implementation in src/base/ftobjs.c)        */
+    ft_scale_advances( advances, count, scale );
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /*
+   * Get scaled advances with the driver's `get_advances' function, going
+   * through a cache attached to the active size.  The cache holds pages of
+   * FT_TS_ADVANCE_PAGE_SIZE glyphs, each with a bitmap of valid entries;
+   * only missing runs get passed to the driver.  It is flushed if the
+   * scaling value or the load flags change.
+   *
+   * Variation fonts are not cached since their advances depend on the
+   * current instance.
+   */
+  static FT_TS_Error
+  ft_face_get_fast_advances( FT_TS_Face    face,
+                             FT_TS_UInt    start,
+                             FT_TS_UInt    count,
+                             FT_TS_Int32   flags,
+                             FT_TS_Fixed  *padvances )
+  {
+    FT_TS_Error                 error;
+    FT_TS_Face_GetAdvancesFunc  func = face->driver->clazz->get_advances;
+    FT_TS_Memory                memory;
+    FT_TS_Size_Internal         internal;
+    FT_TS_Fixed                 scale;
+    FT_TS_Int32                 key;
+    FT_TS_UInt                  nn;
 
-    for ( nn = 0; nn < count; nn++ )
-      advances[nn] = FT_TS_MulDiv( advances[nn], scale, 64 );
+
+    if ( ( flags & FT_TS_LOAD_NO_SCALE )  ||
+         !face->size                      ||
+         FT_TS_HAS_MULTIPLE_MASTERS( face ) )
+      goto NoCache;
+
+#ifdef FT_TS_CONFIG_OPTION_INCREMENTAL
+    if ( face->internal->incremental_interface )
+      goto NoCache;
+#endif
+
+    memory   = face->memory;
+    internal = face->size->internal;
+
+    if ( flags & FT_TS_LOAD_VERTICAL_LAYOUT )
+      scale = face->size->metrics.y_scale;
+    else
+      scale = face->size->metrics.x_scale;
+
+    key = flags & ~FT_TS_ADVANCE_FLAG_FAST_ONLY;
+
+    if ( !internal->advance_pages )
+    {
+      FT_TS_UInt  num_pages = ( (FT_TS_UInt)face->num_glyphs +
+                                FT_TS_ADVANCE_PAGE_SIZE - 1 ) /
+                              FT_TS_ADVANCE_PAGE_SIZE;
+
+
+      if ( FT_TS_NEW_ARRAY( internal->advance_pages, num_pages ) )
+        goto NoCache;
+
+      internal->num_advance_pages = num_pages;
+      internal->advance_scale     = scale;
+      internal->advance_flags     = key;
+    }
+    else if ( internal->advance_scale != scale ||
+              internal->advance_flags != key   )
+    {
+      for ( nn = 0; nn < internal->num_advance_pages; nn++ )
+        if ( internal->advance_pages[nn] )
+          FT_TS_ZERO( &internal->advance_pages[nn]->valid );
+
+      internal->advance_scale = scale;
+      internal->advance_flags = key;
+    }
+
+    nn = 0;
+    while ( nn < count )
+    {
+      FT_TS_UInt          gindex = start + nn;
+      FT_TS_UInt          base   = gindex & ~( FT_TS_ADVANCE_PAGE_SIZE - 1U );
+      FT_TS_UInt          first  = gindex - base;
+      FT_TS_UInt          end    = FT_TS_MIN( FT_TS_ADVANCE_PAGE_SIZE,
+                                              first + ( count - nn ) );
+      FT_TS_UInt          i, j;
+      FT_TS_AdvancePage   page;
+      FT_TS_AdvancePage*  ppage;
+
+
+      ppage = internal->advance_pages + gindex / FT_TS_ADVANCE_PAGE_SIZE;
+      if ( !*ppage && FT_TS_NEW( *ppage ) )
+      {
+        /* out of memory; fetch the rest directly */
+        start     += nn;
+        count     -= nn;
+        padvances += nn;
+        goto NoCache;
+      }
+
+      page = *ppage;
+
+      /* get runs of missing entries from the driver */
+      i = first;
+      while ( i < end )
+      {
+        if ( ( page->valid[i >> 5] >> ( i & 31 ) ) & 1 )
+        {
+          i++;
+          continue;
+        }
+
+        for ( j = i + 1; j < end; j++ )
+          if ( ( page->valid[j >> 5] >> ( j & 31 ) ) & 1 )
+            break;
+
+        error = func( face, base + i, j - i, flags, page->advances + i );
+        if ( error )
+          return error;
+
+        ft_scale_advances( page->advances + i, j - i, scale );
+
+        for ( ; i < j; i++ )
+          page->valid[i >> 5] |= (FT_TS_UInt32)1 << ( i & 31 );
+      }
+
+      FT_TS_ARRAY_COPY( padvances + nn, page->advances + first, end - first );
+
+      nn += end - first;
+    }
 
     return FT_TS_Err_Ok;
+
+  NoCache:
+    error = func( face, start, count, flags, padvances );
+    if ( !error )
+      error = _ft_face_scale_advances( face, padvances, count, flags );
+
+    return error;
   }
 
 
@@ -94,9 +259,9 @@
       FT_TS_Error  error;
 
 
-      error = func( face, gindex, 1, flags, padvance );
+      error = ft_face_get_fast_advances( face, gindex, 1, flags, padvance );
       if ( !error )
-        return _ft_face_scale_advances( face, padvance, 1, flags );
+        return error;
 
       if ( FT_TS_ERR_NEQ( error, Unimplemented_Feature ) )
         return error;
@@ -140,9 +305,10 @@
     func = face->driver->clazz->get_advances;
     if ( func && LOAD_ADVANCE_FAST_CHECK( face, flags ) )
     {
-      error = func( face, start, count, flags, padvances );
+      error = ft_face_get_fast_advances( face, start, count, flags,
+                                         padvances );
       if ( !error )
-        return _ft_face_scale_advances( face, padvances, count, flags );
+        return error;
 
       if ( FT_TS_ERR_NEQ( error, Unimplemented_Feature ) )
         return error;
@@ -17,9 +17,14 @@
 
 
 #include <freetype/internal/ftdebug.h>
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftcalc.h>
+#include <freetype/internal/fthash.h>
 #include <freetype/internal/sfnt.h>
 #include <freetype/internal/tttypes.h>
 #include <freetype/ftcolor.h>
+#include <freetype/ftoutln.h>
+#include <freetype/fttrigon.h>
 
 
 #ifdef TT_CONFIG_OPTION_COLOR_LAYERS
@@ -111,6 +116,3128 @@
     return FT_TS_Err_Ok;
   }
 
+
+#ifdef FT_TS_COLRV1_RENDERING
+
+  /**************************************************************************
+   *
+   * 'COLR' v1 rendering.
+   *
+   * The paint graph of a glyph is walked recursively and composited into
+   * a canvas of premultiplied ARGB words, which is returned as the BGRA
+   * bitmap of the glyph slot.
+   *
+   * Glyph outlines are rasterized with `FT_TS_Outline_Render` in direct
+   * mode.  If a glyph is filled with a color or a gradient (which is by
+   * far the most common case), its spans are shaded and blended right
+   * away; otherwise the spans become a coverage mask that clips the
+   * child paint.  Everything is computed in fixed point: the current
+   * transformation maps font units to 26.6 device coordinates, and
+   * gradients are evaluated incrementally along each span with 64-bit
+   * integers.  Blending processes two color channels per 32-bit
+   * operation.
+   *
+   * Intermediate layers (for composition and isolated layer groups) only
+   * cover the bounding box of their contents, clipped to the current clip
+   * mask.  All layers and clip masks of a glyph are taken from a fixed
+   * memory budget; rendering fails as soon as it is exhausted.
+   *
+   * The image of a 'PaintColrLayers' table drawn without a clip mask only
+   * depends on the table and the transformation.  It is kept in a small
+   * per-face cache, so that layer groups shared between glyphs, and
+   * glyphs rendered repeatedly, are composited from memory.
+   *
+   */
+
+
+  /* limits on the paint graph of a single glyph */
+#define COLR_MAX_DEPTH   64
+#define COLR_MAX_PAINTS  0x10000L
+
+  /* limits on the canvas size (in pixels) and the transformation */
+  /* (16.16 coefficients for 26.6 device units per font unit)     */
+#define COLR_MAX_DIM    16384
+#define COLR_MAX_COEFF  0x8000000L
+#define COLR_MAX_DELTA  0x40000000L
+
+  /* limit on the memory used by intermediate layers and clip masks */
+  /* of a single glyph (in bytes, in addition to the canvas)        */
+#define COLR_MAX_MEMORY  0x4000000L
+
+#define COLR_ONE32  ( (FT_TS_Int64)1 << 32 )
+
+#define COLR_OUT_OF_RANGE( x, max )  ( (x) > (max) || (x) < -(max) )
+
+  /* outlines are loaded in font units and transformed by us */
+#define COLR_LOAD_FLAGS  ( FT_TS_LOAD_NO_SCALE        | \
+                           FT_TS_LOAD_NO_BITMAP       | \
+                           FT_TS_LOAD_IGNORE_TRANSFORM )
+
+
+  /* a transformation from paint space to device space */
+  typedef struct  ColrTransform_
+  {
+    FT_TS_Matrix  matrix;     /* 16.16, 26.6 units per font unit */
+    FT_TS_Vector  delta;      /* 26.6                            */
+
+  } ColrTransform;
+
+
+  /* a rectangle of canvas pixels; rows are counted from the top */
+  typedef struct  ColrBox_
+  {
+    FT_TS_Int  x_min, y_min;
+    FT_TS_Int  x_max, y_max;  /* exclusive */
+
+  } ColrBox;
+
+
+  /* an image of the pixels within `area' and the box of its */
+  /* non-transparent pixels                                   */
+  typedef struct  ColrLayer_
+  {
+    FT_TS_UInt32*  pixels;
+    ColrBox        area;
+    ColrBox        box;
+
+  } ColrLayer;
+
+
+#define COLR_PIXEL( layer, x, y )                                     \
+          ( (layer)->pixels +                                         \
+            ( (y) - (layer)->area.y_min ) *                           \
+              ( (layer)->area.x_max - (layer)->area.x_min ) +         \
+            ( (x) - (layer)->area.x_min ) )
+
+
+  /* a coverage mask; only the pixels within its box are stored */
+  typedef struct  ColrMask_
+  {
+    FT_TS_Byte*  coverage;
+    ColrBox      box;
+
+  } ColrMask;
+
+
+  /* a solid color or a gradient */
+  typedef struct  ColrShader_
+  {
+    FT_TS_PaintFormat  format;
+    FT_TS_PaintExtend  extend;
+    FT_TS_UInt32       color;
+
+    /* Linear gradients: the gradient parameter in 32.32 format at the  */
+    /* center of canvas pixel (0,0) and its increments per column and   */
+    /* row (`u'); radial and sweep gradients: the position in paint     */
+    /* space (16.16 font units, relative to the gradient's center) and  */
+    /* its increments (`u' for x, `v' for y).                           */
+    FT_TS_Int64  u0, u_x, u_y;
+    FT_TS_Int64  v0, v_x, v_y;
+
+    /* radial gradients, in units of 2^shift font units (16.16) */
+    FT_TS_Int    shift;
+    FT_TS_Int64  cx, cy, dr, r0;
+    FT_TS_Int64  a, r0dr, r0r0;
+
+    /* sweep gradients (16.16 degrees) */
+    FT_TS_Angle  start;
+    FT_TS_Int64  scale;
+
+    /* the color line, sampled between its first and last stop */
+    FT_TS_Int64   stop_min;
+    FT_TS_Int64   stop_scale;
+    FT_TS_UInt32  ramp[256];
+
+  } ColrShader;
+
+
+  /* a cached image of a layer group */
+  typedef struct  ColrCacheEntry_
+  {
+    FT_TS_MruNodeRec  node;
+
+    FT_TS_Byte*    paint;        /* the 'PaintColrLayers' table        */
+    FT_TS_Matrix   matrix;
+    FT_TS_Pos      dx, dy;       /* fractional part of the translation */
+
+    /* the region rendered and the position of the image, in pixels     */
+    /* relative to the integer part of the translation, y axis upwards */
+    FT_TS_Int      x_min, y_min, x_max, y_max;
+    FT_TS_Int      left, top;
+    FT_TS_UInt     width, rows;
+    FT_TS_UInt32*  pixels;
+
+  } ColrCacheEntry;
+
+
+  typedef struct  FT_TS_ColrCacheRec_
+  {
+    FT_TS_MruListRec  entries;
+
+    /* the colors the images were rendered with */
+    FT_TS_Color*  palette;
+    FT_TS_UShort  num_palette_entries;
+    FT_TS_UShort  palette_index;
+    FT_TS_Bool    have_foreground_color;
+    FT_TS_Color   foreground_color;
+
+  } FT_TS_ColrCacheRec, *FT_TS_ColrCache;
+
+
+  typedef struct  ColrContext_
+  {
+    FT_TS_Face       face;
+    FT_TS_Memory     memory;
+    FT_TS_GlyphSlot  slot;       /* for loading outlines */
+    FT_TS_ColrCache  cache;      /* NULL if not used     */
+
+    FT_TS_Int  width;            /* canvas size in pixels */
+    FT_TS_Int  rows;
+
+    ColrMask*          clip;     /* the current clip mask, if any     */
+    ColrLayer*         layer;    /* the target of `ft_colr_fill_spans' */
+    ColrMask*          mask;     /* the target of `ft_colr_mask_spans' */
+    const ColrShader*  shader;
+    FT_TS_UInt32*      scratch;  /* one row of shaded pixels           */
+
+    FT_TS_Long   budget;         /* remaining number of paints        */
+    FT_TS_ULong  memory_left;    /* remaining bytes for layers, masks */
+    FT_TS_Bool   unbounded;      /* set by `ft_colr_bounds'           */
+
+  } ColrContext;
+
+
+  static FT_TS_Error
+  ft_colr_paint( ColrContext*          ctx,
+                 FT_TS_OpaquePaint     opaque,
+                 const ColrTransform*  tr,
+                 ColrLayer*            layer,
+                 FT_TS_UInt            depth );
+
+  static FT_TS_Error
+  ft_colr_bounds( ColrContext*          ctx,
+                  FT_TS_OpaquePaint     opaque,
+                  const ColrTransform*  tr,
+                  FT_TS_BBox*           bbox,
+                  FT_TS_UInt            depth );
+
+
+  /* multiply two 8-bit values, rounding like a division by 255 */
+  static FT_TS_UInt
+  ft_colr_mul8( FT_TS_UInt  a,
+                FT_TS_UInt  b )
+  {
+    FT_TS_UInt  t = a * b + 128;
+
+
+    return ( t + ( t >> 8 ) ) >> 8;
+  }
+
+
+  /* multiply all channels of `c' with `a/255', two channels at once */
+  static FT_TS_UInt32
+  ft_colr_mul( FT_TS_UInt32  c,
+               FT_TS_UInt    a )
+  {
+    FT_TS_UInt32  rb = ( c & 0x00FF00FFU ) * a + 0x00800080U;
+    FT_TS_UInt32  ag = ( ( c >> 8 ) & 0x00FF00FFU ) * a + 0x00800080U;
+
+
+    rb = ( ( rb + ( ( rb >> 8 ) & 0x00FF00FFU ) ) >> 8 ) & 0x00FF00FFU;
+    ag = ( ag + ( ( ag >> 8 ) & 0x00FF00FFU ) ) & 0xFF00FF00U;
+
+    return rb | ag;
+  }
+
+
+  /* add all channels of two colors with saturation */
+  static FT_TS_UInt32
+  ft_colr_add( FT_TS_UInt32  a,
+               FT_TS_UInt32  b )
+  {
+    FT_TS_UInt32  rb = ( a & 0x00FF00FFU ) + ( b & 0x00FF00FFU );
+    FT_TS_UInt32  ag = ( ( a >> 8 ) & 0x00FF00FFU ) +
+                       ( ( b >> 8 ) & 0x00FF00FFU );
+
+
+    rb |= 0x01000100U - ( ( rb >> 8 ) & 0x00010001U );
+    ag |= 0x01000100U - ( ( ag >> 8 ) & 0x00010001U );
+
+    return ( rb & 0x00FF00FFU ) | ( ( ag & 0x00FF00FFU ) << 8 );
+  }
+
+
+  /* composite premultiplied color `s' over `d' */
+#define COLR_OVER( d, s )  ( (s) + ft_colr_mul( (d), 255 - ( (s) >> 24 ) ) )
+
+
+  /* Blend `count' pixels over `dst', taken from `src' or, if that is */
+  /* NULL, in the solid `color'.  The source is attenuated by         */
+  /* `coverage' and the optional coverage `mask'.                     */
+  static void
+  ft_colr_blend_span( FT_TS_UInt32*        dst,
+                      const FT_TS_UInt32*  src,
+                      FT_TS_UInt32         color,
+                      const FT_TS_Byte*    mask,
+                      FT_TS_UInt           coverage,
+                      FT_TS_UInt           count )
+  {
+    FT_TS_UInt  i;
+
+
+    if ( !src )
+    {
+      if ( coverage < 255 )
+        color = ft_colr_mul( color, coverage );
+
+      if ( !color )
+        return;
+
+      if ( mask )
+      {
+        for ( i = 0; i < count; i++ )
+        {
+          FT_TS_UInt  m = mask[i];
+
+
+          if ( m == 255 )
+            dst[i] = COLR_OVER( dst[i], color );
+          else if ( m )
+          {
+            FT_TS_UInt32  s = ft_colr_mul( color, m );
+
+
+            dst[i] = COLR_OVER( dst[i], s );
+          }
+        }
+      }
+      else if ( ( color >> 24 ) == 255 )
+      {
+        for ( i = 0; i < count; i++ )
+          dst[i] = color;
+      }
+      else
+      {
+        for ( i = 0; i < count; i++ )
+          dst[i] = COLR_OVER( dst[i], color );
+      }
+    }
+    else
+    {
+      for ( i = 0; i < count; i++ )
+      {
+        FT_TS_UInt32  s = src[i];
+        FT_TS_UInt    m = mask ? ft_colr_mul8( mask[i], coverage )
+                               : coverage;
+
+
+        if ( m < 255 )
+          s = ft_colr_mul( s, m );
+
+        if ( ( s >> 24 ) == 255 )
+          dst[i] = s;
+        else if ( s )
+          dst[i] = COLR_OVER( dst[i], s );
+      }
+    }
+  }
+
+
+  /* Return palette entry `palette_index' (or the foreground color for */
+  /* 0xFFFF) as a premultiplied color, with its alpha value multiplied  */
+  /* by `alpha' (in F2Dot14 format).  Invalid entries are transparent. */
+  static FT_TS_UInt32
+  ft_colr_get_color( FT_TS_Face     face,
+                     FT_TS_UInt     palette_index,
+                     FT_TS_F2Dot14  alpha )
+  {
+    TT_Face      ttface = (TT_Face)face;
+    FT_TS_Color  color;
+    FT_TS_UInt   a;
+
+
+    if ( palette_index == 0xFFFF )
+    {
+      if ( ttface->have_foreground_color )
+        color = ttface->foreground_color;
+      else
+      {
+        /* the same defaults as for 'COLR' v0 layers */
+        if ( ttface->palette_data.palette_flags                            &&
+             ( ttface->palette_data.palette_flags[ttface->palette_index] &
+                 FT_TS_PALETTE_FOR_DARK_BACKGROUND                        ) )
+          color.red = color.green = color.blue = 0xFF;
+        else
+          color.red = color.green = color.blue = 0x00;
+
+        color.alpha = 0xFF;
+      }
+    }
+    else if ( ttface->palette                                     &&
+              palette_index <
+                ttface->palette_data.num_palette_entries )
+      color = ttface->palette[palette_index];
+    else
+      return 0;
+
+    if ( alpha <= 0 )
+      return 0;
+
+    a = color.alpha;
+    if ( alpha < 0x4000 )
+      a = ( a * (FT_TS_UInt)alpha + 0x2000 ) >> 14;
+
+    return ( (FT_TS_UInt32)a                              << 24 ) |
+           ( (FT_TS_UInt32)ft_colr_mul8( color.red,   a ) << 16 ) |
+           ( (FT_TS_UInt32)ft_colr_mul8( color.green, a ) <<  8 ) |
+             (FT_TS_UInt32)ft_colr_mul8( color.blue,  a );
+  }
+
+
+  /* Compute `a/b' in 32.32 format, saturating at 2^24; `b' must be */
+  /* positive.                                                      */
+  static FT_TS_Int64
+  ft_colr_div( FT_TS_Int64  a,
+               FT_TS_Int64  b )
+  {
+    FT_TS_Int64  q, r;
+
+
+    /* keep `b' below 2^31 so that the remainder can be shifted */
+    while ( b > 0x7FFFFFFFL )
+    {
+      a >>= 1;
+      b >>= 1;
+    }
+
+    q = a / b;
+    r = a % b;
+
+    if ( q >= 0x1000000L )
+      return 0x1000000L * COLR_ONE32;
+    if ( q <= -0x1000000L )
+      return -0x1000000L * COLR_ONE32;
+
+    return q * COLR_ONE32 + r * COLR_ONE32 / b;
+  }
+
+
+  /* Integer square root of `x', using Newton's method with the start */
+  /* value `r' (usually the previous result along a span).            */
+  static FT_TS_UInt64
+  ft_colr_sqrt( FT_TS_UInt64  x,
+                FT_TS_UInt64  r )
+  {
+    FT_TS_UInt64  s;
+
+
+    if ( !x )
+      return 0;
+
+    if ( !r )
+    {
+      for ( r = 1, s = x; s; s >>= 2 )
+        r <<= 1;
+    }
+
+    /* after one step we are never below the root */
+    r = ( r + x / r ) >> 1;
+    for (;;)
+    {
+      s = ( r + x / r ) >> 1;
+      if ( s >= r )
+        break;
+
+      r = s;
+    }
+
+    return r;
+  }
+
+
+  /* Map gradient parameter `t' (16.16) to a color of the ramp. */
+  static FT_TS_UInt32
+  ft_colr_lookup( const ColrShader*  sh,
+                  FT_TS_Int64        t )
+  {
+    FT_TS_Int64  u;
+
+
+    if ( t > 0x7FFFFFFFL )
+      t = 0x7FFFFFFFL;
+    else if ( t < -0x7FFFFFFFL )
+      t = -0x7FFFFFFFL;
+
+    u = ( ( t - sh->stop_min ) * sh->stop_scale ) >> 16;
+
+    switch ( sh->extend )
+    {
+    case FT_TS_COLR_PAINT_EXTEND_REPEAT:
+      u = (FT_TS_Int64)( (FT_TS_UInt64)u & 0xFFFFU );
+      break;
+
+    case FT_TS_COLR_PAINT_EXTEND_REFLECT:
+      u = (FT_TS_Int64)( (FT_TS_UInt64)u & 0x1FFFFU );
+      if ( u > 0x10000L )
+        u = 0x20000L - u;
+      break;
+
+    default:
+      if ( u < 0 )
+        u = 0;
+      else if ( u > 0x10000L )
+        u = 0x10000L;
+    }
+
+    return sh->ramp[( u * 255 + 0x8000 ) >> 16];
+  }
+
+
+  /* Sample a color line into the 256 entries of the shader's ramp. */
+  static FT_TS_Error
+  ft_colr_setup_ramp( ColrContext*      ctx,
+                      FT_TS_ColorLine*  line,
+                      ColrShader*       sh,
+                      FT_TS_Bool*       avisible )
+  {
+    FT_TS_Memory  memory = ctx->memory;
+    FT_TS_Error   error;
+
+    typedef struct  ColrStop_
+    {
+      FT_TS_Fixed   offset;
+      FT_TS_UInt32  color;
+
+    } ColrStop;
+
+    ColrStop*        stops = NULL;
+    FT_TS_ColorStop  stop;
+    FT_TS_UInt       num   = line->color_stop_iterator.num_color_stops;
+    FT_TS_UInt       n     = 0;
+    FT_TS_UInt       i, k;
+    FT_TS_Fixed      range;
+
+
+    *avisible = 0;
+
+    if ( !num )
+      return FT_TS_Err_Ok;
+
+    if ( FT_TS_QNEW_ARRAY( stops, num ) )
+      return error;
+
+    while ( n < num                                           &&
+            FT_TS_Get_Colorline_Stops( ctx->face,
+                                       &stop,
+                                       &line->color_stop_iterator ) )
+    {
+      ColrStop  s;
+
+
+      s.offset = (FT_TS_Fixed)stop.stop_offset * 4;
+      s.color  = ft_colr_get_color( ctx->face,
+                                    stop.color.palette_index,
+                                    stop.color.alpha );
+
+      /* insertion sort that keeps stops of equal offset in order */
+      for ( i = n; i > 0 && stops[i - 1].offset > s.offset; i-- )
+        stops[i] = stops[i - 1];
+
+      stops[i] = s;
+      n++;
+    }
+
+    if ( !n )
+      goto Exit;
+
+    range = stops[n - 1].offset - stops[0].offset;
+
+    sh->extend     = line->extend;
+    sh->stop_min   = stops[0].offset;
+    sh->stop_scale = range > 0 ? COLR_ONE32 / range : 0;
+
+    for ( k = 0, i = 0; k < 256; k++ )
+    {
+      FT_TS_Fixed   t = stops[0].offset +
+                          (FT_TS_Fixed)( ( (FT_TS_Int64)range * k + 127 ) /
+                                         255 );
+      FT_TS_UInt32  c;
+
+
+      while ( i + 1 < n && stops[i + 1].offset < t )
+        i++;
+
+      if ( i + 1 == n || t <= stops[i].offset )
+        c = stops[i].color;
+      else
+      {
+        FT_TS_Fixed  d = stops[i + 1].offset - stops[i].offset;
+        FT_TS_Int64  u = (FT_TS_Int64)( t - stops[i].offset ) * 255;
+        FT_TS_UInt   w = (FT_TS_UInt)( ( u + d / 2 ) / d );
+
+
+        c = ft_colr_mul( stops[i].color, 255 - w ) +
+            ft_colr_mul( stops[i + 1].color, w );
+      }
+
+      sh->ramp[k] = c;
+    }
+
+    *avisible = 1;
+
+  Exit:
+    FT_TS_FREE( stops );
+
+    return error;
+  }
+
+
+  /* Set up the mapping from canvas pixel centers to paint space, */
+  /* relative to point (`ox',`oy') (16.16 font units).            */
+  static FT_TS_Bool
+  ft_colr_setup_inverse( ColrContext*          ctx,
+                         const ColrTransform*  tr,
+                         FT_TS_Fixed           ox,
+                         FT_TS_Fixed           oy,
+                         ColrShader*           sh )
+  {
+    FT_TS_Int64  xx = tr->matrix.xx;
+    FT_TS_Int64  xy = tr->matrix.xy;
+    FT_TS_Int64  yx = tr->matrix.yx;
+    FT_TS_Int64  yy = tr->matrix.yy;
+    FT_TS_Int64  det, dx, dy;
+
+
+    det = xx * yy - xy * yx;
+    if ( det < 0 )
+    {
+      det = -det;
+      xx  = -xx;
+      xy  = -xy;
+      yx  = -yx;
+      yy  = -yy;
+    }
+    if ( !det )
+      return 0;
+
+    /* the center of pixel (0,0) relative to the paint space origin */
+    dx = 32 - (FT_TS_Int64)tr->delta.x;
+    dy = 64 * (FT_TS_Int64)ctx->rows - 32 - (FT_TS_Int64)tr->delta.y;
+
+    sh->u0  = ft_colr_div( yy * dx - xy * dy, det ) - ox;
+    sh->u_x = ft_colr_div( yy * 64, det );
+    sh->u_y = ft_colr_div( xy * 64, det );
+
+    sh->v0  = ft_colr_div( xx * dy - yx * dx, det ) - oy;
+    sh->v_x = ft_colr_div( -yx * 64, det );
+    sh->v_y = ft_colr_div( -xx * 64, det );
+
+    /* reject transformations that are (almost) singular */
+    if ( COLR_OUT_OF_RANGE( sh->u_x, COLR_ONE32 * 256 ) ||
+         COLR_OUT_OF_RANGE( sh->u_y, COLR_ONE32 * 256 ) ||
+         COLR_OUT_OF_RANGE( sh->v_x, COLR_ONE32 * 256 ) ||
+         COLR_OUT_OF_RANGE( sh->v_y, COLR_ONE32 * 256 ) )
+      return 0;
+
+    return 1;
+  }
+
+
+  /* Transform point `p' (16.16 font units) to device space (26.6). */
+  static void
+  ft_colr_transform_point( const ColrTransform*  tr,
+                           const FT_TS_Vector*   p,
+                           FT_TS_Int64*          ax,
+                           FT_TS_Int64*          ay )
+  {
+    const FT_TS_Matrix*  m = &tr->matrix;
+
+
+    *ax = tr->delta.x + ( ( (FT_TS_Int64)m->xx * p->x +
+                            (FT_TS_Int64)m->xy * p->y +
+                            COLR_ONE32 / 2            ) >> 32 );
+    *ay = tr->delta.y + ( ( (FT_TS_Int64)m->yx * p->x +
+                            (FT_TS_Int64)m->yy * p->y +
+                            COLR_ONE32 / 2            ) >> 32 );
+  }
+
+
+  /* Set up a shader for a fill paint; `*avisible' is set to 0 if the */
+  /* paint draws nothing.                                             */
+  static FT_TS_Error
+  ft_colr_setup_shader( ColrContext*          ctx,
+                        FT_TS_COLR_Paint*     paint,
+                        const ColrTransform*  tr,
+                        ColrShader*           sh,
+                        FT_TS_Bool*           avisible )
+  {
+    FT_TS_Error  error = FT_TS_Err_Ok;
+
+
+    *avisible  = 0;
+    sh->format = paint->format;
+
+    switch ( paint->format )
+    {
+    case FT_TS_COLR_PAINTFORMAT_SOLID:
+      sh->color = ft_colr_get_color( ctx->face,
+                                     paint->u.solid.color.palette_index,
+                                     paint->u.solid.color.alpha );
+      *avisible = sh->color != 0;
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_LINEAR_GRADIENT:
+      {
+        FT_TS_PaintLinearGradient*  g = &paint->u.linear_gradient;
+
+        FT_TS_Int64  x0, y0, x1, y1, x2, y2;
+        FT_TS_Int64  ex, ey, c, d;
+
+
+        /* The gradient parameter is the distance from line p0p2 in */
+        /* units of the distance of p1, which is invariant under    */
+        /* affine transformations; we thus work in device space.    */
+        ft_colr_transform_point( tr, &g->p0, &x0, &y0 );
+        ft_colr_transform_point( tr, &g->p1, &x1, &y1 );
+        ft_colr_transform_point( tr, &g->p2, &x2, &y2 );
+
+        ex = x2 - x0;
+        ey = y2 - y0;
+        c  = ex * ( y1 - y0 ) - ey * ( x1 - x0 );
+        if ( c < 0 )
+        {
+          c  = -c;
+          ex = -ex;
+          ey = -ey;
+        }
+        if ( !c )
+          break;
+
+        d = ex * ( 64 * (FT_TS_Int64)ctx->rows - 32 - y0 ) - ey * ( 32 - x0 );
+
+        sh->u0  = ft_colr_div( d, c );
+        sh->u_x = ft_colr_div( -ey * 64, c );
+        sh->u_y = ft_colr_div( -ex * 64, c );
+
+        if ( COLR_OUT_OF_RANGE( sh->u_x, COLR_ONE32 * 256 ) ||
+             COLR_OUT_OF_RANGE( sh->u_y, COLR_ONE32 * 256 ) )
+          break;
+
+        error = ft_colr_setup_ramp( ctx, &g->colorline, sh, avisible );
+      }
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_RADIAL_GRADIENT:
+      {
+        FT_TS_PaintRadialGradient*  g = &paint->u.radial_gradient;
+
+        FT_TS_Pos  cx = ( g->c1.x - g->c0.x ) >> 16;
+        FT_TS_Pos  cy = ( g->c1.y - g->c0.y ) >> 16;
+        FT_TS_Pos  r0 = g->r0 >> 16;
+        FT_TS_Pos  r1 = g->r1 >> 16;
+        FT_TS_Pos  l;
+
+
+        if ( !ft_colr_setup_inverse( ctx, tr, g->c0.x, g->c0.y, sh ) )
+          break;
+
+        /* normalize the geometry by a power of two not smaller than */
+        /* any of its dimensions                                     */
+        l = FT_TS_MAX( FT_TS_ABS( cx ), FT_TS_ABS( cy ) );
+        l = FT_TS_MAX( l, FT_TS_MAX( r0, r1 ) );
+
+        for ( sh->shift = 0; ( 1L << sh->shift ) < l; sh->shift++ )
+          ;
+
+        sh->cx   = ( (FT_TS_Int64)cx * 0x10000L ) >> sh->shift;
+        sh->cy   = ( (FT_TS_Int64)cy * 0x10000L ) >> sh->shift;
+        sh->r0   = ( (FT_TS_Int64)r0 * 0x10000L ) >> sh->shift;
+        sh->dr   = ( (FT_TS_Int64)( r1 - r0 ) * 0x10000L ) >> sh->shift;
+        sh->a    = ( sh->cx * sh->cx + sh->cy * sh->cy - sh->dr * sh->dr ) >>
+                     16;
+        sh->r0dr = sh->r0 * sh->dr;
+        sh->r0r0 = sh->r0 * sh->r0;
+
+        error = ft_colr_setup_ramp( ctx, &g->colorline, sh, avisible );
+      }
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_SWEEP_GRADIENT:
+      {
+        FT_TS_PaintSweepGradient*  g = &paint->u.sweep_gradient;
+
+        /* `FT_TS_Get_Paint' returns the angles as stored, with a bias */
+        /* of 1.0 (i.e., 180 degrees) to be able to express a full    */
+        /* circle; we need them relative to the positive x axis       */
+        FT_TS_Angle  start = ( g->start_angle + 0x10000L ) * 180;
+        FT_TS_Angle  end   = ( g->end_angle + 0x10000L ) * 180;
+
+
+        if ( start == end                                            ||
+             !ft_colr_setup_inverse( ctx,
+                                     tr,
+                                     g->center.x,
+                                     g->center.y,
+                                     sh )                            )
+          break;
+
+        sh->start = start;
+        sh->scale = COLR_ONE32 / ( end - start );
+
+        error = ft_colr_setup_ramp( ctx, &g->colorline, sh, avisible );
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    return error;
+  }
+
+
+  /* Return the color of a radial gradient at paint space position */
+  /* (`x',`y'); `root' keeps the last square root.                 */
+  static FT_TS_UInt32
+  ft_colr_radial( const ColrShader*  sh,
+                  FT_TS_Int64        x,
+                  FT_TS_Int64        y,
+                  FT_TS_UInt64*      root )
+  {
+    FT_TS_Int64  b, c, t;
+
+
+    x >>= sh->shift;
+    y >>= sh->shift;
+
+    if ( x > 0x10000000L )
+      x = 0x10000000L;
+    else if ( x < -0x10000000L )
+      x = -0x10000000L;
+
+    if ( y > 0x10000000L )
+      y = 0x10000000L;
+    else if ( y < -0x10000000L )
+      y = -0x10000000L;
+
+    /* find the largest `t' with `|p - c(t)| = r(t)' and `r(t) >= 0', */
+    /* that is, solve `a t^2 - 2 b t + c = 0'                        */
+    b = ( x * sh->cx + y * sh->cy + sh->r0dr ) >> 16;
+    c = ( x * x + y * y - sh->r0r0 ) >> 16;
+
+    if ( !sh->a )
+    {
+      if ( !b )
+        return 0;
+
+      t = c * 0x10000L / ( 2 * b );
+    }
+    else
+    {
+      FT_TS_Int64  d = b * b - sh->a * c;
+      FT_TS_Int64  s, t2;
+
+
+      if ( d < 0 )
+        return 0;
+
+      s     = (FT_TS_Int64)ft_colr_sqrt( (FT_TS_UInt64)d, *root + 1 );
+      *root = (FT_TS_UInt64)s;
+
+      t  = ( b + s ) * 0x10000L / sh->a;
+      t2 = ( b - s ) * 0x10000L / sh->a;
+
+      if ( t2 > t )
+      {
+        FT_TS_Int64  tmp = t;
+
+
+        t  = t2;
+        t2 = tmp;
+      }
+
+      if ( t > 0x7FFFFFFFL )
+        t = 0x7FFFFFFFL;
+
+      if ( sh->r0 + ( ( t * sh->dr ) >> 16 ) < 0 )
+        t = t2;
+    }
+
+    if ( t > 0x7FFFFFFFL )
+      t = 0x7FFFFFFFL;
+    else if ( t < -0x7FFFFFFFL )
+      t = -0x7FFFFFFFL;
+
+    if ( sh->r0 + ( ( t * sh->dr ) >> 16 ) < 0 )
+      return 0;
+
+    return ft_colr_lookup( sh, t );
+  }
+
+
+  /* atan(i/64) in 16.16 degrees */
+  static const FT_TS_Angle  ft_colr_atan_table[65] =
+  {
+            0,   58666,  117304,  175884,  234379,
+       292760,  350999,  409070,  466945,  524598,
+       582003,  639135,  695970,  752484,  808654,
+       864460,  919879,  974893, 1029481, 1083627,
+      1137313, 1190524, 1243245, 1295461, 1347161,
+      1398332, 1448965, 1499049, 1548575, 1597536,
+      1645926, 1693738, 1740967, 1787610, 1833663,
+      1879123, 1923990, 1968261, 2011937, 2055018,
+      2097505, 2139399, 2180703, 2221419, 2261551,
+      2301101, 2340074, 2378474, 2416306, 2453574,
+      2490285, 2526443, 2562055, 2597126, 2631664,
+      2665673, 2699161, 2732134, 2764600, 2796564,
+      2828035, 2859019, 2889523, 2919554, 2949120
+  };
+
+
+  /* Return the angle of vector (`x',`y') in the range [0,360) degrees. */
+  /* We interpolate a table for the first octant, which is accurate to  */
+  /* about 0.001 degrees and much faster than `FT_TS_Atan2'.             */
+  static FT_TS_Angle
+  ft_colr_atan2( FT_TS_Int64  x,
+                 FT_TS_Int64  y )
+  {
+    FT_TS_Int64  ax = x < 0 ? -x : x;
+    FT_TS_Int64  ay = y < 0 ? -y : y;
+    FT_TS_Int64  r;
+    FT_TS_Angle  angle;
+    FT_TS_Int    i;
+
+
+    if ( !ax && !ay )
+      return 0;
+
+    /* keep the ratio computation within 64 bits */
+    while ( ax > 0x3FFFFFFFL || ay > 0x3FFFFFFFL )
+    {
+      ax >>= 1;
+      ay >>= 1;
+    }
+
+    /* the tangent in the first octant, in units of 2^-22 */
+    if ( ay <= ax )
+      r = ( ay << 22 ) / ax;
+    else
+      r = ( ax << 22 ) / ay;
+
+    i     = (FT_TS_Int)( r >> 16 );
+    angle = ft_colr_atan_table[i];
+    if ( i < 64 )
+      angle += (FT_TS_Angle)( ( ( ft_colr_atan_table[i + 1] - angle ) *
+                                ( r & 0xFFFF ) ) >> 16 );
+
+    if ( ay > ax )
+      angle = FT_TS_ANGLE_PI2 - angle;
+    if ( x < 0 )
+      angle = FT_TS_ANGLE_PI - angle;
+    if ( y < 0 && angle )
+      angle = FT_TS_ANGLE_2PI - angle;
+
+    return angle;
+  }
+
+
+  /* Return the color of a sweep gradient at paint space position */
+  /* (`x',`y').                                                   */
+  static FT_TS_UInt32
+  ft_colr_sweep( const ColrShader*  sh,
+                 FT_TS_Int64        x,
+                 FT_TS_Int64        y )
+  {
+    FT_TS_Angle  angle = ft_colr_atan2( x, y );
+
+
+    return ft_colr_lookup( sh,
+                           ( ( angle - sh->start ) * sh->scale ) >> 16 );
+  }
+
+
+  /* Shade `count' pixels of canvas row `y', starting at column `x'. */
+  static void
+  ft_colr_shade( const ColrShader*  sh,
+                 FT_TS_Int          x,
+                 FT_TS_Int          y,
+                 FT_TS_UInt         count,
+                 FT_TS_UInt32*      out )
+  {
+    FT_TS_Int64   u, v;
+    FT_TS_UInt64  root = 0;
+    FT_TS_UInt    i;
+
+
+    /* linear gradients only set up `u' */
+    switch ( sh->format )
+    {
+    case FT_TS_COLR_PAINTFORMAT_LINEAR_GRADIENT:
+      u = sh->u0 + x * sh->u_x + y * sh->u_y;
+
+      for ( i = 0; i < count; i++, u += sh->u_x )
+        out[i] = ft_colr_lookup( sh, u >> 16 );
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_RADIAL_GRADIENT:
+      u = sh->u0 + x * sh->u_x + y * sh->u_y;
+      v = sh->v0 + x * sh->v_x + y * sh->v_y;
+
+      for ( i = 0; i < count; i++, u += sh->u_x, v += sh->v_x )
+        out[i] = ft_colr_radial( sh, u, v, &root );
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_SWEEP_GRADIENT:
+      u = sh->u0 + x * sh->u_x + y * sh->u_y;
+      v = sh->v0 + x * sh->v_x + y * sh->v_y;
+
+      for ( i = 0; i < count; i++, u += sh->u_x, v += sh->v_x )
+        out[i] = ft_colr_sweep( sh, u, v );
+      break;
+
+    default:
+      for ( i = 0; i < count; i++ )
+        out[i] = sh->color;
+    }
+  }
+
+
+  /* Set `child' to `tr' applied after the affine transformation `a' */
+  /* of paint space.  Return 0 if the result exceeds our limits.     */
+  static FT_TS_Bool
+  ft_colr_transform( const ColrTransform*   tr,
+                     const FT_TS_Affine23*  a,
+                     ColrTransform*         child )
+  {
+    const FT_TS_Matrix*  m = &tr->matrix;
+
+    FT_TS_Int64  xx, xy, yx, yy, dx, dy;
+
+
+    xx = ( (FT_TS_Int64)m->xx * a->xx + (FT_TS_Int64)m->xy * a->yx +
+           0x8000 ) >> 16;
+    xy = ( (FT_TS_Int64)m->xx * a->xy + (FT_TS_Int64)m->xy * a->yy +
+           0x8000 ) >> 16;
+    yx = ( (FT_TS_Int64)m->yx * a->xx + (FT_TS_Int64)m->yy * a->yx +
+           0x8000 ) >> 16;
+    yy = ( (FT_TS_Int64)m->yx * a->xy + (FT_TS_Int64)m->yy * a->yy +
+           0x8000 ) >> 16;
+
+    dx = tr->delta.x + ( ( (FT_TS_Int64)m->xx * a->dx +
+                           (FT_TS_Int64)m->xy * a->dy +
+                           COLR_ONE32 / 2             ) >> 32 );
+    dy = tr->delta.y + ( ( (FT_TS_Int64)m->yx * a->dx +
+                           (FT_TS_Int64)m->yy * a->dy +
+                           COLR_ONE32 / 2             ) >> 32 );
+
+    if ( COLR_OUT_OF_RANGE( xx, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( xy, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( yx, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( yy, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( dx, COLR_MAX_DELTA ) ||
+         COLR_OUT_OF_RANGE( dy, COLR_MAX_DELTA ) )
+      return 0;
+
+    child->matrix.xx = (FT_TS_Fixed)xx;
+    child->matrix.xy = (FT_TS_Fixed)xy;
+    child->matrix.yx = (FT_TS_Fixed)yx;
+    child->matrix.yy = (FT_TS_Fixed)yy;
+    child->delta.x   = (FT_TS_Pos)dx;
+    child->delta.y   = (FT_TS_Pos)dy;
+
+    return 1;
+  }
+
+
+  /* For a transformation paint, compute the transformation of its */
+  /* child paint `next'.  Return 0 for other paints or if nothing  */
+  /* can be drawn.                                                 */
+  static FT_TS_Bool
+  ft_colr_child_transform( const FT_TS_COLR_Paint*  paint,
+                           const ColrTransform*     tr,
+                           ColrTransform*           child,
+                           FT_TS_OpaquePaint*       next )
+  {
+    FT_TS_Affine23  a;
+    FT_TS_Fixed     cx, cy;
+    FT_TS_Angle     angle;
+
+
+    switch ( paint->format )
+    {
+    case FT_TS_COLR_PAINTFORMAT_TRANSFORM:
+      *next = paint->u.transform.paint;
+
+      return ft_colr_transform( tr, &paint->u.transform.affine, child );
+
+    case FT_TS_COLR_PAINTFORMAT_TRANSLATE:
+      *next = paint->u.translate.paint;
+
+      a.xx = 0x10000L;
+      a.xy = 0;
+      a.yx = 0;
+      a.yy = 0x10000L;
+      a.dx = paint->u.translate.dx;
+      a.dy = paint->u.translate.dy;
+
+      return ft_colr_transform( tr, &a, child );
+
+    case FT_TS_COLR_PAINTFORMAT_SCALE:
+      *next = paint->u.scale.paint;
+
+      a.xx = paint->u.scale.scale_x;
+      a.xy = 0;
+      a.yx = 0;
+      a.yy = paint->u.scale.scale_y;
+      cx   = paint->u.scale.center_x;
+      cy   = paint->u.scale.center_y;
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_ROTATE:
+      *next = paint->u.rotate.paint;
+
+      /* angles are given in multiples of 180 degrees; */
+      /* rotation is counter-clockwise                 */
+      angle = paint->u.rotate.angle * 180;
+      a.xx  = FT_TS_Cos( angle );
+      a.xy  = -FT_TS_Sin( angle );
+      a.yx  = FT_TS_Sin( angle );
+      a.yy  = a.xx;
+      cx    = paint->u.rotate.center_x;
+      cy    = paint->u.rotate.center_y;
+      break;
+
+    case FT_TS_COLR_PAINTFORMAT_SKEW:
+      *next = paint->u.skew.paint;
+
+      /* a positive x skew angle turns the y axis counter-clockwise, */
+      /* a positive y skew angle turns the x axis counter-clockwise  */
+      a.xx = 0x10000L;
+      a.xy = -FT_TS_Tan( paint->u.skew.x_skew_angle * 180 );
+      a.yx = FT_TS_Tan( paint->u.skew.y_skew_angle * 180 );
+      a.yy = 0x10000L;
+      cx   = paint->u.skew.center_x;
+      cy   = paint->u.skew.center_y;
+      break;
+
+    default:
+      return 0;
+    }
+
+    /* keep the center fixed */
+    a.dx = cx - FT_TS_MulFix( a.xx, cx ) - FT_TS_MulFix( a.xy, cy );
+    a.dy = cy - FT_TS_MulFix( a.yx, cx ) - FT_TS_MulFix( a.yy, cy );
+
+    return ft_colr_transform( tr, &a, child );
+  }
+
+
+  static void
+  ft_colr_box_intersect( ColrBox*        box,
+                         const ColrBox*  other )
+  {
+    box->x_min = FT_TS_MAX( box->x_min, other->x_min );
+    box->y_min = FT_TS_MAX( box->y_min, other->y_min );
+    box->x_max = FT_TS_MIN( box->x_max, other->x_max );
+    box->y_max = FT_TS_MIN( box->y_max, other->y_max );
+  }
+
+
+#define COLR_BOX_EMPTY( b )  ( (b)->x_min >= (b)->x_max || \
+                               (b)->y_min >= (b)->y_max )
+
+
+  static void
+  ft_colr_box_add( ColrBox*   box,
+                   FT_TS_Int  x_min,
+                   FT_TS_Int  y_min,
+                   FT_TS_Int  x_max,
+                   FT_TS_Int  y_max )
+  {
+    if ( COLR_BOX_EMPTY( box ) )
+    {
+      box->x_min = x_min;
+      box->y_min = y_min;
+      box->x_max = x_max;
+      box->y_max = y_max;
+    }
+    else
+    {
+      box->x_min = FT_TS_MIN( box->x_min, x_min );
+      box->y_min = FT_TS_MIN( box->y_min, y_min );
+      box->x_max = FT_TS_MAX( box->x_max, x_max );
+      box->y_max = FT_TS_MAX( box->y_max, y_max );
+    }
+  }
+
+
+  /* Convert a bounding box in 26.6 device coordinates to canvas */
+  /* pixels, clipped to the canvas.                               */
+  static void
+  ft_colr_pixel_box( ColrContext*       ctx,
+                     const FT_TS_BBox*  bbox,
+                     ColrBox*           box )
+  {
+    FT_TS_Pos  x_min = FT_TS_MAX( bbox->xMin, 0 ) >> 6;
+    FT_TS_Pos  y_min = FT_TS_MAX( bbox->yMin, 0 ) >> 6;
+    FT_TS_Pos  x_max = FT_TS_MAX( bbox->xMax + 63, 0 ) >> 6;
+    FT_TS_Pos  y_max = FT_TS_MAX( bbox->yMax + 63, 0 ) >> 6;
+
+
+    box->x_min = (FT_TS_Int)FT_TS_MIN( x_min, ctx->width );
+    box->x_max = (FT_TS_Int)FT_TS_MIN( x_max, ctx->width );
+    box->y_min = ctx->rows - (FT_TS_Int)FT_TS_MIN( y_max, ctx->rows );
+    box->y_max = ctx->rows - (FT_TS_Int)FT_TS_MIN( y_min, ctx->rows );
+  }
+
+
+  /* Take `size' bytes from the memory budget of the glyph. */
+  static FT_TS_Error
+  ft_colr_reserve( ColrContext*  ctx,
+                   FT_TS_ULong   size )
+  {
+    if ( size > ctx->memory_left )
+      return FT_TS_THROW( Raster_Overflow );
+
+    ctx->memory_left -= size;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+#define COLR_LAYER_SIZE( layer )                                   \
+          ( 4 * (FT_TS_ULong)( (layer)->area.x_max -               \
+                               (layer)->area.x_min ) *             \
+                (FT_TS_ULong)( (layer)->area.y_max -               \
+                               (layer)->area.y_min ) )
+
+
+  /* Allocate a transparent layer covering `area'. */
+  static FT_TS_Error
+  ft_colr_new_layer( ColrContext*    ctx,
+                     ColrLayer*      layer,
+                     const ColrBox*  area )
+  {
+    FT_TS_Memory  memory = ctx->memory;
+    FT_TS_Error   error;
+
+
+    layer->pixels    = NULL;
+    layer->box.x_min = 0;
+    layer->box.y_min = 0;
+    layer->box.x_max = 0;
+    layer->box.y_max = 0;
+
+    if ( COLR_BOX_EMPTY( area ) )
+    {
+      layer->area = layer->box;
+      return FT_TS_Err_Ok;
+    }
+
+    layer->area = *area;
+
+    error = ft_colr_reserve( ctx, COLR_LAYER_SIZE( layer ) );
+    if ( error )
+      return error;
+
+    if ( FT_TS_NEW_ARRAY( layer->pixels, COLR_LAYER_SIZE( layer ) / 4 ) )
+      ctx->memory_left += COLR_LAYER_SIZE( layer );
+
+    return error;
+  }
+
+
+  static void
+  ft_colr_done_layer( ColrContext*  ctx,
+                      ColrLayer*    layer )
+  {
+    FT_TS_Memory  memory = ctx->memory;
+
+
+    if ( layer->pixels )
+    {
+      FT_TS_FREE( layer->pixels );
+      ctx->memory_left += COLR_LAYER_SIZE( layer );
+    }
+  }
+
+
+  /* Compute the area of an intermediate layer for `opaque', i.e., the */
+  /* part of `area' that its contents can cover.                        */
+  static FT_TS_Error
+  ft_colr_content_area( ColrContext*          ctx,
+                        FT_TS_OpaquePaint     opaque,
+                        const ColrTransform*  tr,
+                        ColrBox*              area,
+                        FT_TS_UInt            depth )
+  {
+    FT_TS_BBox   bbox;
+    ColrBox      box;
+    FT_TS_Error  error;
+
+
+    if ( COLR_BOX_EMPTY( area ) )
+      return FT_TS_Err_Ok;
+
+    bbox.xMin = 0;
+    bbox.yMin = 0;
+    bbox.xMax = -1;
+    bbox.yMax = -1;
+
+    ctx->unbounded = 0;
+
+    error = ft_colr_bounds( ctx, opaque, tr, &bbox, depth );
+    if ( error || ctx->unbounded )
+      return error;
+
+    if ( bbox.xMin > bbox.xMax )
+    {
+      area->x_max = area->x_min;
+      return FT_TS_Err_Ok;
+    }
+
+    ft_colr_pixel_box( ctx, &bbox, &box );
+    ft_colr_box_intersect( area, &box );
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* Fill a run of pixels in canvas row `y' with the current shader. */
+  static void
+  ft_colr_fill_run( ColrContext*       ctx,
+                    ColrLayer*         layer,
+                    FT_TS_Int          x,
+                    FT_TS_Int          y,
+                    FT_TS_UInt         count,
+                    FT_TS_UInt         coverage,
+                    const FT_TS_Byte*  mask )
+  {
+    const ColrShader*  sh  = ctx->shader;
+    FT_TS_UInt32*      dst = COLR_PIXEL( layer, x, y );
+
+
+    if ( sh->format == FT_TS_COLR_PAINTFORMAT_SOLID )
+      ft_colr_blend_span( dst, NULL, sh->color, mask, coverage, count );
+    else
+    {
+      ft_colr_shade( sh, x, y, count, ctx->scratch );
+      ft_colr_blend_span( dst, ctx->scratch, 0, mask, coverage, count );
+    }
+
+    ft_colr_box_add( &layer->box, x, y, x + (FT_TS_Int)count, y + 1 );
+  }
+
+
+  /* span callback: shade and blend into `ctx->layer' */
+  static void
+  ft_colr_fill_spans( int                y,
+                      int                count,
+                      const FT_TS_Span*  spans,
+                      void*              user )
+  {
+    ColrContext*  ctx  = (ColrContext*)user;
+    ColrMask*     clip = ctx->clip;
+    FT_TS_Int     row  = ctx->rows - 1 - y;
+
+
+    for ( ; count > 0; count--, spans++ )
+    {
+      const FT_TS_Byte*  mask = NULL;
+
+
+      if ( clip )
+        mask = clip->coverage +
+               ( row - clip->box.y_min ) *
+                 ( clip->box.x_max - clip->box.x_min ) +
+               ( spans->x - clip->box.x_min );
+
+      ft_colr_fill_run( ctx,
+                        ctx->layer,
+                        spans->x,
+                        row,
+                        spans->len,
+                        spans->coverage,
+                        mask );
+    }
+  }
+
+
+  /* span callback: store coverage in `ctx->mask' */
+  static void
+  ft_colr_mask_spans( int                y,
+                      int                count,
+                      const FT_TS_Span*  spans,
+                      void*              user )
+  {
+    ColrContext*  ctx  = (ColrContext*)user;
+    ColrMask*     mask = ctx->mask;
+    ColrMask*     clip = ctx->clip;
+    FT_TS_Int     row  = ctx->rows - 1 - y;
+
+    FT_TS_Byte*  line = mask->coverage +
+                          ( row - mask->box.y_min ) *
+                            ( mask->box.x_max - mask->box.x_min );
+
+
+    for ( ; count > 0; count--, spans++ )
+    {
+      FT_TS_Byte*  dst = line + spans->x - mask->box.x_min;
+      FT_TS_UInt   i;
+
+
+      if ( clip )
+      {
+        const FT_TS_Byte*  src = clip->coverage +
+                                   ( row - clip->box.y_min ) *
+                                     ( clip->box.x_max - clip->box.x_min ) +
+                                   ( spans->x - clip->box.x_min );
+
+
+        for ( i = 0; i < spans->len; i++ )
+          dst[i] = (FT_TS_Byte)ft_colr_mul8( spans->coverage, src[i] );
+      }
+      else
+        FT_TS_MEM_SET( dst, spans->coverage, spans->len );
+    }
+  }
+
+
+  /* Rasterize an outline within `box'. */
+  static FT_TS_Error
+  ft_colr_raster( ColrContext*    ctx,
+                  FT_TS_Outline*  outline,
+                  FT_TS_SpanFunc  spans,
+                  const ColrBox*  box )
+  {
+    FT_TS_Raster_Params  params;
+
+
+    FT_TS_ZERO( &params );
+
+    params.source     = outline;
+    params.flags      = FT_TS_RASTER_FLAG_AA     |
+                        FT_TS_RASTER_FLAG_DIRECT |
+                        FT_TS_RASTER_FLAG_CLIP;
+    params.gray_spans = spans;
+    params.user       = ctx;
+
+    params.clip_box.xMin = box->x_min;
+    params.clip_box.yMin = ctx->rows - box->y_max;
+    params.clip_box.xMax = box->x_max;
+    params.clip_box.yMax = ctx->rows - box->y_min;
+
+    return FT_TS_Outline_Render( FT_TS_FACE_LIBRARY( ctx->face ),
+                                 outline,
+                                 &params );
+  }
+
+
+  /* Load the outline of a glyph in device coordinates and compute its */
+  /* box, clipped to the canvas and the current clip mask.             */
+  static FT_TS_Error
+  ft_colr_load_outline( ColrContext*          ctx,
+                        FT_TS_UInt            glyph_index,
+                        const ColrTransform*  tr,
+                        ColrBox*              box )
+  {
+    FT_TS_Outline*  outline = &ctx->slot->outline;
+    FT_TS_BBox      cbox;
+    FT_TS_Error     error;
+
+
+    box->x_min = 0;
+    box->y_min = 0;
+    box->x_max = 0;
+    box->y_max = 0;
+
+    error = FT_TS_Load_Glyph( ctx->face, glyph_index, COLR_LOAD_FLAGS );
+    if ( error )
+      return error;
+
+    if ( ctx->slot->format != FT_TS_GLYPH_FORMAT_OUTLINE ||
+         !outline->n_points                              )
+      return FT_TS_Err_Ok;
+
+    FT_TS_Outline_Transform( outline, &tr->matrix );
+    FT_TS_Outline_Translate( outline, tr->delta.x, tr->delta.y );
+    FT_TS_Outline_Get_CBox( outline, &cbox );
+
+    ft_colr_pixel_box( ctx, &cbox, box );
+
+    if ( ctx->clip )
+      ft_colr_box_intersect( box, &ctx->clip->box );
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* Composite layer `src' over `dst', through the clip mask if any. */
+  static void
+  ft_colr_blend_layer( ColrLayer*        dst,
+                       const ColrLayer*  src,
+                       const ColrMask*   clip )
+  {
+    ColrBox    box = src->box;
+    FT_TS_Int  y;
+
+
+    if ( clip )
+      ft_colr_box_intersect( &box, &clip->box );
+
+    if ( COLR_BOX_EMPTY( &box ) )
+      return;
+
+    for ( y = box.y_min; y < box.y_max; y++ )
+    {
+      const FT_TS_Byte*  mask = NULL;
+
+
+      if ( clip )
+        mask = clip->coverage +
+               ( y - clip->box.y_min ) *
+                 ( clip->box.x_max - clip->box.x_min ) +
+               ( box.x_min - clip->box.x_min );
+
+      ft_colr_blend_span( COLR_PIXEL( dst, box.x_min, y ),
+                          COLR_PIXEL( src, box.x_min, y ),
+                          0,
+                          mask,
+                          255,
+                          (FT_TS_UInt)( box.x_max - box.x_min ) );
+    }
+
+    ft_colr_box_add( &dst->box, box.x_min, box.y_min, box.x_max, box.y_max );
+  }
+
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* Composition modes.  `S' and `B' are premultiplied channels of source  */
+  /* and backdrop, `Sa' and `Ba' their alpha values.  The separable blend  */
+  /* modes of the W3C `Compositing and Blending' specification give        */
+  /*                                                                       */
+  /*   result = S (1 - Ba) + B (1 - Sa) + X                                */
+  /*                                                                       */
+  /* with X computed by `ft_colr_blend_channel', scaled by 255^2.          */
+  /*                                                                       */
+  /*************************************************************************/
+
+  static FT_TS_Int
+  ft_colr_blend_channel( FT_TS_Composite_Mode  mode,
+                         FT_TS_Int             S,
+                         FT_TS_Int             Sa,
+                         FT_TS_Int             B,
+                         FT_TS_Int             Ba )
+  {
+    FT_TS_Int  x, y;
+
+
+    switch ( mode )
+    {
+    case FT_TS_COLR_COMPOSITE_MULTIPLY:
+      return S * B;
+
+    case FT_TS_COLR_COMPOSITE_SCREEN:
+      return S * Ba + B * Sa - S * B;
+
+    case FT_TS_COLR_COMPOSITE_OVERLAY:
+      if ( 2 * B <= Ba )
+        return 2 * S * B;
+      return Sa * Ba - 2 * ( Ba - B ) * ( Sa - S );
+
+    case FT_TS_COLR_COMPOSITE_DARKEN:
+      return FT_TS_MIN( S * Ba, B * Sa );
+
+    case FT_TS_COLR_COMPOSITE_LIGHTEN:
+      return FT_TS_MAX( S * Ba, B * Sa );
+
+    case FT_TS_COLR_COMPOSITE_COLOR_DODGE:
+      if ( !B )
+        return 0;
+      if ( S >= Sa )
+        return Sa * Ba;
+      return FT_TS_MIN( Sa * Ba, B * Sa * Sa / ( Sa - S ) );
+
+    case FT_TS_COLR_COMPOSITE_COLOR_BURN:
+      if ( B >= Ba )
+        return Sa * Ba;
+      if ( !S )
+        return 0;
+      return Sa * Ba - FT_TS_MIN( Sa * Ba, ( Ba - B ) * Sa * Sa / S );
+
+    case FT_TS_COLR_COMPOSITE_HARD_LIGHT:
+      if ( 2 * S <= Sa )
+        return 2 * S * B;
+      return Sa * Ba - 2 * ( Ba - B ) * ( Sa - S );
+
+    case FT_TS_COLR_COMPOSITE_SOFT_TS_LIGHT:
+      {
+        /* unpremultiplied values in 16.16 format */
+        FT_TS_Fixed  cs = Sa ? FT_TS_DivFix( S, Sa ) : 0;
+        FT_TS_Fixed  cb = Ba ? FT_TS_DivFix( B, Ba ) : 0;
+        FT_TS_Fixed  d, r;
+
+
+        if ( cs <= 0x8000L )
+          r = cb - FT_TS_MulFix( FT_TS_MulFix( 0x10000L - 2 * cs, cb ),
+                                 0x10000L - cb );
+        else
+        {
+          if ( cb <= 0x4000L )
+            d = FT_TS_MulFix( FT_TS_MulFix( 16 * cb - 0xC0000L, cb ) +
+                                0x40000L,
+                              cb );
+          else
+            d = (FT_TS_Fixed)ft_colr_sqrt( (FT_TS_UInt64)cb << 16, 0 );
+
+          r = cb + FT_TS_MulFix( 2 * cs - 0x10000L, d - cb );
+        }
+
+        return (FT_TS_Int)( ( (FT_TS_Long)Sa * Ba * r + 0x8000L ) >> 16 );
+      }
+
+    case FT_TS_COLR_COMPOSITE_DIFFERENCE:
+      x = S * Ba;
+      y = B * Sa;
+      return x + y - 2 * FT_TS_MIN( x, y );
+
+    case FT_TS_COLR_COMPOSITE_EXCLUSION:
+      return S * Ba + B * Sa - 2 * S * B;
+
+    default:
+      return 0;
+    }
+  }
+
+
+  /* luminosity of an unpremultiplied color */
+#define COLR_LUM( c )                                         \
+          ( ( 77 * (c)[0] + 151 * (c)[1] + 28 * (c)[2] + 128 ) >> 8 )
+
+
+  static void
+  ft_colr_set_lum( FT_TS_Int*  c,
+                   FT_TS_Int   lum )
+  {
+    FT_TS_Int  d = lum - COLR_LUM( c );
+    FT_TS_Int  i, n, x;
+
+
+    c[0] += d;
+    c[1] += d;
+    c[2] += d;
+
+    /* clip the color into range, keeping its luminosity */
+    lum = COLR_LUM( c );
+    n   = FT_TS_MIN( c[0], FT_TS_MIN( c[1], c[2] ) );
+    x   = FT_TS_MAX( c[0], FT_TS_MAX( c[1], c[2] ) );
+
+    for ( i = 0; i < 3; i++ )
+    {
+      if ( n < 0 )
+        c[i] = lum + ( c[i] - lum ) * lum / ( lum - n );
+      if ( x > 255 )
+        c[i] = lum + ( c[i] - lum ) * ( 255 - lum ) / ( x - lum );
+
+      c[i] = FT_TS_MIN( FT_TS_MAX( c[i], 0 ), 255 );
+    }
+  }
+
+
+  static void
+  ft_colr_set_sat( FT_TS_Int*  c,
+                   FT_TS_Int   sat )
+  {
+    FT_TS_Int  n = FT_TS_MIN( c[0], FT_TS_MIN( c[1], c[2] ) );
+    FT_TS_Int  x = FT_TS_MAX( c[0], FT_TS_MAX( c[1], c[2] ) );
+    FT_TS_Int  i;
+
+
+    for ( i = 0; i < 3; i++ )
+      c[i] = x > n ? ( c[i] - n ) * sat / ( x - n ) : 0;
+  }
+
+
+#define COLR_SAT( c )  ( FT_TS_MAX( (c)[0], FT_TS_MAX( (c)[1], (c)[2] ) ) - \
+                         FT_TS_MIN( (c)[0], FT_TS_MIN( (c)[1], (c)[2] ) ) )
+
+
+  static FT_TS_UInt32
+  ft_colr_composite_pixel( FT_TS_Composite_Mode  mode,
+                           FT_TS_UInt32          s,
+                           FT_TS_UInt32          b )
+  {
+    FT_TS_UInt  sa = s >> 24;
+    FT_TS_UInt  ba = b >> 24;
+    FT_TS_UInt  fa, fb;
+
+    FT_TS_Int  cs[3], cb[3], cr[3];
+    FT_TS_Int  i, ra;
+
+
+    /* Porter-Duff operators: `s Fa + b Fb' */
+    switch ( mode )
+    {
+    case FT_TS_COLR_COMPOSITE_CLEAR:
+      return 0;
+    case FT_TS_COLR_COMPOSITE_SRC:
+      return s;
+    case FT_TS_COLR_COMPOSITE_DEST:
+      return b;
+    case FT_TS_COLR_COMPOSITE_SRC_OVER:
+      return COLR_OVER( b, s );
+    case FT_TS_COLR_COMPOSITE_DEST_OVER:
+      return COLR_OVER( s, b );
+    case FT_TS_COLR_COMPOSITE_SRC_IN:
+      return ft_colr_mul( s, ba );
+    case FT_TS_COLR_COMPOSITE_DEST_IN:
+      return ft_colr_mul( b, sa );
+    case FT_TS_COLR_COMPOSITE_SRC_OUT:
+      return ft_colr_mul( s, 255 - ba );
+    case FT_TS_COLR_COMPOSITE_DEST_OUT:
+      return ft_colr_mul( b, 255 - sa );
+    case FT_TS_COLR_COMPOSITE_SRC_ATOP:
+      fa = ba;
+      fb = 255 - sa;
+      goto Porter_Duff;
+    case FT_TS_COLR_COMPOSITE_DEST_ATOP:
+      fa = 255 - ba;
+      fb = sa;
+      goto Porter_Duff;
+    case FT_TS_COLR_COMPOSITE_XOR:
+      fa = 255 - ba;
+      fb = 255 - sa;
+      goto Porter_Duff;
+    case FT_TS_COLR_COMPOSITE_PLUS:
+      return ft_colr_add( s, b );
+    default:
+      break;
+    }
+
+    if ( !sa )
+      return b;
+    if ( !ba )
+      return s;
+
+    for ( i = 0; i < 3; i++ )
+    {
+      cs[i] = ( s >> ( 16 - 8 * i ) ) & 0xFF;
+      cb[i] = ( b >> ( 16 - 8 * i ) ) & 0xFF;
+    }
+
+    ra = (FT_TS_Int)( sa + ba ) - (FT_TS_Int)ft_colr_mul8( sa, ba );
+
+    if ( mode < FT_TS_COLR_COMPOSITE_HSL_HUE )
+    {
+      for ( i = 0; i < 3; i++ )
+        cr[i] = ( cs[i] * (FT_TS_Int)( 255 - ba ) +
+                  cb[i] * (FT_TS_Int)( 255 - sa ) +
+                  ft_colr_blend_channel( mode,
+                                         cs[i], (FT_TS_Int)sa,
+                                         cb[i], (FT_TS_Int)ba ) +
+                  127 ) / 255;
+    }
+    else
+    {
+      /* non-separable modes work on unpremultiplied colors */
+      FT_TS_Int  u[3], v[3];
+
+
+      for ( i = 0; i < 3; i++ )
+      {
+        u[i] = cs[i] * 255 / (FT_TS_Int)sa;
+        v[i] = cb[i] * 255 / (FT_TS_Int)ba;
+      }
+
+      switch ( mode )
+      {
+      case FT_TS_COLR_COMPOSITE_HSL_HUE:
+        ft_colr_set_sat( u, COLR_SAT( v ) );
+        ft_colr_set_lum( u, COLR_LUM( v ) );
+        break;
+
+      case FT_TS_COLR_COMPOSITE_HSL_SATURATION:
+        {
+          FT_TS_Int  sat = COLR_SAT( u );
+
+
+          u[0] = v[0];
+          u[1] = v[1];
+          u[2] = v[2];
+          ft_colr_set_sat( u, sat );
+          ft_colr_set_lum( u, COLR_LUM( v ) );
+        }
+        break;
+
+      case FT_TS_COLR_COMPOSITE_HSL_COLOR:
+        ft_colr_set_lum( u, COLR_LUM( v ) );
+        break;
+
+      default: /* FT_TS_COLR_COMPOSITE_HSL_LUMINOSITY */
+        {
+          FT_TS_Int  lum = COLR_LUM( u );
+
+
+          u[0] = v[0];
+          u[1] = v[1];
+          u[2] = v[2];
+          ft_colr_set_lum( u, lum );
+        }
+        break;
+      }
+
+      for ( i = 0; i < 3; i++ )
+        cr[i] = ( cs[i] * (FT_TS_Int)( 255 - ba ) +
+                  cb[i] * (FT_TS_Int)( 255 - sa ) +
+                  (FT_TS_Int)( sa * ba ) * u[i] / 255 +
+                  127 ) / 255;
+    }
+
+    for ( i = 0; i < 3; i++ )
+      cr[i] = FT_TS_MIN( FT_TS_MAX( cr[i], 0 ), ra );
+
+    return ( (FT_TS_UInt32)ra    << 24 ) |
+           ( (FT_TS_UInt32)cr[0] << 16 ) |
+           ( (FT_TS_UInt32)cr[1] <<  8 ) |
+             (FT_TS_UInt32)cr[2];
+
+  Porter_Duff:
+    return ft_colr_add( ft_colr_mul( s, fa ), ft_colr_mul( b, fb ) );
+  }
+
+
+  /* Composite `source' onto `backdrop' with the given mode. */
+  static void
+  ft_colr_composite( const ColrLayer*      source,
+                     ColrLayer*            backdrop,
+                     FT_TS_Composite_Mode  mode )
+  {
+    ColrBox    box = backdrop->box;
+    FT_TS_Int  x, y;
+
+
+    if ( !COLR_BOX_EMPTY( &source->box ) )
+      ft_colr_box_add( &box,
+                       source->box.x_min,
+                       source->box.y_min,
+                       source->box.x_max,
+                       source->box.y_max );
+
+    for ( y = box.y_min; y < box.y_max; y++ )
+    {
+      const FT_TS_UInt32*  s = COLR_PIXEL( source, box.x_min, y );
+      FT_TS_UInt32*        b = COLR_PIXEL( backdrop, box.x_min, y );
+
+
+      for ( x = 0; x < box.x_max - box.x_min; x++ )
+        b[x] = ft_colr_composite_pixel( mode, s[x], b[x] );
+    }
+
+    backdrop->box = box;
+  }
+
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* The cache of layer group images.                                      */
+  /*                                                                       */
+  /*************************************************************************/
+
+#define COLR_CACHE_HASH( paint, dx, dy )                          \
+          ( (FT_TS_UInt32)(FT_TS_PtrDist)(void*)(paint) * 4096U + \
+            (FT_TS_UInt32)( (dx) * 64 + (dy) ) )
+
+
+  /* what `ft_colr_cache_lookup' looks for */
+  typedef struct  ColrCacheKey_
+  {
+    FT_TS_Byte*          paint;
+    const FT_TS_Matrix*  matrix;
+    FT_TS_Pos            dx, dy;
+
+    /* the area that the image must cover */
+    FT_TS_Int            x_min, y_min, x_max, y_max;
+
+  } ColrCacheKey;
+
+
+  static FT_TS_Bool
+  ft_colr_cache_compare( FT_TS_MruNode  node,
+                         const void*    key_ )
+  {
+    ColrCacheEntry*      entry = (ColrCacheEntry*)node;
+    const ColrCacheKey*  key   = (const ColrCacheKey*)key_;
+
+
+    return entry->paint == key->paint                 &&
+           entry->dx == key->dx                       &&
+           entry->dy == key->dy                       &&
+           entry->matrix.xx == key->matrix->xx        &&
+           entry->matrix.xy == key->matrix->xy        &&
+           entry->matrix.yx == key->matrix->yx        &&
+           entry->matrix.yy == key->matrix->yy        &&
+           entry->x_min <= key->x_min                 &&
+           entry->y_min <= key->y_min                 &&
+           entry->x_max >= key->x_max                 &&
+           entry->y_max >= key->y_max;
+  }
+
+
+  static void
+  ft_colr_cache_entry_free( FT_TS_MruNode  node,
+                            FT_TS_Memory   memory )
+  {
+    FT_TS_FREE( node );
+  }
+
+
+  static void
+  ft_colr_cache_flush( FT_TS_Memory     memory,
+                       FT_TS_ColrCache  cache )
+  {
+    ft_mru_done( &cache->entries, ft_colr_cache_entry_free, memory );
+  }
+
+
+  /* Get the cache of a face, flushing it if the colors have changed. */
+  static FT_TS_Error
+  ft_colr_cache_get( FT_TS_Face        face,
+                     FT_TS_ColrCache*  acache )
+  {
+    FT_TS_Memory     memory = face->memory;
+    FT_TS_ColrCache  cache  = face->internal->colr_cache;
+    TT_Face          ttface = (TT_Face)face;
+    FT_TS_Error      error;
+
+    FT_TS_UShort  num = ttface->palette
+                          ? ttface->palette_data.num_palette_entries
+                          : 0;
+
+
+    *acache = NULL;
+
+    if ( !cache )
+    {
+      if ( FT_TS_NEW( cache ) )
+        return error;
+
+      face->internal->colr_cache = cache;
+    }
+
+    if ( cache->num_palette_entries != num                           ||
+         cache->palette_index != ttface->palette_index               ||
+         cache->have_foreground_color !=
+           ttface->have_foreground_color                             ||
+         ( ttface->have_foreground_color                            &&
+           ft_memcmp( &cache->foreground_color,
+                          &ttface->foreground_color,
+                          sizeof ( FT_TS_Color ) )                  ) ||
+         ( num                                                      &&
+           ft_memcmp( cache->palette,
+                          ttface->palette,
+                          num * sizeof ( FT_TS_Color ) )            ) )
+    {
+      ft_colr_cache_flush( memory, cache );
+
+      if ( cache->num_palette_entries != num )
+      {
+        if ( FT_TS_QRENEW_ARRAY( cache->palette,
+                                 cache->num_palette_entries,
+                                 num ) )
+        {
+          cache->num_palette_entries = 0;
+          return error;
+        }
+
+        cache->num_palette_entries = num;
+      }
+
+      if ( num )
+        FT_TS_ARRAY_COPY( cache->palette, ttface->palette, num );
+
+      cache->palette_index         = ttface->palette_index;
+      cache->have_foreground_color = ttface->have_foreground_color;
+      cache->foreground_color      = ttface->foreground_color;
+    }
+
+    *acache = cache;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* Look up the image of a layer group; blend it into `layer' if found. */
+  static FT_TS_Bool
+  ft_colr_cache_lookup( ColrContext*          ctx,
+                        FT_TS_Byte*           paint,
+                        const ColrTransform*  tr,
+                        ColrLayer*            layer )
+  {
+    ColrCacheEntry*  entry;
+    ColrCacheKey     key;
+
+    FT_TS_Pos  dx = tr->delta.x & 63;
+    FT_TS_Pos  dy = tr->delta.y & 63;
+    FT_TS_Int  ix = (FT_TS_Int)( ( tr->delta.x - dx ) / 64 );
+    FT_TS_Int  iy = (FT_TS_Int)( ( tr->delta.y - dy ) / 64 );
+
+
+    key.paint  = paint;
+    key.matrix = &tr->matrix;
+    key.dx     = dx;
+    key.dy     = dy;
+
+    /* the area of `layer' in the coordinates of the cache entries */
+    key.x_min = layer->area.x_min - ix;
+    key.y_min = ctx->rows - layer->area.y_max - iy;
+    key.x_max = layer->area.x_max - ix;
+    key.y_max = ctx->rows - layer->area.y_min - iy;
+
+    entry = (ColrCacheEntry*)ft_mru_lookup( &ctx->cache->entries,
+                                            COLR_CACHE_HASH( paint, dx, dy ),
+                                            ft_colr_cache_compare,
+                                            &key );
+    if ( !entry )
+      return 0;
+
+    if ( entry->width && entry->rows )
+    {
+      ColrBox    image, box;
+      FT_TS_Int  y;
+
+
+      /* the image in canvas coordinates */
+      image.x_min = entry->left + ix;
+      image.y_min = ctx->rows - ( entry->top + iy );
+      image.x_max = image.x_min + (FT_TS_Int)entry->width;
+      image.y_max = image.y_min + (FT_TS_Int)entry->rows;
+
+      box = image;
+      ft_colr_box_intersect( &box, &layer->area );
+
+      if ( COLR_BOX_EMPTY( &box ) )
+        return 1;
+
+      for ( y = box.y_min; y < box.y_max; y++ )
+        ft_colr_blend_span( COLR_PIXEL( layer, box.x_min, y ),
+                            entry->pixels +
+                              ( y - image.y_min ) *
+                                (FT_TS_Int)entry->width +
+                              ( box.x_min - image.x_min ),
+                            0,
+                            NULL,
+                            255,
+                            (FT_TS_UInt)( box.x_max - box.x_min ) );
+
+      ft_colr_box_add( &layer->box,
+                       box.x_min,
+                       box.y_min,
+                       box.x_max,
+                       box.y_max );
+    }
+
+    return 1;
+  }
+
+
+  /* Store the image of a layer group, rendered within `area'. */
+  static void
+  ft_colr_cache_add( ColrContext*          ctx,
+                     FT_TS_Byte*           paint,
+                     const ColrTransform*  tr,
+                     const ColrLayer*      group,
+                     const ColrBox*        area )
+  {
+    FT_TS_Memory  memory = ctx->memory;
+    FT_TS_Error   error;
+
+    ColrCacheEntry*  entry;
+    ColrBox          box = group->box;
+    FT_TS_ULong      size;
+    FT_TS_Int        y;
+
+    FT_TS_Pos  dx = tr->delta.x & 63;
+    FT_TS_Pos  dy = tr->delta.y & 63;
+    FT_TS_Int  ix = (FT_TS_Int)( ( tr->delta.x - dx ) / 64 );
+    FT_TS_Int  iy = (FT_TS_Int)( ( tr->delta.y - dy ) / 64 );
+
+
+    if ( COLR_BOX_EMPTY( &box ) )
+    {
+      box.x_min = 0;
+      box.y_min = 0;
+      box.x_max = 0;
+      box.y_max = 0;
+    }
+
+    size = sizeof ( ColrCacheEntry ) +
+           4 * (FT_TS_ULong)( box.x_max - box.x_min ) *
+                 (FT_TS_ULong)( box.y_max - box.y_min );
+    if ( size > TT_CONFIG_COLRV1_CACHE_MAX_SIZE )
+      return;
+
+    if ( FT_TS_QALLOC( entry, size ) )
+      return;
+
+    entry->node.hash = COLR_CACHE_HASH( paint, dx, dy );
+    entry->node.size = size;
+
+    entry->paint  = paint;
+    entry->matrix = tr->matrix;
+    entry->dx     = dx;
+    entry->dy     = dy;
+
+    entry->x_min = area->x_min - ix;
+    entry->y_min = ctx->rows - area->y_max - iy;
+    entry->x_max = area->x_max - ix;
+    entry->y_max = ctx->rows - area->y_min - iy;
+
+    entry->left   = box.x_min - ix;
+    entry->top    = ctx->rows - box.y_min - iy;
+    entry->width  = (FT_TS_UInt)( box.x_max - box.x_min );
+    entry->rows   = (FT_TS_UInt)( box.y_max - box.y_min );
+    entry->pixels = (FT_TS_UInt32*)( entry + 1 );
+
+    for ( y = box.y_min; y < box.y_max; y++ )
+      FT_TS_ARRAY_COPY( entry->pixels +
+                          ( y - box.y_min ) * (FT_TS_Int)entry->width,
+                        COLR_PIXEL( group, box.x_min, y ),
+                        entry->width );
+
+    ft_mru_add( &ctx->cache->entries,
+                &entry->node,
+                TT_CONFIG_COLRV1_CACHE_MAX_SIZE,
+                ft_colr_cache_entry_free,
+                memory );
+  }
+
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* Paints.                                                               */
+  /*                                                                       */
+  /*************************************************************************/
+
+  /* a fill that is not directly clipped by a glyph */
+  static FT_TS_Error
+  ft_colr_paint_fill( ColrContext*          ctx,
+                      FT_TS_COLR_Paint*     paint,
+                      const ColrTransform*  tr,
+                      ColrLayer*            layer )
+  {
+    ColrShader   shader;
+    ColrMask*    clip = ctx->clip;
+    FT_TS_Bool   visible;
+    FT_TS_Error  error;
+    FT_TS_Int    x, y;
+
+
+    error = ft_colr_setup_shader( ctx, paint, tr, &shader, &visible );
+    if ( error || !visible )
+      return error;
+
+    ctx->shader = &shader;
+
+    if ( !clip )
+    {
+      if ( COLR_BOX_EMPTY( &layer->area ) )
+        goto Exit;
+
+      for ( y = layer->area.y_min; y < layer->area.y_max; y++ )
+        ft_colr_fill_run( ctx,
+                          layer,
+                          layer->area.x_min,
+                          y,
+                          (FT_TS_UInt)( layer->area.x_max -
+                                        layer->area.x_min ),
+                          255,
+                          NULL );
+
+      goto Exit;
+    }
+
+    for ( y = clip->box.y_min; y < clip->box.y_max; y++ )
+    {
+      FT_TS_Int          pitch = clip->box.x_max - clip->box.x_min;
+      const FT_TS_Byte*  line  = clip->coverage +
+                                   ( y - clip->box.y_min ) * pitch;
+
+
+      x = 0;
+      while ( x < pitch )
+      {
+        FT_TS_Int  start;
+
+
+        while ( x < pitch && !line[x] )
+          x++;
+
+        start = x;
+        while ( x < pitch && line[x] )
+          x++;
+
+        if ( x > start )
+          ft_colr_fill_run( ctx,
+                            layer,
+                            clip->box.x_min + start,
+                            y,
+                            (FT_TS_UInt)( x - start ),
+                            255,
+                            line + start );
+      }
+    }
+
+  Exit:
+    ctx->shader = NULL;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  static FT_TS_Error
+  ft_colr_paint_glyph( ColrContext*          ctx,
+                       FT_TS_COLR_Paint*     paint,
+                       const ColrTransform*  tr,
+                       ColrLayer*            layer,
+                       FT_TS_UInt            depth )
+  {
+    FT_TS_Memory  memory = ctx->memory;
+    FT_TS_Error   error;
+
+    FT_TS_OpaquePaint  child = paint->u.glyph.paint;
+    FT_TS_COLR_Paint   fill;
+    ColrTransform      ftr   = *tr;
+    ColrBox            box;
+    ColrMask           mask;
+    ColrMask*          clip;
+    FT_TS_ULong        size;
+
+
+    error = ft_colr_load_outline( ctx, paint->u.glyph.glyphID, tr, &box );
+    if ( error )
+      return error;
+
+    ft_colr_box_intersect( &box, &layer->area );
+    if ( COLR_BOX_EMPTY( &box ) )
+      return FT_TS_Err_Ok;
+
+    /* look through transformations for a fill */
+    for ( ; depth < COLR_MAX_DEPTH; depth++ )
+    {
+      if ( !FT_TS_Get_Paint( ctx->face, child, &fill ) )
+        return FT_TS_Err_Ok;
+
+      if ( fill.format == FT_TS_COLR_PAINTFORMAT_SOLID           ||
+           fill.format == FT_TS_COLR_PAINTFORMAT_LINEAR_GRADIENT ||
+           fill.format == FT_TS_COLR_PAINTFORMAT_RADIAL_GRADIENT ||
+           fill.format == FT_TS_COLR_PAINTFORMAT_SWEEP_GRADIENT  )
+      {
+        ColrShader  shader;
+        FT_TS_Bool  visible;
+
+
+        error = ft_colr_setup_shader( ctx, &fill, &ftr, &shader, &visible );
+        if ( error || !visible )
+          return error;
+
+        /* blend the spans directly */
+        ctx->shader = &shader;
+        ctx->layer  = layer;
+
+        error = ft_colr_raster( ctx,
+                                &ctx->slot->outline,
+                                ft_colr_fill_spans,
+                                &box );
+
+        ctx->shader = NULL;
+        ctx->layer  = NULL;
+
+        return error;
+      }
+
+      if ( !ft_colr_child_transform( &fill, &ftr, &ftr, &child ) )
+        break;
+
+      if ( --ctx->budget < 0 )
+        return FT_TS_THROW( Invalid_Table );
+    }
+
+    /* otherwise, render a clip mask for the child paint */
+    size = (FT_TS_ULong)( box.x_max - box.x_min ) *
+             (FT_TS_ULong)( box.y_max - box.y_min );
+
+    error = ft_colr_reserve( ctx, size );
+    if ( error )
+      return error;
+
+    mask.box = box;
+    if ( FT_TS_ALLOC( mask.coverage, size ) )
+    {
+      ctx->memory_left += size;
+      return error;
+    }
+
+    ctx->mask = &mask;
+
+    error = ft_colr_raster( ctx,
+                            &ctx->slot->outline,
+                            ft_colr_mask_spans,
+                            &box );
+    ctx->mask = NULL;
+
+    if ( !error )
+    {
+      clip      = ctx->clip;
+      ctx->clip = &mask;
+
+      error = ft_colr_paint( ctx,
+                             paint->u.glyph.paint,
+                             tr,
+                             layer,
+                             depth + 1 );
+
+      ctx->clip = clip;
+    }
+
+    FT_TS_FREE( mask.coverage );
+    ctx->memory_left += size;
+
+    return error;
+  }
+
+
+  static FT_TS_Error
+  ft_colr_paint_layers( ColrContext*          ctx,
+                        FT_TS_OpaquePaint     opaque,
+                        FT_TS_COLR_Paint*     paint,
+                        const ColrTransform*  tr,
+                        ColrLayer*            layer,
+                        FT_TS_UInt            depth )
+  {
+    FT_TS_Error  error = FT_TS_Err_Ok;
+
+    FT_TS_LayerIterator  iterator = paint->u.colr_layers.layer_iterator;
+    FT_TS_OpaquePaint    child;
+    ColrLayer            group;
+    ColrBox              area;
+    FT_TS_Bool           isolated = 0;
+
+
+    /* Without a clip mask, draw the layers as an isolated group, which */
+    /* can be cached.  This only makes a difference for composition    */
+    /* modes that look at the backdrop.                                */
+    if ( ctx->clip )
+      group = *layer;
+    else
+    {
+      if ( ctx->cache && ft_colr_cache_lookup( ctx, opaque.p, tr, layer ) )
+        return FT_TS_Err_Ok;
+
+      if ( COLR_BOX_EMPTY( &layer->box ) )
+        group = *layer;
+      else
+      {
+        /* the layer only needs to cover the contents of the group */
+        area  = layer->area;
+        error = ft_colr_content_area( ctx, opaque, tr, &area, depth );
+        if ( !error )
+          error = ft_colr_new_layer( ctx, &group, &area );
+        if ( error )
+          return error;
+
+        isolated = 1;
+      }
+    }
+
+    child.p                     = NULL;
+    child.insert_root_transform = 0;
+
+    while ( FT_TS_Get_Paint_Layers( ctx->face, &iterator, &child ) )
+    {
+      error = ft_colr_paint( ctx, child, tr, &group, depth + 1 );
+      if ( error )
+        break;
+    }
+
+    /* the group was rendered within the area of `layer' */
+    if ( !error && !ctx->clip && ctx->cache )
+      ft_colr_cache_add( ctx, opaque.p, tr, &group, &layer->area );
+
+    if ( !isolated )
+      layer->box = group.box;
+    else
+    {
+      if ( !error )
+        ft_colr_blend_layer( layer, &group, NULL );
+
+      ft_colr_done_layer( ctx, &group );
+    }
+
+    return error;
+  }
+
+
+  static FT_TS_Error
+  ft_colr_paint_composite( ColrContext*          ctx,
+                           FT_TS_OpaquePaint     opaque,
+                           FT_TS_COLR_Paint*     paint,
+                           const ColrTransform*  tr,
+                           ColrLayer*            layer,
+                           FT_TS_UInt            depth )
+  {
+    FT_TS_Error  error;
+
+    ColrLayer  backdrop, source;
+    ColrMask*  clip = ctx->clip;
+    ColrBox    area = layer->area;
+
+
+    backdrop.pixels = NULL;
+    source.pixels   = NULL;
+
+    /* only the part of the result within the clip mask is used */
+    if ( clip )
+      ft_colr_box_intersect( &area, &clip->box );
+
+    error = ft_colr_content_area( ctx, opaque, tr, &area, depth );
+    if ( error )
+      goto Exit;
+
+    error = ft_colr_new_layer( ctx, &backdrop, &area );
+    if ( error )
+      goto Exit;
+
+    error = ft_colr_new_layer( ctx, &source, &area );
+    if ( error )
+      goto Exit;
+
+    /* the operands are not clipped, only the result */
+    ctx->clip = NULL;
+
+    error = ft_colr_paint( ctx,
+                           paint->u.composite.backdrop_paint,
+                           tr,
+                           &backdrop,
+                           depth + 1 );
+    if ( !error )
+      error = ft_colr_paint( ctx,
+                             paint->u.composite.source_paint,
+                             tr,
+                             &source,
+                             depth + 1 );
+
+    ctx->clip = clip;
+
+    if ( error )
+      goto Exit;
+
+    ft_colr_composite( &source,
+                       &backdrop,
+                       paint->u.composite.composite_mode );
+    ft_colr_blend_layer( layer, &backdrop, clip );
+
+  Exit:
+    ft_colr_done_layer( ctx, &backdrop );
+    ft_colr_done_layer( ctx, &source );
+
+    return error;
+  }
+
+
+  static FT_TS_Error
+  ft_colr_paint( ColrContext*          ctx,
+                 FT_TS_OpaquePaint     opaque,
+                 const ColrTransform*  tr,
+                 ColrLayer*            layer,
+                 FT_TS_UInt            depth )
+  {
+    FT_TS_COLR_Paint   paint;
+    FT_TS_OpaquePaint  next;
+    ColrTransform      child;
+
+
+    /* protect against cycles and excessive fan-out */
+    if ( depth >= COLR_MAX_DEPTH || --ctx->budget < 0 )
+      return FT_TS_THROW( Invalid_Table );
+
+    /* unknown or invalid paints draw nothing */
+    if ( !FT_TS_Get_Paint( ctx->face, opaque, &paint ) )
+      return FT_TS_Err_Ok;
+
+    switch ( paint.format )
+    {
+    case FT_TS_COLR_PAINTFORMAT_COLR_LAYERS:
+      return ft_colr_paint_layers( ctx, opaque, &paint, tr, layer, depth );
+
+    case FT_TS_COLR_PAINTFORMAT_SOLID:
+    case FT_TS_COLR_PAINTFORMAT_LINEAR_GRADIENT:
+    case FT_TS_COLR_PAINTFORMAT_RADIAL_GRADIENT:
+    case FT_TS_COLR_PAINTFORMAT_SWEEP_GRADIENT:
+      return ft_colr_paint_fill( ctx, &paint, tr, layer );
+
+    case FT_TS_COLR_PAINTFORMAT_GLYPH:
+      return ft_colr_paint_glyph( ctx, &paint, tr, layer, depth );
+
+    case FT_TS_COLR_PAINTFORMAT_COLR_GLYPH:
+      next.p                     = NULL;
+      next.insert_root_transform = 0;
+
+      if ( !FT_TS_Get_Color_Glyph_Paint( ctx->face,
+                                         paint.u.colr_glyph.glyphID,
+                                         FT_TS_COLOR_NO_ROOT_TRANSFORM,
+                                         &next ) )
+        return FT_TS_Err_Ok;
+
+      return ft_colr_paint( ctx, next, tr, layer, depth + 1 );
+
+    case FT_TS_COLR_PAINTFORMAT_COMPOSITE:
+      return ft_colr_paint_composite( ctx,
+                                      opaque,
+                                      &paint,
+                                      tr,
+                                      layer,
+                                      depth );
+
+    default:
+      if ( !ft_colr_child_transform( &paint, tr, &child, &next ) )
+        return FT_TS_Err_Ok;
+
+      return ft_colr_paint( ctx, next, &child, layer, depth + 1 );
+    }
+  }
+
+
+  /* Compute the device bounding box (26.6) of all glyphs in a paint */
+  /* graph, for glyphs without a clip box.                           */
+  static FT_TS_Error
+  ft_colr_bounds( ColrContext*          ctx,
+                  FT_TS_OpaquePaint     opaque,
+                  const ColrTransform*  tr,
+                  FT_TS_BBox*           bbox,
+                  FT_TS_UInt            depth )
+  {
+    FT_TS_COLR_Paint   paint;
+    FT_TS_OpaquePaint  next;
+    ColrTransform      child;
+    FT_TS_Error        error;
+
+
+    if ( depth >= COLR_MAX_DEPTH || --ctx->budget < 0 )
+      return FT_TS_THROW( Invalid_Table );
+
+    if ( !FT_TS_Get_Paint( ctx->face, opaque, &paint ) )
+      return FT_TS_Err_Ok;
+
+    switch ( paint.format )
+    {
+    case FT_TS_COLR_PAINTFORMAT_COLR_LAYERS:
+      {
+        FT_TS_LayerIterator  iterator = paint.u.colr_layers.layer_iterator;
+
+
+        next.p                     = NULL;
+        next.insert_root_transform = 0;
+
+        while ( FT_TS_Get_Paint_Layers( ctx->face, &iterator, &next ) )
+        {
+          error = ft_colr_bounds( ctx, next, tr, bbox, depth + 1 );
+          if ( error )
+            return error;
+        }
+      }
+      return FT_TS_Err_Ok;
+
+    case FT_TS_COLR_PAINTFORMAT_GLYPH:
+      {
+        FT_TS_Outline*  outline = &ctx->slot->outline;
+        FT_TS_BBox      cbox;
+
+
+        /* the glyph clips everything below it */
+        error = FT_TS_Load_Glyph( ctx->face,
+                                  paint.u.glyph.glyphID,
+                                  COLR_LOAD_FLAGS );
+        if ( error )
+          return error;
+
+        if ( ctx->slot->format != FT_TS_GLYPH_FORMAT_OUTLINE ||
+             !outline->n_points                              )
+          return FT_TS_Err_Ok;
+
+        FT_TS_Outline_Transform( outline, &tr->matrix );
+        FT_TS_Outline_Translate( outline, tr->delta.x, tr->delta.y );
+        FT_TS_Outline_Get_CBox( outline, &cbox );
+
+        if ( bbox->xMin > bbox->xMax )
+          *bbox = cbox;
+        else
+        {
+          bbox->xMin = FT_TS_MIN( bbox->xMin, cbox.xMin );
+          bbox->yMin = FT_TS_MIN( bbox->yMin, cbox.yMin );
+          bbox->xMax = FT_TS_MAX( bbox->xMax, cbox.xMax );
+          bbox->yMax = FT_TS_MAX( bbox->yMax, cbox.yMax );
+        }
+      }
+      return FT_TS_Err_Ok;
+
+    case FT_TS_COLR_PAINTFORMAT_COLR_GLYPH:
+      next.p                     = NULL;
+      next.insert_root_transform = 0;
+
+      if ( !FT_TS_Get_Color_Glyph_Paint( ctx->face,
+                                         paint.u.colr_glyph.glyphID,
+                                         FT_TS_COLOR_NO_ROOT_TRANSFORM,
+                                         &next ) )
+        return FT_TS_Err_Ok;
+
+      return ft_colr_bounds( ctx, next, tr, bbox, depth + 1 );
+
+    case FT_TS_COLR_PAINTFORMAT_COMPOSITE:
+      error = ft_colr_bounds( ctx,
+                              paint.u.composite.backdrop_paint,
+                              tr,
+                              bbox,
+                              depth + 1 );
+      if ( error )
+        return error;
+
+      return ft_colr_bounds( ctx,
+                             paint.u.composite.source_paint,
+                             tr,
+                             bbox,
+                             depth + 1 );
+
+    case FT_TS_COLR_PAINTFORMAT_SOLID:
+    case FT_TS_COLR_PAINTFORMAT_LINEAR_GRADIENT:
+    case FT_TS_COLR_PAINTFORMAT_RADIAL_GRADIENT:
+    case FT_TS_COLR_PAINTFORMAT_SWEEP_GRADIENT:
+      /* fills without a glyph are clipped to the other contents */
+      ctx->unbounded = 1;
+      return FT_TS_Err_Ok;
+
+    default:
+      if ( !ft_colr_child_transform( &paint, tr, &child, &next ) )
+        return FT_TS_Err_Ok;
+
+      return ft_colr_bounds( ctx, next, &child, bbox, depth + 1 );
+    }
+  }
+
+
+  /* Compute the canvas size for a bounding box (in 26.6 format) and */
+  /* return the position of its lower left corner.                   */
+  static FT_TS_Error
+  ft_colr_setup_canvas( ColrContext*       ctx,
+                        const FT_TS_BBox*  bbox,
+                        FT_TS_Pos*         aleft,
+                        FT_TS_Pos*         abottom )
+  {
+    FT_TS_Pos  left   = FT_TS_PIX_FLOOR( bbox->xMin );
+    FT_TS_Pos  bottom = FT_TS_PIX_FLOOR( bbox->yMin );
+
+
+    if ( bbox->xMax - left > COLR_MAX_DIM * 64 ||
+         bbox->yMax - bottom > COLR_MAX_DIM * 64 )
+      return FT_TS_THROW( Raster_Overflow );
+
+    ctx->width = (FT_TS_Int)( ( FT_TS_PIX_CEIL( bbox->xMax ) -
+                                left ) >> 6 );
+    ctx->rows  = (FT_TS_Int)( ( FT_TS_PIX_CEIL( bbox->yMax ) -
+                                bottom ) >> 6 );
+
+    /* the canvas itself always fits into the memory budget */
+    ctx->memory_left = COLR_MAX_MEMORY +
+                       4 * (FT_TS_ULong)ctx->width * (FT_TS_ULong)ctx->rows;
+
+    *aleft   = left;
+    *abottom = bottom;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* Hand over the canvas to `slot' as a BGRA bitmap. */
+  static void
+  ft_colr_set_bitmap( ColrContext*     ctx,
+                      FT_TS_GlyphSlot  slot,
+                      ColrLayer*       canvas,
+                      FT_TS_Pos        left,
+                      FT_TS_Pos        bottom )
+  {
+    FT_TS_UInt32*  pixels = canvas->pixels;
+    FT_TS_ULong    count  = (FT_TS_ULong)ctx->width * (FT_TS_ULong)ctx->rows;
+    FT_TS_ULong    i;
+
+
+    /* convert to BGRA byte order */
+    for ( i = 0; i < count; i++ )
+    {
+      FT_TS_UInt32  c = pixels[i];
+      FT_TS_Byte*   p = (FT_TS_Byte*)( pixels + i );
+
+
+      p[0] = (FT_TS_Byte)c;
+      p[1] = (FT_TS_Byte)( c >> 8 );
+      p[2] = (FT_TS_Byte)( c >> 16 );
+      p[3] = (FT_TS_Byte)( c >> 24 );
+    }
+
+    ft_glyphslot_set_bitmap( slot, (FT_TS_Byte*)pixels );
+    slot->internal->flags |= FT_TS_GLYPH_OWN_BITMAP;
+    canvas->pixels         = NULL;
+
+    slot->bitmap_left = (FT_TS_Int)( left >> 6 );
+    slot->bitmap_top  = (FT_TS_Int)( bottom >> 6 ) + ctx->rows;
+
+    slot->bitmap.width      = (unsigned int)ctx->width;
+    slot->bitmap.rows       = (unsigned int)ctx->rows;
+    slot->bitmap.pitch      = ctx->width * 4;
+    slot->bitmap.pixel_mode = FT_TS_PIXEL_MODE_BGRA;
+    slot->bitmap.num_grays  = 256;
+
+    slot->format = FT_TS_GLYPH_FORMAT_BITMAP;
+  }
+
+
+  /* a layer of a 'COLR' v0 glyph, kept in a shared outline buffer */
+  typedef struct  ColrOutline_
+  {
+    FT_TS_UInt32  color;
+    FT_TS_UInt    first_point;
+    FT_TS_UInt    first_contour;
+    short         n_points;
+    short         n_contours;
+    int           flags;
+
+  } ColrOutline;
+
+
+  /* Render the layers of a 'COLR' v0 glyph straight into one canvas.  */
+  /* The layer outlines are loaded with the glyph's load flags (thus    */
+  /* hinted and transformed as usual) and collected in a single buffer  */
+  /* to get the bounding box; each one is then rasterized and blended   */
+  /* in its color span by span, without any intermediate bitmaps.       */
+  static FT_TS_Error
+  ft_colr_render_layers( FT_TS_GlyphSlot  slot )
+  {
+    FT_TS_Face    face   = slot->face;
+    FT_TS_Memory  memory = face->memory;
+    FT_TS_Error   error;
+
+    FT_TS_LayerIterator  iterator;
+    FT_TS_UInt           glyph_index;
+    FT_TS_UInt           color_index;
+    FT_TS_Int32          load_flags;
+
+    ColrContext    ctx;
+    ColrLayer      canvas;
+    ColrOutline*   layers       = NULL;
+    FT_TS_UInt     num_layers   = 0;
+    FT_TS_Vector*  points       = NULL;
+    char*          tags         = NULL;
+    FT_TS_UInt     num_points   = 0;
+    FT_TS_UInt     max_points   = 0;
+    short*         contours     = NULL;
+    FT_TS_UInt     num_contours = 0;
+    FT_TS_UInt     max_contours = 0;
+    FT_TS_BBox     bbox;
+    FT_TS_Pos      left, bottom;
+    FT_TS_UInt     n;
+
+
+    iterator.p = NULL;
+    if ( !FT_TS_Get_Color_Glyph_Layer( face,
+                                       slot->glyph_index,
+                                       &glyph_index,
+                                       &color_index,
+                                       &iterator ) )
+      return FT_TS_ERR( Cannot_Render_Glyph );
+
+    FT_TS_ZERO( &ctx );
+    ctx.face   = face;
+    ctx.memory = memory;
+
+    canvas.pixels = NULL;
+
+    if ( FT_TS_QNEW_ARRAY( layers, iterator.num_layers ) )
+      return error;
+
+    error = FT_TS_New_GlyphSlot( face, &ctx.slot );
+    if ( error )
+      goto Exit;
+
+    /* the layers get loaded like the glyph itself, but not rendered */
+    load_flags = slot->internal->load_flags &
+                 ~( FT_TS_LOAD_COLOR | FT_TS_LOAD_RENDER );
+
+    bbox.xMin = 0;
+    bbox.yMin = 0;
+    bbox.xMax = -1;
+    bbox.yMax = -1;
+
+    do
+    {
+      FT_TS_Outline*  outline = &ctx.slot->outline;
+      ColrOutline*    layer;
+      FT_TS_BBox      cbox;
+      FT_TS_UInt32    color;
+
+
+      color = ft_colr_get_color( face, color_index, 0x4000 );
+      if ( !color )
+        continue;
+
+      error = FT_TS_Load_Glyph( face, glyph_index, load_flags );
+      if ( error )
+        goto Exit;
+
+      /* leave bitmap layers to the generic code */
+      if ( ctx.slot->format != FT_TS_GLYPH_FORMAT_OUTLINE )
+      {
+        error = FT_TS_THROW( Cannot_Render_Glyph );
+        goto Exit;
+      }
+
+      if ( outline->n_points <= 0 || outline->n_contours <= 0 )
+        continue;
+
+      if ( num_points + (FT_TS_UInt)outline->n_points > max_points )
+      {
+        FT_TS_UInt  new_max = FT_TS_MAX( 2 * max_points,
+                                         num_points +
+                                           (FT_TS_UInt)outline->n_points );
+
+
+        if ( FT_TS_QRENEW_ARRAY( points, max_points, new_max ) ||
+             FT_TS_QRENEW_ARRAY( tags, max_points, new_max )   )
+          goto Exit;
+
+        max_points = new_max;
+      }
+
+      if ( num_contours + (FT_TS_UInt)outline->n_contours > max_contours )
+      {
+        FT_TS_UInt  new_max = FT_TS_MAX( 2 * max_contours,
+                                         num_contours +
+                                           (FT_TS_UInt)outline->n_contours );
+
+
+        if ( FT_TS_QRENEW_ARRAY( contours, max_contours, new_max ) )
+          goto Exit;
+
+        max_contours = new_max;
+      }
+
+      layer = layers + num_layers++;
+
+      layer->color         = color;
+      layer->first_point   = num_points;
+      layer->first_contour = num_contours;
+      layer->n_points      = outline->n_points;
+      layer->n_contours    = outline->n_contours;
+      layer->flags         = outline->flags;
+
+      FT_TS_ARRAY_COPY( points + num_points,
+                        outline->points,
+                        outline->n_points );
+      FT_TS_ARRAY_COPY( tags + num_points,
+                        outline->tags,
+                        outline->n_points );
+      FT_TS_ARRAY_COPY( contours + num_contours,
+                        outline->contours,
+                        outline->n_contours );
+
+      num_points   += (FT_TS_UInt)outline->n_points;
+      num_contours += (FT_TS_UInt)outline->n_contours;
+
+      FT_TS_Outline_Get_CBox( outline, &cbox );
+
+      if ( bbox.xMin > bbox.xMax )
+        bbox = cbox;
+      else
+      {
+        bbox.xMin = FT_TS_MIN( bbox.xMin, cbox.xMin );
+        bbox.yMin = FT_TS_MIN( bbox.yMin, cbox.yMin );
+        bbox.xMax = FT_TS_MAX( bbox.xMax, cbox.xMax );
+        bbox.yMax = FT_TS_MAX( bbox.yMax, cbox.yMax );
+      }
+
+    } while ( FT_TS_Get_Color_Glyph_Layer( face,
+                                           slot->glyph_index,
+                                           &glyph_index,
+                                           &color_index,
+                                           &iterator ) );
+
+    if ( bbox.xMin > bbox.xMax )
+    {
+      bbox.xMin = 0;
+      bbox.yMin = 0;
+      bbox.xMax = 0;
+      bbox.yMax = 0;
+    }
+
+    error = ft_colr_setup_canvas( &ctx, &bbox, &left, &bottom );
+    if ( error )
+      goto Exit;
+
+    if ( ctx.width && ctx.rows )
+    {
+      ColrShader  shader;
+      ColrBox     box;
+
+
+      box.x_min = 0;
+      box.y_min = 0;
+      box.x_max = ctx.width;
+      box.y_max = ctx.rows;
+
+      error = ft_colr_new_layer( &ctx, &canvas, &box );
+      if ( error )
+        goto Exit;
+
+      /* render with the canvas origin at (0,0) */
+      for ( n = 0; n < num_points; n++ )
+      {
+        points[n].x -= left;
+        points[n].y -= bottom;
+      }
+
+      shader.format = FT_TS_COLR_PAINTFORMAT_SOLID;
+
+      ctx.shader = &shader;
+      ctx.layer  = &canvas;
+
+      for ( n = 0; n < num_layers; n++ )
+      {
+        FT_TS_Outline  outline;
+
+
+        outline.n_points   = layers[n].n_points;
+        outline.n_contours = layers[n].n_contours;
+        outline.points     = points + layers[n].first_point;
+        outline.tags       = tags + layers[n].first_point;
+        outline.contours   = contours + layers[n].first_contour;
+        outline.flags      = layers[n].flags;
+
+        shader.color = layers[n].color;
+
+        error = ft_colr_raster( &ctx, &outline, ft_colr_fill_spans, &box );
+        if ( error )
+          break;
+      }
+
+      ctx.shader = NULL;
+      ctx.layer  = NULL;
+
+      if ( error )
+        goto Exit;
+    }
+
+    ft_colr_set_bitmap( &ctx, slot, &canvas, left, bottom );
+
+  Exit:
+    FT_TS_FREE( canvas.pixels );
+    FT_TS_FREE( layers );
+    FT_TS_FREE( points );
+    FT_TS_FREE( tags );
+    FT_TS_FREE( contours );
+
+    /* this also restores `slot' as the glyph slot */
+    FT_TS_Done_GlyphSlot( ctx.slot );
+
+    return error;
+  }
+
+
+  /* documentation is in ftobjs.h */
+
+  FT_TS_BASE_DEF( FT_TS_Error )
+  ft_glyphslot_render_colr( FT_TS_GlyphSlot  slot )
+  {
+    FT_TS_Face    face   = slot->face;
+    FT_TS_Memory  memory = face->memory;
+    FT_TS_Error   error;
+
+    FT_TS_Face_Internal  internal = face->internal;
+
+    FT_TS_OpaquePaint  root;
+    FT_TS_ClipBox      clip_box;
+    FT_TS_BBox         bbox;
+    ColrContext        ctx;
+    ColrTransform      tr;
+    ColrLayer          canvas;
+    ColrBox            area;
+    FT_TS_Pos          left, bottom;
+
+
+    root.p                     = NULL;
+    root.insert_root_transform = 0;
+
+    if ( !face->size )
+      return FT_TS_ERR( Cannot_Render_Glyph );
+
+    if ( !FT_TS_Get_Color_Glyph_Paint( face,
+                                       slot->glyph_index,
+                                       FT_TS_COLOR_NO_ROOT_TRANSFORM,
+                                       &root ) )
+      return ft_colr_render_layers( slot );
+
+    /* the root transformation: scaling and `FT_TS_Set_Transform' */
+    tr.matrix.xx = face->size->metrics.x_scale;
+    tr.matrix.xy = 0;
+    tr.matrix.yx = 0;
+    tr.matrix.yy = face->size->metrics.y_scale;
+    tr.delta.x   = 0;
+    tr.delta.y   = 0;
+
+    if ( !( slot->internal->load_flags & FT_TS_LOAD_IGNORE_TRANSFORM ) )
+    {
+      if ( internal->transform_flags & 1 )
+        FT_TS_Matrix_Multiply( &internal->transform_matrix, &tr.matrix );
+
+      if ( internal->transform_flags & 2 )
+        tr.delta = internal->transform_delta;
+    }
+
+    if ( COLR_OUT_OF_RANGE( tr.matrix.xx, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( tr.matrix.xy, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( tr.matrix.yx, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( tr.matrix.yy, COLR_MAX_COEFF ) ||
+         COLR_OUT_OF_RANGE( tr.delta.x, COLR_MAX_DELTA )   ||
+         COLR_OUT_OF_RANGE( tr.delta.y, COLR_MAX_DELTA )   )
+      return FT_TS_THROW( Invalid_Argument );
+
+    FT_TS_ZERO( &ctx );
+    ctx.face   = face;
+    ctx.memory = memory;
+    ctx.budget = COLR_MAX_PAINTS;
+
+    canvas.pixels = NULL;
+
+    error = FT_TS_New_GlyphSlot( face, &ctx.slot );
+    if ( error )
+      return error;
+
+    /* The canvas covers the clip box (which includes the root    */
+    /* transformation); without one, we compute the bounding box. */
+    if ( !( slot->internal->load_flags & FT_TS_LOAD_IGNORE_TRANSFORM ) &&
+         FT_TS_Get_Color_Glyph_ClipBox( face,
+                                        slot->glyph_index,
+                                        &clip_box )                    )
+    {
+      bbox.xMin = FT_TS_MIN( FT_TS_MIN( clip_box.bottom_left.x,
+                                        clip_box.top_left.x ),
+                             FT_TS_MIN( clip_box.top_right.x,
+                                        clip_box.bottom_right.x ) );
+      bbox.yMin = FT_TS_MIN( FT_TS_MIN( clip_box.bottom_left.y,
+                                        clip_box.top_left.y ),
+                             FT_TS_MIN( clip_box.top_right.y,
+                                        clip_box.bottom_right.y ) );
+      bbox.xMax = FT_TS_MAX( FT_TS_MAX( clip_box.bottom_left.x,
+                                        clip_box.top_left.x ),
+                             FT_TS_MAX( clip_box.top_right.x,
+                                        clip_box.bottom_right.x ) );
+      bbox.yMax = FT_TS_MAX( FT_TS_MAX( clip_box.bottom_left.y,
+                                        clip_box.top_left.y ),
+                             FT_TS_MAX( clip_box.top_right.y,
+                                        clip_box.bottom_right.y ) );
+    }
+    else
+    {
+      bbox.xMin = 0;
+      bbox.yMin = 0;
+      bbox.xMax = -1;
+      bbox.yMax = -1;
+
+      error = ft_colr_bounds( &ctx, root, &tr, &bbox, 0 );
+      if ( error )
+        goto Exit;
+
+      if ( bbox.xMin > bbox.xMax )
+      {
+        bbox.xMin = 0;
+        bbox.yMin = 0;
+        bbox.xMax = 0;
+        bbox.yMax = 0;
+      }
+
+      ctx.budget = COLR_MAX_PAINTS;
+    }
+
+    error = ft_colr_setup_canvas( &ctx, &bbox, &left, &bottom );
+    if ( error )
+      goto Exit;
+
+    /* render with the canvas origin at (0,0) */
+    tr.delta.x -= left;
+    tr.delta.y -= bottom;
+
+    if ( COLR_OUT_OF_RANGE( tr.delta.x, COLR_MAX_DELTA ) ||
+         COLR_OUT_OF_RANGE( tr.delta.y, COLR_MAX_DELTA ) )
+    {
+      error = FT_TS_THROW( Invalid_Argument );
+      goto Exit;
+    }
+
+    if ( ctx.width && ctx.rows )
+    {
+      if ( !FT_TS_HAS_MULTIPLE_MASTERS( face ) )
+      {
+        error = ft_colr_cache_get( face, &ctx.cache );
+        if ( error )
+          goto Exit;
+      }
+
+      if ( FT_TS_QNEW_ARRAY( ctx.scratch, ctx.width ) )
+        goto Exit;
+
+      area.x_min = 0;
+      area.y_min = 0;
+      area.x_max = ctx.width;
+      area.y_max = ctx.rows;
+
+      error = ft_colr_new_layer( &ctx, &canvas, &area );
+      if ( error )
+        goto Exit;
+
+      error = ft_colr_paint( &ctx, root, &tr, &canvas, 0 );
+      if ( error )
+        goto Exit;
+    }
+
+    ft_colr_set_bitmap( &ctx, slot, &canvas, left, bottom );
+
+  Exit:
+    FT_TS_FREE( canvas.pixels );
+    FT_TS_FREE( ctx.scratch );
+
+    /* this also restores `slot' as the glyph slot */
+    FT_TS_Done_GlyphSlot( ctx.slot );
+
+    return error;
+  }
+
+
+  /* documentation is in ftobjs.h */
+
+  FT_TS_BASE_DEF( void )
+  ft_face_done_colr( FT_TS_Face  face )
+  {
+    FT_TS_Memory     memory = face->memory;
+    FT_TS_ColrCache  cache  = face->internal->colr_cache;
+
+
+    if ( !cache )
+      return;
+
+    ft_colr_cache_flush( memory, cache );
+    FT_TS_FREE( cache->palette );
+    FT_TS_FREE( face->internal->colr_cache );
+  }
+
+#endif /* FT_TS_COLRV1_RENDERING */
+
 #else /* !TT_CONFIG_OPTION_COLOR_LAYERS */
 
   FT_TS_EXPORT_DEF( FT_TS_Error )
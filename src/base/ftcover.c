@@ -0,0 +1,837 @@
+/****************************************************************************
+ *
+ * ftcover.c
+ *
+ *   FreeType API for character coverage sets (body).
+ *
+ * Copyright (C) 2021 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcover.h>
+#include <freetype/internal/ftdebug.h>
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftstream.h>
+
+
+  /*
+   * A character code is split into a 16-bit key (the upper half) and a
+   * 16-bit value.  All values with the same key are collected in a
+   * container, which is a sorted array of values if it holds at most
+   * FT_TS_COVERAGE_ARRAY_MAX elements, and a bitmap otherwise; this is the
+   * limit where both representations take 8kByte.
+   *
+   * The serialized form (all numbers in big-endian byte order) is
+   *
+   *   ULong   tag            'FTCV'
+   *   UShort  version        1
+   *   UShort  reserved       0
+   *   ULong   numContainers
+   *
+   * followed by `numContainers' records, sorted by key:
+   *
+   *   UShort  key
+   *   UShort  count - 1
+   *   UShort  values[count]  if count <= FT_TS_COVERAGE_ARRAY_MAX
+   *   ULong   bits[2048]     otherwise
+   */
+
+#define FT_TS_COVERAGE_ARRAY_MAX    4096
+#define FT_TS_COVERAGE_BITS_WORDS   ( 0x10000L / 32 )
+
+#define FT_TS_COVERAGE_TAG          FT_TS_MAKE_TAG( 'F', 'T', 'C', 'V' )
+#define FT_TS_COVERAGE_VERSION      1
+#define FT_TS_COVERAGE_HEADER_SIZE  12
+
+
+  typedef struct  FT_TS_CoverageContainerRec_
+  {
+    FT_TS_UInt     key;
+    FT_TS_UInt     count;   /* 1..0x10000                     */
+    FT_TS_UShort*  values;  /* if `count' is small, or ...    */
+    FT_TS_UInt32*  bits;    /* ... a bitmap of 0x10000 bits   */
+
+  } FT_TS_CoverageContainerRec, *FT_TS_CoverageContainer;
+
+
+  typedef struct  FT_TS_CoverageRec_
+  {
+    FT_TS_Memory             memory;
+    FT_TS_ULong              count;
+    FT_TS_UInt               num_containers;
+    FT_TS_CoverageContainer  containers;
+
+  } FT_TS_CoverageRec;
+
+
+  static FT_TS_UInt
+  ft_coverage_popcount( FT_TS_UInt32  x )
+  {
+    x = x - ( ( x >> 1 ) & 0x55555555UL );
+    x = ( x & 0x33333333UL ) + ( ( x >> 2 ) & 0x33333333UL );
+    x = ( x + ( x >> 4 ) ) & 0x0F0F0F0FUL;
+
+    return (FT_TS_UInt)( (FT_TS_UInt32)( x * 0x01010101UL ) >> 24 );
+  }
+
+
+  static void
+  ft_coverage_free( FT_TS_Coverage  coverage )
+  {
+    FT_TS_Memory  memory = coverage->memory;
+    FT_TS_UInt    n;
+
+
+    for ( n = 0; n < coverage->num_containers; n++ )
+    {
+      FT_TS_FREE( coverage->containers[n].values );
+      FT_TS_FREE( coverage->containers[n].bits );
+    }
+
+    FT_TS_FREE( coverage->containers );
+    FT_TS_FREE( coverage );
+  }
+
+
+  static FT_TS_CoverageContainer
+  ft_coverage_find( FT_TS_Coverage  coverage,
+                    FT_TS_UInt      key )
+  {
+    FT_TS_UInt  min = 0;
+    FT_TS_UInt  max = coverage->num_containers;
+
+
+    while ( min < max )
+    {
+      FT_TS_UInt               mid = min + ( ( max - min ) >> 1 );
+      FT_TS_CoverageContainer  c   = coverage->containers + mid;
+
+
+      if ( c->key == key )
+        return c;
+
+      if ( c->key < key )
+        min = mid + 1;
+      else
+        max = mid;
+    }
+
+    return NULL;
+  }
+
+
+  static FT_TS_Bool
+  ft_coverage_container_has( FT_TS_CoverageContainer  c,
+                             FT_TS_UInt               value )
+  {
+    FT_TS_UInt  min, max;
+
+
+    if ( c->bits )
+      return FT_TS_BOOL( ( c->bits[value >> 5] >> ( value & 31 ) ) & 1 );
+
+    min = 0;
+    max = c->count;
+
+    while ( min < max )
+    {
+      FT_TS_UInt  mid = min + ( ( max - min ) >> 1 );
+      FT_TS_UInt  val = c->values[mid];
+
+
+      if ( val == value )
+        return 1;
+
+      if ( val < value )
+        min = mid + 1;
+      else
+        max = mid;
+    }
+
+    return 0;
+  }
+
+
+  /* build a coverage set from a sorted array of unique character codes */
+  static FT_TS_Error
+  ft_coverage_build( FT_TS_Memory         memory,
+                     const FT_TS_UInt32*  codes,
+                     FT_TS_ULong          num_codes,
+                     FT_TS_Coverage      *acoverage )
+  {
+    FT_TS_Error     error;
+    FT_TS_Coverage  coverage = NULL;
+    FT_TS_UInt      num_containers;
+    FT_TS_ULong     i, j, k;
+
+
+    num_containers = 0;
+    for ( i = 0; i < num_codes; i++ )
+      if ( i == 0 || ( codes[i] >> 16 ) != ( codes[i - 1] >> 16 ) )
+        num_containers++;
+
+    if ( FT_TS_NEW( coverage ) )
+      goto Exit;
+
+    coverage->memory = memory;
+
+    if ( num_containers                                         &&
+         FT_TS_NEW_ARRAY( coverage->containers, num_containers ) )
+      goto Exit;
+
+    for ( i = 0; i < num_codes; i = j )
+    {
+      FT_TS_CoverageContainer  c   = coverage->containers +
+                                     coverage->num_containers;
+      FT_TS_UInt               key = (FT_TS_UInt)( codes[i] >> 16 );
+
+
+      for ( j = i + 1; j < num_codes && ( codes[j] >> 16 ) == key; j++ )
+        ;
+
+      c->key   = key;
+      c->count = (FT_TS_UInt)( j - i );
+
+      coverage->num_containers++;
+
+      if ( c->count <= FT_TS_COVERAGE_ARRAY_MAX )
+      {
+        if ( FT_TS_QNEW_ARRAY( c->values, c->count ) )
+          goto Exit;
+
+        for ( k = i; k < j; k++ )
+          c->values[k - i] = (FT_TS_UShort)( codes[k] & 0xFFFFU );
+      }
+      else
+      {
+        if ( FT_TS_NEW_ARRAY( c->bits, FT_TS_COVERAGE_BITS_WORDS ) )
+          goto Exit;
+
+        for ( k = i; k < j; k++ )
+        {
+          FT_TS_UInt  value = codes[k] & 0xFFFFU;
+
+
+          c->bits[value >> 5] |= (FT_TS_UInt32)1 << ( value & 31 );
+        }
+      }
+    }
+
+    coverage->count = num_codes;
+
+  Exit:
+    if ( error && coverage )
+    {
+      ft_coverage_free( coverage );
+      coverage = NULL;
+    }
+
+    *acoverage = coverage;
+    return error;
+  }
+
+
+  FT_TS_COMPARE_DEF( int )
+  ft_coverage_compare( const void*  a,
+                       const void*  b )
+  {
+    FT_TS_UInt32  code1 = *(const FT_TS_UInt32*)a;
+    FT_TS_UInt32  code2 = *(const FT_TS_UInt32*)b;
+
+
+    return code1 < code2 ? -1 : code1 > code2;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Coverage_New( FT_TS_Face       face,
+                      FT_TS_Coverage  *acoverage )
+  {
+    FT_TS_Error    error;
+    FT_TS_Memory   memory;
+    FT_TS_UInt32*  codes     = NULL;
+    FT_TS_ULong    num_codes = 0;
+    FT_TS_ULong    max_codes = 0;
+    FT_TS_Bool     sorted    = 1;
+    FT_TS_ULong    charcode;
+    FT_TS_UInt     gindex;
+
+
+    if ( !face )
+      return FT_TS_THROW( Invalid_Face_Handle );
+
+    if ( !acoverage )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+
+    if ( !face->charmap )
+      return FT_TS_THROW( Invalid_CharMap_Handle );
+
+    memory = face->memory;
+
+    charcode = FT_TS_Get_First_Char( face, &gindex );
+    while ( gindex )
+    {
+      if ( charcode <= 0xFFFFFFFFUL )
+      {
+        if ( num_codes == max_codes )
+        {
+          FT_TS_ULong  new_max = max_codes ? 2 * max_codes : 256;
+
+
+          if ( FT_TS_QRENEW_ARRAY( codes, max_codes, new_max ) )
+            goto Exit;
+
+          max_codes = new_max;
+        }
+
+        if ( num_codes && codes[num_codes - 1] >= charcode )
+          sorted = 0;
+
+        codes[num_codes++] = (FT_TS_UInt32)charcode;
+      }
+
+      charcode = FT_TS_Get_Next_Char( face, charcode, &gindex );
+    }
+
+    /* `char_next' implementations return ascending character codes; */
+    /* be prepared for drivers that don't, though                   */
+    if ( !sorted )
+    {
+      FT_TS_ULong  i, j;
+
+
+      ft_qsort( codes, num_codes, sizeof ( FT_TS_UInt32 ),
+                ft_coverage_compare );
+
+      for ( i = 1, j = 1; i < num_codes; i++ )
+        if ( codes[i] != codes[j - 1] )
+          codes[j++] = codes[i];
+
+      if ( num_codes )
+        num_codes = j;
+    }
+
+    error = ft_coverage_build( memory, codes, num_codes, acoverage );
+
+  Exit:
+    FT_TS_FREE( codes );
+    return error;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( void )
+  FT_TS_Coverage_Done( FT_TS_Coverage  coverage )
+  {
+    if ( coverage )
+      ft_coverage_free( coverage );
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Bool )
+  FT_TS_Coverage_Has_Char( FT_TS_Coverage  coverage,
+                           FT_TS_ULong     charcode )
+  {
+    FT_TS_CoverageContainer  c;
+
+
+    if ( !coverage || charcode > 0xFFFFFFFFUL )
+      return 0;
+
+    c = ft_coverage_find( coverage, (FT_TS_UInt)( charcode >> 16 ) );
+
+    return c ? ft_coverage_container_has( c, charcode & 0xFFFFU ) : 0;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_ULong )
+  FT_TS_Coverage_Count( FT_TS_Coverage  coverage )
+  {
+    return coverage ? coverage->count : 0;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Coverage_Find_First( const FT_TS_Coverage*  coverages,
+                             FT_TS_UInt             num_coverages,
+                             const FT_TS_UInt32*    charcodes,
+                             FT_TS_UInt             count,
+                             FT_TS_Int*             indices )
+  {
+    FT_TS_UInt  i, n;
+    FT_TS_UInt  left = count;
+
+
+    if ( !count )
+      return FT_TS_Err_Ok;
+
+    if ( !charcodes || !indices || ( num_coverages && !coverages ) )
+      return FT_TS_THROW( Invalid_Argument );
+
+    for ( n = 0; n < count; n++ )
+      indices[n] = -1;
+
+    for ( i = 0; i < num_coverages && left; i++ )
+    {
+      FT_TS_Coverage           coverage = coverages[i];
+      FT_TS_CoverageContainer  c        = NULL;
+      FT_TS_UInt               last_key = 0;
+      FT_TS_Bool               have_key = 0;
+
+
+      if ( !coverage || !coverage->num_containers )
+        continue;
+
+      /* runs of character codes from the same block share a container */
+      for ( n = 0; n < count; n++ )
+      {
+        FT_TS_UInt32  code = charcodes[n];
+        FT_TS_UInt    key  = code >> 16;
+
+
+        if ( indices[n] >= 0 )
+          continue;
+
+        if ( !have_key || key != last_key )
+        {
+          c        = ft_coverage_find( coverage, key );
+          last_key = key;
+          have_key = 1;
+        }
+
+        if ( c && ft_coverage_container_has( c, code & 0xFFFFU ) )
+        {
+          indices[n] = (FT_TS_Int)i;
+          left--;
+        }
+      }
+    }
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  static FT_TS_Error
+  ft_coverage_container_intersect( FT_TS_Memory             memory,
+                                   FT_TS_CoverageContainer  a,
+                                   FT_TS_CoverageContainer  b,
+                                   FT_TS_CoverageContainer  result )
+  {
+    FT_TS_Error  error = FT_TS_Err_Ok;
+    FT_TS_UInt   count = 0;
+
+
+    result->key = a->key;
+
+    if ( a->bits && b->bits )
+    {
+      FT_TS_UInt32*  bits = NULL;
+      FT_TS_UInt     k;
+
+
+      if ( FT_TS_QNEW_ARRAY( bits, FT_TS_COVERAGE_BITS_WORDS ) )
+        goto Exit;
+
+      for ( k = 0; k < FT_TS_COVERAGE_BITS_WORDS; k++ )
+      {
+        bits[k] = a->bits[k] & b->bits[k];
+        count  += ft_coverage_popcount( bits[k] );
+      }
+
+      if ( count > FT_TS_COVERAGE_ARRAY_MAX )
+        result->bits = bits;
+      else
+      {
+        /* too sparse for a bitmap; convert to an array */
+        if ( count )
+          (void)FT_TS_QNEW_ARRAY( result->values, count );
+
+        if ( !error )
+        {
+          FT_TS_UInt  n = 0;
+
+
+          for ( k = 0; k < FT_TS_COVERAGE_BITS_WORDS; k++ )
+          {
+            FT_TS_UInt32  w = bits[k];
+            FT_TS_UInt    bit;
+
+
+            for ( bit = 0; w; bit++, w >>= 1 )
+              if ( w & 1 )
+                result->values[n++] = (FT_TS_UShort)( k * 32 + bit );
+          }
+        }
+
+        FT_TS_FREE( bits );
+        if ( error )
+          goto Exit;
+      }
+    }
+    else if ( a->bits || b->bits )
+    {
+      FT_TS_CoverageContainer  array  = a->bits ? b : a;
+      FT_TS_UInt32*            bitmap = a->bits ? a->bits : b->bits;
+      FT_TS_UInt               k;
+
+
+      if ( FT_TS_QNEW_ARRAY( result->values, array->count ) )
+        goto Exit;
+
+      for ( k = 0; k < array->count; k++ )
+      {
+        FT_TS_UInt  value = array->values[k];
+
+
+        if ( ( bitmap[value >> 5] >> ( value & 31 ) ) & 1 )
+          result->values[count++] = (FT_TS_UShort)value;
+      }
+    }
+    else
+    {
+      FT_TS_UInt  i = 0;
+      FT_TS_UInt  j = 0;
+
+
+      if ( FT_TS_QNEW_ARRAY( result->values,
+                             FT_TS_MIN( a->count, b->count ) ) )
+        goto Exit;
+
+      while ( i < a->count && j < b->count )
+      {
+        if ( a->values[i] < b->values[j] )
+          i++;
+        else if ( a->values[i] > b->values[j] )
+          j++;
+        else
+        {
+          result->values[count++] = a->values[i];
+          i++;
+          j++;
+        }
+      }
+    }
+
+    if ( !count )
+      FT_TS_FREE( result->values );
+
+    result->count = count;
+
+  Exit:
+    return error;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Coverage_Intersect( FT_TS_Coverage   coverage1,
+                            FT_TS_Coverage   coverage2,
+                            FT_TS_Coverage  *acoverage )
+  {
+    FT_TS_Error     error;
+    FT_TS_Memory    memory;
+    FT_TS_Coverage  coverage = NULL;
+    FT_TS_UInt      max_containers;
+    FT_TS_UInt      i, j;
+
+
+    if ( !acoverage )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+
+    if ( !coverage1 || !coverage2 )
+      return FT_TS_THROW( Invalid_Argument );
+
+    memory = coverage1->memory;
+
+    if ( FT_TS_NEW( coverage ) )
+      goto Exit;
+
+    coverage->memory = memory;
+
+    max_containers = FT_TS_MIN( coverage1->num_containers,
+                                coverage2->num_containers );
+    if ( max_containers                                         &&
+         FT_TS_NEW_ARRAY( coverage->containers, max_containers ) )
+      goto Exit;
+
+    i = 0;
+    j = 0;
+
+    while ( i < coverage1->num_containers &&
+            j < coverage2->num_containers )
+    {
+      FT_TS_CoverageContainer  a = coverage1->containers + i;
+      FT_TS_CoverageContainer  b = coverage2->containers + j;
+
+
+      if ( a->key < b->key )
+        i++;
+      else if ( a->key > b->key )
+        j++;
+      else
+      {
+        FT_TS_CoverageContainer  c = coverage->containers +
+                                     coverage->num_containers;
+
+
+        error = ft_coverage_container_intersect( memory, a, b, c );
+        if ( error )
+          goto Exit;
+
+        if ( c->count )
+        {
+          coverage->count += c->count;
+          coverage->num_containers++;
+        }
+
+        i++;
+        j++;
+      }
+    }
+
+  Exit:
+    if ( error && coverage )
+    {
+      ft_coverage_free( coverage );
+      coverage = NULL;
+    }
+
+    *acoverage = coverage;
+    return error;
+  }
+
+
+#define FT_TS_COVERAGE_PUT_USHORT( p, v )      \
+          do                                   \
+          {                                    \
+            (p)[0] = (FT_TS_Byte)( (v) >> 8 ); \
+            (p)[1] = (FT_TS_Byte)( (v)      ); \
+            (p)   += 2;                        \
+          } while ( 0 )
+
+#define FT_TS_COVERAGE_PUT_ULONG( p, v )        \
+          do                                    \
+          {                                     \
+            (p)[0] = (FT_TS_Byte)( (v) >> 24 ); \
+            (p)[1] = (FT_TS_Byte)( (v) >> 16 ); \
+            (p)[2] = (FT_TS_Byte)( (v) >>  8 ); \
+            (p)[3] = (FT_TS_Byte)( (v)       ); \
+            (p)   += 4;                         \
+          } while ( 0 )
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Coverage_Save( FT_TS_Coverage  coverage,
+                       FT_TS_Byte*     buffer,
+                       FT_TS_ULong    *alength )
+  {
+    FT_TS_ULong  size;
+    FT_TS_UInt   n, k;
+
+
+    if ( !coverage || !alength )
+      return FT_TS_THROW( Invalid_Argument );
+
+    size = FT_TS_COVERAGE_HEADER_SIZE;
+    for ( n = 0; n < coverage->num_containers; n++ )
+    {
+      FT_TS_CoverageContainer  c = coverage->containers + n;
+
+
+      size += 4 + ( c->bits ? 4 * FT_TS_COVERAGE_BITS_WORDS
+                            : 2 * (FT_TS_ULong)c->count );
+    }
+
+    if ( buffer )
+    {
+      FT_TS_Byte*  p = buffer;
+
+
+      if ( *alength < size )
+      {
+        *alength = size;
+        return FT_TS_THROW( Invalid_Argument );
+      }
+
+      FT_TS_COVERAGE_PUT_ULONG( p, FT_TS_COVERAGE_TAG );
+      FT_TS_COVERAGE_PUT_USHORT( p, FT_TS_COVERAGE_VERSION );
+      FT_TS_COVERAGE_PUT_USHORT( p, 0 );
+      FT_TS_COVERAGE_PUT_ULONG( p, coverage->num_containers );
+
+      for ( n = 0; n < coverage->num_containers; n++ )
+      {
+        FT_TS_CoverageContainer  c = coverage->containers + n;
+
+
+        FT_TS_COVERAGE_PUT_USHORT( p, c->key );
+        FT_TS_COVERAGE_PUT_USHORT( p, c->count - 1 );
+
+        if ( c->bits )
+        {
+          for ( k = 0; k < FT_TS_COVERAGE_BITS_WORDS; k++ )
+            FT_TS_COVERAGE_PUT_ULONG( p, c->bits[k] );
+        }
+        else
+        {
+          for ( k = 0; k < c->count; k++ )
+            FT_TS_COVERAGE_PUT_USHORT( p, c->values[k] );
+        }
+      }
+    }
+
+    *alength = size;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* documentation is in ftcover.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Coverage_Load( FT_TS_Library       library,
+                       const FT_TS_Byte*  data,
+                       FT_TS_ULong        length,
+                       FT_TS_Coverage    *acoverage )
+  {
+    FT_TS_Error        error;
+    FT_TS_Memory       memory;
+    FT_TS_Coverage     coverage = NULL;
+    const FT_TS_Byte*  p        = data;
+    const FT_TS_Byte*  limit;
+    FT_TS_ULong        num_containers;
+    FT_TS_UInt         n, k;
+
+
+    if ( !library )
+      return FT_TS_THROW( Invalid_Library_Handle );
+
+    if ( !acoverage || ( !data && length ) )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *acoverage = NULL;
+
+    if ( length < FT_TS_COVERAGE_HEADER_SIZE           ||
+         FT_TS_NEXT_ULONG( p ) != FT_TS_COVERAGE_TAG    ||
+         FT_TS_NEXT_USHORT( p ) != FT_TS_COVERAGE_VERSION )
+      return FT_TS_THROW( Unknown_File_Format );
+
+    limit = data + length;
+
+    p             += 2;
+    num_containers = FT_TS_NEXT_ULONG( p );
+
+    if ( num_containers > 0x10000UL                         ||
+         num_containers > (FT_TS_ULong)( limit - p ) / 4 )
+      return FT_TS_THROW( Invalid_File_Format );
+
+    memory = library->memory;
+
+    if ( FT_TS_NEW( coverage ) )
+      goto Exit;
+
+    coverage->memory = memory;
+
+    if ( num_containers                                         &&
+         FT_TS_NEW_ARRAY( coverage->containers, num_containers ) )
+      goto Exit;
+
+    for ( n = 0; n < num_containers; n++ )
+    {
+      FT_TS_CoverageContainer  c = coverage->containers + n;
+
+
+      if ( limit - p < 4 )
+        goto Invalid;
+
+      c->key   = FT_TS_NEXT_USHORT( p );
+      c->count = FT_TS_NEXT_USHORT( p ) + 1U;
+
+      coverage->num_containers++;
+
+      if ( n > 0 && c->key <= c[-1].key )
+        goto Invalid;
+
+      if ( c->count <= FT_TS_COVERAGE_ARRAY_MAX )
+      {
+        if ( (FT_TS_ULong)( limit - p ) < 2 * (FT_TS_ULong)c->count )
+          goto Invalid;
+
+        if ( FT_TS_QNEW_ARRAY( c->values, c->count ) )
+          goto Exit;
+
+        for ( k = 0; k < c->count; k++ )
+        {
+          c->values[k] = FT_TS_NEXT_USHORT( p );
+
+          if ( k > 0 && c->values[k] <= c->values[k - 1] )
+            goto Invalid;
+        }
+      }
+      else
+      {
+        FT_TS_UInt  count = 0;
+
+
+        if ( limit - p < 4 * FT_TS_COVERAGE_BITS_WORDS )
+          goto Invalid;
+
+        if ( FT_TS_QNEW_ARRAY( c->bits, FT_TS_COVERAGE_BITS_WORDS ) )
+          goto Exit;
+
+        for ( k = 0; k < FT_TS_COVERAGE_BITS_WORDS; k++ )
+        {
+          c->bits[k] = (FT_TS_UInt32)FT_TS_NEXT_ULONG( p );
+          count     += ft_coverage_popcount( c->bits[k] );
+        }
+
+        if ( count != c->count )
+          goto Invalid;
+      }
+
+      coverage->count += c->count;
+    }
+
+    if ( p != limit )
+      goto Invalid;
+
+  Exit:
+    if ( error && coverage )
+    {
+      ft_coverage_free( coverage );
+      coverage = NULL;
+    }
+
+    *acoverage = coverage;
+    return error;
+
+  Invalid:
+    error = FT_TS_THROW( Invalid_File_Format );
+    goto Exit;
+  }
+
+
+/* END */
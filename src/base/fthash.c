@@ -335,4 +335,188 @@
   }
 
 
+  /*
+   * Return the index of the first of `count` names (as returned by
+   * `get_name`) that equals `name`, or -1 if there is none.  A string
+   * hash of all names is built in `*ahash` on the first call; the caller
+   * frees it with `ft_hash_str_free`.  Names are inserted in reverse
+   * order so that the first one of several elements with the same name
+   * wins, as with a linear search, which is used if we run out of
+   * memory.
+   */
+  FT_TS_Long
+  ft_hash_name_index( FT_TS_Hash*          ahash,
+                      const char*          name,
+                      FT_TS_UInt           count,
+                      FT_TS_Hash_NameFunc  get_name,
+                      void*                object,
+                      FT_TS_Memory         memory )
+  {
+    FT_TS_Hash   hash = *ahash;
+    FT_TS_Error  error;
+    const char*  gname;
+    size_t*      idx;
+    FT_TS_UInt   i;
+
+
+    if ( !name )
+      return -1;
+
+    if ( !hash )
+    {
+      if ( FT_TS_NEW( hash ) )
+        goto Linear;
+
+      if ( ft_hash_str_init( hash, memory ) )
+      {
+        FT_TS_FREE( hash );
+        goto Linear;
+      }
+
+      for ( i = count; i > 0; i-- )
+      {
+        gname = get_name( object, i - 1 );
+        if ( !gname )
+          continue;
+
+        if ( ft_hash_str_insert( gname, i - 1, hash, memory ) )
+        {
+          ft_hash_str_free( hash, memory );
+          FT_TS_FREE( hash );
+          goto Linear;
+        }
+      }
+
+      *ahash = hash;
+    }
+
+    idx = ft_hash_str_lookup( name, hash );
+
+    return idx ? (FT_TS_Long)*idx : -1;
+
+  Linear:
+    for ( i = 0; i < count; i++ )
+    {
+      gname = get_name( object, i );
+
+      if ( gname && !ft_strcmp( name, gname ) )
+        return (FT_TS_Long)i;
+    }
+
+    return -1;
+  }
+
+
+  FT_TS_UInt32
+  ft_hash_data( FT_TS_UInt32       hash,
+                const FT_TS_Byte*  data,
+                FT_TS_ULong        len )
+  {
+    FT_TS_ULong  step = len / 64 + 1;
+    FT_TS_ULong  i;
+
+
+    hash = ( hash ^ (FT_TS_UInt32)len ) * 16777619UL;
+
+    for ( i = 0; i < len; i += step )
+      hash = ( hash ^ data[i] ) * 16777619UL;
+
+    return hash;
+  }
+
+
+  /* Find the item for `key' and move it to the front of the list. */
+  FT_TS_MruNode
+  ft_mru_lookup( FT_TS_MruList          list,
+                 FT_TS_UInt32           hash,
+                 FT_TS_Mru_CompareFunc  compare,
+                 const void*            key )
+  {
+    FT_TS_MruNode   node;
+    FT_TS_MruNode*  pnode;
+
+
+    for ( pnode = &list->nodes; *pnode; pnode = &(*pnode)->next )
+    {
+      node = *pnode;
+
+      if ( node->hash == hash && compare( node, key ) )
+      {
+        *pnode      = node->next;
+        node->next  = list->nodes;
+        list->nodes = node;
+
+        return node;
+      }
+    }
+
+    return NULL;
+  }
+
+
+  /* Insert `node' at the front of the list, then free the least */
+  /* recently used items that don't fit into `max_size' bytes.   */
+  /* The new item itself is always kept.                         */
+  void
+  ft_mru_add( FT_TS_MruList       list,
+              FT_TS_MruNode       node,
+              FT_TS_ULong         max_size,
+              FT_TS_Mru_FreeFunc  node_free,
+              FT_TS_Memory        memory )
+  {
+    FT_TS_ULong  size;
+
+
+    node->next  = list->nodes;
+    list->nodes = node;
+
+    size = 0;
+    for ( ; node; node = node->next )
+    {
+      size += node->size;
+
+      if ( node->next && size + node->next->size > max_size )
+      {
+        FT_TS_MruNode  cur = node->next;
+
+
+        node->next = NULL;
+
+        while ( cur )
+        {
+          FT_TS_MruNode  next = cur->next;
+
+
+          node_free( cur, memory );
+          cur = next;
+        }
+      }
+    }
+
+    list->size = size;
+  }
+
+
+  void
+  ft_mru_done( FT_TS_MruList       list,
+               FT_TS_Mru_FreeFunc  node_free,
+               FT_TS_Memory        memory )
+  {
+    FT_TS_MruNode  node = list->nodes;
+
+
+    while ( node )
+    {
+      FT_TS_MruNode  next = node->next;
+
+
+      node_free( node, memory );
+      node = next;
+    }
+
+    list->nodes = NULL;
+    list->size  = 0;
+  }
+
+
 /* END */
@@ -194,6 +194,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     return error;
   }
 
@@ -229,6 +233,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     return error;
   }
 
@@ -303,6 +311,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     return error;
   }
 
@@ -379,6 +391,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     return error;
   }
 
@@ -430,6 +446,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     return error;
   }
 
@@ -554,6 +574,10 @@
       face->autohint.data = NULL;
     }
 
+    /* the coordinates no longer belong to a variation instance */
+    if ( !error )
+      face->internal->var_instance = NULL;
+
     if ( !error )
     {
       face->face_index  = ( instance_index << 16 )        |
@@ -565,4 +589,129 @@
   }
 
 
+  /* documentation is in ftmm.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_New_Var_Instance( FT_TS_Face           face,
+                          FT_TS_UInt           num_coords,
+                          FT_TS_Fixed*         coords,
+                          FT_TS_Var_Instance  *ainstance )
+  {
+    FT_TS_Error                 error;
+    FT_TS_Service_MultiMasters  service_mm = NULL;
+
+
+    /* check of `face' delayed to `ft_face_get_mm_service' */
+
+    if ( !ainstance )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *ainstance = NULL;
+
+    if ( num_coords && !coords )
+      return FT_TS_THROW( Invalid_Argument );
+
+    error = ft_face_get_mm_service( face, &service_mm );
+    if ( !error )
+    {
+      error = FT_TS_ERR( Invalid_Argument );
+      if ( service_mm->new_var_instance )
+        error = service_mm->new_var_instance( face,
+                                              num_coords,
+                                              coords,
+                                              ainstance );
+    }
+
+    return error;
+  }
+
+
+  /* documentation is in ftmm.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Set_Var_Instance( FT_TS_Face          face,
+                          FT_TS_Var_Instance  instance )
+  {
+    FT_TS_Error                      error;
+    FT_TS_Service_MultiMasters       service_mm   = NULL;
+    FT_TS_Service_MetricsVariations  service_mvar = NULL;
+
+    FT_TS_Var_Instance  active;
+
+
+    /* check of `face' delayed to `ft_face_get_mm_service' */
+
+    error = ft_face_get_mm_service( face, &service_mm );
+    if ( error )
+      return error;
+
+    if ( !instance || instance->face != face )
+      return FT_TS_THROW( Invalid_Argument );
+
+    active = face->internal->var_instance;
+    if ( instance == active )
+      return FT_TS_Err_Ok;
+
+    error = FT_TS_ERR( Invalid_Argument );
+    if ( service_mm->set_var_instance )
+      error = service_mm->set_var_instance( face, instance );
+
+    if ( error == -1 )
+      error = FT_TS_Err_Ok;
+    else if ( !error )
+    {
+      (void)ft_face_get_mvar_service( face, &service_mvar );
+
+      if ( service_mvar && service_mvar->metrics_adjust )
+        service_mvar->metrics_adjust( face );
+    }
+
+    if ( !error )
+    {
+      /* park the auto-hinting data of the previous instance, */
+      /* then take over the data of the new one (if any)      */
+      if ( active )
+        active->autohint = face->autohint;
+      else if ( face->autohint.finalizer )
+        face->autohint.finalizer( face->autohint.data );
+
+      face->autohint = instance->autohint;
+      FT_TS_ZERO( &instance->autohint );
+
+      face->internal->var_instance = instance;
+    }
+
+    return error;
+  }
+
+
+  /* documentation is in ftmm.h */
+
+  FT_TS_EXPORT_DEF( void )
+  FT_TS_Done_Var_Instance( FT_TS_Var_Instance  instance )
+  {
+    FT_TS_Face                  face;
+    FT_TS_Service_MultiMasters  service_mm = NULL;
+
+
+    if ( !instance )
+      return;
+
+    face = instance->face;
+
+    if ( face->internal->var_instance == instance )
+      face->internal->var_instance = NULL;
+
+    if ( instance->autohint.finalizer )
+    {
+      instance->autohint.finalizer( instance->autohint.data );
+      instance->autohint.data = NULL;
+    }
+
+    if ( !ft_face_get_mm_service( face, &service_mm ) &&
+         service_mm->done_var_instance                )
+      service_mm->done_var_instance( instance );
+  }
+
+
 /* END */
@@ -1185,6 +1185,18 @@
     if ( driver->clazz->done_size )
       driver->clazz->done_size( size );
 
+    /* release the advance cache of `FT_TS_Get_Advances' */
+    if ( size->internal )
+    {
+      FT_TS_Size_Internal  internal = size->internal;
+      FT_TS_UInt           n;
+
+
+      for ( n = 0; n < internal->num_advance_pages; n++ )
+        FT_TS_FREE( internal->advance_pages[n] );
+      FT_TS_FREE( internal->advance_pages );
+    }
+
     FT_TS_FREE( size->internal );
     FT_TS_FREE( size );
   }
@@ -1265,6 +1277,9 @@
     /* get rid of it */
     if ( face->internal )
     {
+#ifdef FT_TS_COLRV1_RENDERING
+      ft_face_done_colr( face );
+#endif
       FT_TS_FREE( face->internal );
     }
     FT_TS_FREE( face );
@@ -3829,6 +3844,53 @@
   }
 
 
+  /* documentation is in freetype.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Get_Char_Indices( FT_TS_Face           face,
+                       const FT_TS_UInt32*  charcodes,
+                       FT_TS_UInt           count,
+                       FT_TS_UInt*          gindices )
+  {
+    FT_TS_CMap  cmap;
+    FT_TS_UInt  num_glyphs;
+    FT_TS_UInt  n;
+
+
+    if ( !face )
+      return FT_TS_THROW( Invalid_Face_Handle );
+
+    if ( !count )
+      return FT_TS_Err_Ok;
+
+    if ( !charcodes || !gindices )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( !face->charmap )
+    {
+      FT_TS_MEM_ZERO( gindices, count * sizeof ( *gindices ) );
+      return FT_TS_Err_Ok;
+    }
+
+    cmap       = FT_TS_CMAP( face->charmap );
+    num_glyphs = (FT_TS_UInt)face->num_glyphs;
+
+    if ( cmap->clazz->char_indices )
+      cmap->clazz->char_indices( cmap, charcodes, count, gindices );
+    else
+    {
+      for ( n = 0; n < count; n++ )
+        gindices[n] = cmap->clazz->char_index( cmap, charcodes[n] );
+    }
+
+    for ( n = 0; n < count; n++ )
+      if ( gindices[n] >= num_glyphs )
+        gindices[n] = 0;
+
+    return FT_TS_Err_Ok;
+  }
+
+
   /* documentation is in freetype.h */
 
   FT_TS_EXPORT_DEF( FT_TS_ULong )
@@ -4641,6 +4703,14 @@
         FT_TS_UInt  color_index;
 
 
+#ifdef FT_TS_COLRV1_RENDERING
+        /* 'COLR' v1 paint graphs take precedence over v0 layers; */
+        /* both are handled here, the code below is a fallback    */
+        if ( slot->format != FT_TS_GLYPH_FORMAT_BITMAP &&
+             !ft_glyphslot_render_colr( slot )         )
+          return FT_TS_Err_Ok;
+#endif
+
         /* check whether we have colored glyph layers */
         iterator.p  = NULL;
         have_layers = FT_TS_Get_Color_Glyph_Layer( face,
@@ -247,6 +247,18 @@ FT_TS_BEGIN_HEADER
   bdf_get_font_property( bdf_font_t*  font,
                          const char*  name );
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+
+  FT_TS_LOCAL( FT_TS_Error )
+  bdf_compact_font( bdf_font_t*    font,
+                    bdf_font_t*   *acompact,
+                    FT_TS_ULong   *asize );
+
+  FT_TS_LOCAL( void )
+  bdf_free_compact_font( bdf_font_t*  font );
+
+#endif
+
 
 FT_TS_END_HEADER
 
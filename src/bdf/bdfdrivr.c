@@ -203,7 +203,7 @@ THE SOFTWARE.
     bdf_cmap_char_index,
     bdf_cmap_char_next,
 
-    NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL
   };
 
 
@@ -318,6 +318,157 @@ THE SOFTWARE.
   }
 
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+
+  /*
+   * The font cache maps the data of a BDF font to a compact copy of the
+   * parsed font (see `bdf_compact_font').  Each entry keeps a copy of
+   * the data it was parsed from; a hash of the data only preselects the
+   * entries whose data gets compared byte by byte.
+   *
+   * Every face using a cached font holds a reference to its entry, as
+   * does the cache itself.  The font is freed when the last reference is
+   * gone.
+   */
+
+  typedef struct  BDF_CacheEntryRec_
+  {
+    FT_TS_MruNodeRec  node;
+
+    FT_TS_Memory      memory;
+    FT_TS_ULong       ref_count;
+
+    FT_TS_Byte*       key;          /* a copy of the BDF data */
+    FT_TS_ULong       key_len;
+
+    bdf_font_t*       font;         /* a compact font         */
+    FT_TS_ULong       font_len;     /* memory used by `font'  */
+
+  } BDF_CacheEntryRec;
+
+
+  /* the BDF data, as looked for by `bdf_cache_compare' */
+  typedef struct  BDF_CacheKeyRec_
+  {
+    const FT_TS_Byte*  data;
+    FT_TS_ULong        len;
+
+  } BDF_CacheKeyRec;
+
+
+  static FT_TS_Bool
+  bdf_cache_compare( FT_TS_MruNode  node,
+                     const void*    key_ )
+  {
+    BDF_CacheEntry          entry = (BDF_CacheEntry)node;
+    const BDF_CacheKeyRec*  key   = (const BDF_CacheKeyRec*)key_;
+
+
+    return entry->key_len == key->len                         &&
+           ft_memcmp( entry->key, key->data, key->len ) == 0;
+  }
+
+
+  static void
+  bdf_cache_entry_release( BDF_CacheEntry  entry )
+  {
+    FT_TS_Memory  memory = entry->memory;
+
+
+    if ( --entry->ref_count == 0 )
+    {
+      bdf_free_compact_font( entry->font );
+      FT_TS_FREE( entry );
+    }
+  }
+
+
+  /* Remove an entry from the cache; it must already be unlinked. */
+  static void
+  bdf_cache_entry_discard( FT_TS_MruNode  node,
+                           FT_TS_Memory   memory )
+  {
+    BDF_CacheEntry  entry = (BDF_CacheEntry)node;
+
+
+    /* the data is only needed to find the entry */
+    FT_TS_FREE( entry->key );
+    entry->key_len = 0;
+
+    bdf_cache_entry_release( entry );
+  }
+
+
+  /* Add the compact font `font' for `data' to the cache.  The new entry */
+  /* takes over `*pkey' if it is not NULL (and holds `data'); otherwise, */
+  /* it gets a copy of `data'.  On success, the entry also owns `font'.  */
+  static BDF_CacheEntry
+  bdf_cache_add( BDF_Cache          cache,
+                 bdf_font_t*        font,
+                 FT_TS_ULong        font_len,
+                 const FT_TS_Byte*  data,
+                 FT_TS_ULong        data_len,
+                 FT_TS_Byte**       pkey,
+                 FT_TS_UInt32       hash )
+  {
+    FT_TS_Memory  memory = font->memory;
+    FT_TS_Error   error;
+
+    BDF_CacheEntry  entry;
+    FT_TS_ULong     size;
+
+
+    size = sizeof ( BDF_CacheEntryRec ) + data_len + font_len;
+    if ( size > BDF_CONFIG_FONT_CACHE_MAX_SIZE )
+      return NULL;
+
+    if ( FT_TS_QNEW( entry ) )
+      return NULL;
+
+    if ( *pkey )
+    {
+      entry->key = *pkey;
+      *pkey      = NULL;
+    }
+    else
+    {
+      if ( FT_TS_QALLOC( entry->key, data_len ) )
+      {
+        FT_TS_FREE( entry );
+        return NULL;
+      }
+
+      FT_TS_MEM_COPY( entry->key, data, data_len );
+    }
+
+    entry->node.hash = hash;
+    entry->node.size = size;
+    entry->memory    = memory;
+    entry->ref_count = 1;
+    entry->key_len   = data_len;
+    entry->font      = font;
+    entry->font_len  = font_len;
+
+    ft_mru_add( cache,
+                &entry->node,
+                BDF_CONFIG_FONT_CACHE_MAX_SIZE,
+                bdf_cache_entry_discard,
+                memory );
+
+    return entry;
+  }
+
+
+  static void
+  bdf_cache_done( BDF_Cache     cache,
+                  FT_TS_Memory  memory )
+  {
+    ft_mru_done( cache, bdf_cache_entry_discard, memory );
+  }
+
+#endif /* BDF_CONFIG_OPTION_FONT_CACHE */
+
+
   FT_TS_CALLBACK_DEF( void )
   BDF_Face_Done( FT_TS_Face  bdfface )         /* BDF_Face */
   {
@@ -330,6 +481,16 @@ THE SOFTWARE.
 
     memory = FT_TS_FACE_MEMORY( face );
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    if ( face->cache_entry )
+    {
+      bdf_cache_entry_release( face->cache_entry );
+
+      face->cache_entry = NULL;
+      face->bdffont     = NULL;
+    }
+#endif
+
     bdf_free_font( face->bdffont );
 
     FT_TS_FREE( face->en_table );
@@ -359,6 +520,15 @@ THE SOFTWARE.
     bdf_font_t*    font = NULL;
     bdf_options_t  options;
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    BDF_Cache          cache    = NULL;
+    BDF_CacheEntry     entry;
+    FT_TS_Byte*        key      = NULL;
+    const FT_TS_Byte*  key_data = NULL;
+    FT_TS_UInt32       hash     = 0;
+    FT_TS_StreamRec    key_stream;
+#endif
+
     FT_TS_UNUSED( num_params );
     FT_TS_UNUSED( params );
 
@@ -373,6 +543,74 @@ THE SOFTWARE.
     options.keep_comments   = 0;
     options.font_spacing    = BDF_PROPORTIONAL;
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    /* the cache key is computed from the complete BDF data; to avoid */
+    /* reading other files completely, it must start with `STARTFONT' */
+    if ( stream->size >= 9 )
+    {
+      if ( !stream->read )
+      {
+        if ( ft_memcmp( stream->base, "STARTFONT", 9 ) == 0 )
+          key_data = stream->base;
+      }
+      else if ( stream->size <= BDF_CONFIG_FONT_CACHE_MAX_SIZE )
+      {
+        /* the copy read for this is also parsed; limit its size */
+        FT_TS_Byte  start[9];
+
+
+        if ( FT_TS_STREAM_READ( start, 9 ) ||
+             FT_TS_STREAM_SEEK( 0 )        )
+          goto Exit;
+
+        if ( ft_memcmp( start, "STARTFONT", 9 ) == 0 )
+        {
+          if ( FT_TS_QALLOC( key, stream->size )      ||
+               FT_TS_STREAM_READ( key, stream->size ) )
+            goto Exit;
+
+          key_data = key;
+        }
+      }
+    }
+
+    if ( key_data )
+    {
+      BDF_CacheKeyRec  cache_key;
+
+
+      cache = &( (BDF_Driver)FT_TS_FACE_DRIVER( face ) )->font_cache;
+
+      cache_key.data = key_data;
+      cache_key.len  = stream->size;
+
+      hash  = ft_hash_data( 2166136261UL, key_data, stream->size );
+      entry = (BDF_CacheEntry)ft_mru_lookup( cache,
+                                             hash,
+                                             bdf_cache_compare,
+                                             &cache_key );
+      if ( entry )
+      {
+        FT_TS_TRACE2(( "  using cached font\n" ));
+
+        entry->ref_count++;
+        face->cache_entry = entry;
+
+        font = entry->font;
+        goto Face;
+      }
+
+      /* parse the data already read into memory */
+      if ( key )
+      {
+        FT_TS_Stream_OpenMemory( &key_stream, key, stream->size );
+        key_stream.memory = memory;
+
+        stream = &key_stream;
+      }
+    }
+#endif /* BDF_CONFIG_OPTION_FONT_CACHE */
+
     error = bdf_load_font( stream, memory, &options, &font );
     if ( FT_TS_ERR_EQ( error, Missing_Startfont_Field ) )
     {
@@ -382,6 +620,41 @@ THE SOFTWARE.
     else if ( error )
       goto Exit;
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    if ( cache )
+    {
+      bdf_font_t*  compact     = NULL;
+      FT_TS_ULong  compact_len = 0;
+
+
+      /* all faces opened from the same data share the compact font */
+      if ( !bdf_compact_font( font, &compact, &compact_len ) )
+      {
+        entry = bdf_cache_add( cache,
+                               compact,
+                               compact_len,
+                               key_data,
+                               stream->size,
+                               &key,
+                               hash );
+        if ( entry )
+        {
+          bdf_free_font( font );
+          FT_TS_FREE( font );
+
+          entry->ref_count++;
+          face->cache_entry = entry;
+
+          font = compact;
+        }
+        else
+          bdf_free_compact_font( compact );
+      }
+    }
+
+  Face:
+#endif /* BDF_CONFIG_OPTION_FONT_CACHE */
+
     /* we have a bdf font: let's construct the face object */
     face->bdffont = font;
 
@@ -395,7 +668,8 @@ THE SOFTWARE.
     {
       FT_TS_ERROR(( "BDF_Face_Init: invalid face index\n" ));
       BDF_Face_Done( bdfface );
-      return FT_TS_THROW( Invalid_Argument );
+      error = FT_TS_THROW( Invalid_Argument );
+      goto Exit;
     }
 
     {
@@ -716,11 +990,15 @@ THE SOFTWARE.
     }
 
   Exit:
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    FT_TS_FREE( key );
+#endif
     return error;
 
   Fail:
     BDF_Face_Done( bdfface );
-    return FT_TS_THROW( Unknown_File_Format );
+    error = FT_TS_THROW( Unknown_File_Format );
+    goto Exit;
   }
 
 
@@ -962,6 +1240,17 @@ THE SOFTWARE.
   };
 
 
+  FT_TS_CALLBACK_DEF( void )
+  bdf_driver_done( FT_TS_Module  module )
+  {
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    bdf_cache_done( &( (BDF_Driver)module )->font_cache, module->memory );
+#else
+    FT_TS_UNUSED( module );
+#endif
+  }
+
+
   FT_TS_CALLBACK_DEF( FT_TS_Module_Interface )
   bdf_driver_requester( FT_TS_Module    module,
                         const char*  name )
@@ -979,7 +1268,7 @@ THE SOFTWARE.
     {
       FT_TS_MODULE_FONT_DRIVER         |
       FT_TS_MODULE_DRIVER_NO_OUTLINES,
-      sizeof ( FT_TS_DriverRec ),
+      sizeof ( BDF_DriverRec ),
 
       "bdf",
       0x10000L,
@@ -988,7 +1277,7 @@ THE SOFTWARE.
       NULL,    /* module-specific interface */
 
       NULL,                     /* FT_TS_Module_Constructor  module_init   */
-      NULL,                     /* FT_TS_Module_Destructor   module_done   */
+      bdf_driver_done,          /* FT_TS_Module_Destructor   module_done   */
       bdf_driver_requester      /* FT_TS_Module_Requester    get_interface */
     },
 
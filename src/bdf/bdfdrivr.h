@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define BDFDRIVR_H_
 
 #include <freetype/internal/ftdrv.h>
+#include <freetype/internal/fthash.h>
 
 #include "bdf.h"
 
@@ -44,6 +45,28 @@ FT_TS_BEGIN_HEADER
   } BDF_encoding_el;
 
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+
+  typedef struct BDF_CacheEntryRec_*  BDF_CacheEntry;
+
+  /* the cache of parsed fonts, owned by the `bdf' driver */
+  typedef FT_TS_MruListRec  BDF_CacheRec;
+  typedef FT_TS_MruList     BDF_Cache;
+
+#endif /* BDF_CONFIG_OPTION_FONT_CACHE */
+
+
+  typedef struct  BDF_DriverRec_
+  {
+    FT_TS_DriverRec  root;
+
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    BDF_CacheRec     font_cache;
+#endif
+
+  } BDF_DriverRec, *BDF_Driver;
+
+
   typedef struct  BDF_FaceRec_
   {
     FT_TS_FaceRec        root;
@@ -57,6 +80,10 @@ FT_TS_BEGIN_HEADER
 
     FT_TS_UInt           default_glyph;
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+    BDF_CacheEntry    cache_entry;   /* owner of `bdffont' if not NULL */
+#endif
+
   } BDF_FaceRec, *BDF_Face;
 
 
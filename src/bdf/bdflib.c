@@ -171,9 +171,11 @@
   /* An auxiliary macro to parse properties, to be used in conditionals. */
   /* It behaves like `strncmp' but also tests the following character    */
   /* whether it is a whitespace or null.                                 */
-  /* `property' is a constant string of length `n' to compare with.      */
+  /* `property' is a constant string of length `n' to compare with; its  */
+  /* first character is tested inline to avoid most `strncmp' calls.     */
 #define _bdf_strncmp( name, property, n )      \
-          ( ft_strncmp( name, property, n ) || \
+          ( name[0] != property[0]          || \
+            ft_strncmp( name, property, n ) || \
             !( name[n] == ' '  ||              \
                name[n] == '\0' ||              \
                name[n] == '\n' ||              \
@@ -1291,7 +1293,7 @@
                      void*          call_data,
                      void*          client_data )
   {
-    int                c, mask_index;
+    int                c, d, mask_index;
     char*              s;
     unsigned char*     bp;
     unsigned long      i, slen, nibbles;
@@ -1313,6 +1315,19 @@
     font   = p->font;
     memory = font->memory;
 
+    /* Bitmap rows are by far the most frequent lines, so handle them */
+    /* before testing any keyword.  All keywords checked below have a */
+    /* non-hexadecimal character within their first two bytes.        */
+    if ( ( p->flags & BDF_BITMAP_ )  &&
+         sbitset( hdigits, line[0] ) &&
+         sbitset( hdigits, line[1] ) )
+    {
+      if ( p->glyph_enc == -1 && p->opts->keep_unencoded == 0 )
+        goto Exit;
+
+      goto Glyph_Data;
+    }
+
     /* Check for a comment. */
     if ( _bdf_strncmp( line, "COMMENT", 7 ) == 0 )
     {
@@ -1553,6 +1568,7 @@
     if ( !( p->flags & BDF_ENCODING_ ) )
       goto Missing_Encoding;
 
+  Glyph_Data:
     /* Point at the glyph being constructed. */
     if ( p->glyph_enc == -1 )
       glyph = font->unencoded + ( font->unencoded_used - 1 );
@@ -1580,14 +1596,25 @@
       nibbles = glyph->bpr << 1;
       bp      = glyph->bitmap + p->row * glyph->bpr;
 
-      for ( i = 0; i < nibbles; i++ )
+      /* Decode two nibbles at a time; `nibbles' is always even.  A */
+      /* single trailing nibble ends up in the lower half of a byte. */
+      for ( i = 0; i < nibbles; i += 2 )
       {
         c = line[i];
         if ( !sbitset( hdigits, c ) )
           break;
-        *bp = (FT_TS_Byte)( ( *bp << 4 ) + a2i[c] );
-        if ( i + 1 < nibbles && ( i & 1 ) )
-          *++bp = 0;
+
+        d = line[i + 1];
+        if ( !sbitset( hdigits, d ) )
+        {
+          *bp = a2i[c];
+          i++;
+          break;
+        }
+
+        *bp = (FT_TS_Byte)( ( a2i[c] << 4 ) + a2i[d] );
+        if ( i + 2 < nibbles )
+          bp++;
       }
 
       /* If any line has not enough columns,            */
@@ -2371,6 +2398,223 @@
   }
 
 
+#ifdef BDF_CONFIG_OPTION_FONT_CACHE
+
+  /* Copy string `s' to `*acur' and advance `*acur'. */
+  static char*
+  _bdf_copy_string( FT_TS_Byte*  *acur,
+                    const char*   s )
+  {
+    char*   d   = (char*)*acur;
+    size_t  len = ft_strlen( s ) + 1;
+
+
+    FT_TS_MEM_COPY( d, s, len );
+    *acur += len;
+
+    return d;
+  }
+
+
+  /* Copy the bitmaps and names of `count' glyphs to `*acur'. */
+  static void
+  _bdf_copy_glyphs( bdf_glyph_t*   glyph,
+                    unsigned long  count,
+                    FT_TS_Byte*   *acur )
+  {
+    unsigned long  i;
+
+
+    for ( i = 0; i < count; i++, glyph++ )
+    {
+      if ( glyph->bitmap )
+      {
+        FT_TS_MEM_COPY( *acur, glyph->bitmap, glyph->bytes );
+        glyph->bitmap = *acur;
+        *acur        += glyph->bytes;
+      }
+
+      if ( glyph->name )
+        glyph->name = _bdf_copy_string( acur, glyph->name );
+    }
+  }
+
+
+  /* Return the memory needed for the bitmaps and names of `count' glyphs. */
+  static FT_TS_ULong
+  _bdf_glyphs_size( bdf_glyph_t*   glyph,
+                    unsigned long  count )
+  {
+    FT_TS_ULong    size = 0;
+    unsigned long  i;
+
+
+    for ( i = 0; i < count; i++, glyph++ )
+    {
+      if ( glyph->bitmap )
+        size += glyph->bytes;
+      if ( glyph->name )
+        size += ft_strlen( glyph->name ) + 1;
+    }
+
+    return size;
+  }
+
+
+  /*
+   * Create a compact copy of a loaded font: the font record, the glyph
+   * and property arrays, all bitmaps, and all strings share a single
+   * memory block; only the hash table of property names is separate.
+   * The copy must be freed with `bdf_free_compact_font'.  `*asize' is
+   * set to the memory it uses.
+   */
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  bdf_compact_font( bdf_font_t*    font,
+                    bdf_font_t*   *acompact,
+                    FT_TS_ULong   *asize )
+  {
+    FT_TS_Memory     memory  = font->memory;
+    FT_TS_Error      error;
+
+    bdf_font_t*      compact = NULL;
+    FT_TS_Hash       hash;
+    bdf_property_t*  prop;
+    FT_TS_Byte*      cur;
+    FT_TS_ULong      size;
+    unsigned long    i;
+
+
+    size = sizeof ( bdf_font_t )                         +
+           font->glyphs_size    * sizeof ( bdf_glyph_t ) +
+           font->unencoded_used * sizeof ( bdf_glyph_t ) +
+           font->props_used     * sizeof ( bdf_property_t );
+
+    size += _bdf_glyphs_size( font->glyphs, font->glyphs_used );
+    size += _bdf_glyphs_size( font->unencoded, font->unencoded_used );
+
+    for ( i = 0, prop = font->props; i < font->props_used; i++, prop++ )
+    {
+      if ( !prop->builtin )
+        size += ft_strlen( prop->name ) + 1;
+      if ( prop->format == BDF_ATOM && prop->value.atom )
+        size += ft_strlen( prop->value.atom ) + 1;
+    }
+
+    if ( font->name )
+      size += ft_strlen( font->name ) + 1;
+    size += font->comments_len;
+
+    if ( FT_TS_QALLOC( compact, size ) )
+      goto Exit;
+
+    *compact = *font;
+    cur      = (FT_TS_Byte*)( compact + 1 );
+
+    /* the arrays */
+    compact->glyphs = (bdf_glyph_t*)cur;
+    FT_TS_MEM_COPY( compact->glyphs, font->glyphs,
+                    font->glyphs_size * sizeof ( bdf_glyph_t ) );
+    cur += font->glyphs_size * sizeof ( bdf_glyph_t );
+
+    compact->unencoded_size = font->unencoded_used;
+    compact->unencoded      = (bdf_glyph_t*)cur;
+    if ( font->unencoded_used )
+      FT_TS_MEM_COPY( compact->unencoded, font->unencoded,
+                      font->unencoded_used * sizeof ( bdf_glyph_t ) );
+    cur += font->unencoded_used * sizeof ( bdf_glyph_t );
+
+    compact->props_size = font->props_used;
+    compact->props      = (bdf_property_t*)cur;
+    if ( font->props_used )
+      FT_TS_MEM_COPY( compact->props, font->props,
+                      font->props_used * sizeof ( bdf_property_t ) );
+    cur += font->props_used * sizeof ( bdf_property_t );
+
+    /* bitmaps and strings */
+    _bdf_copy_glyphs( compact->glyphs, compact->glyphs_used, &cur );
+    _bdf_copy_glyphs( compact->unencoded, compact->unencoded_used, &cur );
+
+    for ( i = 0, prop = compact->props; i < compact->props_used; i++, prop++ )
+    {
+      if ( !prop->builtin )
+        prop->name = _bdf_copy_string( &cur, prop->name );
+      if ( prop->format == BDF_ATOM && prop->value.atom )
+        prop->value.atom = _bdf_copy_string( &cur, prop->value.atom );
+    }
+
+    if ( font->name )
+      compact->name = _bdf_copy_string( &cur, font->name );
+
+    if ( font->comments_len )
+    {
+      compact->comments = (char*)cur;
+      FT_TS_MEM_COPY( compact->comments, font->comments,
+                      font->comments_len );
+    }
+
+    /* user properties are only needed while parsing */
+    compact->user_props  = NULL;
+    compact->nuser_props = 0;
+    FT_TS_ZERO( &compact->proptbl );
+
+    /* the hash table of property names, as set up by `_bdf_add_property' */
+    compact->internal = NULL;
+    if ( FT_TS_NEW( hash ) )
+      goto Fail;
+
+    compact->internal = hash;
+
+    error = ft_hash_str_init( hash, memory );
+    if ( error )
+      goto Fail;
+
+    for ( i = 0, prop = compact->props; i < compact->props_used; i++, prop++ )
+    {
+      if ( _bdf_strncmp( prop->name, "COMMENT", 7 ) != 0 )
+      {
+        error = ft_hash_str_insert( prop->name, i, hash, memory );
+        if ( error )
+          goto Fail;
+      }
+    }
+
+    *acompact = compact;
+    *asize    = size + sizeof ( FT_TS_HashRec )                  +
+                  hash->size * sizeof ( FT_TS_Hashnode )         +
+                  hash->used * sizeof ( FT_TS_HashnodeRec );
+
+  Exit:
+    return error;
+
+  Fail:
+    bdf_free_compact_font( compact );
+    goto Exit;
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  bdf_free_compact_font( bdf_font_t*  font )
+  {
+    FT_TS_Memory  memory;
+
+
+    if ( font == NULL )
+      return;
+
+    memory = font->memory;
+
+    if ( font->internal )
+    {
+      ft_hash_str_free( (FT_TS_Hash)font->internal, memory );
+      FT_TS_FREE( font->internal );
+    }
+
+    FT_TS_FREE( font );
+  }
+
+#endif /* BDF_CONFIG_OPTION_FONT_CACHE */
+
+
   FT_TS_LOCAL_DEF( bdf_property_t * )
   bdf_get_font_property( bdf_font_t*  font,
                          const char*  name )
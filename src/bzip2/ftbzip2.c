@@ -107,6 +107,13 @@
     FT_TS_Byte*   cursor;
     FT_TS_Byte*   limit;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Bool    use_cache;       /* cleared if the output gets too large */
+    FT_TS_Byte*   cache;           /* all output produced so far           */
+    FT_TS_ULong   cache_size;      /* number of bytes in `cache'           */
+    FT_TS_ULong   cache_max;       /* allocated size of `cache'            */
+#endif
+
   } FT_TS_BZip2FileRec, *FT_TS_BZip2File;
 
 
@@ -154,6 +161,13 @@
     zip->cursor = zip->limit;
     zip->pos    = 0;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    zip->use_cache  = TRUE;
+    zip->cache      = NULL;
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
+
     /* check .bz2 header */
     {
       stream = source;
@@ -188,6 +202,14 @@
   {
     bz_stream*  bzstream = &zip->bzstream;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Memory  memory = zip->memory;
+
+
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
 
     BZ2_bzDecompressEnd( bzstream );
 
@@ -229,6 +251,11 @@
       zip->cursor = zip->limit;
       zip->pos    = 0;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+      /* the cache gets refilled from the start */
+      zip->cache_size = 0;
+#endif
+
       BZ2_bzDecompressInit( bzstream, 0, 0 );
     }
 
@@ -236,6 +263,58 @@
   }
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+
+  /* Append the output buffer's content to the cache; give up caching */
+  /* if it gets too large or we run out of memory.                    */
+  static void
+  ft_bzip2_file_cache_output( FT_TS_BZip2File  zip )
+  {
+    FT_TS_Memory  memory = zip->memory;
+    FT_TS_ULong   count  = (FT_TS_ULong)( zip->limit - zip->cursor );
+    FT_TS_Error   error;
+
+
+    if ( !zip->use_cache || count == 0 )
+      return;
+
+    if ( zip->cache_size + count > zip->cache_max )
+    {
+      FT_TS_ULong  new_max = zip->cache_max;
+
+
+      if ( zip->cache_size + count >
+             FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        goto Fail;
+
+      if ( new_max < 4 * FT_TS_BZIP2_BUFFER_SIZE )
+        new_max = 4 * FT_TS_BZIP2_BUFFER_SIZE;
+      while ( new_max < zip->cache_size + count )
+        new_max += new_max >> 1;
+      if ( new_max > FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        new_max = FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE;
+
+      if ( FT_TS_QREALLOC( zip->cache, zip->cache_max, new_max ) )
+        goto Fail;
+
+      zip->cache_max = new_max;
+    }
+
+    FT_TS_MEM_COPY( zip->cache + zip->cache_size, zip->cursor, count );
+    zip->cache_size += count;
+
+    return;
+
+  Fail:
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+    zip->use_cache  = FALSE;
+  }
+
+#endif /* FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE */
+
+
   static FT_TS_Error
   ft_bzip2_file_fill_input( FT_TS_BZip2File  zip )
   {
@@ -317,6 +396,10 @@
       }
     }
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    ft_bzip2_file_cache_output( zip );
+#endif
+
     return error;
   }
 
@@ -363,6 +446,29 @@
     FT_TS_Error  error;
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    /* The cache holds everything decompressed so far; the rest */
+    /* comes from the current decompression position, which is  */
+    /* never before the end of the cache.                       */
+    if ( pos < zip->cache_size && count > 0 )
+    {
+      FT_TS_ULong  delta = zip->cache_size - pos;
+
+
+      if ( delta > count )
+        delta = count;
+
+      FT_TS_MEM_COPY( buffer, zip->cache + pos, delta );
+      buffer += delta;
+      result += delta;
+      pos    += delta;
+      count  -= delta;
+
+      if ( count == 0 )
+        goto Exit;
+    }
+#endif
+
     /* Reset inflate stream if we're seeking backwards.        */
     /* Yes, that is not too efficient, but it saves memory :-) */
     if ( pos < zip->pos )
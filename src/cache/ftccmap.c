@@ -188,6 +188,58 @@
   }
 
 
+  /* fill all unknown glyph indices of `node' with a single charmap query */
+  static FT_TS_Error
+  ftc_cmap_node_fill( FTC_CMapNode  node,
+                      FTC_Cache     cache,
+                      FT_TS_UInt    cmap_index,
+                      FT_TS_Bool    no_cmap_change )
+  {
+    FT_TS_Face    face;
+    FT_TS_Error   error;
+    FT_TS_UInt32  char_codes[FTC_CMAP_INDICES_MAX];
+    FT_TS_UInt    gindices[FTC_CMAP_INDICES_MAX];
+    FT_TS_UInt    nn;
+
+
+    error = FTC_Manager_LookupFace( cache->manager, node->face_id, &face );
+    if ( error )
+      return error;
+
+    FT_TS_ARRAY_ZERO( gindices, FTC_CMAP_INDICES_MAX );
+
+    if ( cmap_index < (FT_TS_UInt)face->num_charmaps )
+    {
+      FT_TS_CharMap  old, cmap;
+
+
+      old  = face->charmap;
+      cmap = face->charmaps[cmap_index];
+
+      if ( old != cmap && !no_cmap_change )
+        FT_TS_Set_Charmap( face, cmap );
+
+      for ( nn = 0; nn < FTC_CMAP_INDICES_MAX; nn++ )
+        char_codes[nn] = node->first + nn;
+
+      error = FT_TS_Get_Char_Indices( face, char_codes,
+                                   FTC_CMAP_INDICES_MAX, gindices );
+
+      if ( old != cmap && !no_cmap_change )
+        FT_TS_Set_Charmap( face, old );
+
+      if ( error )
+        return error;
+    }
+
+    for ( nn = 0; nn < FTC_CMAP_INDICES_MAX; nn++ )
+      if ( node->indices[nn] == FTC_CMAP_UNKNOWN )
+        node->indices[nn] = (FT_TS_UShort)gindices[nn];
+
+    return FT_TS_Err_Ok;
+  }
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*****                                                               *****/
@@ -322,4 +374,96 @@
   }
 
 
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_CMapCache_LookupIndices( FTC_CMapCache        cmap_cache,
+                               FTC_FaceID           face_id,
+                               FT_TS_Int            cmap_index,
+                               const FT_TS_UInt32*  char_codes,
+                               FT_TS_UInt           count,
+                               FT_TS_UInt*          gindices )
+  {
+    FTC_Cache         cache = FTC_CACHE( cmap_cache );
+    FTC_CMapQueryRec  query;
+    FTC_CMapNode      node  = NULL;
+    FT_TS_Error       error = FT_TS_Err_Ok;
+    FT_TS_Bool        no_cmap_change = 0;
+    FT_TS_UInt        n;
+
+
+    if ( cmap_index < 0 )
+    {
+      /* see `FTC_CMapCache_Lookup' */
+      no_cmap_change = 1;
+      cmap_index     = 0;
+    }
+
+    if ( !cache )
+      return FT_TS_THROW( Invalid_Cache_Handle );
+
+    if ( !count )
+      return FT_TS_Err_Ok;
+
+    if ( !char_codes || !gindices )
+      return FT_TS_THROW( Invalid_Argument );
+
+    query.face_id    = face_id;
+    query.cmap_index = (FT_TS_UInt)cmap_index;
+
+    for ( n = 0; n < count; n++ )
+    {
+      FT_TS_UInt32  char_code = char_codes[n];
+      FT_TS_UInt    gindex;
+
+
+      /* consecutive characters usually share a node, */
+      /* so we can avoid the hash table lookup        */
+      if ( !node || char_code - node->first >= FTC_CMAP_INDICES_MAX )
+      {
+        FTC_Node      ftcnode;
+        FT_TS_Offset  hash;
+
+
+        query.char_code = char_code;
+        hash = FTC_CMAP_HASH( face_id, (FT_TS_UInt)cmap_index, char_code );
+
+        FTC_CACHE_LOOKUP_CMP( cache, ftc_cmap_node_compare, hash, &query,
+                              ftcnode, error );
+        if ( error )
+          goto Exit;
+
+        node = FTC_CMAP_NODE( ftcnode );
+
+        /* something rotten can happen with rogue clients */
+        if ( char_code - node->first >= FTC_CMAP_INDICES_MAX )
+        {
+          error = FT_TS_THROW( Invalid_Cache_Handle );
+          goto Exit;
+        }
+      }
+
+      gindex = node->indices[char_code - node->first];
+      if ( gindex == FTC_CMAP_UNKNOWN )
+      {
+        error = ftc_cmap_node_fill( node, cache,
+                                    (FT_TS_UInt)cmap_index, no_cmap_change );
+        if ( error )
+          goto Exit;
+
+        gindex = node->indices[char_code - node->first];
+      }
+
+      gindices[n] = gindex;
+    }
+
+  Exit:
+    /* don't leave garbage in the output array */
+    for ( ; n < count; n++ )
+      gindices[n] = 0;
+
+    return error;
+  }
+
+
 /* END */
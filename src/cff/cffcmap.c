@@ -117,7 +117,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   )
 
 
@@ -224,7 +226,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   )
 
 
@@ -379,20 +379,31 @@
   }
 
 
+  static const char*
+  cff_get_glyph_name_string( void*       object,
+                             FT_TS_UInt  idx )
+  {
+    CFF_Font      cff = (CFF_Font)object;
+    FT_TS_UShort  sid = cff->charset.sids[idx];
+
+
+    if ( sid > 390 )
+      return cff_index_get_string( cff, sid - 391 );
+    else
+      return cff->psnames->adobe_std_strings( sid );
+  }
+
+
   static FT_TS_UInt
   cff_get_name_index( CFF_Face          face,
                       const FT_TS_String*  glyph_name )
   {
-    CFF_Font            cff;
-    CFF_Charset         charset;
+    CFF_Font               cff;
     FT_TS_Service_PsCMaps  psnames;
-    FT_TS_String*          name;
-    FT_TS_UShort           sid;
-    FT_TS_UInt             i;
+    FT_TS_Long             idx;
 
 
-    cff     = (CFF_FontRec *)face->extra.data;
-    charset = &cff->charset;
+    cff = (CFF_FontRec *)face->extra.data;
 
     /* CFF2 table does not have glyph names; */
     /* we need to use `post' table method    */
@@ -420,26 +431,17 @@
     }
 
     FT_TS_FACE_FIND_GLOBAL_SERVICE( face, psnames, POSTSCRIPT_CMAPS );
-    if ( !psnames )
+    if ( !psnames || !cff->charset.sids )
       return 0;
 
-    for ( i = 0; i < cff->num_glyphs; i++ )
-    {
-      sid = charset->sids[i];
-
-      if ( sid > 390 )
-        name = cff_index_get_string( cff, sid - 391 );
-      else
-        name = (FT_TS_String *)psnames->adobe_std_strings( sid );
-
-      if ( !name )
-        continue;
-
-      if ( !ft_strcmp( glyph_name, name ) )
-        return i;
-    }
+    idx = ft_hash_name_index( &cff->glyph_names_hash,
+                              glyph_name,
+                              cff->num_glyphs,
+                              cff_get_glyph_name_string,
+                              cff,
+                              FT_TS_FACE_MEMORY( face ) );
 
-    return 0;
+    return idx >= 0 ? (FT_TS_UInt)idx : 0;
   }
 
 
@@ -936,6 +938,44 @@
   }
 
 
+  static FT_TS_Error
+  cff_new_var_instance( CFF_Face             face,
+                        FT_TS_UInt           num_coords,
+                        FT_TS_Fixed*         coords,
+                        FT_TS_Var_Instance  *ainstance )
+  {
+    FT_TS_Service_MultiMasters  mm = (FT_TS_Service_MultiMasters)face->mm;
+
+
+    return mm->new_var_instance( FT_TS_FACE( face ),
+                                 num_coords,
+                                 coords,
+                                 ainstance );
+  }
+
+
+  static FT_TS_Error
+  cff_set_var_instance( CFF_Face            face,
+                        FT_TS_Var_Instance  instance )
+  {
+    FT_TS_Service_MultiMasters  mm = (FT_TS_Service_MultiMasters)face->mm;
+
+
+    return mm->set_var_instance( FT_TS_FACE( face ), instance );
+  }
+
+
+  static void
+  cff_done_var_instance( FT_TS_Var_Instance  instance )
+  {
+    CFF_Face                    face = (CFF_Face)instance->face;
+    FT_TS_Service_MultiMasters  mm   = (FT_TS_Service_MultiMasters)face->mm;
+
+
+    mm->done_var_instance( instance );
+  }
+
+
   FT_TS_DEFINE_SERVICE_MULTIMASTERSREC(
     cff_service_multi_masters,
 
@@ -949,6 +989,9 @@
     (FT_TS_Set_Instance_Func)       cff_set_instance,        /* set_instance        */
     (FT_TS_Set_MM_WeightVector_Func)cff_set_mm_weightvector, /* set_mm_weightvector */
     (FT_TS_Get_MM_WeightVector_Func)cff_get_mm_weightvector, /* get_mm_weightvector */
+    (FT_TS_New_Var_Instance_Func)   cff_new_var_instance,    /* new_var_instance    */
+    (FT_TS_Set_Var_Instance_Func)   cff_set_var_instance,    /* set_var_instance    */
+    (FT_TS_Done_Var_Instance_Func)  cff_done_var_instance,   /* done_var_instance   */
 
     (FT_TS_Get_Var_Blend_Func)      cff_get_var_blend,       /* get_var_blend       */
     (FT_TS_Done_Blend_Func)         cff_done_blend           /* done_blend          */
@@ -1392,6 +1392,22 @@
   }
 
 
+  /* Discard all cached blend vectors of `font'. */
+  static void
+  cff_blend_flush_vectors( CFF_Font  font )
+  {
+    FT_TS_Memory  memory = font->memory;
+    FT_TS_UInt    i;
+
+
+    if ( !font->blend_vectors )
+      return;
+
+    for ( i = 0; i < font->vstore.dataCount; i++ )
+      FT_TS_FREE( font->blend_vectors[i] );
+  }
+
+
   /* Compute a blend vector from variation store index and normalized  */
   /* vector based on pseudo-code in OpenType Font Variations Overview. */
   /*                                                                   */
@@ -1406,9 +1422,11 @@
     FT_TS_Memory  memory = blend->font->memory;  /* for FT_TS_REALLOC */
 
     FT_TS_UInt       len;
+    CFF_Font      font = blend->font;
     CFF_VStore    vs;
     CFF_VarData*  varData;
     FT_TS_UInt       master;
+    FT_TS_Int32*     cached;
 
 
     /* protect against malformed fonts */
@@ -1449,6 +1467,38 @@
 
     blend->lenBV = len;
 
+    /* The blend vectors of all `vsindex' values are cached for the  */
+    /* last normalized design vector; they are shared by the DICT    */
+    /* parser and the charstrings of all glyphs.                     */
+    if ( font->blend_lenNDV != lenNDV                      ||
+         ( lenNDV                                        &&
+           ft_memcmp( NDV,
+                      font->blend_NDV,
+                      lenNDV * sizeof ( *NDV ) ) != 0    ) )
+    {
+      cff_blend_flush_vectors( font );
+
+      if ( FT_TS_QRENEW_ARRAY( font->blend_NDV, font->blend_lenNDV, lenNDV ) )
+        goto Exit;
+
+      if ( lenNDV )
+        FT_TS_MEM_COPY( font->blend_NDV, NDV, lenNDV * sizeof ( *NDV ) );
+      font->blend_lenNDV = lenNDV;
+    }
+
+    if ( !font->blend_vectors                                  &&
+         FT_TS_NEW_ARRAY( font->blend_vectors, vs->dataCount ) )
+      goto Exit;
+
+    cached = font->blend_vectors[vsindex];
+    if ( cached )
+    {
+      FT_TS_TRACE4(( "   use cached blend vector len %d\n", len ));
+
+      FT_TS_ARRAY_COPY( blend->BV, cached, len );
+      goto Done;
+    }
+
     /* outer loop steps through master designs to be blended */
     for ( master = 0; master < len; master++ )
     {
@@ -1540,6 +1590,13 @@
 
     FT_TS_TRACE4(( "]\n" ));
 
+    if ( FT_TS_QNEW_ARRAY( cached, len ) )
+      goto Exit;
+
+    FT_TS_ARRAY_COPY( cached, blend->BV, len );
+    font->blend_vectors[vsindex] = cached;
+
+  Done:
     /* record the parameters used to build the blend vector */
     blend->lastVsindex = vsindex;
 
@@ -2553,8 +2610,14 @@
 
     cff_encoding_done( &font->encoding );
     cff_charset_done( &font->charset, font->stream );
+    cff_blend_flush_vectors( font );
+    FT_TS_FREE( font->blend_vectors );
+    FT_TS_FREE( font->blend_NDV );
     cff_vstore_done( &font->vstore, memory );
 
+    ft_hash_str_free( font->glyph_names_hash, memory );
+    FT_TS_FREE( font->glyph_names_hash );
+
     cff_subfont_done( memory, &font->top_font );
 
     CFF_Done_FD_Select( &font->fd_select, font->stream );
@@ -193,6 +193,13 @@
     FT_TS_Byte*   cursor;
     FT_TS_Byte*   limit;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Bool    use_cache;       /* cleared if the output gets too large */
+    FT_TS_Byte*   cache;           /* all output produced so far           */
+    FT_TS_ULong   cache_size;      /* number of bytes in `cache'           */
+    FT_TS_ULong   cache_max;       /* allocated size of `cache'            */
+#endif
+
   } FT_TS_GZipFileRec, *FT_TS_GZipFile;
 
 
@@ -297,6 +304,13 @@
     zip->cursor = zip->limit;
     zip->pos    = 0;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    zip->use_cache  = TRUE;
+    zip->cache      = NULL;
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
+
     /* check and skip .gz header */
     {
       stream = source;
@@ -330,6 +344,14 @@
   {
     z_stream*  zstream = &zip->zstream;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Memory  memory = zip->memory;
+
+
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
 
     inflateEnd( zstream );
 
@@ -370,12 +392,69 @@
       zip->limit  = zip->buffer + FT_TS_GZIP_BUFFER_SIZE;
       zip->cursor = zip->limit;
       zip->pos    = 0;
+
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+      /* the cache gets refilled from the start */
+      zip->cache_size = 0;
+#endif
     }
 
     return error;
   }
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+
+  /* Append the output buffer's content to the cache; give up caching */
+  /* if it gets too large or we run out of memory.                    */
+  static void
+  ft_gzip_file_cache_output( FT_TS_GZipFile  zip )
+  {
+    FT_TS_Memory  memory = zip->memory;
+    FT_TS_ULong   count  = (FT_TS_ULong)( zip->limit - zip->cursor );
+    FT_TS_Error   error;
+
+
+    if ( !zip->use_cache || count == 0 )
+      return;
+
+    if ( zip->cache_size + count > zip->cache_max )
+    {
+      FT_TS_ULong  new_max = zip->cache_max;
+
+
+      if ( zip->cache_size + count >
+             FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        goto Fail;
+
+      if ( new_max < 4 * FT_TS_GZIP_BUFFER_SIZE )
+        new_max = 4 * FT_TS_GZIP_BUFFER_SIZE;
+      while ( new_max < zip->cache_size + count )
+        new_max += new_max >> 1;
+      if ( new_max > FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        new_max = FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE;
+
+      if ( FT_TS_QREALLOC( zip->cache, zip->cache_max, new_max ) )
+        goto Fail;
+
+      zip->cache_max = new_max;
+    }
+
+    FT_TS_MEM_COPY( zip->cache + zip->cache_size, zip->cursor, count );
+    zip->cache_size += count;
+
+    return;
+
+  Fail:
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+    zip->use_cache  = FALSE;
+  }
+
+#endif /* FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE */
+
+
   static FT_TS_Error
   ft_gzip_file_fill_input( FT_TS_GZipFile  zip )
   {
@@ -457,6 +536,10 @@
       }
     }
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    ft_gzip_file_cache_output( zip );
+#endif
+
     return error;
   }
 
@@ -503,6 +586,29 @@
     FT_TS_Error  error;
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    /* The cache holds everything inflated so far; the rest comes */
+    /* from the current inflate position, which is never before   */
+    /* the end of the cache.                                      */
+    if ( pos < zip->cache_size && count > 0 )
+    {
+      FT_TS_ULong  delta = zip->cache_size - pos;
+
+
+      if ( delta > count )
+        delta = count;
+
+      FT_TS_MEM_COPY( buffer, zip->cache + pos, delta );
+      buffer += delta;
+      result += delta;
+      pos    += delta;
+      count  -= delta;
+
+      if ( count == 0 )
+        goto Exit;
+    }
+#endif
+
     /* Reset inflate stream if we're seeking backwards.        */
     /* Yes, that is not too efficient, but it saves memory :-) */
     if ( pos < zip->pos )
@@ -705,6 +811,21 @@
         error = FT_TS_Err_Ok;
       }
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+      /* The uncompressed size stored in the trailer is only a hint    */
+      /* (it is taken modulo 2^32 and might be wrong), but it lets us */
+      /* avoid reallocations in the common case.  A failed attempt to */
+      /* read a small file above has already filled the cache.        */
+      if ( !zip->cache                                                 &&
+           zip_size                                                    &&
+           zip_size <= FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+      {
+        if ( !FT_TS_QALLOC( zip->cache, zip_size ) )
+          zip->cache_max = zip_size;
+        error = FT_TS_Err_Ok;
+      }
+#endif
+
       if ( zip_size )
         stream->size = zip_size;
       else
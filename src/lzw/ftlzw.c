@@ -74,6 +74,13 @@
     FT_TS_Byte*        cursor;
     FT_TS_Byte*        limit;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Bool         use_cache;  /* cleared if the output gets too large */
+    FT_TS_Byte*        cache;      /* all output produced so far           */
+    FT_TS_ULong        cache_size; /* number of bytes in `cache'           */
+    FT_TS_ULong        cache_max;  /* allocated size of `cache'            */
+#endif
+
   } FT_TS_LZWFileRec, *FT_TS_LZWFile;
 
 
@@ -116,6 +123,13 @@
     zip->cursor = zip->limit;
     zip->pos    = 0;
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    zip->use_cache  = TRUE;
+    zip->cache      = NULL;
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
+
     /* check and skip .Z header */
     error = ft_lzw_check_header( source );
     if ( error )
@@ -132,6 +146,15 @@
   static void
   ft_lzw_file_done( FT_TS_LZWFile  zip )
   {
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    FT_TS_Memory  memory = zip->memory;
+
+
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+#endif
+
     /* clear the rest */
     ft_lzwstate_done( &zip->lzw );
 
@@ -155,12 +178,69 @@
       zip->limit  = zip->buffer + FT_TS_LZW_BUFFER_SIZE;
       zip->cursor = zip->limit;
       zip->pos    = 0;
+
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+      /* the cache gets refilled from the start */
+      zip->cache_size = 0;
+#endif
     }
 
     return error;
   }
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+
+  /* Append the output buffer's content to the cache; give up caching */
+  /* if it gets too large or we run out of memory.                    */
+  static void
+  ft_lzw_file_cache_output( FT_TS_LZWFile  zip )
+  {
+    FT_TS_Memory  memory = zip->memory;
+    FT_TS_ULong   count  = (FT_TS_ULong)( zip->limit - zip->cursor );
+    FT_TS_Error   error;
+
+
+    if ( !zip->use_cache || count == 0 )
+      return;
+
+    if ( zip->cache_size + count > zip->cache_max )
+    {
+      FT_TS_ULong  new_max = zip->cache_max;
+
+
+      if ( zip->cache_size + count >
+             FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        goto Fail;
+
+      if ( new_max < 4 * FT_TS_LZW_BUFFER_SIZE )
+        new_max = 4 * FT_TS_LZW_BUFFER_SIZE;
+      while ( new_max < zip->cache_size + count )
+        new_max += new_max >> 1;
+      if ( new_max > FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE )
+        new_max = FT_TS_CONFIG_COMPRESSED_STREAM_CACHE_MAX_SIZE;
+
+      if ( FT_TS_QREALLOC( zip->cache, zip->cache_max, new_max ) )
+        goto Fail;
+
+      zip->cache_max = new_max;
+    }
+
+    FT_TS_MEM_COPY( zip->cache + zip->cache_size, zip->cursor, count );
+    zip->cache_size += count;
+
+    return;
+
+  Fail:
+    FT_TS_FREE( zip->cache );
+    zip->cache_size = 0;
+    zip->cache_max  = 0;
+    zip->use_cache  = FALSE;
+  }
+
+#endif /* FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE */
+
+
   static FT_TS_Error
   ft_lzw_file_fill_output( FT_TS_LZWFile  zip )
   {
@@ -178,6 +258,10 @@
     if ( count == 0 )
       error = FT_TS_THROW( Invalid_Stream_Operation );
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    ft_lzw_file_cache_output( zip );
+#endif
+
     return error;
   }
 
@@ -211,6 +295,26 @@
       FT_TS_ULong  numread;
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+      /* the skipped data must go through the output buffer */
+      /* so that it ends up in the cache                    */
+      if ( zip->use_cache )
+      {
+        error = ft_lzw_file_fill_output( zip );
+        if ( error )
+          break;
+
+        delta = (FT_TS_ULong)( zip->limit - zip->cursor );
+        if ( delta > count )
+          delta = count;
+
+        zip->cursor += delta;
+        zip->pos    += delta;
+        count       -= delta;
+        continue;
+      }
+#endif
+
       if ( delta > count )
         delta = count;
 
@@ -240,6 +344,28 @@
     FT_TS_Error  error;
 
 
+#ifdef FT_TS_CONFIG_OPTION_COMPRESSED_STREAM_CACHE
+    /* The cache holds everything decompressed so far; the rest */
+    /* comes from the current decompression position, which is  */
+    /* never before the end of the cache.                       */
+    if ( pos < zip->cache_size && count > 0 )
+    {
+      FT_TS_ULong  delta = zip->cache_size - pos;
+
+
+      if ( delta > count )
+        delta = count;
+
+      FT_TS_MEM_COPY( buffer, zip->cache + pos, delta );
+      result += delta;
+      pos    += delta;
+      count  -= delta;
+
+      if ( count == 0 )
+        goto Exit;
+    }
+#endif
+
     /* seeking backwards. */
     if ( pos < zip->pos )
     {
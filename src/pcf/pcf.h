@@ -158,11 +158,22 @@ FT_TS_BEGIN_HEADER
     PCF_Property  properties;
 
     FT_TS_ULong      nmetrics;
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+    FT_TS_ULong      metricsFormat;
+    FT_TS_Byte*      metricsData;    /* on-disk metrics of glyphs 1, 2, ...  */
+    FT_TS_UShort     defaultGlyph;   /* glyph 0 is a copy of this glyph      */
+#else
     PCF_Metric    metrics;
+#endif
 
     PCF_EncRec    enc;
 
     FT_TS_ULong      bitmapsFormat;
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+    FT_TS_Byte*      bitmapsOffsets; /* on-disk offsets of glyphs 1, 2, ...  */
+    FT_TS_ULong      bitmapsStart;   /* stream position of bitmap data       */
+    FT_TS_ULong      bitmapsSize;    /* size of the PCF_BITMAPS table        */
+#endif
 
   } PCF_FaceRec, *PCF_Face;
 
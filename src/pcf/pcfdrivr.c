@@ -181,7 +181,7 @@ THE SOFTWARE.
     pcf_cmap_char_index,
     pcf_cmap_char_next,
 
-    NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL
   };
 
 
@@ -197,7 +197,12 @@ THE SOFTWARE.
 
     memory = FT_TS_FACE_MEMORY( face );
 
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+    FT_TS_Stream_ReleaseFrame( pcfface->stream, &face->metricsData );
+    FT_TS_Stream_ReleaseFrame( pcfface->stream, &face->bitmapsOffsets );
+#else
     FT_TS_FREE( face->metrics );
+#endif
     FT_TS_FREE( face->enc.offset );
 
     /* free properties */
@@ -473,8 +478,10 @@ THE SOFTWARE.
     FT_TS_Stream   stream;
     FT_TS_Error    error  = FT_TS_Err_Ok;
     FT_TS_Bitmap*  bitmap = &slot->bitmap;
-    PCF_Metric  metric;
+    PCF_MetricRec  metric_rec;
+    PCF_Metric  metric = &metric_rec;
     FT_TS_ULong    bytes;
+    FT_TS_Bool     swap;
 
 
     FT_TS_TRACE1(( "PCF_Glyph_Load: glyph index %d\n", glyph_index ));
@@ -493,7 +500,7 @@ THE SOFTWARE.
 
     stream = face->root.stream;
 
-    metric = face->metrics + glyph_index;
+    pcf_get_glyph_metric( face, glyph_index, metric );
 
     bitmap->rows       = (unsigned int)( metric->ascent +
                                          metric->descent );
@@ -545,6 +552,29 @@ THE SOFTWARE.
     /* XXX: to do: are there cases that need repadding the bitmap? */
     bytes = (FT_TS_ULong)bitmap->pitch * bitmap->rows;
 
+    swap = PCF_BYTE_ORDER( face->bitmapsFormat ) !=
+             PCF_BIT_ORDER( face->bitmapsFormat ) &&
+           ( PCF_SCAN_UNIT( face->bitmapsFormat ) == 2 ||
+             PCF_SCAN_UNIT( face->bitmapsFormat ) == 4 );
+
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+    /* bitmaps in native order can be used directly from memory */
+    if ( !stream->read                                   &&
+         PCF_BIT_ORDER( face->bitmapsFormat ) == MSBFirst &&
+         !swap                                           )
+    {
+      if ( metric->bits > stream->size         ||
+           bytes > stream->size - metric->bits )
+      {
+        error = FT_TS_THROW( Invalid_Stream_Operation );
+        goto Exit;
+      }
+
+      ft_glyphslot_set_bitmap( slot, stream->base + metric->bits );
+      goto Exit;
+    }
+#endif
+
     error = ft_glyphslot_alloc_bitmap( slot, (FT_TS_ULong)bytes );
     if ( error )
       goto Exit;
@@ -556,22 +586,12 @@ THE SOFTWARE.
     if ( PCF_BIT_ORDER( face->bitmapsFormat ) != MSBFirst )
       BitOrderInvert( bitmap->buffer, bytes );
 
-    if ( ( PCF_BYTE_ORDER( face->bitmapsFormat ) !=
-           PCF_BIT_ORDER( face->bitmapsFormat )  ) )
+    if ( swap )
     {
-      switch ( PCF_SCAN_UNIT( face->bitmapsFormat ) )
-      {
-      case 1:
-        break;
-
-      case 2:
+      if ( PCF_SCAN_UNIT( face->bitmapsFormat ) == 2 )
         TwoByteSwap( bitmap->buffer, bytes );
-        break;
-
-      case 4:
+      else
         FourByteSwap( bitmap->buffer, bytes );
-        break;
-      }
     }
 
   Exit:
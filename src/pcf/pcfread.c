@@ -681,8 +681,12 @@ THE SOFTWARE.
     FT_TS_Error    error;
     FT_TS_Memory   memory  = FT_TS_FACE( face )->memory;
     FT_TS_ULong    format, size;
+    FT_TS_ULong    nmetrics, orig_nmetrics;
+
+#ifndef PCF_CONFIG_OPTION_LAZY_METRICS
     PCF_Metric  metrics = NULL;
-    FT_TS_ULong    nmetrics, orig_nmetrics, i;
+    FT_TS_ULong    i;
+#endif
 
 
     error = pcf_seek_to_table_type( stream,
@@ -767,6 +771,24 @@ THE SOFTWARE.
 
     face->nmetrics = nmetrics + 1;
 
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+
+    /* Keep the metrics in their on-disk form; they get decoded in       */
+    /* `pcf_get_glyph_metric'.  For memory-based streams this is just a */
+    /* pointer into the stream.                                         */
+    FT_TS_UNUSED( memory );
+
+    face->metricsFormat = format;
+
+    if ( FT_TS_FRAME_EXTRACT( nmetrics *
+                             ( PCF_FORMAT_MATCH( format, PCF_DEFAULT_FORMAT )
+                                 ? PCF_METRIC_SIZE
+                                 : PCF_COMPRESSED_METRIC_SIZE ),
+                           face->metricsData ) )
+      goto Bail;
+
+#else /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+
     if ( FT_TS_QNEW_ARRAY( face->metrics, face->nmetrics ) )
       return error;
 
@@ -804,6 +826,8 @@ THE SOFTWARE.
     if ( error )
       FT_TS_FREE( face->metrics );
 
+#endif /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+
   Bail:
     return error;
   }
@@ -877,6 +901,18 @@ THE SOFTWARE.
     /* start position of bitmap data */
     pos = stream->pos + nbitmaps * 4 + 4 * 4;
 
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+
+    /* as with the metrics, keep the offsets in their on-disk form; */
+    /* they get checked in `pcf_get_glyph_metric'                  */
+    if ( FT_TS_FRAME_EXTRACT( nbitmaps * 4, face->bitmapsOffsets ) )
+      goto Bail;
+
+    face->bitmapsStart = pos;
+    face->bitmapsSize  = size;
+
+#else /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+
     FT_TS_TRACE5(( "\n" ));
     for ( i = 1; i <= nbitmaps; i++ )
     {
@@ -905,6 +941,8 @@ THE SOFTWARE.
     if ( error )
       goto Bail;
 
+#endif /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+
     for ( i = 0; i < GLYPHPADOPTIONS; i++ )
     {
       if ( PCF_BYTE_ORDER( format ) == MSBFirst )
@@ -934,6 +972,100 @@ THE SOFTWARE.
   }
 
 
+  FT_TS_LOCAL_DEF( void )
+  pcf_get_glyph_metric( PCF_Face    face,
+                        FT_TS_UInt     glyph_index,
+                        PCF_Metric  metric )
+  {
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+
+    FT_TS_ULong  format = face->metricsFormat;
+    FT_TS_Byte*  p;
+    FT_TS_ULong  offset;
+
+
+    /* glyph 0 is a copy of the default character */
+    if ( glyph_index == 0 )
+      glyph_index = face->defaultGlyph;
+
+    /* there is no on-disk data for the artificial glyph 0 */
+    glyph_index--;
+
+    if ( PCF_FORMAT_MATCH( format, PCF_DEFAULT_FORMAT ) )
+    {
+      p = face->metricsData + glyph_index * PCF_METRIC_SIZE;
+
+      if ( PCF_BYTE_ORDER( format ) == MSBFirst )
+      {
+        metric->leftSideBearing  = FT_TS_NEXT_SHORT( p );
+        metric->rightSideBearing = FT_TS_NEXT_SHORT( p );
+        metric->characterWidth   = FT_TS_NEXT_SHORT( p );
+        metric->ascent           = FT_TS_NEXT_SHORT( p );
+        metric->descent          = FT_TS_NEXT_SHORT( p );
+        metric->attributes       = FT_TS_NEXT_SHORT( p );
+      }
+      else
+      {
+        metric->leftSideBearing  = FT_TS_NEXT_SHORT_LE( p );
+        metric->rightSideBearing = FT_TS_NEXT_SHORT_LE( p );
+        metric->characterWidth   = FT_TS_NEXT_SHORT_LE( p );
+        metric->ascent           = FT_TS_NEXT_SHORT_LE( p );
+        metric->descent          = FT_TS_NEXT_SHORT_LE( p );
+        metric->attributes       = FT_TS_NEXT_SHORT_LE( p );
+      }
+    }
+    else
+    {
+      p = face->metricsData + glyph_index * PCF_COMPRESSED_METRIC_SIZE;
+
+      metric->leftSideBearing  = (FT_TS_Short)( p[0] - 0x80 );
+      metric->rightSideBearing = (FT_TS_Short)( p[1] - 0x80 );
+      metric->characterWidth   = (FT_TS_Short)( p[2] - 0x80 );
+      metric->ascent           = (FT_TS_Short)( p[3] - 0x80 );
+      metric->descent          = (FT_TS_Short)( p[4] - 0x80 );
+      metric->attributes       = 0;
+    }
+
+    /* see `pcf_get_metrics' */
+    if ( metric->rightSideBearing < metric->leftSideBearing ||
+         metric->ascent < -metric->descent                  )
+    {
+      metric->characterWidth   = 0;
+      metric->leftSideBearing  = 0;
+      metric->rightSideBearing = 0;
+      metric->ascent           = 0;
+      metric->descent          = 0;
+
+      FT_TS_TRACE1(( "pcf_get_glyph_metric:"
+                  " invalid metrics for glyph %u\n", glyph_index + 1 ));
+    }
+
+    p = face->bitmapsOffsets + glyph_index * 4;
+
+    if ( PCF_BYTE_ORDER( face->bitmapsFormat ) == MSBFirst )
+      offset = FT_TS_PEEK_ULONG( p );
+    else
+      offset = FT_TS_PEEK_ULONG_LE( p );
+
+    /* see `pcf_get_bitmaps' */
+    if ( offset > face->bitmapsSize )
+    {
+      FT_TS_TRACE1(( "pcf_get_glyph_metric:"
+                  " invalid offset to bitmap data of glyph %u\n",
+                  glyph_index + 1 ));
+      offset = 0;
+    }
+
+    metric->bits = face->bitmapsStart + offset;
+
+#else /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+
+    *metric = face->metrics[glyph_index];
+
+#endif /* !PCF_CONFIG_OPTION_LAZY_METRICS */
+  }
+
+
   /*
    * This file uses X11 terminology for PCF data; an `encoding' in X11 speak
    * is the same as a character code in FreeType speak.
@@ -1107,7 +1239,11 @@ THE SOFTWARE.
     }
 
     /* copy metrics of default character to index 0 */
+#ifdef PCF_CONFIG_OPTION_LAZY_METRICS
+    face->defaultGlyph = (FT_TS_UShort)defaultCharEncodingOffset;
+#else
     face->metrics[0] = face->metrics[defaultCharEncodingOffset];
+#endif
 
     /* now loop over all values */
     offset = enc->offset;
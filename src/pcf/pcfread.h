@@ -36,6 +36,11 @@ FT_TS_BEGIN_HEADER
   pcf_find_property( PCF_Face          face,
                      const FT_TS_String*  prop );
 
+  FT_TS_LOCAL( void )
+  pcf_get_glyph_metric( PCF_Face    face,
+                        FT_TS_UInt     glyph_index,
+                        PCF_Metric  metric );
+
 FT_TS_END_HEADER
 
 #endif /* PCFREAD_H_ */
@@ -35,6 +35,14 @@ in this Software without prior written authorization from The Open Group.
 #include "pcfutil.h"
 
 
+  /*
+   * The functions below handle four bytes at once; they only shuffle bits
+   * or bytes within 32-bit words, thus the host's byte order doesn't
+   * matter.  `ft_memcpy' with a constant size compiles to a single
+   * (unaligned) load or store on all relevant platforms.
+   */
+
+
   /*
    * Invert bit order within each BYTE of an array.
    */
@@ -43,6 +51,20 @@ in this Software without prior written authorization from The Open Group.
   BitOrderInvert( unsigned char*  buf,
                   size_t          nbytes )
   {
+    for ( ; nbytes >= 4; nbytes -= 4, buf += 4 )
+    {
+      FT_TS_UInt32  val;
+
+
+      ft_memcpy( &val, buf, 4 );
+
+      val = ( ( val >> 1 ) & 0x55555555UL ) | ( ( val << 1 ) & 0xAAAAAAAAUL );
+      val = ( ( val >> 2 ) & 0x33333333UL ) | ( ( val << 2 ) & 0xCCCCCCCCUL );
+      val = ( ( val >> 4 ) & 0x0F0F0F0FUL ) | ( ( val << 4 ) & 0xF0F0F0F0UL );
+
+      ft_memcpy( buf, &val, 4 );
+    }
+
     for ( ; nbytes > 0; nbytes--, buf++ )
     {
       unsigned int  val = *buf;
@@ -65,7 +87,19 @@ in this Software without prior written authorization from The Open Group.
   TwoByteSwap( unsigned char*  buf,
                size_t          nbytes )
   {
-    for ( ; nbytes >= 2; nbytes -= 2, buf += 2 )
+    for ( ; nbytes >= 4; nbytes -= 4, buf += 4 )
+    {
+      FT_TS_UInt32  val;
+
+
+      ft_memcpy( &val, buf, 4 );
+
+      val = ( ( val >> 8 ) & 0x00FF00FFUL ) | ( ( val << 8 ) & 0xFF00FF00UL );
+
+      ft_memcpy( buf, &val, 4 );
+    }
+
+    if ( nbytes >= 2 )
     {
       unsigned char  c;
 
@@ -76,6 +110,7 @@ in this Software without prior written authorization from The Open Group.
     }
   }
 
+
   /*
    * Invert byte order within each 32-bits of an array.
    */
@@ -86,16 +121,15 @@ in this Software without prior written authorization from The Open Group.
   {
     for ( ; nbytes >= 4; nbytes -= 4, buf += 4 )
     {
-      unsigned char  c;
+      FT_TS_UInt32  val;
 
 
-      c      = buf[0];
-      buf[0] = buf[3];
-      buf[3] = c;
+      ft_memcpy( &val, buf, 4 );
+
+      val = ( ( val >> 8 ) & 0x00FF00FFUL ) | ( ( val << 8 ) & 0xFF00FF00UL );
+      val = ( val >> 16 ) | ( val << 16 );
 
-      c      = buf[1];
-      buf[1] = buf[2];
-      buf[2] = c;
+      ft_memcpy( buf, &val, 4 );
     }
   }
 
@@ -59,6 +59,23 @@ FT_TS_BEGIN_HEADER
 #define CF2_STORAGE_SIZE        32
 
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+
+  /* pre-decoded local subroutines of a subfont, */
+  /* identified by its array of subroutines       */
+  typedef struct  CF2_LocalSubrsRec_
+  {
+    FT_TS_Byte**  locals;
+    CF2_UInt      numSubrs;
+    CF2_Tokens*   subrs;
+
+    struct CF2_LocalSubrsRec_*  next;
+
+  } CF2_LocalSubrsRec, *CF2_LocalSubrs;
+
+#endif
+
+
   /* typedef is in `cf2glue.h' */
   struct  CF2_FontRec_
   {
@@ -115,6 +132,15 @@ FT_TS_BEGIN_HEADER
     CF2_BluesRec  blues;                         /* computed zone data */
 
     FT_TS_Service_CFFLoad  cffload;           /* pointer to cff functions */
+
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+    /* pre-decoded subroutines, created on first use */
+    CF2_Tokens*     globalSubrs;
+    CF2_UInt        numGlobalSubrs;
+    CF2_LocalSubrs  localSubrs;       /* list of all subfonts            */
+    CF2_LocalSubrs  lastLocalSubrs;   /* entry of last used subfont      */
+    FT_TS_ULong     subrCacheSize;    /* total size of cached subrs      */
+#endif
   };
 
 
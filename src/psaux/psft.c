@@ -43,6 +43,8 @@
 #include "pserror.h"
 #include "psobjs.h"
 #include "cffdecode.h"
+#include "psintrp.h"
+#include "psstack.h"
 
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
 #include <freetype/ftmm.h>
@@ -116,6 +118,30 @@
 
       FT_TS_FREE( font->blend.lastNDV );
       FT_TS_FREE( font->blend.BV );
+
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+      {
+        CF2_UInt  i;
+
+
+        for ( i = 0; i < font->numGlobalSubrs; i++ )
+          FT_TS_FREE( font->globalSubrs[i] );
+        FT_TS_FREE( font->globalSubrs );
+
+        while ( font->localSubrs )
+        {
+          CF2_LocalSubrs  locals = font->localSubrs;
+
+
+          for ( i = 0; i < locals->numSubrs; i++ )
+            FT_TS_FREE( locals->subrs[i] );
+          FT_TS_FREE( locals->subrs );
+
+          font->localSubrs = locals->next;
+          FT_TS_FREE( locals );
+        }
+      }
+#endif
     }
   }
 
@@ -626,6 +652,119 @@
   }
 
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+
+  /* Attach the pre-decoded tokens of subroutine `idx' to `buf', */
+  /* decoding the subroutine first if necessary.  Nothing is     */
+  /* attached if we run out of memory or exceed the cache limit. */
+  static void
+  cf2_attachSubrTokens( PS_Decoder*  decoder,
+                        FT_TS_Bool   global,
+                        CF2_UInt     idx,
+                        CF2_Buffer   buf )
+  {
+    CF2_Font      font   = (CF2_Font)decoder->cf2_instance->data;
+    FT_TS_Memory  memory = font->memory;
+    FT_TS_Error   error;
+
+    CF2_Tokens*  slot;
+    CF2_Tokens   tokens;
+
+
+    if ( global )
+    {
+      if ( !font->globalSubrs )
+      {
+        if ( FT_TS_NEW_ARRAY( font->globalSubrs, decoder->num_globals ) )
+          return;
+
+        font->numGlobalSubrs  = decoder->num_globals;
+        font->subrCacheSize  += decoder->num_globals * sizeof ( CF2_Tokens );
+      }
+
+      if ( idx >= font->numGlobalSubrs )
+        return;
+
+      slot = font->globalSubrs + idx;
+    }
+    else
+    {
+      CF2_LocalSubrs  locals = font->lastLocalSubrs;
+
+
+      if ( !locals || locals->locals != decoder->locals )
+      {
+        for ( locals = font->localSubrs; locals; locals = locals->next )
+          if ( locals->locals == decoder->locals )
+            break;
+
+        if ( !locals )
+        {
+          if ( FT_TS_QNEW( locals ) )
+            return;
+
+          if ( FT_TS_NEW_ARRAY( locals->subrs, decoder->num_locals ) )
+          {
+            FT_TS_FREE( locals );
+            return;
+          }
+
+          locals->locals   = decoder->locals;
+          locals->numSubrs = decoder->num_locals;
+          locals->next     = font->localSubrs;
+          font->localSubrs = locals;
+
+          font->subrCacheSize += sizeof ( CF2_LocalSubrsRec ) +
+                                 decoder->num_locals * sizeof ( CF2_Tokens );
+        }
+
+        font->lastLocalSubrs = locals;
+      }
+
+      if ( idx >= locals->numSubrs )
+        return;
+
+      slot = locals->subrs + idx;
+    }
+
+    tokens = *slot;
+    if ( !tokens )
+    {
+      FT_TS_ULong  len;
+
+
+      if ( buf->end <= buf->start )
+        return;
+
+      /* every byte is at most one operand or operator */
+      len = (FT_TS_ULong)( buf->end - buf->start );
+      if ( font->subrCacheSize + sizeof ( CF2_TokensRec ) +
+             len * sizeof ( CF2_StackNumber )              >
+             CFF_CONFIG_SUBR_CACHE_MAX_SIZE                )
+        return;
+
+      tokens = cf2_decodeT2CharString( memory, buf->start, buf->end );
+      if ( !tokens )
+        return;
+
+      font->subrCacheSize += sizeof ( CF2_TokensRec )                    +
+                             tokens->numArgs * sizeof ( CF2_StackNumber ) +
+                             tokens->numTokens * sizeof ( CF2_TokenRec );
+      *slot = tokens;
+    }
+
+    if ( tokens->numTokens )
+    {
+      buf->token     = tokens->tokens;
+      buf->token_end = tokens->tokens + tokens->numTokens;
+      buf->args      = tokens->args;
+      buf->resume    = buf->start + tokens->resume;
+    }
+  }
+
+#endif /* CFF_CONFIG_OPTION_SUBR_CACHE */
+
+
   /* convert unbiased subroutine index to `CF2_Buffer' and */
   /* return 0 on success                                   */
   FT_TS_LOCAL_DEF( CF2_Int )
@@ -650,6 +789,10 @@
     buf->ptr   = decoder->globals[idx];
     buf->end   = decoder->globals[idx + 1];
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+    cf2_attachSubrTokens( decoder, TRUE, idx, buf );
+#endif
+
     return FALSE;      /* success */
   }
 
@@ -842,6 +985,11 @@
 
     buf->ptr = buf->start;
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+    if ( !decoder->builder.is_t1 )
+      cf2_attachSubrTokens( decoder, FALSE, idx, buf );
+#endif
+
     return FALSE;      /* success */
   }
 
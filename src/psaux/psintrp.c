@@ -411,39 +411,72 @@
   }
 
 
+  /* Convert a stack entry to 16.16 format. */
+#define CF2_STACK_NUMBER_TO_FIXED( n )                     \
+          ( (n)->type == CF2_NumberFixed                   \
+              ? (n)->u.r                                   \
+              : (n)->type == CF2_NumberInt                 \
+                  ? cf2_intToFixed( (n)->u.i )             \
+                  : cf2_fracToFixed( (n)->u.f ) )
+
+
   /* Blend numOperands on the stack,                */
   /* store results into the first numBlends values, */
   /* then pop remaining arguments.                  */
+  /*                                                */
+  /* For speed, the operands are accessed directly  */
+  /* in the stack buffer.  Regions with a zero      */
+  /* blend weight (which are frequent for named     */
+  /* instances) don't contribute and are skipped.   */
+  /*                                                */
+  /* The deltas are deliberately not accumulated in */
+  /* batches or with SIMD: every operand is a typed */
+  /* stack entry needing its own conversion, every  */
+  /* product is rounded by `FT_MulFix', and a blend */
+  /* rarely has more than a dozen operands, so the  */
+  /* setup would cost more than it saves.           */
   static void
   cf2_doBlend( const CFF_Blend  blend,
                CF2_Stack        opStack,
                CF2_UInt         numBlends )
   {
-    CF2_UInt  delta;
-    CF2_UInt  base;
-    CF2_UInt  i, j;
+    CF2_UInt  numRegions  = blend->lenBV - 1;
     CF2_UInt  numOperands = (CF2_UInt)( numBlends * blend->lenBV );
+    CF2_UInt  i, j;
 
+    CF2_StackNumber*  base;
+    CF2_StackNumber*  delta;
 
-    base  = cf2_stack_count( opStack ) - numOperands;
+
+    if ( numOperands > cf2_stack_count( opStack ) )
+    {
+      CF2_SET_ERROR( opStack->error, Stack_Overflow );
+      return;
+    }
+
+    base  = opStack->top - numOperands;
     delta = base + numBlends;
 
-    for ( i = 0; i < numBlends; i++ )
+    for ( i = 0; i < numBlends; i++, delta += numRegions )
     {
       const CF2_Fixed*  weight = &blend->BV[1];
 
       /* start with first term */
-      CF2_Fixed  sum = cf2_stack_getReal( opStack, i + base );
+      CF2_Fixed  sum = CF2_STACK_NUMBER_TO_FIXED( &base[i] );
 
 
-      for ( j = 1; j < blend->lenBV; j++ )
-        sum = ADD_INT32( sum,
-                         FT_TS_MulFix( *weight++,
-                                    cf2_stack_getReal( opStack,
-                                                       delta++ ) ) );
+      for ( j = 0; j < numRegions; j++ )
+      {
+        if ( weight[j] )
+          sum = ADD_INT32( sum,
+                           FT_TS_MulFix( weight[j],
+                                      CF2_STACK_NUMBER_TO_FIXED(
+                                        &delta[j] ) ) );
+      }
 
       /* store blended result  */
-      cf2_stack_setReal( opStack, i + base, sum );
+      base[i].u.r  = sum;
+      base[i].type = CF2_NumberFixed;
     }
 
     /* leave only `numBlends' results on stack */
@@ -451,6 +484,188 @@
   }
 
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+
+  /*
+   * Pre-decode a CFF or CFF2 charstring into a `CF2_TokensRec' structure
+   * (see file `psread.h' for details), to be used by
+   * `cf2_interpT2CharString'.  Incomplete data at the end of the
+   * charstring is left to the interpreter, which reports the error.
+   *
+   * Note: This function returns NULL on error (does not set `error').
+   */
+  FT_TS_LOCAL_DEF( CF2_Tokens )
+  cf2_decodeT2CharString( FT_TS_Memory       memory,
+                          const FT_TS_Byte*  start,
+                          const FT_TS_Byte*  end )
+  {
+    FT_TS_Error  error;
+    CF2_Tokens   tokens = NULL;
+
+    const FT_TS_Byte*  p = start;
+    FT_TS_UInt         numTokens;
+    FT_TS_UInt         numArgs;
+    FT_TS_UInt         run;
+    FT_TS_Int          pass;
+
+
+    /* the first pass counts, the second pass stores */
+    for ( pass = 0; pass < 2; pass++ )
+    {
+      CF2_StackNumber*  arg   = pass ? tokens->args : NULL;
+      CF2_TokenRec*     token = pass ? tokens->tokens : NULL;
+
+
+      p         = start;
+      numTokens = 0;
+      numArgs   = 0;
+      run       = 0;
+
+      while ( p < end )
+      {
+        FT_TS_Byte   op1 = *p;
+        FT_TS_Int32  v;
+        FT_TS_Long   len;
+
+
+        if ( op1 >= 32 || op1 == cf2_cmdEXTENDEDNMBR )
+        {
+          CF2_NumberType  type = CF2_NumberInt;
+
+
+          if ( op1 <= 246 && op1 != cf2_cmdEXTENDEDNMBR )
+          {
+            v   = op1 - 139;
+            len = 1;
+          }
+          else if ( op1 <= 254 && op1 != cf2_cmdEXTENDEDNMBR )
+          {
+            if ( end - p < 2 )
+              break;
+
+            if ( op1 <= 250 )
+              v = ( op1 - 247 ) * 256 + p[1] + 108;
+            else
+              v = -( ( op1 - 251 ) * 256 + p[1] ) - 108;
+            len = 2;
+          }
+          else if ( op1 == 255 )
+          {
+            if ( end - p < 5 )
+              break;
+
+            v    = (FT_TS_Int32)( ( (FT_TS_UInt32)p[1] << 24 ) |
+                                  ( (FT_TS_UInt32)p[2] << 16 ) |
+                                  ( (FT_TS_UInt32)p[3] <<  8 ) |
+                                    (FT_TS_UInt32)p[4]         );
+            type = CF2_NumberFixed;
+            len  = 5;
+          }
+          else
+          {
+            if ( end - p < 3 )
+              break;
+
+            v   = (FT_TS_Short)( ( p[1] << 8 ) | p[2] );
+            len = 3;
+          }
+
+          if ( pass )
+          {
+            /* `u.r' and `u.i' are both used for 32-bit integers */
+            if ( type == CF2_NumberFixed )
+              arg->u.r = v;
+            else
+              arg->u.i = v;
+            arg->type = type;
+            arg++;
+          }
+
+          numArgs++;
+          run++;
+          p += len;
+
+          /* flush overlong runs; this can't happen in valid fonts */
+          if ( run == 0xFFFFU )
+          {
+            if ( pass )
+            {
+              token->offset  = (FT_TS_UInt32)( p - start );
+              token->numArgs = (FT_TS_UShort)run;
+              token->op      = 255;
+              token++;
+            }
+
+            numTokens++;
+            run = 0;
+          }
+
+          continue;
+        }
+
+        /* the second byte of an escaped operator */
+        /* is read from the buffer                */
+        len = op1 == cf2_cmdESC ? 2 : 1;
+        if ( end - p < len )
+          break;
+
+        /* the first byte following the operator */
+        p++;
+
+        if ( pass )
+        {
+          token->offset  = (FT_TS_UInt32)( p - start );
+          token->numArgs = (FT_TS_UShort)run;
+          token->op      = op1;
+          token++;
+        }
+
+        numTokens++;
+        run = 0;
+        p  += len - 1;
+
+        /* the mask size depends on the number of stem hints */
+        if ( op1 == cf2_cmdHINTMASK || op1 == cf2_cmdCNTRMASK )
+          break;
+      }
+
+      /* trailing operands */
+      if ( run )
+      {
+        if ( pass )
+        {
+          token->offset  = (FT_TS_UInt32)( p - start );
+          token->numArgs = (FT_TS_UShort)run;
+          token->op      = 255;
+        }
+
+        numTokens++;
+      }
+
+      if ( !pass )
+      {
+        if ( FT_TS_QALLOC( tokens,
+                           sizeof ( CF2_TokensRec )                  +
+                             numArgs * sizeof ( CF2_StackNumber )  +
+                             numTokens * sizeof ( CF2_TokenRec )   ) )
+          return NULL;
+
+        /* `CF2_StackNumber' has the stricter alignment */
+        tokens->args   = (CF2_StackNumber*)( tokens + 1 );
+        tokens->tokens = (CF2_TokenRec*)( tokens->args + numArgs );
+      }
+    }
+
+    tokens->numTokens = numTokens;
+    tokens->numArgs   = numArgs;
+    tokens->resume    = (FT_TS_UInt)( p - start );
+
+    return tokens;
+  }
+
+#endif /* CFF_CONFIG_OPTION_SUBR_CACHE */
+
+
   /*
    * `error' is a shared error code used by many objects in this
    * routine.  Before the code continues from an error, it must check and
@@ -627,6 +842,68 @@
         FT_TS_ASSERT( known_othersubr_result_cnt == 0 ||
                    result_cnt == 0                 );
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+      if ( charstring->token && charstring->token == charstring->token_end )
+      {
+        /* all tokens consumed; continue with the raw data */
+        if ( charstring->ptr < charstring->resume )
+          charstring->ptr = charstring->resume;
+
+        charstring->token = NULL;
+      }
+
+      if ( charstring->token )
+      {
+        const CF2_TokenRec*  token = charstring->token++;
+        CF2_UInt             count = token->numArgs;
+
+
+        if ( count )
+        {
+          /* every operand counts as an instruction */
+          if ( instructionLimit <= count )
+          {
+            lastError = FT_TS_THROW( Invalid_Glyph_Format );
+            goto exit;
+          }
+          instructionLimit -= count;
+
+          cf2_stack_pushNumbers( opStack, charstring->args, count );
+
+#ifdef FT_TS_DEBUG_LEVEL_TRACE
+          {
+            CF2_UInt  i;
+
+
+            for ( i = 0; i < count; i++ )
+            {
+              if ( charstring->args[i].type == CF2_NumberFixed )
+                FT_TS_TRACE4(( " %.5fF", charstring->args[i].u.r / 65536.0 ));
+              else
+                FT_TS_TRACE4(( " %d", charstring->args[i].u.i ));
+            }
+          }
+#endif
+
+          charstring->args += count;
+
+          if ( *error )
+            goto exit;
+        }
+
+        op1 = token->op;
+        if ( op1 == 255 )
+          continue;   /* operands only */
+
+        charstring->ptr = charstring->start + token->offset;
+
+        /* Explicit RETURN and ENDCHAR in CFF2 should be ignored. */
+        if ( ( op1 == cf2_cmdRETURN || op1 == cf2_cmdENDCHAR ) &&
+             font->isCFF2                                      )
+          op1 = cf2_cmdRESERVED_0;
+      }
+      else
+#endif /* CFF_CONFIG_OPTION_SUBR_CACHE */
       if ( cf2_buf_isEnd( charstring ) )
       {
         /* If we've reached the end of the charstring, simulate a */
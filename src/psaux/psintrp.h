@@ -73,6 +73,13 @@ FT_TS_BEGIN_HEADER
                           CF2_Fixed             curY,
                           CF2_Fixed*            width );
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+  FT_TS_LOCAL( CF2_Tokens )
+  cf2_decodeT2CharString( FT_TS_Memory       memory,
+                          const FT_TS_Byte*  start,
+                          const FT_TS_Byte*  end );
+#endif
+
 
 FT_TS_END_HEADER
 
@@ -43,6 +43,45 @@
 FT_TS_BEGIN_HEADER
 
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+
+  /*
+   * A pre-decoded Type 2 charstring, created by `cf2_decodeT2CharString'.
+   *
+   * Each token holds an operator together with the number of operands
+   * preceding it; the operands themselves are stored in `args', ready to
+   * be copied to the operand stack.  Operator 255 (which is not a valid
+   * operator) marks operands not followed by an operator.  `offset' is
+   * the position of the byte following the operator, allowing the
+   * interpreter to read trailing data (like the second byte of escaped
+   * operators) directly from the buffer.
+   *
+   * Decoding stops after the first `hintmask' or `cntrmask' operator,
+   * since the size of its mask is only known at run time; interpretation
+   * then continues with the raw data at offset `resume'.
+   */
+  typedef struct  CF2_TokenRec_
+  {
+    FT_TS_UInt32  offset;
+    FT_TS_UShort  numArgs;
+    FT_TS_Byte    op;
+
+  } CF2_TokenRec, *CF2_Token;
+
+
+  typedef struct  CF2_TokensRec_
+  {
+    FT_TS_UInt                numTokens;
+    FT_TS_UInt                numArgs;
+    FT_TS_UInt                resume;
+    CF2_TokenRec*             tokens;
+    struct CF2_StackNumber_*  args;
+
+  } CF2_TokensRec, *CF2_Tokens;
+
+#endif /* CFF_CONFIG_OPTION_SUBR_CACHE */
+
+
   typedef struct  CF2_BufferRec_
   {
     FT_TS_Error*       error;
@@ -50,6 +89,14 @@ FT_TS_BEGIN_HEADER
     const FT_TS_Byte*  end;
     const FT_TS_Byte*  ptr;
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+    /* pre-decoded data; `token' is NULL if no tokens are left */
+    const CF2_TokenRec*             token;
+    const CF2_TokenRec*             token_end;
+    const struct CF2_StackNumber_*  args;
+    const FT_TS_Byte*               resume;
+#endif
+
   } CF2_BufferRec, *CF2_Buffer;
 
 
@@ -133,6 +133,27 @@
   }
 
 
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+
+  /* push a run of pre-decoded operands */
+  FT_TS_LOCAL_DEF( void )
+  cf2_stack_pushNumbers( CF2_Stack               stack,
+                         const CF2_StackNumber*  numbers,
+                         CF2_UInt                count )
+  {
+    if ( count > (CF2_UInt)( stack->buffer + stack->stackSize - stack->top ) )
+    {
+      CF2_SET_ERROR( stack->error, Stack_Overflow );
+      return;     /* stack overflow */
+    }
+
+    FT_TS_MEM_COPY( stack->top, numbers, count * sizeof ( *numbers ) );
+    stack->top += count;
+  }
+
+#endif /* CFF_CONFIG_OPTION_SUBR_CACHE */
+
+
   /* this function is only allowed to pop an integer type */
   FT_TS_LOCAL_DEF( CF2_Int )
   cf2_stack_popInt( CF2_Stack  stack )
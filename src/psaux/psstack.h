@@ -86,6 +86,12 @@ FT_TS_BEGIN_HEADER
   FT_TS_LOCAL( void )
   cf2_stack_pushFixed( CF2_Stack  stack,
                        CF2_Fixed  val );
+#ifdef CFF_CONFIG_OPTION_SUBR_CACHE
+  FT_TS_LOCAL( void )
+  cf2_stack_pushNumbers( CF2_Stack               stack,
+                         const CF2_StackNumber*  numbers,
+                         CF2_UInt                count );
+#endif
 
   FT_TS_LOCAL( CF2_Int )
   cf2_stack_popInt( CF2_Stack  stack );
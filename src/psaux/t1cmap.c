@@ -145,7 +145,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -174,7 +176,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -274,7 +278,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -367,7 +373,9 @@
     (FT_TS_CMap_CharVarIsDefaultFunc)NULL,  /* char_var_default */
     (FT_TS_CMap_VariantListFunc)     NULL,  /* variant_list     */
     (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
-    (FT_TS_CMap_VariantCharListFunc) NULL   /* variantchar_list */
+    (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
+
+    (FT_TS_CMap_CharIndicesFunc)     NULL   /* char_indices     */
   };
 
 
@@ -180,13 +180,28 @@
   }
 
 
+  static const char*
+  sfnt_get_glyph_name_string( void*       object,
+                              FT_TS_UInt  idx )
+  {
+    FT_TS_String*  gname;
+
+
+    if ( tt_face_get_ps_name( (TT_Face)object, idx, &gname ) )
+      return NULL;
+
+    return gname;
+  }
+
+
   static FT_TS_UInt
   sfnt_get_name_index( FT_TS_Face           face,
                        const FT_TS_String*  glyph_name )
   {
     TT_Face  ttface = (TT_Face)face;
 
-    FT_TS_UInt  i, max_gid = FT_TS_UINT_MAX;
+    FT_TS_UInt  max_gid = FT_TS_UINT_MAX;
+    FT_TS_Long  idx;
 
 
     if ( face->num_glyphs < 0 )
@@ -197,20 +212,14 @@
       FT_TS_TRACE0(( "Ignore glyph names for invalid GID 0x%08x - 0x%08lx\n",
                   FT_TS_UINT_MAX, face->num_glyphs ));
 
-    for ( i = 0; i < max_gid; i++ )
-    {
-      FT_TS_String*  gname;
-      FT_TS_Error    error = tt_face_get_ps_name( ttface, i, &gname );
-
-
-      if ( error )
-        continue;
+    idx = ft_hash_name_index( &ttface->postscript_names.name_index,
+                              glyph_name,
+                              max_gid,
+                              sfnt_get_glyph_name_string,
+                              ttface,
+                              face->memory );
 
-      if ( !ft_strcmp( glyph_name, gname ) )
-        return i;
-    }
-
-    return 0;
+    return idx >= 0 ? (FT_TS_UInt)idx : 0;
   }
 
 
@@ -1312,11 +1321,30 @@
   )
 
 
+#if defined( FT_TS_CONFIG_OPTION_USE_BROTLI ) && \
+    defined( TT_CONFIG_OPTION_WOFF2_CACHE )
+
+  FT_TS_CALLBACK_DEF( void )
+  sfnt_module_done( FT_TS_Module  module )
+  {
+    woff2_cache_done( &( (SFNT_Module)module )->woff2_cache,
+                      module->memory );
+  }
+
+#define PUT_MODULE_DONE( a )  (FT_TS_Module_Destructor)a
+
+#else
+
+#define PUT_MODULE_DONE( a )  (FT_TS_Module_Destructor)NULL
+
+#endif
+
+
   FT_TS_DEFINE_MODULE(
     sfnt_module_class,
 
     0,  /* not a font driver or renderer */
-    sizeof ( FT_TS_ModuleRec ),
+    sizeof ( SFNT_ModuleRec ),
 
     "sfnt",     /* driver name                            */
     0x10000L,   /* driver version 1.0                     */
@@ -1325,7 +1353,7 @@
     (const void*)&sfnt_interface,  /* module specific interface */
 
     (FT_TS_Module_Constructor)NULL,               /* module_init   */
-    (FT_TS_Module_Destructor) NULL,               /* module_done   */
+    PUT_MODULE_DONE( sfnt_module_done ),          /* module_done   */
     (FT_TS_Module_Requester)  sfnt_get_interface  /* get_interface */
   )
 
@@ -21,10 +21,35 @@
 
 
 #include <freetype/ftmodapi.h>
+#include <freetype/internal/ftobjs.h>
+
+#include "sfwoff2.h"
 
 
 FT_TS_BEGIN_HEADER
 
+
+  /**************************************************************************
+   *
+   * @Type:
+   *   SFNT_ModuleRec
+   *
+   * @Description:
+   *   The `sfnt' module record.  It holds data shared by all faces that
+   *   are loaded with the module.
+   */
+  typedef struct  SFNT_ModuleRec_
+  {
+    FT_TS_ModuleRec  root;
+
+#if defined( FT_TS_CONFIG_OPTION_USE_BROTLI ) && \
+    defined( TT_CONFIG_OPTION_WOFF2_CACHE )
+    WOFF2_CacheRec   woff2_cache;
+#endif
+
+  } SFNT_ModuleRec, *SFNT_Module;
+
+
   FT_TS_DECLARE_MODULE( sfnt_module_class )
 
 FT_TS_END_HEADER
@@ -1446,6 +1446,10 @@
     face->horz_metrics_size = 0;
     face->vert_metrics_size = 0;
 
+    /* freeing the decoded metrics */
+    FT_TS_FREE( face->horz_metrics );
+    FT_TS_FREE( face->vert_metrics );
+
     /* freeing vertical metrics, if any */
     if ( face->vertical_info )
     {
@@ -55,6 +55,209 @@
           } while ( 0 )
 
 
+#ifdef TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+
+  /*
+   * The SFNT data of a WOFF font.  Only the SFNT header and the table
+   * directory are built when the font gets opened; a compressed table is
+   * decompressed on its first access and kept until the face gets closed.
+   * Uncompressed tables are read directly from the WOFF stream.
+   */
+  typedef struct  WOFF_SfntRec_
+  {
+    FT_TS_Memory   memory;
+    FT_TS_Stream   stream;       /* the WOFF stream                 */
+    FT_TS_Bool     external;     /* `stream' is owned by the client */
+
+    FT_TS_Byte*    header;       /* SFNT header and table directory */
+    FT_TS_ULong    header_size;
+
+    FT_TS_UShort   num_tables;
+    WOFF_Table     tables;       /* sorted by tag                   */
+    WOFF_Table*    indices;      /* sorted by offset                */
+    FT_TS_Byte**   data;         /* decompressed tables, by offset  */
+
+  } WOFF_SfntRec, *WOFF_Sfnt;
+
+
+  static FT_TS_Error
+  woff_sfnt_load_table( WOFF_Sfnt   sfnt,
+                        FT_TS_UInt  idx )
+  {
+    FT_TS_Stream  stream = sfnt->stream;
+    FT_TS_Memory  memory = sfnt->memory;
+    FT_TS_Error   error;
+
+    WOFF_Table    table      = sfnt->indices[idx];
+    FT_TS_Byte*   data       = NULL;
+    FT_TS_ULong   output_len = table->OrigLength;
+
+
+    if ( FT_TS_QALLOC( data, table->OrigLength ) )
+      return error;
+
+    if ( FT_TS_STREAM_SEEK( table->Offset )     ||
+         FT_TS_FRAME_ENTER( table->CompLength ) )
+      goto Exit;
+
+    error = FT_TS_Gzip_Uncompress( memory,
+                                data, &output_len,
+                                stream->cursor, table->CompLength );
+
+    FT_TS_FRAME_EXIT();
+
+    if ( error )
+      goto Exit;
+
+    if ( output_len != table->OrigLength )
+    {
+      FT_TS_ERROR(( "woff_sfnt_load_table:"
+                 " compressed table length mismatch\n" ));
+      error = FT_TS_THROW( Invalid_Table );
+      goto Exit;
+    }
+
+    sfnt->data[idx] = data;
+    data            = NULL;
+
+  Exit:
+    FT_TS_FREE( data );
+
+    return error;
+  }
+
+
+  static unsigned long
+  woff_sfnt_stream_io( FT_TS_Stream    stream,
+                       unsigned long   offset,
+                       unsigned char*  buffer,
+                       unsigned long   count )
+  {
+    WOFF_Sfnt      sfnt = (WOFF_Sfnt)stream->descriptor.pointer;
+    unsigned long  read = 0;
+
+
+    /* seek only; seeking to the end of the stream is valid */
+    if ( !count )
+      return offset > stream->size;
+
+    if ( offset >= stream->size )
+      return 0;
+
+    if ( count > stream->size - offset )
+      count = stream->size - offset;
+
+    while ( count )
+    {
+      FT_TS_ULong  n;
+
+
+      if ( offset < sfnt->header_size )
+      {
+        n = sfnt->header_size - offset;
+        if ( n > count )
+          n = count;
+
+        FT_TS_MEM_COPY( buffer, sfnt->header + offset, n );
+      }
+      else
+      {
+        WOFF_Table  table;
+        FT_TS_UInt  min = 0;
+        FT_TS_UInt  max = sfnt->num_tables;
+
+
+        /* find the last table starting at or before `offset'; */
+        /* the first table follows the table directory         */
+        while ( max - min > 1 )
+        {
+          FT_TS_UInt  mid = ( min + max ) / 2;
+
+
+          if ( sfnt->indices[mid]->OrigOffset <= offset )
+            min = mid;
+          else
+            max = mid;
+        }
+
+        table = sfnt->indices[min];
+
+        if ( offset < table->OrigOffset + table->OrigLength )
+        {
+          FT_TS_ULong  delta = offset - table->OrigOffset;
+
+
+          n = table->OrigLength - delta;
+          if ( n > count )
+            n = count;
+
+          if ( table->CompLength == table->OrigLength )
+          {
+            if ( FT_TS_Stream_ReadAt( sfnt->stream,
+                                   table->Offset + delta,
+                                   buffer,
+                                   n ) )
+              break;
+          }
+          else
+          {
+            if ( !sfnt->data[min]                   &&
+                 woff_sfnt_load_table( sfnt, min ) )
+              break;
+
+            FT_TS_MEM_COPY( buffer, sfnt->data[min] + delta, n );
+          }
+        }
+        else
+        {
+          /* padding */
+          n = ( ( table->OrigOffset + table->OrigLength + 3 ) & ~3U ) -
+              offset;
+          if ( n > count )
+            n = count;
+
+          FT_TS_MEM_ZERO( buffer, n );
+        }
+      }
+
+      buffer += n;
+      offset += n;
+      count  -= n;
+      read   += n;
+    }
+
+    return read;
+  }
+
+
+  static void
+  woff_sfnt_stream_close( FT_TS_Stream  stream )
+  {
+    WOFF_Sfnt     sfnt   = (WOFF_Sfnt)stream->descriptor.pointer;
+    FT_TS_Memory  memory = sfnt->memory;
+    FT_TS_UInt    nn;
+
+
+    for ( nn = 0; nn < sfnt->num_tables; nn++ )
+      FT_TS_FREE( sfnt->data[nn] );
+
+    FT_TS_FREE( sfnt->data );
+    FT_TS_FREE( sfnt->tables );
+    FT_TS_FREE( sfnt->indices );
+    FT_TS_FREE( sfnt->header );
+
+    FT_TS_Stream_Free( sfnt->stream, sfnt->external );
+
+    FT_TS_FREE( sfnt );
+
+    stream->size               = 0;
+    stream->descriptor.pointer = NULL;
+    stream->close              = NULL;
+  }
+
+#endif /* TT_CONFIG_OPTION_WOFF_LAZY_TABLES */
+
+
   static void
   sfnt_stream_close( FT_TS_Stream  stream )
   {
@@ -113,6 +316,11 @@
 
     FT_TS_Int          nn;
     FT_TS_Tag          old_tag = 0;
+    FT_TS_Bool         lazy    = 0;
+
+#ifdef TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+    WOFF_Sfnt       sfnt_data = NULL;
+#endif
 
     static const FT_TS_Frame_Field  woff_header_fields[] =
     {
@@ -328,10 +536,19 @@
       goto Exit;
     }
 
+#ifdef TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+    /* Decompress the tables on demand.  CFF-based fonts are excluded: */
+    /* the `cff' driver reads the whole `CFF ' table while opening the */
+    /* font anyway, and only a memory-based stream lets it do so       */
+    /* without copying the data.                                       */
+    lazy = woff.flavor != TTAG_OTTO;
+#endif
+
     /* Now use `totalSfntSize'. */
-    if ( FT_TS_REALLOC( sfnt,
-                     12 + woff.num_tables * 16UL,
-                     woff.totalSfntSize ) )
+    if ( !lazy                                   &&
+         FT_TS_REALLOC( sfnt,
+                        12 + woff.num_tables * 16UL,
+                        woff.totalSfntSize )     )
       goto Exit;
 
     sfnt_header = sfnt + 12;
@@ -349,6 +566,9 @@
       WRITE_ULONG( sfnt_header, table->OrigOffset );
       WRITE_ULONG( sfnt_header, table->OrigLength );
 
+      if ( lazy )
+        continue;
+
       /* Write table data. */
       if ( FT_TS_STREAM_SEEK( table->Offset )     ||
            FT_TS_FRAME_ENTER( table->CompLength ) )
@@ -392,14 +612,49 @@
       }
     }
 
-    /* Ok!  Finally ready.  Swap out stream and return. */
-    FT_TS_Stream_OpenMemory( sfnt_stream, sfnt, woff.totalSfntSize );
-    sfnt_stream->memory = stream->memory;
-    sfnt_stream->close  = sfnt_stream_close;
+#ifdef TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+    if ( lazy )
+    {
+      /* Ok!  The tables get decompressed on demand; the new stream */
+      /* takes over the WOFF stream.                                */
+      if ( FT_TS_NEW( sfnt_data )                               ||
+           FT_TS_NEW_ARRAY( sfnt_data->data, woff.num_tables ) )
+        goto Exit;
 
-    FT_TS_Stream_Free(
-      face->root.stream,
-      ( face->root.face_flags & FT_TS_FACE_FLAG_EXTERNAL_STREAM ) != 0 );
+      sfnt_data->memory      = memory;
+      sfnt_data->stream      = stream;
+      sfnt_data->external    =
+        ( face->root.face_flags & FT_TS_FACE_FLAG_EXTERNAL_STREAM ) != 0;
+      sfnt_data->header      = sfnt;
+      sfnt_data->header_size = 12 + woff.num_tables * 16UL;
+      sfnt_data->num_tables  = woff.num_tables;
+      sfnt_data->tables      = tables;
+      sfnt_data->indices     = indices;
+
+      sfnt    = NULL;
+      tables  = NULL;
+      indices = NULL;
+
+      sfnt_stream->size               = woff.totalSfntSize;
+      sfnt_stream->read               = woff_sfnt_stream_io;
+      sfnt_stream->close              = woff_sfnt_stream_close;
+      sfnt_stream->descriptor.pointer = sfnt_data;
+      sfnt_stream->memory             = memory;
+
+      sfnt_data = NULL;
+    }
+    else
+#endif /* TT_CONFIG_OPTION_WOFF_LAZY_TABLES */
+    {
+      /* Ok!  Finally ready.  Swap out stream and return. */
+      FT_TS_Stream_OpenMemory( sfnt_stream, sfnt, woff.totalSfntSize );
+      sfnt_stream->memory = stream->memory;
+      sfnt_stream->close  = sfnt_stream_close;
+
+      FT_TS_Stream_Free(
+        face->root.stream,
+        ( face->root.face_flags & FT_TS_FACE_FLAG_EXTERNAL_STREAM ) != 0 );
+    }
 
     face->root.stream = sfnt_stream;
 
@@ -411,6 +666,11 @@
 
     if ( error )
     {
+#ifdef TT_CONFIG_OPTION_WOFF_LAZY_TABLES
+      if ( sfnt_data )
+        FT_TS_FREE( sfnt_data->data );
+      FT_TS_FREE( sfnt_data );
+#endif
       FT_TS_FREE( sfnt );
       FT_TS_Stream_Close( sfnt_stream );
       FT_TS_FREE( sfnt_stream );
@@ -16,6 +16,7 @@
  */
 
 #include "sfwoff2.h"
+#include "sfdriver.h"
 #include "woff2tags.h"
 #include <freetype/tttags.h>
 #include <freetype/internal/ftdebug.h>
@@ -85,18 +86,8 @@
 #define INSTRUCTION_STREAM  6
 
 
-  static void
-  stream_close( FT_TS_Stream  stream )
-  {
-    FT_TS_Memory  memory = stream->memory;
-
-
-    FT_TS_FREE( stream->base );
-
-    stream->size  = 0;
-    stream->base  = NULL;
-    stream->close = NULL;
-  }
+  typedef struct  WOFF2_GlyfRec_*  WOFF2_Glyf;
+  typedef struct  WOFF2_SfntRec_*  WOFF2_Sfnt;
 
 
   FT_TS_COMPARE_DEF( int )
@@ -517,6 +508,44 @@
   }
 
 
+  /* Compute the number of bytes taken by `n_points' triplets (as */
+  /* decoded by `triplet_decode') without decoding them.          */
+  static FT_TS_Error
+  triplet_skip( const FT_TS_Byte*  flags_in,
+                FT_TS_ULong        in_size,
+                FT_TS_ULong        n_points,
+                FT_TS_ULong*       in_bytes_used )
+  {
+    FT_TS_ULong  triplet_index = 0;
+    FT_TS_ULong  i;
+
+
+    if ( n_points > in_size )
+      return FT_TS_THROW( Invalid_Table );
+
+    for ( i = 0; i < n_points; ++i )
+    {
+      FT_TS_Byte  flag = flags_in[i] & 0x7f;
+
+
+      if ( flag < 84 )
+        triplet_index += 1;
+      else if ( flag < 120 )
+        triplet_index += 2;
+      else if ( flag < 124 )
+        triplet_index += 3;
+      else
+        triplet_index += 4;
+    }
+
+    if ( triplet_index > in_size )
+      return FT_TS_THROW( Invalid_Table );
+
+    *in_bytes_used = triplet_index;
+    return FT_TS_Err_Ok;
+  }
+
+
   /* Store decoded points in glyph buffer. */
   static FT_TS_Error
   store_points( FT_TS_ULong           n_points,
@@ -816,18 +845,16 @@
   }
 
 
+  /* Read the header of a transformed `glyf' table from `stream' (which */
+  /* must be positioned at its start) and set up its `substreams'.      */
   static FT_TS_Error
-  reconstruct_glyf( FT_TS_Stream    stream,
-                    FT_TS_ULong*    glyf_checksum,
-                    FT_TS_ULong*    loca_checksum,
-                    FT_TS_Byte**    sfnt_bytes,
-                    FT_TS_ULong*    sfnt_size,
-                    FT_TS_ULong*    out_offset,
-                    WOFF2_Info   info,
-                    FT_TS_Memory    memory )
+  read_glyf_header( FT_TS_Stream     stream,
+                    WOFF2_Info       info,
+                    WOFF2_Substream  substreams,
+                    FT_TS_UShort*    anum_glyphs,
+                    FT_TS_UShort*    aindex_format )
   {
     FT_TS_Error  error = FT_TS_Err_Ok;
-    FT_TS_Byte*  sfnt  = *sfnt_bytes;
 
     /* current position in stream */
     const FT_TS_ULong  pos = FT_TS_STREAM_POS();
@@ -839,24 +866,8 @@
     FT_TS_ULong   expected_loca_length;
     FT_TS_UInt    offset;
     FT_TS_UInt    i;
-    FT_TS_ULong   points_size;
     FT_TS_ULong   bitmap_length;
-    FT_TS_ULong   glyph_buf_size;
-    FT_TS_ULong   bbox_bitmap_offset;
 
-    const FT_TS_ULong  glyf_start  = *out_offset;
-    FT_TS_ULong        dest_offset = *out_offset;
-
-    WOFF2_Substream  substreams = NULL;
-
-    FT_TS_ULong*    loca_values  = NULL;
-    FT_TS_UShort*   n_points_arr = NULL;
-    FT_TS_Byte*     glyph_buf    = NULL;
-    WOFF2_Point  points       = NULL;
-
-
-    if ( FT_TS_NEW_ARRAY( substreams, num_substreams ) )
-      goto Fail;
 
     if ( FT_TS_STREAM_SKIP( 4 ) )
       goto Fail;
@@ -902,178 +913,229 @@
       offset += substream_size;
     }
 
-    if ( FT_TS_NEW_ARRAY( loca_values, num_glyphs + 1 ) )
+    /* The bbox substream starts with `bboxBitmap', its size being */
+    /* 4 * floor((numGlyphs + 31) / 32).                            */
+    bitmap_length = ( ( num_glyphs + 31U ) >> 5 ) << 2;
+    if ( bitmap_length > substreams[BBOX_STREAM].size )
       goto Fail;
 
-    points_size        = 0;
-    bbox_bitmap_offset = substreams[BBOX_STREAM].offset;
-
-    /* Size of bboxBitmap = 4 * floor((numGlyphs + 31) / 32) */
-    bitmap_length                   = ( ( num_glyphs + 31U ) >> 5 ) << 2;
     substreams[BBOX_STREAM].offset += bitmap_length;
 
-    glyph_buf_size = WOFF2_DEFAULT_GLYPH_BUF;
-    if ( FT_TS_NEW_ARRAY( glyph_buf, glyph_buf_size ) )
+    *anum_glyphs   = num_glyphs;
+    *aindex_format = index_format;
+
+    return error;
+
+  Fail:
+    if ( !error )
+      error = FT_TS_THROW( Invalid_Table );
+
+    return error;
+  }
+
+
+  /*
+   * Reconstruct glyph `glyph_index' of a transformed `glyf' table read by
+   * `stream' into `*glyph_buf' (which gets enlarged if necessary), setting
+   * `*glyph_size' to its size and `*ax_min' to its minimum x coordinate.
+   * The offsets in `substreams' must point to the glyph's data; they are
+   * advanced to the next glyph.
+   *
+   * If `glyph_buf' is NULL, the glyph data is only checked and skipped,
+   * and `*glyph_size' is set to an upper bound of the glyph's size.  For
+   * simple glyphs without explicit bounding box, `*ax_min' is then only
+   * computed if `need_x_min' is set.
+   */
+  static FT_TS_Error
+  reconstruct_glyph( FT_TS_Stream     stream,
+                     WOFF2_Substream  substreams,
+                     FT_TS_UInt       glyph_index,
+                     FT_TS_Bool       need_x_min,
+                     FT_TS_Byte**     glyph_buf,
+                     FT_TS_ULong*     glyph_buf_size,
+                     FT_TS_ULong*     glyph_size,
+                     FT_TS_Short*     ax_min,
+                     FT_TS_Memory     memory )
+  {
+    FT_TS_Error   error      = FT_TS_Err_Ok;
+    FT_TS_ULong   size       = 0;
+    FT_TS_UShort  n_contours = 0;
+    FT_TS_Bool    have_bbox  = FALSE;
+    FT_TS_Byte    bbox_bitmap;
+    FT_TS_ULong   bbox_offset;
+    FT_TS_UShort  x_min      = 0;
+
+    FT_TS_UShort*  n_points_arr = NULL;
+    WOFF2_Point    points       = NULL;
+
+
+    /* Set `have_bbox'. */
+    bbox_offset = substreams[BBOX_STREAM].start + ( glyph_index >> 3 );
+    if ( FT_TS_STREAM_SEEK( bbox_offset ) ||
+         FT_TS_READ_BYTE( bbox_bitmap )   )
       goto Fail;
+    if ( bbox_bitmap & ( 0x80 >> ( glyph_index & 7 ) ) )
+      have_bbox = TRUE;
 
-    if ( FT_TS_NEW_ARRAY( info->x_mins, num_glyphs ) )
+    /* Read value from `nContourStream'. */
+    if ( FT_TS_STREAM_SEEK( substreams[N_CONTOUR_STREAM].offset ) ||
+         FT_TS_READ_USHORT( n_contours )                          )
       goto Fail;
+    substreams[N_CONTOUR_STREAM].offset += 2;
 
-    for ( i = 0; i < num_glyphs; ++i )
+    if ( n_contours == 0xffff )
     {
-      FT_TS_ULong   glyph_size = 0;
-      FT_TS_UShort  n_contours = 0;
-      FT_TS_Bool    have_bbox  = FALSE;
-      FT_TS_Byte    bbox_bitmap;
-      FT_TS_ULong   bbox_offset;
-      FT_TS_UShort  x_min      = 0;
+      /* composite glyph */
+      FT_TS_Bool    have_instructions = FALSE;
+      FT_TS_UShort  instruction_size  = 0;
+      FT_TS_ULong   composite_size;
+      FT_TS_ULong   size_needed;
+      FT_TS_Byte*   pointer           = NULL;
 
 
-      /* Set `have_bbox'. */
-      bbox_offset = bbox_bitmap_offset + ( i >> 3 );
-      if ( FT_TS_STREAM_SEEK( bbox_offset ) ||
-           FT_TS_READ_BYTE( bbox_bitmap )   )
+      /* Composite glyphs must have explicit bbox. */
+      if ( !have_bbox )
         goto Fail;
-      if ( bbox_bitmap & ( 0x80 >> ( i & 7 ) ) )
-        have_bbox = TRUE;
 
-      /* Read value from `nContourStream'. */
-      if ( FT_TS_STREAM_SEEK( substreams[N_CONTOUR_STREAM].offset ) ||
-           FT_TS_READ_USHORT( n_contours )                          )
+      if ( compositeGlyph_size( stream,
+                                substreams[COMPOSITE_STREAM].offset,
+                                &composite_size,
+                                &have_instructions) )
         goto Fail;
-      substreams[N_CONTOUR_STREAM].offset += 2;
 
-      if ( n_contours == 0xffff )
+      if ( have_instructions )
       {
-        /* composite glyph */
-        FT_TS_Bool    have_instructions = FALSE;
-        FT_TS_UShort  instruction_size  = 0;
-        FT_TS_ULong   composite_size;
-        FT_TS_ULong   size_needed;
-        FT_TS_Byte*   pointer           = NULL;
-
-
-        /* Composite glyphs must have explicit bbox. */
-        if ( !have_bbox )
+        if ( FT_TS_STREAM_SEEK( substreams[GLYPH_STREAM].offset ) ||
+             READ_255USHORT( instruction_size )                )
           goto Fail;
+        substreams[GLYPH_STREAM].offset = FT_TS_STREAM_POS();
+      }
 
-        if ( compositeGlyph_size( stream,
-                                  substreams[COMPOSITE_STREAM].offset,
-                                  &composite_size,
-                                  &have_instructions) )
-          goto Fail;
+      /* Read x_min for current glyph. */
+      if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
+           FT_TS_READ_USHORT( x_min )                          )
+        goto Fail;
+      /* No increment here because we read again. */
 
-        if ( have_instructions )
-        {
-          if ( FT_TS_STREAM_SEEK( substreams[GLYPH_STREAM].offset ) ||
-               READ_255USHORT( instruction_size )                )
-            goto Fail;
-          substreams[GLYPH_STREAM].offset = FT_TS_STREAM_POS();
-        }
+      size_needed = 12 + composite_size + instruction_size;
 
-        size_needed = 12 + composite_size + instruction_size;
-        if ( glyph_buf_size < size_needed )
-        {
-          if ( FT_TS_RENEW_ARRAY( glyph_buf, glyph_buf_size, size_needed ) )
-            goto Fail;
-          glyph_buf_size = size_needed;
-        }
+      if ( !glyph_buf )
+      {
+        if ( substreams[BBOX_STREAM].offset + 8 > stream->size ||
+             substreams[INSTRUCTION_STREAM].offset + instruction_size >
+               stream->size                                        )
+          goto Fail;
 
-        pointer = glyph_buf + glyph_size;
-        WRITE_USHORT( pointer, n_contours );
-        glyph_size += 2;
+        substreams[BBOX_STREAM].offset        += 8;
+        substreams[COMPOSITE_STREAM].offset   += composite_size;
+        substreams[INSTRUCTION_STREAM].offset += instruction_size;
 
-        /* Read x_min for current glyph. */
-        if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
-             FT_TS_READ_USHORT( x_min )                          )
-          goto Fail;
-        /* No increment here because we read again. */
+        size = size_needed;
+        goto Exit;
+      }
 
-        if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
-             FT_TS_STREAM_READ( glyph_buf + glyph_size, 8 )      )
+      if ( *glyph_buf_size < size_needed )
+      {
+        if ( FT_TS_RENEW_ARRAY( *glyph_buf, *glyph_buf_size, size_needed ) )
           goto Fail;
+        *glyph_buf_size = size_needed;
+      }
 
-        substreams[BBOX_STREAM].offset += 8;
-        glyph_size                     += 8;
+      pointer = *glyph_buf + size;
+      WRITE_USHORT( pointer, n_contours );
+      size += 2;
 
-        if ( FT_TS_STREAM_SEEK( substreams[COMPOSITE_STREAM].offset )    ||
-             FT_TS_STREAM_READ( glyph_buf + glyph_size, composite_size ) )
-          goto Fail;
+      if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
+           FT_TS_STREAM_READ( *glyph_buf + size, 8 )           )
+        goto Fail;
 
-        substreams[COMPOSITE_STREAM].offset += composite_size;
-        glyph_size                          += composite_size;
+      substreams[BBOX_STREAM].offset += 8;
+      size                           += 8;
 
-        if ( have_instructions )
-        {
-          pointer = glyph_buf + glyph_size;
-          WRITE_USHORT( pointer, instruction_size );
-          glyph_size += 2;
+      if ( FT_TS_STREAM_SEEK( substreams[COMPOSITE_STREAM].offset ) ||
+           FT_TS_STREAM_READ( *glyph_buf + size, composite_size )   )
+        goto Fail;
 
-          if ( FT_TS_STREAM_SEEK( substreams[INSTRUCTION_STREAM].offset )    ||
-               FT_TS_STREAM_READ( glyph_buf + glyph_size, instruction_size ) )
-            goto Fail;
+      substreams[COMPOSITE_STREAM].offset += composite_size;
+      size                                += composite_size;
 
-          substreams[INSTRUCTION_STREAM].offset += instruction_size;
-          glyph_size                            += instruction_size;
-        }
-      }
-      else if ( n_contours > 0 )
+      if ( have_instructions )
       {
-        /* simple glyph */
-        FT_TS_ULong   total_n_points = 0;
-        FT_TS_UShort  n_points_contour;
-        FT_TS_UInt    j;
-        FT_TS_ULong   flag_size;
-        FT_TS_ULong   triplet_size;
-        FT_TS_ULong   triplet_bytes_used;
-        FT_TS_Byte*   flags_buf   = NULL;
-        FT_TS_Byte*   triplet_buf = NULL;
-        FT_TS_UShort  instruction_size;
-        FT_TS_ULong   size_needed;
-        FT_TS_Int     end_point;
-        FT_TS_UInt    contour_ix;
-
-        FT_TS_Byte*   pointer = NULL;
-
-
-        if ( FT_TS_NEW_ARRAY( n_points_arr, n_contours ) )
-          goto Fail;
+        pointer = *glyph_buf + size;
+        WRITE_USHORT( pointer, instruction_size );
+        size += 2;
 
-        if ( FT_TS_STREAM_SEEK( substreams[N_POINTS_STREAM].offset ) )
+        /* the instruction substream might be empty */
+        if ( instruction_size                                           &&
+             ( FT_TS_STREAM_SEEK( substreams[INSTRUCTION_STREAM].offset ) ||
+               FT_TS_STREAM_READ( *glyph_buf + size, instruction_size ) ) )
           goto Fail;
 
-        for ( j = 0; j < n_contours; ++j )
-        {
-          if ( READ_255USHORT( n_points_contour ) )
-            goto Fail;
-          n_points_arr[j] = n_points_contour;
-          /* Prevent negative/overflow. */
-          if ( total_n_points + n_points_contour < total_n_points )
-            goto Fail;
-          total_n_points += n_points_contour;
-        }
-        substreams[N_POINTS_STREAM].offset = FT_TS_STREAM_POS();
+        substreams[INSTRUCTION_STREAM].offset += instruction_size;
+        size                                  += instruction_size;
+      }
+    }
+    else if ( n_contours > 0 )
+    {
+      /* simple glyph */
+      FT_TS_ULong   total_n_points = 0;
+      FT_TS_UShort  n_points_contour;
+      FT_TS_UInt    j;
+      FT_TS_ULong   flag_size;
+      FT_TS_ULong   triplet_size;
+      FT_TS_ULong   triplet_bytes_used;
+      FT_TS_Byte*   flags_buf   = NULL;
+      FT_TS_Byte*   triplet_buf = NULL;
+      FT_TS_UShort  instruction_size;
+      FT_TS_ULong   size_needed;
+      FT_TS_Int     end_point;
+      FT_TS_UInt    contour_ix;
+
+      FT_TS_Byte*   pointer = NULL;
+
+
+      if ( glyph_buf && FT_TS_NEW_ARRAY( n_points_arr, n_contours ) )
+        goto Fail;
+
+      if ( FT_TS_STREAM_SEEK( substreams[N_POINTS_STREAM].offset ) )
+        goto Fail;
 
-        flag_size = total_n_points;
-        if ( flag_size > substreams[FLAG_STREAM].size )
+      for ( j = 0; j < n_contours; ++j )
+      {
+        if ( READ_255USHORT( n_points_contour ) )
+          goto Fail;
+        if ( n_points_arr )
+          n_points_arr[j] = n_points_contour;
+        /* Prevent negative/overflow. */
+        if ( total_n_points + n_points_contour < total_n_points )
           goto Fail;
+        total_n_points += n_points_contour;
+      }
+      substreams[N_POINTS_STREAM].offset = FT_TS_STREAM_POS();
 
-        flags_buf   = stream->base + substreams[FLAG_STREAM].offset;
-        triplet_buf = stream->base + substreams[GLYPH_STREAM].offset;
+      flag_size = total_n_points;
+      if ( flag_size > substreams[FLAG_STREAM].size -
+                         ( substreams[FLAG_STREAM].offset -
+                           substreams[FLAG_STREAM].start ) )
+        goto Fail;
 
-        if ( substreams[GLYPH_STREAM].size <
-               ( substreams[GLYPH_STREAM].offset -
-                 substreams[GLYPH_STREAM].start ) )
-          goto Fail;
+      flags_buf   = stream->base + substreams[FLAG_STREAM].offset;
+      triplet_buf = stream->base + substreams[GLYPH_STREAM].offset;
+
+      if ( substreams[GLYPH_STREAM].size <
+             ( substreams[GLYPH_STREAM].offset -
+               substreams[GLYPH_STREAM].start ) )
+        goto Fail;
 
-        triplet_size       = substreams[GLYPH_STREAM].size -
-                               ( substreams[GLYPH_STREAM].offset -
-                                 substreams[GLYPH_STREAM].start );
-        triplet_bytes_used = 0;
+      triplet_size       = substreams[GLYPH_STREAM].size -
+                             ( substreams[GLYPH_STREAM].offset -
+                               substreams[GLYPH_STREAM].start );
+      triplet_bytes_used = 0;
 
+      if ( glyph_buf || ( need_x_min && !have_bbox ) )
+      {
         /* Create array to store point information. */
-        points_size = total_n_points;
-        if ( FT_TS_NEW_ARRAY( points, points_size ) )
+        if ( FT_TS_NEW_ARRAY( points, total_n_points ) )
           goto Fail;
 
         if ( triplet_decode( flags_buf,
@@ -1083,97 +1145,213 @@
                              points,
                              &triplet_bytes_used ) )
           goto Fail;
+      }
+      else if ( triplet_skip( flags_buf,
+                              triplet_size,
+                              total_n_points,
+                              &triplet_bytes_used ) )
+        goto Fail;
 
-        substreams[FLAG_STREAM].offset  += flag_size;
-        substreams[GLYPH_STREAM].offset += triplet_bytes_used;
+      substreams[FLAG_STREAM].offset  += flag_size;
+      substreams[GLYPH_STREAM].offset += triplet_bytes_used;
 
-        if ( FT_TS_STREAM_SEEK( substreams[GLYPH_STREAM].offset ) ||
-             READ_255USHORT( instruction_size )                )
-          goto Fail;
+      if ( FT_TS_STREAM_SEEK( substreams[GLYPH_STREAM].offset ) ||
+           READ_255USHORT( instruction_size )                )
+        goto Fail;
 
-        substreams[GLYPH_STREAM].offset = FT_TS_STREAM_POS();
+      substreams[GLYPH_STREAM].offset = FT_TS_STREAM_POS();
 
-        if ( total_n_points >= ( 1 << 27 ) )
+      if ( total_n_points >= ( 1 << 27 ) )
+        goto Fail;
+
+      size_needed = 12 +
+                    ( 2 * n_contours ) +
+                    ( 5 * total_n_points ) +
+                    instruction_size;
+
+      if ( have_bbox )
+      {
+        /* Read x_min for current glyph. */
+        if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
+             FT_TS_READ_USHORT( x_min )                          )
           goto Fail;
+        /* No increment here because we read again. */
+      }
 
-        size_needed = 12 +
-                      ( 2 * n_contours ) +
-                      ( 5 * total_n_points ) +
-                      instruction_size;
-        if ( glyph_buf_size < size_needed )
-        {
-          if ( FT_TS_RENEW_ARRAY( glyph_buf, glyph_buf_size, size_needed ) )
-            goto Fail;
-          glyph_buf_size = size_needed;
-        }
+      if ( !glyph_buf )
+      {
+        FT_TS_Byte  bbox[10];
 
-        pointer = glyph_buf + glyph_size;
-        WRITE_USHORT( pointer, n_contours );
-        glyph_size += 2;
+
+        /* the last end point must fit into 16 bits (see below) */
+        if ( total_n_points > 65536 )
+          goto Fail;
 
         if ( have_bbox )
         {
-          /* Read x_min for current glyph. */
-          if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
-               FT_TS_READ_USHORT( x_min )                          )
-            goto Fail;
-          /* No increment here because we read again. */
-
-          if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
-               FT_TS_STREAM_READ( glyph_buf + glyph_size, 8 )      )
+          if ( substreams[BBOX_STREAM].offset + 8 > stream->size )
             goto Fail;
           substreams[BBOX_STREAM].offset += 8;
         }
-        else
-          compute_bbox( total_n_points, points, glyph_buf, &x_min );
-
-        glyph_size = CONTOUR_OFFSET_END_POINT;
+        else if ( points )
+          compute_bbox( total_n_points, points, bbox, &x_min );
 
-        pointer   = glyph_buf + glyph_size;
-        end_point = -1;
+        if ( substreams[INSTRUCTION_STREAM].offset + instruction_size >
+               stream->size                                          )
+          goto Fail;
+        substreams[INSTRUCTION_STREAM].offset += instruction_size;
 
-        for ( contour_ix = 0; contour_ix < n_contours; ++contour_ix )
-        {
-          end_point += n_points_arr[contour_ix];
-          if ( end_point >= 65536 )
-            goto Fail;
+        size = size_needed;
+        goto Exit;
+      }
 
-          WRITE_SHORT( pointer, end_point );
-          glyph_size += 2;
-        }
+      if ( *glyph_buf_size < size_needed )
+      {
+        if ( FT_TS_RENEW_ARRAY( *glyph_buf, *glyph_buf_size, size_needed ) )
+          goto Fail;
+        *glyph_buf_size = size_needed;
+      }
 
-        WRITE_USHORT( pointer, instruction_size );
-        glyph_size += 2;
+      pointer = *glyph_buf + size;
+      WRITE_USHORT( pointer, n_contours );
+      size += 2;
 
-        if ( FT_TS_STREAM_SEEK( substreams[INSTRUCTION_STREAM].offset )    ||
-             FT_TS_STREAM_READ( glyph_buf + glyph_size, instruction_size ) )
+      if ( have_bbox )
+      {
+        if ( FT_TS_STREAM_SEEK( substreams[BBOX_STREAM].offset ) ||
+             FT_TS_STREAM_READ( *glyph_buf + size, 8 )           )
           goto Fail;
+        substreams[BBOX_STREAM].offset += 8;
+      }
+      else
+        compute_bbox( total_n_points, points, *glyph_buf, &x_min );
 
-        substreams[INSTRUCTION_STREAM].offset += instruction_size;
-        glyph_size                            += instruction_size;
-
-        if ( store_points( total_n_points,
-                           points,
-                           n_contours,
-                           instruction_size,
-                           glyph_buf,
-                           glyph_buf_size,
-                           &glyph_size ) )
+      size = CONTOUR_OFFSET_END_POINT;
+
+      pointer   = *glyph_buf + size;
+      end_point = -1;
+
+      for ( contour_ix = 0; contour_ix < n_contours; ++contour_ix )
+      {
+        end_point += n_points_arr[contour_ix];
+        if ( end_point >= 65536 )
           goto Fail;
 
-        FT_TS_FREE( points );
-        FT_TS_FREE( n_points_arr );
+        WRITE_SHORT( pointer, end_point );
+        size += 2;
       }
-      else
+
+      WRITE_USHORT( pointer, instruction_size );
+      size += 2;
+
+      if ( instruction_size                                           &&
+           ( FT_TS_STREAM_SEEK( substreams[INSTRUCTION_STREAM].offset ) ||
+             FT_TS_STREAM_READ( *glyph_buf + size, instruction_size ) ) )
+        goto Fail;
+
+      substreams[INSTRUCTION_STREAM].offset += instruction_size;
+      size                                  += instruction_size;
+
+      if ( store_points( total_n_points,
+                         points,
+                         n_contours,
+                         instruction_size,
+                         *glyph_buf,
+                         *glyph_buf_size,
+                         &size ) )
+        goto Fail;
+    }
+    else
+    {
+      /* Empty glyph.          */
+      /* Must not have a bbox. */
+      if ( have_bbox )
       {
-        /* Empty glyph.          */
-        /* Must not have a bbox. */
-        if ( have_bbox )
-        {
-          FT_TS_ERROR(( "Empty glyph has a bbox.\n" ));
-          goto Fail;
-        }
+        FT_TS_ERROR(( "Empty glyph has a bbox.\n" ));
+        goto Fail;
       }
+    }
+
+  Exit:
+    *glyph_size = size;
+    *ax_min     = (FT_TS_Short)x_min;
+
+    FT_TS_FREE( n_points_arr );
+    FT_TS_FREE( points );
+
+    return error;
+
+  Fail:
+    if ( !error )
+      error = FT_TS_THROW( Invalid_Table );
+
+    FT_TS_FREE( n_points_arr );
+    FT_TS_FREE( points );
+
+    return error;
+  }
+
+
+  static FT_TS_Error
+  reconstruct_glyf( FT_TS_Stream    stream,
+                    FT_TS_ULong*    glyf_checksum,
+                    FT_TS_ULong*    loca_checksum,
+                    FT_TS_Byte**    sfnt_bytes,
+                    FT_TS_ULong*    sfnt_size,
+                    FT_TS_ULong*    out_offset,
+                    WOFF2_Info   info,
+                    FT_TS_Memory    memory )
+  {
+    FT_TS_Error  error = FT_TS_Err_Ok;
+    FT_TS_Byte*  sfnt  = *sfnt_bytes;
+
+    FT_TS_UShort  num_glyphs;
+    FT_TS_UShort  index_format;
+    FT_TS_UInt    i;
+    FT_TS_ULong   glyph_buf_size;
+
+    const FT_TS_ULong  glyf_start  = *out_offset;
+    FT_TS_ULong        dest_offset = *out_offset;
+
+    WOFF2_SubstreamRec  substreams[7];
+
+    FT_TS_ULong*  loca_values = NULL;
+    FT_TS_Byte*   glyph_buf   = NULL;
+
+
+    if ( read_glyf_header( stream,
+                           info,
+                           substreams,
+                           &num_glyphs,
+                           &index_format ) )
+      goto Fail;
+
+    if ( FT_TS_NEW_ARRAY( loca_values, num_glyphs + 1 ) )
+      goto Fail;
+
+    glyph_buf_size = WOFF2_DEFAULT_GLYPH_BUF;
+    if ( FT_TS_NEW_ARRAY( glyph_buf, glyph_buf_size ) )
+      goto Fail;
+
+    if ( FT_TS_NEW_ARRAY( info->x_mins, num_glyphs ) )
+      goto Fail;
+
+    for ( i = 0; i < num_glyphs; ++i )
+    {
+      FT_TS_ULong  glyph_size;
+
+
+      /* Also store x_mins, may be required to reconstruct `hmtx'. */
+      if ( reconstruct_glyph( stream,
+                              substreams,
+                              i,
+                              TRUE,
+                              &glyph_buf,
+                              &glyph_buf_size,
+                              &glyph_size,
+                              &info->x_mins[i],
+                              memory ) )
+        goto Fail;
 
       loca_values[i] = dest_offset - glyf_start;
 
@@ -1184,10 +1362,6 @@
         goto Fail;
 
       *glyf_checksum += compute_ULong_sum( glyph_buf, glyph_size );
-
-      /* Store x_mins, may be required to reconstruct `hmtx'. */
-      if ( n_contours > 0 )
-        info->x_mins[i] = (FT_TS_Short)x_min;
     }
 
     info->glyf_table->dst_length = dest_offset - info->glyf_table->dst_offset;
@@ -1217,30 +1391,241 @@
     *sfnt_bytes = sfnt;
     *out_offset = dest_offset;
 
-    FT_TS_FREE( substreams );
-    FT_TS_FREE( loca_values );
-    FT_TS_FREE( n_points_arr );
-    FT_TS_FREE( glyph_buf );
-    FT_TS_FREE( points );
+    FT_TS_FREE( loca_values );
+    FT_TS_FREE( glyph_buf );
+
+    return error;
+
+  Fail:
+    if ( !error )
+      error = FT_TS_THROW( Invalid_Table );
+
+    /* Set pointer `sfnt_bytes' to its correct value. */
+    *sfnt_bytes = sfnt;
+
+    FT_TS_FREE( loca_values );
+    FT_TS_FREE( glyph_buf );
+
+    return error;
+  }
+
+
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+
+  /*
+   * Instead of reconstructing a transformed `glyf' table when the font
+   * gets opened, glyphs can be reconstructed one at a time when they are
+   * read from the SFNT stream.  For this purpose, a first pass over the
+   * transformed data records the substream offsets of each glyph along
+   * with an upper bound of its reconstructed size.  The latter gives the
+   * layout of the synthesized `glyf' table; a glyph's slot is padded with
+   * zero bytes.
+   *
+   * The synthesized table is not part of the SFNT data in memory; it
+   * (virtually) follows the last table (see `woff2_sfnt_stream_io').
+   */
+
+  /* number of substream offsets recorded per glyph; the offset into */
+  /* `nContourStream' is implied by the glyph index                  */
+#define WOFF2_GLYPH_OFFSETS  6
+
+  typedef struct  WOFF2_GlyfRec_
+  {
+    FT_TS_Byte*         data;           /* transformed `glyf' table */
+    FT_TS_ULong         data_size;
+    WOFF2_SubstreamRec  substreams[7];
+
+    FT_TS_UShort        num_glyphs;
+    FT_TS_UInt32*       offsets;        /* substream offsets per glyph */
+    FT_TS_ULong*        loca;           /* only while indexing         */
+
+    FT_TS_ULong         offset;         /* position in the SFNT stream */
+    FT_TS_ULong         size;
+    FT_TS_ULong         loca_offset;    /* synthesized `loca' table    */
+    FT_TS_UShort        index_format;
+
+  } WOFF2_GlyfRec;
+
+
+  static void
+  woff2_glyf_done( WOFF2_Glyf    glyf,
+                   FT_TS_Memory  memory )
+  {
+    if ( !glyf )
+      return;
+
+    FT_TS_FREE( glyf->data );
+    FT_TS_FREE( glyf->offsets );
+    FT_TS_FREE( glyf->loca );
+    FT_TS_FREE( glyf );
+  }
+
+
+  /*
+   * Index the transformed `glyf' table in `data'.  `*aglyf' is set to
+   * NULL if the synthesized table would be too large for the font's
+   * `loca' format; the table must then be reconstructed up front.
+   *
+   * The minimum x coordinate of all glyphs is only computed (in
+   * `info->x_mins') if `need_x_mins' is set.
+   *
+   * `data' is not copied; the caller must set `glyf->data' to a buffer
+   * holding it before glyphs get reconstructed.
+   */
+  static FT_TS_Error
+  index_glyf( FT_TS_Byte*   data,
+              FT_TS_ULong   data_size,
+              WOFF2_Info    info,
+              FT_TS_Bool    need_x_mins,
+              WOFF2_Glyf*   aglyf,
+              FT_TS_Memory  memory )
+  {
+    FT_TS_Error      error  = FT_TS_Err_Ok;
+    FT_TS_StreamRec  glyf_stream;
+    FT_TS_Stream     stream = &glyf_stream;
+    WOFF2_Glyf       glyf   = NULL;
+
+    WOFF2_SubstreamRec  substreams[7];
+
+    FT_TS_UShort  num_glyphs;
+    FT_TS_UShort  index_format;
+    FT_TS_UInt    i;
+    FT_TS_ULong   size;
+    FT_TS_ULong   max_size;
+
+
+    *aglyf = NULL;
+
+    if ( FT_TS_NEW( glyf ) )
+      goto Fail;
+
+    glyf->data_size = data_size;
+
+    FT_TS_ZERO( stream );
+    FT_TS_Stream_OpenMemory( stream, data, data_size );
+
+    if ( read_glyf_header( stream,
+                           info,
+                           glyf->substreams,
+                           &num_glyphs,
+                           &index_format ) )
+      goto Fail;
+
+    if ( FT_TS_QNEW_ARRAY( glyf->offsets,
+                           WOFF2_GLYPH_OFFSETS * num_glyphs ) ||
+         FT_TS_QNEW_ARRAY( glyf->loca, num_glyphs + 1 )       ||
+         FT_TS_NEW_ARRAY( info->x_mins, num_glyphs )          )
+      goto Fail;
+
+    FT_TS_ARRAY_COPY( substreams, glyf->substreams, 7 );
+
+    /* short `loca' offsets are stored divided by two */
+    max_size = index_format ? 0xFFFFFFFFUL : 0x1FFFEUL;
+    size     = 0;
+
+    for ( i = 0; i < num_glyphs; i++ )
+    {
+      FT_TS_UInt32*  offsets = glyf->offsets + WOFF2_GLYPH_OFFSETS * i;
+      FT_TS_ULong    glyph_size;
+      FT_TS_UInt     j;
+
+
+      for ( j = 0; j < WOFF2_GLYPH_OFFSETS; j++ )
+        offsets[j] = (FT_TS_UInt32)substreams[N_POINTS_STREAM + j].offset;
+
+      glyf->loca[i] = size;
+
+      if ( reconstruct_glyph( stream,
+                              substreams,
+                              i,
+                              need_x_mins,
+                              NULL,
+                              NULL,
+                              &glyph_size,
+                              &info->x_mins[i],
+                              memory ) )
+        goto Fail;
+
+      glyph_size = ROUND4( glyph_size );
+      if ( glyph_size > max_size - size )
+      {
+        FT_TS_TRACE2(( "index_glyf:"
+                    " glyph offsets exceed `loca' format,"
+                    " reconstructing `glyf' table\n" ));
+
+        FT_TS_FREE( info->x_mins );
+        woff2_glyf_done( glyf, memory );
+
+        return FT_TS_Err_Ok;
+      }
+
+      size += glyph_size;
+    }
+
+    glyf->loca[num_glyphs] = size;
+
+    glyf->num_glyphs   = num_glyphs;
+    glyf->size         = size;
+    glyf->index_format = index_format;
+
+    *aglyf = glyf;
+
+    return error;
+
+  Fail:
+    if ( !error )
+      error = FT_TS_THROW( Invalid_Table );
+
+    woff2_glyf_done( glyf, memory );
+
+    return error;
+  }
+
+
+  /* Reconstruct glyph `glyph_index' of `glyf' into `buffer', which is */
+  /* zero-filled and holds `buffer_size' bytes, the glyph's slot size.  */
+  static FT_TS_Error
+  woff2_glyf_load_glyph( WOFF2_Glyf    glyf,
+                         FT_TS_UInt    glyph_index,
+                         FT_TS_Byte*   buffer,
+                         FT_TS_ULong   buffer_size,
+                         FT_TS_Memory  memory )
+  {
+    FT_TS_StreamRec  glyf_stream;
+    FT_TS_ULong      glyph_size;
+    FT_TS_Short      x_min;
+    FT_TS_UInt       j;
+
+    WOFF2_SubstreamRec  substreams[7];
 
-    return error;
+    const FT_TS_UInt32*  offsets = glyf->offsets +
+                                     WOFF2_GLYPH_OFFSETS * glyph_index;
 
-  Fail:
-    if ( !error )
-      error = FT_TS_THROW( Invalid_Table );
 
-    /* Set pointer `sfnt_bytes' to its correct value. */
-    *sfnt_bytes = sfnt;
+    FT_TS_ZERO( &glyf_stream );
+    FT_TS_Stream_OpenMemory( &glyf_stream, glyf->data, glyf->data_size );
 
-    FT_TS_FREE( substreams );
-    FT_TS_FREE( loca_values );
-    FT_TS_FREE( n_points_arr );
-    FT_TS_FREE( glyph_buf );
-    FT_TS_FREE( points );
+    FT_TS_ARRAY_COPY( substreams, glyf->substreams, 7 );
 
-    return error;
+    substreams[N_CONTOUR_STREAM].offset += 2 * glyph_index;
+    for ( j = 0; j < WOFF2_GLYPH_OFFSETS; j++ )
+      substreams[N_POINTS_STREAM + j].offset = offsets[j];
+
+    /* the buffer is large enough, so `reconstruct_glyph' never has to */
+    /* reallocate it                                                   */
+    return reconstruct_glyph( &glyf_stream,
+                              substreams,
+                              glyph_index,
+                              FALSE,
+                              &buffer,
+                              &buffer_size,
+                              &glyph_size,
+                              &x_min,
+                              memory );
   }
 
+#endif /* TT_CONFIG_OPTION_WOFF2_LAZY_GLYF */
+
 
   /* Get `x_mins' for untransformed `glyf' table. */
   static FT_TS_Error
@@ -1497,6 +1882,7 @@
                     WOFF2_Info    info,
                     FT_TS_Byte**     sfnt_bytes,
                     FT_TS_ULong*     sfnt_size,
+                    WOFF2_Glyf*      aglyf,
                     FT_TS_Memory     memory )
   {
     /* Memory management of `transformed_buf' is handled by the caller. */
@@ -1521,6 +1907,14 @@
 
     FT_TS_ULong  table_entry_offset = 12;
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    WOFF2_Table  hmtx_table;
+    FT_TS_Bool   need_x_mins;
+    FT_TS_ULong  glyf_entry_offset = 0;
+#else
+    FT_TS_UNUSED( aglyf );
+#endif
+
 
     /* A few table checks before reconstruction. */
     /* `glyf' must be present with `loca'.       */
@@ -1545,6 +1939,14 @@
       }
     }
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    /* The minimum x coordinates of glyphs are only needed */
+    /* to reconstruct a transformed `hmtx' table.          */
+    hmtx_table  = find_table( indices, num_tables, TTAG_hmtx );
+    need_x_mins = hmtx_table                                     &&
+                  ( hmtx_table->flags & WOFF2_FLAGS_TRANSFORM ) != 0;
+#endif
+
     /* Create buffer for table entries. */
     if ( FT_TS_NEW_ARRAY( table_entry, 16 ) )
       goto Fail;
@@ -1618,6 +2020,53 @@
           is_glyf_xform    = TRUE;
           table.dst_offset = dest_offset;
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+          if ( index_glyf( transformed_buf + table.src_offset,
+                           table.src_length,
+                           info,
+                           need_x_mins,
+                           aglyf,
+                           memory ) )
+            goto Fail;
+
+          if ( !*aglyf )
+          {
+            /* `woff2_open_font' didn't reserve space for the table */
+            if ( FT_TS_REALLOC( sfnt,
+                                *sfnt_size,
+                                *sfnt_size + table.dst_length ) )
+              goto Fail;
+            *sfnt_size += table.dst_length;
+          }
+
+          if ( *aglyf )
+          {
+            /* Only write `loca' now.  The directory entry of `glyf' */
+            /* gets its final offset and length after the loop.      */
+            glyf_entry_offset = table_entry_offset;
+            table.dst_length  = 0;
+
+            info->loca_table->dst_offset = dest_offset;
+            (*aglyf)->loca_offset        = dest_offset;
+
+            if ( store_loca( (*aglyf)->loca,
+                             info->num_glyphs + 1,
+                             (*aglyf)->index_format,
+                             &loca_checksum,
+                             &sfnt,
+                             sfnt_size,
+                             &dest_offset,
+                             memory ) )
+              goto Fail;
+
+            /* glyph offsets get read from `loca' from now on */
+            FT_TS_FREE( (*aglyf)->loca );
+
+            info->loca_table->dst_length = dest_offset -
+                                             info->loca_table->dst_offset;
+          }
+          else
+#endif
           if ( reconstruct_glyf( stream,
                                  &checksum,
                                  &loca_checksum,
@@ -1688,6 +2137,18 @@
       }
     }
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    /* The synthesized `glyf' table follows the last table. */
+    if ( *aglyf )
+    {
+      (*aglyf)->offset = dest_offset;
+
+      buf_cursor = sfnt + glyf_entry_offset + 8;
+      WRITE_ULONG( buf_cursor, dest_offset );
+      WRITE_ULONG( buf_cursor, (*aglyf)->size );
+    }
+#endif
+
     /* Update `head' checkSumAdjustment. */
     info->head_table = find_table( indices, num_tables, TTAG_head );
     if ( !info->head_table )
@@ -1732,6 +2193,358 @@
   }
 
 
+  /* Return the face index that `face_instance_index' refers to in a */
+  /* WOFF2 font with `num_fonts' faces, or -1 if it is invalid.        */
+  static FT_TS_Int
+  woff2_face_index( FT_TS_Int   face_instance_index,
+                    FT_TS_Long  num_fonts )
+  {
+    FT_TS_Int  face_index = FT_TS_ABS( face_instance_index ) & 0xFFFF;
+
+
+    /* value -(N+1) requests information on index N */
+    if ( face_instance_index < 0 )
+      face_index--;
+
+    if ( face_index >= num_fonts )
+    {
+      if ( face_instance_index >= 0 )
+        return -1;
+      else
+        face_index = 0;
+    }
+
+    return face_index;
+  }
+
+
+  /*
+   * The SFNT data synthesized from a WOFF2 font.  It is reference-counted
+   * since the WOFF2 cache shares it between faces: each stream reading
+   * the data holds a reference (as does the cache).
+   */
+  typedef struct  WOFF2_SfntRec_
+  {
+    FT_TS_Memory  memory;
+    FT_TS_ULong   ref_count;
+
+    FT_TS_Byte*   base;
+    FT_TS_ULong   size;
+    WOFF2_Glyf    glyf;      /* lazily reconstructed `glyf' table */
+
+  } WOFF2_SfntRec;
+
+
+  static void
+  woff2_sfnt_release( WOFF2_Sfnt  sfnt )
+  {
+    FT_TS_Memory  memory = sfnt->memory;
+
+
+    if ( --sfnt->ref_count )
+      return;
+
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    woff2_glyf_done( sfnt->glyf, memory );
+#endif
+    FT_TS_FREE( sfnt->base );
+    FT_TS_FREE( sfnt );
+  }
+
+
+  static void
+  woff2_sfnt_stream_close( FT_TS_Stream  stream )
+  {
+    woff2_sfnt_release( (WOFF2_Sfnt)stream->descriptor.pointer );
+
+    stream->size               = 0;
+    stream->base               = NULL;
+    stream->close              = NULL;
+    stream->descriptor.pointer = NULL;
+  }
+
+
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+
+  /* Get the offset of glyph `idx' in the synthesized `glyf' table. */
+  static FT_TS_ULong
+  woff2_glyf_offset( WOFF2_Sfnt  sfnt,
+                     FT_TS_UInt  idx )
+  {
+    FT_TS_Byte*  p = sfnt->base + sfnt->glyf->loca_offset;
+
+
+    if ( sfnt->glyf->index_format )
+      return FT_TS_PEEK_ULONG( p + 4 * idx );
+    else
+      return (FT_TS_ULong)FT_TS_PEEK_USHORT( p + 2 * idx ) << 1;
+  }
+
+
+  /* Read SFNT data whose `glyf' table gets reconstructed on demand. */
+  static unsigned long
+  woff2_sfnt_stream_io( FT_TS_Stream    stream,
+                        unsigned long   offset,
+                        unsigned char*  buffer,
+                        unsigned long   count )
+  {
+    WOFF2_Sfnt    sfnt   = (WOFF2_Sfnt)stream->descriptor.pointer;
+    WOFF2_Glyf    glyf   = sfnt->glyf;
+    FT_TS_Memory  memory = stream->memory;
+    FT_TS_Error   error  = FT_TS_Err_Ok;
+
+    unsigned long  read_bytes = 0;
+
+
+    /* seek */
+    if ( !count )
+      return offset > stream->size;
+
+    if ( offset >= stream->size )
+      return 0;
+
+    if ( count > stream->size - offset )
+      count = stream->size - offset;
+
+    if ( offset < sfnt->size )
+    {
+      read_bytes = sfnt->size - offset;
+      if ( read_bytes > count )
+        read_bytes = count;
+
+      FT_TS_MEM_COPY( buffer, sfnt->base + offset, read_bytes );
+    }
+
+    while ( read_bytes < count )
+    {
+      FT_TS_ULong  pos = offset + read_bytes - glyf->offset;
+      FT_TS_ULong  start, len, n;
+      FT_TS_UInt   min, max, mid;
+
+      FT_TS_Byte*  slot = NULL;
+
+
+      /* find the (non-empty) glyph whose slot contains `pos' */
+      min = 0;
+      max = glyf->num_glyphs - 1U;
+      while ( min < max )
+      {
+        mid = ( min + max ) >> 1;
+        if ( woff2_glyf_offset( sfnt, mid + 1 ) > pos )
+          max = mid;
+        else
+          min = mid + 1;
+      }
+
+      start = woff2_glyf_offset( sfnt, min );
+      len   = woff2_glyf_offset( sfnt, min + 1 ) - start;
+
+      n = start + len - pos;
+      if ( n > count - read_bytes )
+        n = count - read_bytes;
+
+      /* reconstruct directly into `buffer' if it covers the slot */
+      if ( n == len )
+      {
+        FT_TS_MEM_ZERO( buffer + read_bytes, len );
+        error = woff2_glyf_load_glyph( glyf,
+                                       min,
+                                       buffer + read_bytes,
+                                       len,
+                                       memory );
+      }
+      else if ( !FT_TS_ALLOC( slot, len ) )
+      {
+        error = woff2_glyf_load_glyph( glyf, min, slot, len, memory );
+        if ( !error )
+          FT_TS_MEM_COPY( buffer + read_bytes, slot + ( pos - start ), n );
+
+        FT_TS_FREE( slot );
+      }
+
+      if ( error )
+      {
+        FT_TS_ERROR(( "woff2_sfnt_stream_io:"
+                   " cannot reconstruct glyph %u\n", min ));
+        break;
+      }
+
+      read_bytes += n;
+    }
+
+    return read_bytes;
+  }
+
+#endif /* TT_CONFIG_OPTION_WOFF2_LAZY_GLYF */
+
+
+  /* Make `stream' read the SFNT data `sfnt'. */
+  static void
+  woff2_sfnt_stream_open( FT_TS_Stream  stream,
+                          WOFF2_Sfnt    sfnt )
+  {
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    if ( sfnt->glyf )
+    {
+      FT_TS_ZERO( stream );
+
+      stream->size = sfnt->size + sfnt->glyf->size;
+      stream->read = woff2_sfnt_stream_io;
+    }
+    else
+#endif
+      FT_TS_Stream_OpenMemory( stream, sfnt->base, sfnt->size );
+
+    stream->memory             = sfnt->memory;
+    stream->close              = woff2_sfnt_stream_close;
+    stream->descriptor.pointer = sfnt;
+
+    sfnt->ref_count++;
+  }
+
+
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+
+  /*
+   * The WOFF2 cache maps the WOFF2 data of a font (together with the face
+   * index for collections) to the reconstructed SFNT data.  Entries are
+   * found by a hash value computed from a sample of the data, then
+   * compared in full.
+   *
+   * A discarded entry only drops its reference to the SFNT data, which
+   * thus stays valid as long as a face still uses it.
+   */
+
+  typedef struct  WOFF2_CacheEntryRec_
+  {
+    FT_TS_MruNodeRec  node;
+
+    FT_TS_Byte*       key;          /* a copy of the WOFF2 data */
+    FT_TS_ULong       key_len;
+    FT_TS_Int         face_index;
+    FT_TS_Long        num_faces;
+
+    WOFF2_Sfnt        sfnt;
+
+  } WOFF2_CacheEntryRec, *WOFF2_CacheEntry;
+
+
+  /* what `woff2_cache_compare' looks for */
+  typedef struct  WOFF2_CacheKeyRec_
+  {
+    const FT_TS_Byte*  data;
+    FT_TS_ULong        len;
+    FT_TS_Int          face_instance_index;
+
+  } WOFF2_CacheKeyRec;
+
+
+  static FT_TS_Bool
+  woff2_cache_compare( FT_TS_MruNode  node,
+                       const void*    key_ )
+  {
+    WOFF2_CacheEntry          entry = (WOFF2_CacheEntry)node;
+    const WOFF2_CacheKeyRec*  key   = (const WOFF2_CacheKeyRec*)key_;
+
+
+    return entry->key_len == key->len                            &&
+           entry->face_index ==
+             woff2_face_index( key->face_instance_index,
+                               entry->num_faces )                &&
+           ft_memcmp( entry->key, key->data, key->len ) == 0;
+  }
+
+
+  static void
+  woff2_cache_entry_free( FT_TS_MruNode  node,
+                          FT_TS_Memory   memory )
+  {
+    WOFF2_CacheEntry  entry = (WOFF2_CacheEntry)node;
+
+
+    woff2_sfnt_release( entry->sfnt );
+
+    FT_TS_FREE( entry->key );
+    FT_TS_FREE( entry );
+  }
+
+
+  /* Add the SFNT data `sfnt' to the cache.  The WOFF2 data in `*akey' */
+  /* (if not NULL) is taken over, otherwise `key' gets copied.         */
+  static void
+  woff2_cache_add( WOFF2_Cache        cache,
+                   WOFF2_Sfnt         sfnt,
+                   FT_TS_Byte**       akey,
+                   const FT_TS_Byte*  key,
+                   FT_TS_ULong        key_len,
+                   FT_TS_UInt32       hash,
+                   FT_TS_Int          face_index,
+                   FT_TS_Long         num_faces )
+  {
+    FT_TS_Memory  memory = sfnt->memory;
+    FT_TS_Error   error;
+
+    WOFF2_CacheEntry  entry;
+    FT_TS_ULong       sfnt_len = sfnt->size;
+
+
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    if ( sfnt->glyf )
+      sfnt_len += sfnt->glyf->data_size +
+                  sfnt->glyf->num_glyphs *
+                    WOFF2_GLYPH_OFFSETS * sizeof ( FT_TS_UInt32 );
+#endif
+
+    if ( sizeof ( WOFF2_CacheEntryRec ) + key_len + sfnt_len >
+           TT_CONFIG_WOFF2_CACHE_MAX_SIZE                      )
+      return;
+
+    if ( FT_TS_QNEW( entry ) )
+      return;
+
+    if ( *akey )
+    {
+      entry->key = *akey;
+      *akey      = NULL;
+    }
+    else
+    {
+      if ( FT_TS_QALLOC( entry->key, key_len ) )
+      {
+        FT_TS_FREE( entry );
+        return;
+      }
+
+      FT_TS_MEM_COPY( entry->key, key, key_len );
+    }
+
+    entry->node.hash  = hash;
+    entry->node.size  = sizeof ( WOFF2_CacheEntryRec ) + key_len + sfnt_len;
+    entry->key_len    = key_len;
+    entry->face_index = face_index;
+    entry->num_faces  = num_faces;
+    entry->sfnt       = sfnt;
+
+    sfnt->ref_count++;
+
+    ft_mru_add( cache,
+                &entry->node,
+                TT_CONFIG_WOFF2_CACHE_MAX_SIZE,
+                woff2_cache_entry_free,
+                memory );
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  woff2_cache_done( WOFF2_Cache   cache,
+                    FT_TS_Memory  memory )
+  {
+    ft_mru_done( cache, woff2_cache_entry_free, memory );
+  }
+
+#endif /* TT_CONFIG_OPTION_WOFF2_CACHE */
+
+
   /* Replace `face->root.stream' with a stream containing the extracted */
   /* SFNT of a WOFF2 font.                                              */
 
@@ -1766,9 +2579,22 @@
     FT_TS_Stream  sfnt_stream = NULL;
     FT_TS_Byte*   sfnt_header;
     FT_TS_ULong   sfnt_size;
+    WOFF2_Sfnt    sfnt_data   = NULL;
+    WOFF2_Glyf    glyf        = NULL;
+    FT_TS_ULong   glyf_size   = 0;
 
     FT_TS_Byte*  uncompressed_buf = NULL;
 
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+    WOFF2_Cache        cache   = NULL;
+    WOFF2_CacheEntry   entry;
+    FT_TS_Module       module;
+    FT_TS_Byte*        key     = NULL;
+    const FT_TS_Byte*  key_data = NULL;
+    FT_TS_UInt32       hash    = 0;
+    WOFF2_CacheKeyRec  cache_key;
+#endif
+
     static const FT_TS_Frame_Field  woff2_header_fields[] =
     {
 #undef  FT_TS_STRUCTURE
@@ -1795,11 +2621,56 @@
     FT_TS_ASSERT( stream == face->root.stream );
     FT_TS_ASSERT( FT_TS_STREAM_POS() == 0 );
 
-    face_index = FT_TS_ABS( *face_instance_index ) & 0xFFFF;
+    woff2.ttc_fonts = NULL;
+
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+    module = FT_TS_Get_Module( FT_TS_FACE_LIBRARY( face ), "sfnt" );
+    if ( module                                                     &&
+         sizeof ( WOFF2_CacheEntryRec ) + stream->size <=
+           TT_CONFIG_WOFF2_CACHE_MAX_SIZE                           )
+    {
+      cache = &( (SFNT_Module)module )->woff2_cache;
+
+      /* the complete WOFF2 data is the cache key */
+      if ( stream->read )
+      {
+        if ( FT_TS_QALLOC( key, stream->size )         ||
+             FT_TS_STREAM_READ( key, stream->size )    ||
+             FT_TS_STREAM_SEEK( 0 )                    )
+          goto Exit;
+
+        key_data = key;
+      }
+      else
+        key_data = stream->base;
+
+      cache_key.data                = key_data;
+      cache_key.len                 = stream->size;
+      cache_key.face_instance_index = *face_instance_index;
+
+      hash  = ft_hash_data( 2166136261UL, key_data, stream->size );
+      entry = (WOFF2_CacheEntry)ft_mru_lookup( cache,
+                                               hash,
+                                               woff2_cache_compare,
+                                               &cache_key );
+      if ( entry )
+      {
+        FT_TS_TRACE2(( "woff2_open_font: using cached SFNT data\n" ));
+
+        if ( FT_TS_NEW( sfnt_stream ) )
+          goto Exit;
+
+        woff2_sfnt_stream_open( sfnt_stream, entry->sfnt );
+        *num_faces = entry->num_faces;
+
+        goto Swap;
+      }
+    }
+#endif /* TT_CONFIG_OPTION_WOFF2_CACHE */
 
     /* Read WOFF2 Header. */
     if ( FT_TS_STREAM_READ_FIELDS( woff2_header_fields, &woff2 ) )
-      return error;
+      goto Exit;
 
     FT_TS_TRACE4(( "signature     -> 0x%lX\n", woff2.signature ));
     FT_TS_TRACE2(( "flavor        -> 0x%08lx\n", woff2.flavor ));
@@ -1813,7 +2684,10 @@
 
     /* Make sure we don't recurse back here. */
     if ( woff2.flavor == TTAG_wOF2 )
-      return FT_TS_THROW( Invalid_Table );
+    {
+      error = FT_TS_THROW( Invalid_Table );
+      goto Exit;
+    }
 
     /* Miscellaneous checks. */
     if ( woff2.length != stream->size                               ||
@@ -1829,13 +2703,12 @@
          ( woff2.length - woff2.privOffset < woff2.privLength )     )
     {
       FT_TS_ERROR(( "woff2_open_font: invalid WOFF2 header\n" ));
-      return FT_TS_THROW( Invalid_Table );
+      error = FT_TS_THROW( Invalid_Table );
+      goto Exit;
     }
 
     FT_TS_TRACE2(( "woff2_open_font: WOFF2 Header is valid.\n" ));
 
-    woff2.ttc_fonts = NULL;
-
     /* Read table directory. */
     if ( FT_TS_NEW_ARRAY( tables, woff2.num_tables )  ||
          FT_TS_NEW_ARRAY( indices, woff2.num_tables ) )
@@ -2085,19 +2958,11 @@
 
     /* Validate requested face index. */
     *num_faces = woff2.num_fonts;
-    /* value -(N+1) requests information on index N */
-    if ( *face_instance_index < 0 )
-      face_index--;
-
-    if ( face_index >= woff2.num_fonts )
+    face_index = woff2_face_index( *face_instance_index, woff2.num_fonts );
+    if ( face_index < 0 )
     {
-      if ( *face_instance_index >= 0 )
-      {
-        error = FT_TS_THROW( Invalid_Argument );
-        goto Exit;
-      }
-      else
-        face_index = 0;
+      error = FT_TS_THROW( Invalid_Argument );
+      goto Exit;
     }
 
     /* Only retain tables of the requested face in a TTC. */
@@ -2157,9 +3022,27 @@
 #endif
     }
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    /* Don't reserve space for a transformed `glyf' table; it usually */
+    /* doesn't get reconstructed up front (see `index_glyf').  If it  */
+    /* does, `write_buf' enlarges the buffer.                         */
+    {
+      WOFF2_Table  glyf_table = find_table( indices,
+                                            woff2.num_tables,
+                                            TTAG_glyf );
+
+
+      if ( glyf_table                                          &&
+           ( glyf_table->flags & WOFF2_FLAGS_TRANSFORM )       &&
+           glyf_table->dst_length <
+             sfnt_size - ( 12 + woff2.num_tables * 16UL )      )
+        glyf_size = glyf_table->dst_length;
+    }
+#endif
+
     /* Write sfnt header. */
-    if ( FT_TS_QALLOC( sfnt, sfnt_size ) ||
-         FT_TS_NEW( sfnt_stream )        )
+    if ( FT_TS_QALLOC( sfnt, sfnt_size - glyf_size ) ||
+         FT_TS_NEW( sfnt_stream )                    )
       goto Exit;
 
     sfnt_header = sfnt;
@@ -2229,6 +3112,9 @@
       goto Exit;
     }
 
+    /* the size of the `sfnt' buffer */
+    sfnt_size -= glyf_size;
+
     /* Allocate memory for uncompressed table data. */
     if ( FT_TS_QALLOC( uncompressed_buf, woff2.uncompressed_size ) ||
          FT_TS_FRAME_ENTER( woff2.totalCompressedSize )            )
@@ -2252,6 +3138,7 @@
                               &info,
                               &sfnt,
                               &sfnt_size,
+                              &glyf,
                               memory );
 
     if ( error )
@@ -2270,10 +3157,49 @@
 
     /* `reconstruct_font' has done all the work. */
     /* Swap out stream and return.               */
-    FT_TS_Stream_OpenMemory( sfnt_stream, sfnt, woff2.actual_sfnt_size );
-    sfnt_stream->memory = stream->memory;
-    sfnt_stream->close  = stream_close;
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    if ( glyf )
+    {
+      /* Keep the transformed `glyf' data, reusing its buffer. */
+      FT_TS_MEM_MOVE( uncompressed_buf,
+                      uncompressed_buf + info.glyf_table->src_offset,
+                      glyf->data_size );
+      if ( FT_TS_QREALLOC( uncompressed_buf,
+                           woff2.uncompressed_size,
+                           glyf->data_size ) )
+        goto Exit;
+
+      glyf->data       = uncompressed_buf;
+      uncompressed_buf = NULL;
+    }
+#endif
+
+    if ( FT_TS_NEW( sfnt_data ) )
+      goto Exit;
+
+    sfnt_data->memory = memory;
+    sfnt_data->base   = sfnt;
+    sfnt_data->size   = woff2.actual_sfnt_size;
+    sfnt_data->glyf   = glyf;
 
+    sfnt = NULL;
+    glyf = NULL;
+
+    woff2_sfnt_stream_open( sfnt_stream, sfnt_data );
+
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+    if ( cache )
+      woff2_cache_add( cache,
+                       sfnt_data,
+                       &key,
+                       key_data,
+                       stream->size,
+                       hash,
+                       face_index,
+                       woff2.num_fonts );
+
+  Swap:
+#endif
     FT_TS_Stream_Free(
       face->root.stream,
       ( face->root.face_flags & FT_TS_FACE_FLAG_EXTERNAL_STREAM ) != 0 );
@@ -2295,6 +3221,14 @@
     FT_TS_FREE( uncompressed_buf );
     FT_TS_FREE( info.x_mins );
 
+#ifdef TT_CONFIG_OPTION_WOFF2_LAZY_GLYF
+    woff2_glyf_done( glyf, memory );
+#endif
+
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+    FT_TS_FREE( key );
+#endif
+
     if ( woff2.ttc_fonts )
     {
       WOFF2_TtcFont  ttc_font = woff2.ttc_fonts;
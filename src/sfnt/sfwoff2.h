@@ -22,6 +22,7 @@
 
 #include <freetype/internal/sfnt.h>
 #include <freetype/internal/ftobjs.h>
+#include <freetype/internal/fthash.h>
 
 
 FT_TS_BEGIN_HEADER
@@ -61,6 +62,20 @@ FT_TS_BEGIN_HEADER
 #define CONTOUR_OFFSET_END_POINT  10
 
 
+#ifdef TT_CONFIG_OPTION_WOFF2_CACHE
+
+  /* the cache of reconstructed SFNT data, owned by the `sfnt' module */
+  typedef FT_TS_MruListRec  WOFF2_CacheRec;
+  typedef FT_TS_MruList     WOFF2_Cache;
+
+
+  FT_TS_LOCAL( void )
+  woff2_cache_done( WOFF2_Cache   cache,
+                    FT_TS_Memory  memory );
+
+#endif /* TT_CONFIG_OPTION_WOFF2_CACHE */
+
+
   FT_TS_LOCAL( FT_TS_Error )
   woff2_open_font( FT_TS_Stream  stream,
                    TT_Face    face,
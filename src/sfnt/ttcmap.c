@@ -67,6 +67,287 @@
   }
 
 
+  /* the per-character lookup function of a cmap format */
+  typedef FT_TS_UInt
+  (*TT_CMap_LookupFunc)( TT_CMap    cmap,
+                         FT_TS_UInt32  char_code );
+
+
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                     TWO-LEVEL LOOKUP TABLE                    *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+  /**************************************************************************
+   *
+   * For formats 4, 12, and 13 we build a flat lookup table on demand.  The
+   * character code range [0;accel_limit[ is split into pages of 256
+   * entries.  `accel_pages' maps a page number to a block index in
+   * `accel_glyphs', which holds 256 glyph indices per block.  Block~0 is
+   * all zeros and shared by all pages without mapped characters.
+   *
+   * The table is filled by calling the subtable's regular lookup function
+   * for every character code of all pages touched by a segment or group,
+   * so it gives exactly the same results.  Glyph indices not smaller than
+   * the number of glyphs are stored as zero; `FT_TS_Get_Char_Index' rejects
+   * them anyway.
+   */
+
+#define TT_CMAP_ACCEL_PAGE_SHIFT  8
+#define TT_CMAP_ACCEL_PAGE_SIZE   ( 1UL << TT_CMAP_ACCEL_PAGE_SHIFT )
+#define TT_CMAP_ACCEL_PAGE_MASK   ( TT_CMAP_ACCEL_PAGE_SIZE - 1 )
+
+  /* we don't go beyond the Unicode range */
+#define TT_CMAP_ACCEL_MAX_LIMIT  0x110000UL
+
+
+  /* release the lookup table of `cmap' (if any) */
+  FT_TS_CALLBACK_DEF( void )
+  tt_cmap_accel_done( TT_CMap  cmap )
+  {
+    FT_TS_Memory  memory = cmap->cmap.charmap.face->memory;
+
+
+    FT_TS_FREE( cmap->accel_pages );
+    FT_TS_FREE( cmap->accel_glyphs );
+
+    cmap->accel_limit = 0;
+  }
+
+
+  /* allocate an empty page directory covering [0;limit[ */
+  static FT_TS_Error
+  tt_cmap_accel_init( TT_CMap    cmap,
+                      FT_TS_UInt32  limit )
+  {
+    FT_TS_Face    face   = cmap->cmap.charmap.face;
+    FT_TS_Memory  memory = face->memory;
+    FT_TS_Error   error;
+    FT_TS_UInt    num_pages;
+
+
+    cmap->accel_tried = 1;
+
+    /* we store glyph indices as 16-bit values */
+    if ( face->num_glyphs > 0xFFFFL )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( limit > TT_CMAP_ACCEL_MAX_LIMIT )
+      limit = TT_CMAP_ACCEL_MAX_LIMIT;
+
+    num_pages = (FT_TS_UInt)( ( limit + TT_CMAP_ACCEL_PAGE_MASK ) >>
+                              TT_CMAP_ACCEL_PAGE_SHIFT );
+    if ( !num_pages )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( FT_TS_NEW_ARRAY( cmap->accel_pages, num_pages ) )
+      return error;
+
+    cmap->accel_limit = (FT_TS_UInt32)num_pages << TT_CMAP_ACCEL_PAGE_SHIFT;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* mark all pages touched by charcodes [start;end] */
+  static void
+  tt_cmap_accel_mark( TT_CMap    cmap,
+                      FT_TS_UInt32  start,
+                      FT_TS_UInt32  end )
+  {
+    FT_TS_UInt32  page, last;
+
+
+    if ( start > end || start >= cmap->accel_limit )
+      return;
+
+    if ( end >= cmap->accel_limit )
+      end = cmap->accel_limit - 1;
+
+    last = end >> TT_CMAP_ACCEL_PAGE_SHIFT;
+
+    for ( page = start >> TT_CMAP_ACCEL_PAGE_SHIFT; page <= last; page++ )
+      cmap->accel_pages[page] = 1;
+  }
+
+
+  /* allocate blocks for all marked pages and fill them using `lookup'; */
+  /* on failure, the lookup table is dropped                            */
+  static void
+  tt_cmap_accel_fill( TT_CMap             cmap,
+                      TT_CMap_LookupFunc  lookup )
+  {
+    FT_TS_Face    face   = cmap->cmap.charmap.face;
+    FT_TS_Memory  memory = face->memory;
+    FT_TS_Error   error;
+
+    FT_TS_UInt    num_pages = (FT_TS_UInt)( cmap->accel_limit >>
+                                            TT_CMAP_ACCEL_PAGE_SHIFT );
+    FT_TS_UInt    num_blocks;
+    FT_TS_UInt    page;
+    FT_TS_ULong   size;
+
+
+    num_blocks = 1;
+    for ( page = 0; page < num_pages; page++ )
+      if ( cmap->accel_pages[page] )
+        num_blocks++;
+
+    size = num_pages * sizeof ( FT_TS_UShort ) +
+           num_blocks * TT_CMAP_ACCEL_PAGE_SIZE * sizeof ( FT_TS_UShort );
+
+    if ( size > (FT_TS_ULong)TT_CONFIG_CMAP_ACCELERATOR_MAX_SIZE )
+    {
+      FT_TS_TRACE2(( "tt_cmap_accel_fill:"
+                     " lookup table would need %lu bytes, skipped\n",
+                     size ));
+      goto Fail;
+    }
+
+    if ( FT_TS_NEW_ARRAY( cmap->accel_glyphs,
+                          num_blocks * TT_CMAP_ACCEL_PAGE_SIZE ) )
+      goto Fail;
+
+    num_blocks = 1;
+    for ( page = 0; page < num_pages; page++ )
+    {
+      FT_TS_UShort*  block;
+      FT_TS_UInt32   char_code;
+      FT_TS_UInt     n;
+
+
+      if ( !cmap->accel_pages[page] )
+        continue;
+
+      cmap->accel_pages[page] = (FT_TS_UShort)num_blocks;
+
+      block     = cmap->accel_glyphs + num_blocks * TT_CMAP_ACCEL_PAGE_SIZE;
+      char_code = (FT_TS_UInt32)page << TT_CMAP_ACCEL_PAGE_SHIFT;
+
+      for ( n = 0; n < TT_CMAP_ACCEL_PAGE_SIZE; n++ )
+      {
+        FT_TS_UInt  gindex = lookup( cmap, char_code + n );
+
+
+        if ( gindex < (FT_TS_UInt)face->num_glyphs )
+          block[n] = (FT_TS_UShort)gindex;
+      }
+
+      num_blocks++;
+    }
+
+    FT_TS_TRACE4(( "tt_cmap_accel_fill:"
+                   " %u pages, %u blocks, %lu bytes\n",
+                   num_pages, num_blocks, size ));
+    return;
+
+  Fail:
+    tt_cmap_accel_done( cmap );
+  }
+
+
+  /* `char_code' must be smaller than `cmap->accel_limit' */
+  static FT_TS_UInt
+  tt_cmap_accel_lookup( TT_CMap    cmap,
+                        FT_TS_UInt32  char_code )
+  {
+    FT_TS_UInt  block = cmap->accel_pages[char_code >>
+                                          TT_CMAP_ACCEL_PAGE_SHIFT];
+
+
+    return cmap->accel_glyphs[( block << TT_CMAP_ACCEL_PAGE_SHIFT ) |
+                              ( char_code & TT_CMAP_ACCEL_PAGE_MASK )];
+  }
+
+
+#define TT_CMAP_ACCEL_DONE  tt_cmap_accel_done
+
+#else /* !TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+#define TT_CMAP_ACCEL_DONE  NULL
+
+#endif /* !TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+
+  /* map an array of character codes, using the lookup table if possible */
+  static void
+  tt_cmap_char_indices( TT_CMap              cmap,
+                        const FT_TS_UInt32*  char_codes,
+                        FT_TS_UInt           count,
+                        FT_TS_UInt*          gindices,
+                        TT_CMap_LookupFunc   lookup )
+  {
+    FT_TS_UInt  n = 0;
+
+
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( cmap->accel_limit )
+    {
+      FT_TS_UInt32         limit  = cmap->accel_limit;
+      const FT_TS_UShort*  latin1 = cmap->accel_glyphs +
+                                    ( (FT_TS_UInt)cmap->accel_pages[0] <<
+                                      TT_CMAP_ACCEL_PAGE_SHIFT );
+
+      FT_TS_UInt32         cur_page  = 0;
+      const FT_TS_UShort*  cur_block = latin1;
+
+
+      while ( n < count )
+      {
+        FT_TS_UInt32  char_code;
+
+
+        /* fast path for runs of ASCII and Latin-1 characters; */
+        /* this is a plain gather compilers can vectorize      */
+        while ( n < count && char_codes[n] < TT_CMAP_ACCEL_PAGE_SIZE )
+        {
+          gindices[n] = latin1[char_codes[n]];
+          n++;
+        }
+
+        /* other characters; consecutive lookups in the same page */
+        /* (which is typical for most scripts) reuse the block    */
+        for ( ; n < count; n++ )
+        {
+          char_code = char_codes[n];
+
+          if ( char_code < TT_CMAP_ACCEL_PAGE_SIZE )
+            break;
+
+          if ( char_code >= limit )
+            gindices[n] = lookup( cmap, char_code );
+          else
+          {
+            FT_TS_UInt32  page = char_code >> TT_CMAP_ACCEL_PAGE_SHIFT;
+
+
+            if ( page != cur_page )
+            {
+              cur_page  = page;
+              cur_block = cmap->accel_glyphs +
+                          ( (FT_TS_UInt)cmap->accel_pages[page] <<
+                            TT_CMAP_ACCEL_PAGE_SHIFT );
+            }
+
+            gindices[n] = cur_block[char_code & TT_CMAP_ACCEL_PAGE_MASK];
+          }
+        }
+      }
+
+      return;
+    }
+#endif /* TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+    for ( ; n < count; n++ )
+      gindices[n] = lookup( cmap, char_codes[n] );
+  }
+
+
   /*************************************************************************/
   /*************************************************************************/
   /*****                                                               *****/
@@ -194,6 +475,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     0,
     (TT_CMap_ValidateFunc)tt_cmap0_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap0_get_info   /* get_cmap_info */
@@ -608,6 +891,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     2,
     (TT_CMap_ValidateFunc)tt_cmap2_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap2_get_info   /* get_cmap_info */
@@ -1488,6 +1773,51 @@
   }
 
 
+  static FT_TS_UInt
+  tt_cmap4_char_lookup( TT_CMap    cmap,
+                        FT_TS_UInt32  char_code )
+  {
+    if ( cmap->flags & TT_CMAP_FLAG_UNSORTED )
+      return tt_cmap4_char_map_linear( cmap, &char_code, 0 );
+    else
+      return tt_cmap4_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+
+  static void
+  tt_cmap4_accel_build( TT_CMap  cmap )
+  {
+    FT_TS_Byte*  p;
+    FT_TS_Byte*  q;
+    FT_TS_UInt   num_segs2, n;
+
+
+    if ( tt_cmap_accel_init( cmap, 0x10000UL ) )
+      return;
+
+    p         = cmap->data + 6;
+    num_segs2 = FT_TS_PAD_FLOOR( TT_PEEK_USHORT( p ), 2 );
+
+    p = cmap->data + 14;               /* ends table   */
+    q = cmap->data + 16 + num_segs2;   /* starts table */
+
+    for ( n = 0; n < num_segs2; n += 2 )
+    {
+      FT_TS_UInt  end   = TT_NEXT_USHORT( p );
+      FT_TS_UInt  start = TT_NEXT_USHORT( q );
+
+
+      tt_cmap_accel_mark( cmap, start, end );
+    }
+
+    tt_cmap_accel_fill( cmap, tt_cmap4_char_lookup );
+  }
+
+#endif /* TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+
   FT_TS_CALLBACK_DEF( FT_TS_UInt )
   tt_cmap4_char_index( TT_CMap    cmap,
                        FT_TS_UInt32  char_code )
@@ -1495,10 +1825,31 @@
     if ( char_code >= 0x10000UL )
       return 0;
 
-    if ( cmap->flags & TT_CMAP_FLAG_UNSORTED )
-      return tt_cmap4_char_map_linear( cmap, &char_code, 0 );
-    else
-      return tt_cmap4_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap4_accel_build( cmap );
+
+    if ( char_code < cmap->accel_limit )
+      return tt_cmap_accel_lookup( cmap, char_code );
+#endif
+
+    return tt_cmap4_char_lookup( cmap, char_code );
+  }
+
+
+  FT_TS_CALLBACK_DEF( void )
+  tt_cmap4_char_indices( TT_CMap              cmap,
+                          const FT_TS_UInt32*  char_codes,
+                          FT_TS_UInt           count,
+                          FT_TS_UInt*          gindices )
+  {
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap4_accel_build( cmap );
+#endif
+
+    tt_cmap_char_indices( cmap, char_codes, count, gindices,
+                          tt_cmap4_char_lookup );
   }
 
 
@@ -1555,7 +1906,7 @@
       sizeof ( TT_CMap4Rec ),
 
       (FT_TS_CMap_InitFunc)     tt_cmap4_init,        /* init       */
-      (FT_TS_CMap_DoneFunc)     NULL,                 /* done       */
+      (FT_TS_CMap_DoneFunc)     TT_CMAP_ACCEL_DONE,   /* done       */
       (FT_TS_CMap_CharIndexFunc)tt_cmap4_char_index,  /* char_index */
       (FT_TS_CMap_CharNextFunc) tt_cmap4_char_next,   /* char_next  */
 
@@ -1565,6 +1916,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     tt_cmap4_char_indices,
+
     4,
     (TT_CMap_ValidateFunc)tt_cmap4_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap4_get_info   /* get_cmap_info */
@@ -1735,6 +2088,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     6,
     (TT_CMap_ValidateFunc)tt_cmap6_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap6_get_info   /* get_cmap_info */
@@ -2029,6 +2384,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     8,
     (TT_CMap_ValidateFunc)tt_cmap8_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap8_get_info   /* get_cmap_info */
@@ -2201,6 +2558,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     10,
     (TT_CMap_ValidateFunc)tt_cmap10_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap10_get_info   /* get_cmap_info */
@@ -2489,11 +2848,87 @@
   }
 
 
+  static FT_TS_UInt
+  tt_cmap12_char_lookup( TT_CMap    cmap,
+                         FT_TS_UInt32  char_code )
+  {
+    return tt_cmap12_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+
+  static void
+  tt_cmap12_accel_build( TT_CMap  cmap )
+  {
+    TT_CMap12     cmap12 = (TT_CMap12)cmap;
+    FT_TS_Byte*   p;
+    FT_TS_ULong   n;
+    FT_TS_UInt32  limit;
+
+
+    if ( !cmap12->num_groups )
+    {
+      cmap->accel_tried = 1;
+      return;
+    }
+
+    /* groups are sorted (checked by the validator), */
+    /* so the last one has the largest end charcode  */
+    p     = cmap->data + 16 + 12 * ( cmap12->num_groups - 1 ) + 4;
+    limit = TT_PEEK_ULONG( p );
+    limit = limit < TT_CMAP_ACCEL_MAX_LIMIT ? limit + 1
+                                            : TT_CMAP_ACCEL_MAX_LIMIT;
+
+    if ( tt_cmap_accel_init( cmap, limit ) )
+      return;
+
+    p = cmap->data + 16;
+    for ( n = 0; n < cmap12->num_groups; n++ )
+    {
+      FT_TS_UInt32  start = TT_NEXT_ULONG( p );
+      FT_TS_UInt32  end   = TT_NEXT_ULONG( p );
+
+
+      p += 4;
+      tt_cmap_accel_mark( cmap, start, end );
+    }
+
+    tt_cmap_accel_fill( cmap, tt_cmap12_char_lookup );
+  }
+
+#endif /* TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+
   FT_TS_CALLBACK_DEF( FT_TS_UInt )
   tt_cmap12_char_index( TT_CMap    cmap,
                         FT_TS_UInt32  char_code )
   {
-    return tt_cmap12_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap12_accel_build( cmap );
+
+    if ( char_code < cmap->accel_limit )
+      return tt_cmap_accel_lookup( cmap, char_code );
+#endif
+
+    return tt_cmap12_char_lookup( cmap, char_code );
+  }
+
+
+  FT_TS_CALLBACK_DEF( void )
+  tt_cmap12_char_indices( TT_CMap              cmap,
+                           const FT_TS_UInt32*  char_codes,
+                           FT_TS_UInt           count,
+                           FT_TS_UInt*          gindices )
+  {
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap12_accel_build( cmap );
+#endif
+
+    tt_cmap_char_indices( cmap, char_codes, count, gindices,
+                          tt_cmap12_char_lookup );
   }
 
 
@@ -2544,7 +2979,7 @@
       sizeof ( TT_CMap12Rec ),
 
       (FT_TS_CMap_InitFunc)     tt_cmap12_init,        /* init       */
-      (FT_TS_CMap_DoneFunc)     NULL,                  /* done       */
+      (FT_TS_CMap_DoneFunc)     TT_CMAP_ACCEL_DONE,    /* done       */
       (FT_TS_CMap_CharIndexFunc)tt_cmap12_char_index,  /* char_index */
       (FT_TS_CMap_CharNextFunc) tt_cmap12_char_next,   /* char_next  */
 
@@ -2554,6 +2989,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     tt_cmap12_char_indices,
+
     12,
     (TT_CMap_ValidateFunc)tt_cmap12_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap12_get_info   /* get_cmap_info */
@@ -2815,11 +3252,87 @@
   }
 
 
+  static FT_TS_UInt
+  tt_cmap13_char_lookup( TT_CMap    cmap,
+                         FT_TS_UInt32  char_code )
+  {
+    return tt_cmap13_char_map_binary( cmap, &char_code, 0 );
+  }
+
+
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+
+  static void
+  tt_cmap13_accel_build( TT_CMap  cmap )
+  {
+    TT_CMap13     cmap13 = (TT_CMap13)cmap;
+    FT_TS_Byte*   p;
+    FT_TS_ULong   n;
+    FT_TS_UInt32  limit;
+
+
+    if ( !cmap13->num_groups )
+    {
+      cmap->accel_tried = 1;
+      return;
+    }
+
+    /* groups are sorted (checked by the validator), */
+    /* so the last one has the largest end charcode  */
+    p     = cmap->data + 16 + 12 * ( cmap13->num_groups - 1 ) + 4;
+    limit = TT_PEEK_ULONG( p );
+    limit = limit < TT_CMAP_ACCEL_MAX_LIMIT ? limit + 1
+                                            : TT_CMAP_ACCEL_MAX_LIMIT;
+
+    if ( tt_cmap_accel_init( cmap, limit ) )
+      return;
+
+    p = cmap->data + 16;
+    for ( n = 0; n < cmap13->num_groups; n++ )
+    {
+      FT_TS_UInt32  start = TT_NEXT_ULONG( p );
+      FT_TS_UInt32  end   = TT_NEXT_ULONG( p );
+
+
+      p += 4;
+      tt_cmap_accel_mark( cmap, start, end );
+    }
+
+    tt_cmap_accel_fill( cmap, tt_cmap13_char_lookup );
+  }
+
+#endif /* TT_CONFIG_OPTION_CMAP_ACCELERATOR */
+
+
   FT_TS_CALLBACK_DEF( FT_TS_UInt )
   tt_cmap13_char_index( TT_CMap    cmap,
                         FT_TS_UInt32  char_code )
   {
-    return tt_cmap13_char_map_binary( cmap, &char_code, 0 );
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap13_accel_build( cmap );
+
+    if ( char_code < cmap->accel_limit )
+      return tt_cmap_accel_lookup( cmap, char_code );
+#endif
+
+    return tt_cmap13_char_lookup( cmap, char_code );
+  }
+
+
+  FT_TS_CALLBACK_DEF( void )
+  tt_cmap13_char_indices( TT_CMap              cmap,
+                           const FT_TS_UInt32*  char_codes,
+                           FT_TS_UInt           count,
+                           FT_TS_UInt*          gindices )
+  {
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    if ( !cmap->accel_tried )
+      tt_cmap13_accel_build( cmap );
+#endif
+
+    tt_cmap_char_indices( cmap, char_codes, count, gindices,
+                          tt_cmap13_char_lookup );
   }
 
 
@@ -2870,7 +3383,7 @@
       sizeof ( TT_CMap13Rec ),
 
       (FT_TS_CMap_InitFunc)     tt_cmap13_init,        /* init       */
-      (FT_TS_CMap_DoneFunc)     NULL,                  /* done       */
+      (FT_TS_CMap_DoneFunc)     TT_CMAP_ACCEL_DONE,    /* done       */
       (FT_TS_CMap_CharIndexFunc)tt_cmap13_char_index,  /* char_index */
       (FT_TS_CMap_CharNextFunc) tt_cmap13_char_next,   /* char_next  */
 
@@ -2880,6 +3393,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     tt_cmap13_char_indices,
+
     13,
     (TT_CMap_ValidateFunc)tt_cmap13_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap13_get_info   /* get_cmap_info */
@@ -3643,6 +4158,8 @@
       (FT_TS_CMap_CharVariantListFunc) tt_cmap14_char_variants,
       (FT_TS_CMap_VariantCharListFunc) tt_cmap14_variant_chars,
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,
+
     14,
     (TT_CMap_ValidateFunc)tt_cmap14_validate,  /* validate      */
     (TT_CMap_Info_GetFunc)tt_cmap14_get_info   /* get_cmap_info */
@@ -3751,6 +4268,8 @@
       (FT_TS_CMap_CharVariantListFunc) NULL,  /* charvariant_list */
       (FT_TS_CMap_VariantCharListFunc) NULL,  /* variantchar_list */
 
+      (FT_TS_CMap_CharIndicesFunc)     NULL,  /* char_indices     */
+
     ~0U,
     (TT_CMap_ValidateFunc)NULL,  /* validate      */
     (TT_CMap_Info_GetFunc)NULL   /* get_cmap_info */
@@ -36,6 +36,14 @@ FT_TS_BEGIN_HEADER
     FT_TS_Byte*    data;           /* pointer to in-memory cmap table */
     FT_TS_Int      flags;          /* for format 4 only               */
 
+#ifdef TT_CONFIG_OPTION_CMAP_ACCELERATOR
+    /* two-level lookup table, for formats 4, 12, and 13 only */
+    FT_TS_Bool     accel_tried;    /* table has been built (or failed) */
+    FT_TS_UInt32   accel_limit;    /* first charcode not in table      */
+    FT_TS_UShort*  accel_pages;    /* page -> block index              */
+    FT_TS_UShort*  accel_glyphs;   /* blocks of 256 glyph indices      */
+#endif
+
   } TT_CMapRec, *TT_CMap;
 
   typedef const struct TT_CMap_ClassRec_*  TT_CMap_Class;
@@ -66,6 +74,7 @@ FT_TS_BEGIN_HEADER
                            variant_list_,      \
                            charvariant_list_,  \
                            variantchar_list_,  \
+                           char_indices_,      \
                            format_,            \
                            validate_,          \
                            get_cmap_info_ )    \
@@ -81,7 +90,8 @@ FT_TS_BEGIN_HEADER
       char_var_default_,                       \
       variant_list_,                           \
       charvariant_list_,                       \
-      variantchar_list_                        \
+      variantchar_list_,                       \
+      char_indices_                            \
     },                                         \
                                                \
     format_,                                   \
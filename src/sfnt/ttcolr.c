@@ -529,12 +529,12 @@
       apaint->u.radial_gradient.c0.x = INT_TO_FIXED( FT_TS_NEXT_SHORT( p ) );
       apaint->u.radial_gradient.c0.y = INT_TO_FIXED( FT_TS_NEXT_SHORT( p ) );
 
-      apaint->u.radial_gradient.r0 = FT_TS_NEXT_USHORT( p ) << 16;
+      apaint->u.radial_gradient.r0 = (FT_TS_Pos)FT_TS_NEXT_USHORT( p ) << 16;
 
       apaint->u.radial_gradient.c1.x = INT_TO_FIXED( FT_TS_NEXT_SHORT( p ) );
       apaint->u.radial_gradient.c1.y = INT_TO_FIXED( FT_TS_NEXT_SHORT( p ) );
 
-      apaint->u.radial_gradient.r1 = FT_TS_NEXT_USHORT( p ) << 16;
+      apaint->u.radial_gradient.r1 = (FT_TS_Pos)FT_TS_NEXT_USHORT( p ) << 16;
 
       return 1;
     }
@@ -882,11 +882,11 @@
         font_clip_box.xMin = FT_TS_MulFix( FT_TS_NEXT_SHORT( p1 ),
                                         face->root.size->metrics.x_scale );
         font_clip_box.yMin = FT_TS_MulFix( FT_TS_NEXT_SHORT( p1 ),
-                                        face->root.size->metrics.x_scale );
+                                        face->root.size->metrics.y_scale );
         font_clip_box.xMax = FT_TS_MulFix( FT_TS_NEXT_SHORT( p1 ),
                                         face->root.size->metrics.x_scale );
         font_clip_box.yMax = FT_TS_MulFix( FT_TS_NEXT_SHORT( p1 ),
-                                        face->root.size->metrics.x_scale );
+                                        face->root.size->metrics.y_scale );
 
         /* Make 4 corner points (xMin, yMin), (xMax, yMax) and transform */
         /* them.  If we we would only transform two corner points and    */
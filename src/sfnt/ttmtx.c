@@ -195,6 +195,121 @@
   }
 
 
+  /*
+   * Decode the `hmtx' or `vmtx' table into an array with one entry per
+   * glyph, so that `tt_face_get_metrics' doesn't need to access the stream
+   * for every call.  The values are exactly those computed by the
+   * stream-based code in `tt_face_get_metrics'; if the array can't be
+   * built (for example, because of an allocation failure), we silently
+   * stay with the latter.
+   */
+  static void
+  tt_face_decode_metrics( TT_Face     face,
+                          FT_TS_Bool  vertical )
+  {
+    FT_TS_Error        error;
+    FT_TS_Stream       stream     = face->root.stream;
+    FT_TS_Memory       memory     = face->root.memory;
+    FT_TS_UInt         num_glyphs = face->max_profile.numGlyphs;
+    TT_HoriHeader*     header;
+    TT_LongMetrics     metrics    = NULL;
+    FT_TS_ULong        table_pos, table_size, size, pos;
+    FT_TS_UInt         k, nn;
+    FT_TS_Byte*        p          = NULL;
+
+
+    if ( vertical )
+    {
+      void*  v = &face->vertical;
+
+
+      header     = (TT_HoriHeader*)v;
+      table_pos  = face->vert_metrics_offset;
+      table_size = face->vert_metrics_size;
+
+      face->vert_metrics_loaded = 1;
+    }
+    else
+    {
+      header     = &face->horizontal;
+      table_pos  = face->horz_metrics_offset;
+      table_size = face->horz_metrics_size;
+
+      face->horz_metrics_loaded = 1;
+    }
+
+    k = header->number_Of_HMetrics;
+
+    /* nothing to gain if there is no data at all */
+    if ( !k || !num_glyphs || !table_size )
+      return;
+
+    /* the number of bytes accessed for glyphs below `num_glyphs' */
+    if ( k >= num_glyphs )
+      size = 4 * (FT_TS_ULong)num_glyphs;
+    else
+      size = 4 * (FT_TS_ULong)k + 2 * (FT_TS_ULong)( num_glyphs - k );
+
+    if ( size > table_size )
+      size = table_size;
+
+    /* we might be called while a frame is active, */
+    /* so we can't use `FT_TS_FRAME_ENTER' here      */
+    if ( FT_TS_QALLOC( p, size )                          ||
+         FT_TS_STREAM_READ_AT( table_pos, p, size )       ||
+         FT_TS_QNEW_ARRAY( metrics, num_glyphs )          )
+    {
+      FT_TS_FREE( p );
+      return;
+    }
+
+    for ( nn = 0; nn < num_glyphs && nn < k; nn++ )
+    {
+      pos = 4 * (FT_TS_ULong)nn;
+
+      if ( pos + 4 > size )
+      {
+        metrics[nn].advance = 0;
+        metrics[nn].bearing = 0;
+      }
+      else
+      {
+        metrics[nn].advance = FT_TS_PEEK_USHORT( p + pos );
+        metrics[nn].bearing = FT_TS_PEEK_SHORT( p + pos + 2 );
+      }
+    }
+
+    if ( nn < num_glyphs )
+    {
+      /* the remaining glyphs share the last advance value */
+      FT_TS_UShort  advance;
+      FT_TS_Bool    no_data;
+
+
+      pos     = 4 * (FT_TS_ULong)( k - 1 );
+      no_data = FT_TS_BOOL( pos + 2 > size );
+      advance = no_data ? 0 : FT_TS_PEEK_USHORT( p + pos );
+
+      for ( ; nn < num_glyphs; nn++ )
+      {
+        pos = 4 * (FT_TS_ULong)k + 2 * (FT_TS_ULong)( nn - k );
+
+        metrics[nn].advance = advance;
+        metrics[nn].bearing = ( no_data || pos + 2 > size )
+                                ? 0
+                                : FT_TS_PEEK_SHORT( p + pos );
+      }
+    }
+
+    FT_TS_FREE( p );
+
+    if ( vertical )
+      face->vert_metrics = metrics;
+    else
+      face->horz_metrics = metrics;
+  }
+
+
   /**************************************************************************
    *
    * @Function:
@@ -236,6 +351,7 @@
     TT_HoriHeader*  header;
     FT_TS_ULong        table_pos, table_size, table_end;
     FT_TS_UShort       k;
+    TT_LongMetrics  metrics;
 
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
     FT_TS_Service_MetricsVariations  var =
@@ -259,50 +375,64 @@
       table_size = face->horz_metrics_size;
     }
 
-    table_end = table_pos + table_size;
+    if ( !( vertical ? face->vert_metrics_loaded
+                     : face->horz_metrics_loaded ) )
+      tt_face_decode_metrics( face, vertical );
 
-    k = header->number_Of_HMetrics;
+    metrics = vertical ? face->vert_metrics : face->horz_metrics;
 
-    if ( k > 0 )
+    if ( metrics && gindex < face->max_profile.numGlyphs )
     {
-      if ( gindex < (FT_TS_UInt)k )
-      {
-        table_pos += 4 * gindex;
-        if ( table_pos + 4 > table_end )
-          goto NoData;
-
-        if ( FT_TS_STREAM_SEEK( table_pos ) ||
-             FT_TS_READ_USHORT( *aadvance ) ||
-             FT_TS_READ_SHORT( *abearing )  )
-          goto NoData;
-      }
-      else
-      {
-        table_pos += 4 * ( k - 1 );
-        if ( table_pos + 2 > table_end )
-          goto NoData;
+      *aadvance = metrics[gindex].advance;
+      *abearing = metrics[gindex].bearing;
+    }
+    else
+    {
+      table_end = table_pos + table_size;
 
-        if ( FT_TS_STREAM_SEEK( table_pos ) ||
-             FT_TS_READ_USHORT( *aadvance ) )
-          goto NoData;
+      k = header->number_Of_HMetrics;
 
-        table_pos += 4 + 2 * ( gindex - k );
-        if ( table_pos + 2 > table_end )
-          *abearing = 0;
+      if ( k > 0 )
+      {
+        if ( gindex < (FT_TS_UInt)k )
+        {
+          table_pos += 4 * gindex;
+          if ( table_pos + 4 > table_end )
+            goto NoData;
+
+          if ( FT_TS_STREAM_SEEK( table_pos ) ||
+               FT_TS_READ_USHORT( *aadvance ) ||
+               FT_TS_READ_SHORT( *abearing )  )
+            goto NoData;
+        }
         else
         {
-          if ( FT_TS_STREAM_SEEK( table_pos ) )
+          table_pos += 4 * ( k - 1 );
+          if ( table_pos + 2 > table_end )
+            goto NoData;
+
+          if ( FT_TS_STREAM_SEEK( table_pos ) ||
+               FT_TS_READ_USHORT( *aadvance ) )
+            goto NoData;
+
+          table_pos += 4 + 2 * ( gindex - k );
+          if ( table_pos + 2 > table_end )
             *abearing = 0;
           else
-            (void)FT_TS_READ_SHORT( *abearing );
+          {
+            if ( FT_TS_STREAM_SEEK( table_pos ) )
+              *abearing = 0;
+            else
+              (void)FT_TS_READ_SHORT( *abearing );
+          }
         }
       }
-    }
-    else
-    {
-    NoData:
-      *abearing = 0;
-      *aadvance = 0;
+      else
+      {
+      NoData:
+        *abearing = 0;
+        *aadvance = 0;
+      }
     }
 
 #ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
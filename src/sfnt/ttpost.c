@@ -444,6 +444,10 @@
       }
     }
     names->loaded = 0;
+
+    /* the hash keys point into the names */
+    ft_hash_str_free( names->name_index, memory );
+    FT_TS_FREE( names->name_index );
   }
 
 
@@ -265,6 +265,18 @@
   }
 
 
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+
+  static void
+  tt_sbit_png_free( FT_TS_MruNode  node,
+                    FT_TS_Memory   memory )
+  {
+    FT_TS_FREE( node );
+  }
+
+#endif
+
+
   FT_TS_LOCAL_DEF( void )
   tt_face_free_sbit( TT_Face  face )
   {
@@ -275,6 +287,34 @@
     face->sbit_table_size  = 0;
     face->sbit_table_type  = TT_SBIT_TABLE_TYPE_NONE;
     face->sbit_num_strikes = 0;
+
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+    {
+      FT_TS_Memory  memory = face->root.memory;
+
+
+      if ( face->sbit_components )
+      {
+        ft_hash_num_free( face->sbit_components, memory );
+        FT_TS_FREE( face->sbit_components );
+      }
+
+      while ( face->sbit_component_list )
+      {
+        TT_SBit_Cached  next = face->sbit_component_list->next;
+
+
+        FT_TS_FREE( face->sbit_component_list );
+        face->sbit_component_list = next;
+      }
+
+      face->sbit_components_size = 0;
+    }
+#endif
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+    ft_mru_done( &face->sbit_pngs, tt_sbit_png_free, face->root.memory );
+#endif
   }
 
 
@@ -487,6 +527,16 @@
     FT_TS_Byte*         eblc_base;
     FT_TS_Byte*         eblc_limit;
 
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+    FT_TS_Bool          use_cache;
+    FT_TS_Int           cache_key;    /* strike index shifted by 16 bits */
+#endif
+
+#ifdef FT_TS_CONFIG_OPTION_USE_PNG
+    FT_TS_Byte*         glyph_data;   /* data of the image being loaded */
+    FT_TS_ULong         glyph_start;  /* and its offset in the table    */
+#endif
+
   } TT_SBitDecoderRec, *TT_SBitDecoder;
 
 
@@ -540,6 +590,12 @@
       p                          += 34;
       decoder->bit_depth          = *p;
 
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+      /* the cache is keyed by strike and glyph index */
+      decoder->use_cache = FT_TS_BOOL( strike_index < 0x8000UL );
+      decoder->cache_key = (FT_TS_Int)( ( strike_index & 0x7FFF ) << 16 );
+#endif
+
       /* decoder->strike_index_array +                               */
       /*   8 * decoder->strike_index_count > face->sbit_table_size ? */
       if ( decoder->strike_index_array > face->sbit_table_size           ||
@@ -706,6 +762,140 @@
                       FT_TS_UInt         recurse_count );
 
 
+  /* OR `count' bytes of `source' into `target', word by word. */
+  static void
+  tt_sbit_decoder_or_bytes( FT_TS_Byte*  target,
+                            FT_TS_Byte*  source,
+                            FT_TS_ULong  count )
+  {
+    for ( ; count >= 4; count -= 4, target += 4, source += 4 )
+    {
+      FT_TS_UInt32  t, s;
+
+
+      ft_memcpy( &t, target, 4 );
+      ft_memcpy( &s, source, 4 );
+      t |= s;
+      ft_memcpy( target, &t, 4 );
+    }
+
+    for ( ; count > 0; count-- )
+      *target++ |= *source++;
+  }
+
+
+  /*
+   * OR `height' rows of `line_bits' bits each into `bitmap', starting with
+   * bit `x_pos' of row `y_pos'.  Row `n' of the source data starts at bit
+   * offset `n * stride' of `p'.
+   *
+   * If both source and target rows start at byte boundaries, whole
+   * 32-bit words are ORed; rows that are contiguous in both source and
+   * target (for example, a complete glyph blitted into a bitmap of its own
+   * size) get handled as a single run.  There are no SIMD variants: a
+   * monochrome sbit row rarely exceeds a few bytes, and the rows are not
+   * aligned, so the setup of vector loads would never pay off.
+   *
+   * Otherwise, instead of shifting the data byte by byte, up to 24~bits of
+   * a row are moved at once: we fetch the four source bytes holding them
+   * as a big-endian 32-bit word, align the bits to the target position,
+   * and OR the (at most four) affected target bytes.  Source bytes at or
+   * after `limit' are read as zero; the caller must ensure that the bits
+   * actually blitted are all before `limit'.
+   */
+  static void
+  tt_sbit_decoder_blit( FT_TS_Bitmap*  bitmap,
+                        FT_TS_Byte*    p,
+                        FT_TS_Byte*    limit,
+                        FT_TS_ULong    stride,
+                        FT_TS_UInt     line_bits,
+                        FT_TS_UInt     height,
+                        FT_TS_Int      x_pos,
+                        FT_TS_Int      y_pos )
+  {
+    FT_TS_Byte*  line  = bitmap->buffer;
+    FT_TS_UInt   shift = (FT_TS_UInt)x_pos & 7;
+    FT_TS_ULong  src   = 0;
+
+
+    line += y_pos * bitmap->pitch + ( x_pos >> 3 );
+
+    if ( !shift && !( stride & 7 ) )
+    {
+      FT_TS_UInt  count = line_bits >> 3;
+      FT_TS_UInt  rest  = line_bits & 7;
+
+
+      stride >>= 3;
+
+      if ( !rest                                 &&
+           stride == count                       &&
+           (FT_TS_UInt)bitmap->pitch == count )
+      {
+        tt_sbit_decoder_or_bytes( line, p, (FT_TS_ULong)count * height );
+        return;
+      }
+
+      for ( ; height > 0; height--, line += bitmap->pitch, p += stride )
+      {
+        tt_sbit_decoder_or_bytes( line, p, count );
+
+        if ( rest )
+          line[count] |= (FT_TS_Byte)( p[count] & ( 0xFF00U >> rest ) );
+      }
+
+      return;
+    }
+
+    for ( ; height > 0; height--, line += bitmap->pitch, src += stride )
+    {
+      FT_TS_Byte*  pwrite = line;
+      FT_TS_ULong  pos    = src;
+      FT_TS_UInt   w, n;
+
+
+      for ( w = line_bits; w > 0; w -= n, pos += n, pwrite += 3 )
+      {
+        FT_TS_Byte*   q = p + ( pos >> 3 );
+        FT_TS_UInt32  val;
+
+
+        n = w < 24 ? w : 24;
+
+        if ( q + 4 <= limit )
+          val = (FT_TS_UInt32)FT_TS_PEEK_ULONG( q );
+        else
+        {
+          val = 0;
+          if ( q < limit )
+            val |= (FT_TS_UInt32)q[0] << 24;
+          if ( q + 1 < limit )
+            val |= (FT_TS_UInt32)q[1] << 16;
+          if ( q + 2 < limit )
+            val |= (FT_TS_UInt32)q[2] << 8;
+        }
+
+        /* left-align the `n' bits to blit, then move them to `shift' */
+        val <<= pos & 7;
+        val  &= 0xFFFFFFFFUL << ( 32 - n );
+        val >>= shift;
+
+        pwrite[0] |= (FT_TS_Byte)( val >> 24 );
+        if ( shift + n > 8 )
+        {
+          pwrite[1] |= (FT_TS_Byte)( val >> 16 );
+          if ( shift + n > 16 )
+          {
+            pwrite[2] |= (FT_TS_Byte)( val >> 8 );
+            if ( shift + n > 24 )
+              pwrite[3] |= (FT_TS_Byte)val;
+          }
+        }
+      }
+    }
+  }
+
+
   static FT_TS_Error
   tt_sbit_decoder_load_byte_aligned( TT_SBitDecoder  decoder,
                                      FT_TS_Byte*        p,
@@ -715,8 +905,7 @@
                                      FT_TS_UInt         recurse_count )
   {
     FT_TS_Error    error = FT_TS_Err_Ok;
-    FT_TS_Byte*    line;
-    FT_TS_Int      pitch, width, height, line_bits, h;
+    FT_TS_Int      width, height, line_bits;
     FT_TS_UInt     bit_height, bit_width;
     FT_TS_Bitmap*  bitmap;
 
@@ -727,8 +916,6 @@
     bitmap     = decoder->bitmap;
     bit_width  = bitmap->width;
     bit_height = bitmap->rows;
-    pitch      = bitmap->pitch;
-    line       = bitmap->buffer;
 
     width  = decoder->metrics->width;
     height = decoder->metrics->height;
@@ -751,60 +938,15 @@
       goto Exit;
     }
 
-    /* now do the blit */
-    line  += y_pos * pitch + ( x_pos >> 3 );
-    x_pos &= 7;
-
-    if ( x_pos == 0 )  /* the easy one */
-    {
-      for ( h = height; h > 0; h--, line += pitch )
-      {
-        FT_TS_Byte*  pwrite = line;
-        FT_TS_Int    w;
-
-
-        for ( w = line_bits; w >= 8; w -= 8 )
-        {
-          pwrite[0] = (FT_TS_Byte)( pwrite[0] | *p++ );
-          pwrite   += 1;
-        }
-
-        if ( w > 0 )
-          pwrite[0] = (FT_TS_Byte)( pwrite[0] | ( *p++ & ( 0xFF00U >> w ) ) );
-      }
-    }
-    else  /* x_pos > 0 */
-    {
-      for ( h = height; h > 0; h--, line += pitch )
-      {
-        FT_TS_Byte*  pwrite = line;
-        FT_TS_Int    w;
-        FT_TS_UInt   wval = 0;
-
-
-        for ( w = line_bits; w >= 8; w -= 8 )
-        {
-          wval       = (FT_TS_UInt)( wval | *p++ );
-          pwrite[0]  = (FT_TS_Byte)( pwrite[0] | ( wval >> x_pos ) );
-          pwrite    += 1;
-          wval     <<= 8;
-        }
-
-        if ( w > 0 )
-          wval = (FT_TS_UInt)( wval | ( *p++ & ( 0xFF00U >> w ) ) );
-
-        /* all bits read and there are `x_pos + w' bits to be written */
-
-        pwrite[0] = (FT_TS_Byte)( pwrite[0] | ( wval >> x_pos ) );
-
-        if ( x_pos + w > 8 )
-        {
-          pwrite++;
-          wval     <<= 8;
-          pwrite[0]  = (FT_TS_Byte)( pwrite[0] | ( wval >> x_pos ) );
-        }
-      }
-    }
+    /* now do the blit; each row starts with a new byte */
+    tt_sbit_decoder_blit( bitmap,
+                          p,
+                          limit,
+                          (FT_TS_ULong)( ( line_bits + 7 ) & ~7 ),
+                          (FT_TS_UInt)line_bits,
+                          (FT_TS_UInt)height,
+                          x_pos,
+                          y_pos );
 
   Exit:
     if ( !error )
@@ -813,41 +955,6 @@
   }
 
 
-  /*
-   * Load a bit-aligned bitmap (with pointer `p') into a line-aligned bitmap
-   * (with pointer `pwrite').  In the example below, the width is 3 pixel,
-   * and `x_pos' is 1 pixel.
-   *
-   *       p                               p+1
-   *     |                               |                               |
-   *     | 7   6   5   4   3   2   1   0 | 7   6   5   4   3   2   1   0 |...
-   *     |                               |                               |
-   *       +-------+   +-------+   +-------+ ...
-   *           .           .           .
-   *           .           .           .
-   *           v           .           .
-   *       +-------+       .           .
-   * |                               | .
-   * | 7   6   5   4   3   2   1   0 | .
-   * |                               | .
-   *   pwrite              .           .
-   *                       .           .
-   *                       v           .
-   *                   +-------+       .
-   *             |                               |
-   *             | 7   6   5   4   3   2   1   0 |
-   *             |                               |
-   *               pwrite+1            .
-   *                                   .
-   *                                   v
-   *                               +-------+
-   *                         |                               |
-   *                         | 7   6   5   4   3   2   1   0 |
-   *                         |                               |
-   *                           pwrite+2
-   *
-   */
-
   static FT_TS_Error
   tt_sbit_decoder_load_bit_aligned( TT_SBitDecoder  decoder,
                                     FT_TS_Byte*        p,
@@ -857,11 +964,9 @@
                                     FT_TS_UInt         recurse_count )
   {
     FT_TS_Error    error = FT_TS_Err_Ok;
-    FT_TS_Byte*    line;
-    FT_TS_Int      pitch, width, height, line_bits, h, nbits;
+    FT_TS_Int      width, height, line_bits;
     FT_TS_UInt     bit_height, bit_width;
     FT_TS_Bitmap*  bitmap;
-    FT_TS_UShort   rval;
 
     FT_TS_UNUSED( recurse_count );
 
@@ -870,8 +975,6 @@
     bitmap     = decoder->bitmap;
     bit_width  = bitmap->width;
     bit_height = bitmap->rows;
-    pitch      = bitmap->pitch;
-    line       = bitmap->buffer;
 
     width  = decoder->metrics->width;
     height = decoder->metrics->height;
@@ -894,92 +997,154 @@
       goto Exit;
     }
 
-    if ( !line_bits || !height )
+    /* now do the blit; the rows form a continuous bit stream */
+    tt_sbit_decoder_blit( bitmap,
+                          p,
+                          limit,
+                          (FT_TS_ULong)line_bits,
+                          (FT_TS_UInt)line_bits,
+                          (FT_TS_UInt)height,
+                          x_pos,
+                          y_pos );
+
+  Exit:
+    if ( !error )
+      FT_TS_TRACE3(( "tt_sbit_decoder_load_bit_aligned: loaded\n" ));
+    return error;
+  }
+
+
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+
+  /* Blit a compound element taken from the face's sbit component cache. */
+  static FT_TS_Error
+  tt_sbit_decoder_load_cached( TT_SBitDecoder  decoder,
+                               TT_SBit_Cached  cached,
+                               FT_TS_Int          x_pos,
+                               FT_TS_Int          y_pos )
+  {
+    FT_TS_Bitmap*  bitmap = decoder->bitmap;
+    FT_TS_Int      width  = cached->metrics.width;
+    FT_TS_Int      height = cached->metrics.height;
+
+
+    *decoder->metrics = cached->metrics;
+
+    if ( x_pos < 0 || (FT_TS_UInt)( x_pos + width ) > bitmap->width  ||
+         y_pos < 0 || (FT_TS_UInt)( y_pos + height ) > bitmap->rows )
     {
-      /* nothing to do */
-      goto Exit;
+      FT_TS_TRACE1(( "tt_sbit_decoder_load_cached:"
+                  " invalid bitmap dimensions\n" ));
+      return FT_TS_THROW( Invalid_File_Format );
     }
 
-    /* now do the blit */
+    tt_sbit_decoder_blit( bitmap,
+                          cached->buffer,
+                          cached->buffer + cached->pitch * (FT_TS_UInt)height,
+                          8 * (FT_TS_ULong)cached->pitch,
+                          (FT_TS_UInt)width * decoder->bit_depth,
+                          (FT_TS_UInt)height,
+                          x_pos,
+                          y_pos );
 
-    /* adjust `line' to point to the first byte of the bitmap */
-    line  += y_pos * pitch + ( x_pos >> 3 );
-    x_pos &= 7;
+    FT_TS_TRACE3(( "tt_sbit_decoder_load_cached: loaded\n" ));
+    return FT_TS_Err_Ok;
+  }
 
-    /* the higher byte of `rval' is used as a buffer */
-    rval  = 0;
-    nbits = 0;
 
-    for ( h = height; h > 0; h--, line += pitch )
-    {
-      FT_TS_Byte*  pwrite = line;
-      FT_TS_Int    w      = line_bits;
+  /*
+   * Decode compound element `glyph_index' with `loader' into a new entry of
+   * the sbit component cache, then blit it.  If the cache is full we
+   * decode directly into the target bitmap.
+   */
+  static FT_TS_Error
+  tt_sbit_decoder_cache_component( TT_SBitDecoder           decoder,
+                                   TT_SBitDecoder_LoadFunc  loader,
+                                   FT_TS_UInt                  glyph_index,
+                                   FT_TS_Byte*                 p,
+                                   FT_TS_Byte*                 limit,
+                                   FT_TS_Int                   x_pos,
+                                   FT_TS_Int                   y_pos,
+                                   FT_TS_UInt                  recurse_count )
+  {
+    TT_Face         face   = decoder->face;
+    FT_TS_Memory       memory = face->root.memory;
+    FT_TS_Bitmap*      bitmap = decoder->bitmap;
+    FT_TS_Error        error;
+    FT_TS_Bitmap       map;
+    TT_SBit_Cached  cached;
+    FT_TS_UInt         pitch;
+    FT_TS_ULong        len;
 
 
-      /* handle initial byte (in target bitmap) specially if necessary */
-      if ( x_pos )
-      {
-        w = ( line_bits < 8 - x_pos ) ? line_bits : 8 - x_pos;
+    pitch = ( decoder->metrics->width * decoder->bit_depth + 7 ) >> 3;
+    len   = sizeof ( TT_SBit_CachedRec ) +
+            pitch * (FT_TS_ULong)decoder->metrics->height;
 
-        if ( h == height )
-        {
-          rval  = *p++;
-          nbits = x_pos;
-        }
-        else if ( nbits < w )
-        {
-          if ( p < limit )
-            rval |= *p++;
-          nbits += 8 - w;
-        }
-        else
-        {
-          rval  >>= 8;
-          nbits  -= w;
-        }
+    if ( face->sbit_components_size + len >
+           TT_CONFIG_SBIT_COMPONENT_CACHE_MAX_SIZE )
+      goto Uncached;
 
-        *pwrite++ |= ( ( rval >> nbits ) & 0xFF ) &
-                     ( ~( 0xFFU << w ) << ( 8 - w - x_pos ) );
-        rval     <<= 8;
+    if ( !face->sbit_components )
+    {
+      if ( FT_TS_QNEW( face->sbit_components ) )
+        goto Uncached;
 
-        w = line_bits - w;
+      if ( ft_hash_num_init( face->sbit_components, memory ) )
+      {
+        FT_TS_FREE( face->sbit_components );
+        goto Uncached;
       }
+    }
 
-      /* handle medial bytes */
-      for ( ; w >= 8; w -= 8 )
-      {
-        rval      |= *p++;
-        *pwrite++ |= ( rval >> nbits ) & 0xFF;
+    /* the loaders OR their data into a zeroed buffer */
+    if ( FT_TS_ALLOC( cached, len ) )
+      goto Uncached;
 
-        rval <<= 8;
-      }
+    cached->pitch  = pitch;
+    cached->buffer = (FT_TS_Byte*)( cached + 1 );
 
-      /* handle final byte if necessary */
-      if ( w > 0 )
-      {
-        if ( nbits < w )
-        {
-          if ( p < limit )
-            rval |= *p++;
-          *pwrite |= ( ( rval >> nbits ) & 0xFF ) & ( 0xFF00U >> w );
-          nbits   += 8 - w;
+    FT_TS_Bitmap_Init( &map );
+    map.width  = decoder->metrics->width;
+    map.rows   = decoder->metrics->height;
+    map.pitch  = (int)pitch;
+    map.buffer = cached->buffer;
 
-          rval <<= 8;
-        }
-        else
-        {
-          *pwrite |= ( ( rval >> nbits ) & 0xFF ) & ( 0xFF00U >> w );
-          nbits   -= w;
-        }
-      }
+    decoder->bitmap = &map;
+    error           = loader( decoder, p, limit, 0, 0, recurse_count );
+    decoder->bitmap = bitmap;
+
+    if ( error )
+    {
+      FT_TS_FREE( cached );
+      return error;
     }
 
-  Exit:
-    if ( !error )
-      FT_TS_TRACE3(( "tt_sbit_decoder_load_bit_aligned: loaded\n" ));
+    cached->metrics = *decoder->metrics;
+
+    error = tt_sbit_decoder_load_cached( decoder, cached, x_pos, y_pos );
+
+    if ( ft_hash_num_insert( decoder->cache_key | (FT_TS_Int)glyph_index,
+                             (size_t)cached,
+                             face->sbit_components,
+                             memory ) )
+    {
+      FT_TS_FREE( cached );
+      return error;
+    }
+
+    cached->next               = face->sbit_component_list;
+    face->sbit_component_list  = cached;
+    face->sbit_components_size += len;
+
     return error;
+
+  Uncached:
+    return loader( decoder, p, limit, x_pos, y_pos, recurse_count );
   }
 
+#endif /* TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE */
+
 
   static FT_TS_Error
   tt_sbit_decoder_load_compound( TT_SBitDecoder  decoder,
@@ -1055,6 +1220,213 @@
 
 #ifdef FT_TS_CONFIG_OPTION_USE_PNG
 
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+
+  /* the PNG data, as looked for by `tt_sbit_png_compare' */
+  typedef struct  TT_SBit_PngKeyRec_
+  {
+    FT_TS_ULong  offset;
+    FT_TS_ULong  size;
+
+  } TT_SBit_PngKeyRec;
+
+
+  static FT_TS_Bool
+  tt_sbit_png_compare( FT_TS_MruNode  node,
+                       const void*    key_ )
+  {
+    TT_SBit_Png               png = (TT_SBit_Png)node;
+    const TT_SBit_PngKeyRec*  key = (const TT_SBit_PngKeyRec*)key_;
+
+
+    return png->offset == key->offset && png->size == key->size;
+  }
+
+
+  /*
+   * Add the image just decoded by `Load_SBit_Png' from `png_len' bytes of
+   * PNG data at `data' (found at `offset' in the bitmap data table) to the
+   * face's PNG cache.
+   */
+  static void
+  tt_face_add_png( TT_Face          face,
+                   FT_TS_ULong         offset,
+                   FT_TS_Byte*         data,
+                   FT_TS_UInt          png_len,
+                   FT_TS_Int           x_offset,
+                   FT_TS_Int           y_offset,
+                   TT_SBit_Metrics  metrics )
+  {
+    FT_TS_Memory   memory = face->root.memory;
+    FT_TS_Bitmap*  map    = &face->root.glyph->bitmap;
+    FT_TS_Error    error;
+
+    TT_SBit_Png  png;
+    FT_TS_UInt      width, rows, i;
+    FT_TS_ULong     size;
+
+
+    /* `Load_SBit_Png' silently ignores images of unexpected size; */
+    /* the dimensions are at a fixed position of the `IHDR' chunk, */
+    /* which must come first                                       */
+    if ( png_len < 24 )
+      return;
+
+    width = (FT_TS_UInt)FT_TS_PEEK_ULONG( data + 16 );
+    rows  = (FT_TS_UInt)FT_TS_PEEK_ULONG( data + 20 );
+
+    if ( width != metrics->width || rows != metrics->height )
+      return;
+
+    size = sizeof ( TT_SBit_PngRec ) + 4 * (FT_TS_ULong)width * rows;
+    if ( size > TT_CONFIG_SBIT_PNG_CACHE_MAX_SIZE )
+      return;
+
+    if ( FT_TS_QALLOC( png, size ) )
+      return;
+
+    png->node.hash = (FT_TS_UInt32)offset;
+    png->node.size = size;
+    png->offset    = offset;
+    png->size      = png_len;
+    png->width     = width;
+    png->rows      = rows;
+    png->buffer    = (FT_TS_Byte*)( png + 1 );
+
+    for ( i = 0; i < rows; i++ )
+      FT_TS_MEM_COPY( png->buffer + i * width * 4,
+                   map->buffer + ( y_offset + (FT_TS_Int)i ) * map->pitch +
+                     x_offset * 4,
+                   width * 4 );
+
+    ft_mru_add( &face->sbit_pngs,
+                &png->node,
+                TT_CONFIG_SBIT_PNG_CACHE_MAX_SIZE,
+                tt_sbit_png_free,
+                memory );
+  }
+
+#endif /* TT_CONFIG_OPTION_SBIT_PNG_CACHE */
+
+
+  /*
+   * A wrapper around `Load_SBit_Png', taking the image from the face's PNG
+   * cache if possible.  `offset' is the position of the PNG data in the
+   * bitmap data table.
+   */
+  static FT_TS_Error
+  tt_face_load_png( TT_Face          face,
+                    FT_TS_ULong         offset,
+                    FT_TS_Int           x_offset,
+                    FT_TS_Int           y_offset,
+                    FT_TS_Int           pix_bits,
+                    TT_SBit_Metrics  metrics,
+                    FT_TS_Memory        memory,
+                    FT_TS_Byte*         data,
+                    FT_TS_UInt          png_len,
+                    FT_TS_Bool          populate_map_and_metrics,
+                    FT_TS_Bool          metrics_only )
+  {
+    FT_TS_GlyphSlot  slot = face->root.glyph;
+    FT_TS_Error      error;
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+    FT_TS_Bitmap*  map = &slot->bitmap;
+
+    TT_SBit_Png        png;
+    TT_SBit_PngKeyRec  key;
+    FT_TS_UInt         i;
+
+
+    key.offset = offset;
+    key.size   = png_len;
+
+    png = (TT_SBit_Png)ft_mru_lookup( &face->sbit_pngs,
+                                      (FT_TS_UInt32)offset,
+                                      tt_sbit_png_compare,
+                                      &key );
+    if ( png )
+      goto Found;
+#else
+    FT_TS_UNUSED( offset );
+#endif
+
+    error = Load_SBit_Png( slot,
+                           x_offset,
+                           y_offset,
+                           pix_bits,
+                           metrics,
+                           memory,
+                           data,
+                           png_len,
+                           populate_map_and_metrics,
+                           metrics_only );
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+    if ( !error && !metrics_only )
+      tt_face_add_png( face,
+                       offset,
+                       data,
+                       png_len,
+                       x_offset,
+                       y_offset,
+                       metrics );
+#endif
+
+    return error;
+
+#ifdef TT_CONFIG_OPTION_SBIT_PNG_CACHE
+  Found:
+    /* do what `Load_SBit_Png' does, without decoding */
+    if ( x_offset < 0 || y_offset < 0 )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( !populate_map_and_metrics )
+    {
+      if ( (FT_TS_UInt)x_offset + metrics->width  > map->width ||
+           (FT_TS_UInt)y_offset + metrics->height > map->rows  ||
+           pix_bits != 32                                   ||
+           map->pixel_mode != FT_TS_PIXEL_MODE_BGRA            )
+        return FT_TS_THROW( Invalid_Argument );
+
+      if ( png->width != metrics->width || png->rows != metrics->height )
+        return FT_TS_Err_Ok;
+    }
+    else
+    {
+      metrics->width  = (FT_TS_UShort)png->width;
+      metrics->height = (FT_TS_UShort)png->rows;
+
+      map->width      = metrics->width;
+      map->rows       = metrics->height;
+      map->pixel_mode = FT_TS_PIXEL_MODE_BGRA;
+      map->pitch      = (int)( map->width * 4 );
+      map->num_grays  = 256;
+    }
+
+    if ( metrics_only )
+      return FT_TS_Err_Ok;
+
+    if ( populate_map_and_metrics )
+    {
+      error = ft_glyphslot_alloc_bitmap( slot,
+                                         map->rows * (FT_TS_ULong)map->pitch );
+      if ( error )
+        return error;
+    }
+
+    for ( i = 0; i < png->rows; i++ )
+      FT_TS_MEM_COPY( map->buffer + ( y_offset + (FT_TS_Int)i ) * map->pitch +
+                     x_offset * 4,
+                   png->buffer + i * png->width * 4,
+                   png->width * 4 );
+
+    FT_TS_TRACE3(( "tt_face_load_png: loaded from cache\n" ));
+    return FT_TS_Err_Ok;
+#endif /* TT_CONFIG_OPTION_SBIT_PNG_CACHE */
+  }
+
+
   static FT_TS_Error
   tt_sbit_decoder_load_png( TT_SBitDecoder  decoder,
                             FT_TS_Byte*        p,
@@ -1084,16 +1456,18 @@
       goto Exit;
     }
 
-    error = Load_SBit_Png( decoder->face->root.glyph,
-                           x_pos,
-                           y_pos,
-                           decoder->bit_depth,
-                           decoder->metrics,
-                           decoder->stream->memory,
-                           p,
-                           png_len,
-                           FALSE,
-                           FALSE );
+    error = tt_face_load_png( decoder->face,
+                              decoder->glyph_start +
+                                (FT_TS_ULong)( p - decoder->glyph_data ),
+                              x_pos,
+                              y_pos,
+                              decoder->bit_depth,
+                              decoder->metrics,
+                              decoder->stream->memory,
+                              p,
+                              png_len,
+                              FALSE,
+                              FALSE );
 
   Exit:
     if ( !error )
@@ -1106,6 +1480,7 @@
 
   static FT_TS_Error
   tt_sbit_decoder_load_bitmap( TT_SBitDecoder  decoder,
+                               FT_TS_UInt         glyph_index,
                                FT_TS_UInt         glyph_format,
                                FT_TS_ULong        glyph_start,
                                FT_TS_ULong        glyph_size,
@@ -1120,6 +1495,10 @@
     FT_TS_Byte*   p_limit;
     FT_TS_Byte*   data;
 
+#ifndef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+    FT_TS_UNUSED( glyph_index );
+#endif
+
 
     /* seek into the EBDT table now */
     if ( !glyph_size                                   ||
@@ -1136,6 +1515,11 @@
     p       = data;
     p_limit = p + glyph_size;
 
+#ifdef FT_TS_CONFIG_OPTION_USE_PNG
+    decoder->glyph_data  = data;
+    decoder->glyph_start = glyph_start;
+#endif
+
     /* read the data, depending on the glyph format */
     switch ( glyph_format )
     {
@@ -1243,7 +1627,23 @@
       if ( metrics_only )
         goto Fail; /* this is not an error */
 
-      error = loader( decoder, p, p_limit, x_pos, y_pos, recurse_count );
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+      /* compound elements with uncompressed data get cached */
+      if ( recurse_count                                     &&
+           decoder->use_cache                                &&
+           ( loader == tt_sbit_decoder_load_byte_aligned ||
+             loader == tt_sbit_decoder_load_bit_aligned  )   )
+        error = tt_sbit_decoder_cache_component( decoder,
+                                                 loader,
+                                                 glyph_index,
+                                                 p,
+                                                 p_limit,
+                                                 x_pos,
+                                                 y_pos,
+                                                 recurse_count );
+      else
+#endif
+        error = loader( decoder, p, p_limit, x_pos, y_pos, recurse_count );
     }
 
   Fail:
@@ -1277,6 +1677,28 @@
       goto Failure;
     }
 
+#ifdef TT_CONFIG_OPTION_SBIT_COMPONENT_CACHE
+    /* Compound elements may already be decoded.  Note that we must not */
+    /* take this shortcut if the compound glyph's bitmap is empty: the  */
+    /* first element then gets loaded into a bitmap of its own size.    */
+    if ( recurse_count                 &&
+         decoder->use_cache            &&
+         decoder->bitmap_allocated     &&
+         decoder->face->sbit_components )
+    {
+      size_t*  cached;
+
+
+      cached = ft_hash_num_lookup( decoder->cache_key | (FT_TS_Int)glyph_index,
+                                   decoder->face->sbit_components );
+      if ( cached )
+        return tt_sbit_decoder_load_cached( decoder,
+                                            (TT_SBit_Cached)*cached,
+                                            x_pos,
+                                            y_pos );
+    }
+#endif
+
 
     /* First, we find the correct strike range that applies to this */
     /* glyph index.                                                 */
@@ -1440,6 +1862,7 @@
                 image_format, glyph_index ));
 
     return tt_sbit_decoder_load_bitmap( decoder,
+                                        glyph_index,
                                         image_format,
                                         image_start,
                                         image_end,
@@ -1547,16 +1970,17 @@
 
     case FT_TS_MAKE_TAG( 'p', 'n', 'g', ' ' ):
 #ifdef FT_TS_CONFIG_OPTION_USE_PNG
-      error = Load_SBit_Png( face->root.glyph,
-                             0,
-                             0,
-                             32,
-                             metrics,
-                             stream->memory,
-                             stream->cursor,
-                             glyph_end - glyph_start - 8,
-                             TRUE,
-                             metrics_only );
+      error = tt_face_load_png( face,
+                                strike_offset + glyph_start + 8,
+                                0,
+                                0,
+                                32,
+                                metrics,
+                                stream->memory,
+                                stream->cursor,
+                                glyph_end - glyph_start - 8,
+                                TRUE,
+                                metrics_only );
 #else
       error = FT_TS_THROW( Unimplemented_Feature );
 #endif
@@ -0,0 +1,249 @@
+/*
+ * gcc -DFT2_BUILD_LIBRARY -I../../include -o test_outhash test_outhash.c \
+ *     -L../../objs/.libs -lfreetype -lz -static
+ *
+ * Usage: test_outhash [-s ppem] [-v] font ...
+ *
+ * Print a hash of all glyph outlines of TrueType fonts, loaded unhinted
+ * and with the bytecode interpreter (grayscale and monochrome).  Variable
+ * fonts are also hashed at every named instance and at the minimum and
+ * maximum of each axis, which exercises `gvar' delta interpolation.
+ *
+ * Run it over a font corpus with two builds of the library and compare
+ * the outputs to verify that a change to `IUP' or `gvar' processing is
+ * bit-exact.  With `-v', a hash for every single glyph is printed too,
+ * to locate the differences.
+ */
+#include <freetype/freetype.h>
+#include <freetype/ftmm.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define PPEM  16L
+
+  static const struct
+  {
+    const char*  name;
+    FT_TS_Int32  flags;
+
+  } load_modes[] =
+  {
+    { "unhinted", FT_TS_LOAD_NO_HINTING },
+    { "hinted",   FT_TS_LOAD_NO_AUTOHINT },
+    { "mono",     FT_TS_LOAD_NO_AUTOHINT | FT_TS_LOAD_TARGET_MONO }
+  };
+
+#define NUM_LOAD_MODES                                     \
+          (int)( sizeof ( load_modes ) / sizeof ( *load_modes ) )
+
+
+  static unsigned long
+  hash_long( unsigned long  hash,
+             long           value )
+  {
+    int  i;
+
+
+    for ( i = 0; i < 4; i++ )
+    {
+      hash  ^= (unsigned long)value & 0xFF;
+      hash  *= 16777619UL;
+      hash  &= 0xFFFFFFFFUL;
+      value >>= 8;
+    }
+
+    return hash;
+  }
+
+
+  /* hash the outlines of all glyphs in the face's current instance */
+  static void
+  hash_instance( FT_TS_Face   face,
+                 const char*  filename,
+                 const char*  instance,
+                 int          verbose )
+  {
+    int  m;
+
+
+    for ( m = 0; m < NUM_LOAD_MODES; m++ )
+    {
+      unsigned long  hash   = 2166136261UL;
+      long           errors = 0;
+      long           gindex;
+
+
+      for ( gindex = 0; gindex < face->num_glyphs; gindex++ )
+      {
+        FT_TS_GlyphSlot  slot    = face->glyph;
+        FT_TS_Outline*   outline = &slot->outline;
+        unsigned long    ghash   = 2166136261UL;
+        FT_TS_Error      error;
+        int              i;
+
+
+        error = FT_TS_Load_Glyph( face,
+                                  (FT_TS_UInt)gindex,
+                                  load_modes[m].flags );
+        ghash = hash_long( ghash, error );
+
+        if ( error )
+          errors++;
+        else
+        {
+          ghash = hash_long( ghash, slot->advance.x );
+          ghash = hash_long( ghash, slot->advance.y );
+          ghash = hash_long( ghash, outline->n_contours );
+          ghash = hash_long( ghash, outline->n_points );
+
+          for ( i = 0; i < outline->n_contours; i++ )
+            ghash = hash_long( ghash, outline->contours[i] );
+
+          for ( i = 0; i < outline->n_points; i++ )
+          {
+            ghash = hash_long( ghash, outline->points[i].x );
+            ghash = hash_long( ghash, outline->points[i].y );
+            ghash = hash_long( ghash, outline->tags[i] );
+          }
+        }
+
+        if ( verbose )
+          printf( "%s %s %s glyph %ld: %08lx\n",
+                  filename, instance, load_modes[m].name, gindex, ghash );
+
+        hash = hash_long( hash, (long)ghash );
+      }
+
+      printf( "%s %s %s: %08lx (%ld errors)\n",
+              filename, instance, load_modes[m].name, hash, errors );
+    }
+  }
+
+
+  static int
+  hash_font( FT_TS_Library  library,
+             const char*    filename,
+             long           ppem,
+             int            verbose )
+  {
+    FT_TS_Face     face;
+    FT_TS_MM_Var*  mm;
+    FT_TS_Fixed*   coords;
+    FT_TS_Error    error;
+    char           instance[32];
+    FT_TS_UInt     i;
+
+
+    error = FT_TS_New_Face( library, filename, 0, &face );
+    if ( !error )
+      error = FT_TS_Set_Pixel_Sizes( face, 0, (FT_TS_UInt)ppem );
+    if ( error )
+    {
+      fprintf( stderr, "%s: cannot open font (error 0x%02X)\n",
+               filename, error );
+      return 1;
+    }
+
+    hash_instance( face, filename, "default", verbose );
+
+    if ( !FT_TS_HAS_MULTIPLE_MASTERS( face )   ||
+         FT_TS_Get_MM_Var( face, &mm )         )
+      goto Exit;
+
+    for ( i = 1; i <= mm->num_namedstyles; i++ )
+    {
+      if ( FT_TS_Set_Named_Instance( face, i ) )
+        continue;
+
+      sprintf( instance, "named-%u", i );
+      hash_instance( face, filename, instance, verbose );
+    }
+
+    coords = (FT_TS_Fixed*)malloc( mm->num_axis * sizeof ( FT_TS_Fixed ) );
+    if ( coords )
+    {
+      FT_TS_UInt  axis;
+
+
+      for ( axis = 0; axis < mm->num_axis; axis++ )
+      {
+        for ( i = 0; i < mm->num_axis; i++ )
+          coords[i] = mm->axis[i].def;
+
+        coords[axis] = mm->axis[axis].minimum;
+        if ( !FT_TS_Set_Var_Design_Coordinates( face, mm->num_axis, coords ) )
+        {
+          sprintf( instance, "axis-%u-min", axis );
+          hash_instance( face, filename, instance, verbose );
+        }
+
+        coords[axis] = mm->axis[axis].maximum;
+        if ( !FT_TS_Set_Var_Design_Coordinates( face, mm->num_axis, coords ) )
+        {
+          sprintf( instance, "axis-%u-max", axis );
+          hash_instance( face, filename, instance, verbose );
+        }
+      }
+
+      free( coords );
+    }
+
+    FT_TS_Done_MM_Var( library, mm );
+
+  Exit:
+    FT_TS_Done_Face( face );
+
+    return 0;
+  }
+
+
+  int  main( int  argc, char**  argv )
+  {
+    FT_TS_Library  library;
+    long           ppem    = PPEM;
+    int            verbose = 0;
+    int            i, status = 0;
+
+
+    while ( argc > 1 && argv[1][0] == '-' )
+    {
+      if ( argc > 2 && !strcmp( argv[1], "-s" ) )
+      {
+        ppem = atol( argv[2] );
+        if ( ppem <= 0 )
+          ppem = PPEM;
+
+        argc--;
+        argv++;
+      }
+      else if ( !strcmp( argv[1], "-v" ) )
+        verbose = 1;
+      else
+        break;
+
+      argc--;
+      argv++;
+    }
+
+    if ( argc < 2 )
+    {
+      fprintf( stderr, "usage: test_outhash [-s ppem] [-v] font ...\n" );
+      return 1;
+    }
+
+    if ( FT_TS_Init_FreeType( &library ) )
+    {
+      fprintf( stderr, "cannot initialize FreeType\n" );
+      return 1;
+    }
+
+    for ( i = 1; i < argc; i++ )
+      status |= hash_font( library, argv[i], ppem, verbose );
+
+    FT_TS_Done_FreeType( library );
+
+    return status;
+  }
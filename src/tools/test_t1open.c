@@ -0,0 +1,112 @@
+/*
+ * gcc -DFT2_BUILD_LIBRARY -I../../include -o test_t1open test_t1open.c \
+ *     -L../../objs/.libs -lfreetype -lz -static
+ *
+ * Usage: test_t1open [-n repeat] font.pfa|font.pfb ...
+ *
+ * Measure how long it takes to open (and immediately close) Type 1 fonts.
+ * The first open of each font is timed separately since it fills the
+ * driver's private dictionary cache; all further opens should hit it.
+ */
+#include <freetype/freetype.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <time.h>    /* for clock() */
+
+/* SunOS 4.1.* does not define CLOCKS_PER_SEC, so include <sys/param.h> */
+/* to get the HZ macro which is the equivalent.                         */
+#if defined(__sun__) && !defined(SVR4) && !defined(__SVR4)
+#include <sys/param.h>
+#define CLOCKS_PER_SEC HZ
+#endif
+
+  static long
+  get_time( void )
+  {
+    return clock() * 10000L / CLOCKS_PER_SEC;
+  }
+
+
+#define REPEAT  200L
+
+  static int
+  profile_open( FT_TS_Library  library,
+                const char*    filename,
+                long           repeat )
+  {
+    FT_TS_Face   face;
+    FT_TS_Error  error;
+    long         count;
+    long         time0, time1;
+
+
+    time0 = get_time();
+    error = FT_TS_New_Face( library, filename, 0, &face );
+    if ( error )
+    {
+      fprintf( stderr, "%s: cannot open font (error 0x%02X)\n",
+               filename, error );
+      return 1;
+    }
+    FT_TS_Done_Face( face );
+    time0 = get_time() - time0;
+
+    time1 = get_time();
+    for ( count = repeat; count > 0; count-- )
+    {
+      error = FT_TS_New_Face( library, filename, 0, &face );
+      if ( error )
+        return 1;
+      FT_TS_Done_Face( face );
+    }
+    time1 = get_time() - time1;
+
+    printf( "%s: first open %7.3f ms, reopen %7.3f ms (%ld opens)\n",
+            filename,
+            (double)time0 / 10.0,
+            (double)time1 / 10.0 / (double)repeat,
+            repeat );
+
+    return 0;
+  }
+
+
+  int  main( int  argc, char**  argv )
+  {
+    FT_TS_Library  library;
+    long           repeat = REPEAT;
+    int            i, status = 0;
+
+
+    if ( argc > 2 && !strcmp( argv[1], "-n" ) )
+    {
+      repeat = atol( argv[2] );
+      if ( repeat <= 0 )
+        repeat = REPEAT;
+
+      argc -= 2;
+      argv += 2;
+    }
+
+    if ( argc < 2 )
+    {
+      fprintf( stderr, "usage: test_t1open [-n repeat] font ...\n" );
+      return 1;
+    }
+
+    if ( FT_TS_Init_FreeType( &library ) )
+    {
+      fprintf( stderr, "cannot initialize FreeType\n" );
+      return 1;
+    }
+
+    for ( i = 1; i < argc; i++ )
+      status |= profile_open( library, argv[i], repeat );
+
+    FT_TS_Done_FreeType( library );
+
+    return status;
+  }
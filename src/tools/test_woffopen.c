@@ -0,0 +1,218 @@
+/*
+ * gcc -DFT2_BUILD_LIBRARY -I../../include -o test_woffopen test_woffopen.c \
+ *     -L../../objs/.libs -lfreetype -lz -static
+ *
+ * Usage: test_woffopen [-n repeat] font.woff ...
+ *
+ * Measure how long it takes to open (and immediately close) WOFF fonts,
+ * and how much memory FreeType needs for that.  The peak memory is
+ * reported twice: right after opening the face, and after loading all
+ * glyphs of it.  Compare the output of builds with and without
+ * `TT_CONFIG_OPTION_WOFF_LAZY_TABLES' to see the effect of decompressing
+ * the tables on demand.
+ */
+#include <freetype/freetype.h>
+#include <freetype/ftmodapi.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <time.h>    /* for clock() */
+
+/* SunOS 4.1.* does not define CLOCKS_PER_SEC, so include <sys/param.h> */
+/* to get the HZ macro which is the equivalent.                         */
+#if defined(__sun__) && !defined(SVR4) && !defined(__SVR4)
+#include <sys/param.h>
+#define CLOCKS_PER_SEC HZ
+#endif
+
+  static long
+  get_time( void )
+  {
+    return clock() * 10000L / CLOCKS_PER_SEC;
+  }
+
+
+  /* a memory manager that keeps track of the allocated bytes */
+
+  typedef union  block_header_
+  {
+    long    size;
+    double  align;
+
+  } block_header;
+
+
+  static long  cur_memory;
+  static long  max_memory;
+
+
+  static void*
+  counting_alloc( FT_TS_Memory  memory,
+                  long          size )
+  {
+    block_header*  block = (block_header*)malloc( sizeof ( block_header ) +
+                                                  (size_t)size );
+
+
+    (void)memory;
+
+    if ( !block )
+      return NULL;
+
+    block->size  = size;
+    cur_memory  += size;
+    if ( cur_memory > max_memory )
+      max_memory = cur_memory;
+
+    return block + 1;
+  }
+
+
+  static void
+  counting_free( FT_TS_Memory  memory,
+                 void*         p )
+  {
+    block_header*  block = (block_header*)p - 1;
+
+
+    (void)memory;
+
+    cur_memory -= block->size;
+    free( block );
+  }
+
+
+  static void*
+  counting_realloc( FT_TS_Memory  memory,
+                    long          cur_size,
+                    long          new_size,
+                    void*         p )
+  {
+    block_header*  block;
+
+
+    (void)cur_size;
+
+    if ( !p )
+      return counting_alloc( memory, new_size );
+
+    block = (block_header*)p - 1;
+    block = (block_header*)realloc( block, sizeof ( block_header ) +
+                                           (size_t)new_size );
+    if ( !block )
+      return NULL;
+
+    cur_memory  += new_size - block->size;
+    block->size  = new_size;
+    if ( cur_memory > max_memory )
+      max_memory = cur_memory;
+
+    return block + 1;
+  }
+
+
+  static struct FT_TS_MemoryRec_  counting_memory =
+  {
+    NULL,
+    counting_alloc,
+    counting_free,
+    counting_realloc
+  };
+
+
+#define REPEAT  200L
+
+  static int
+  profile_open( FT_TS_Library  library,
+                const char*    filename,
+                long           repeat )
+  {
+    FT_TS_Face   face;
+    FT_TS_Error  error;
+    FT_TS_Long   gindex;
+    long         count;
+    long         time0;
+    long         base_memory, open_memory, glyph_memory;
+
+
+    time0 = get_time();
+    for ( count = repeat; count > 0; count-- )
+    {
+      error = FT_TS_New_Face( library, filename, 0, &face );
+      if ( error )
+      {
+        fprintf( stderr, "%s: cannot open font (error 0x%02X)\n",
+                 filename, error );
+        return 1;
+      }
+      FT_TS_Done_Face( face );
+    }
+    time0 = get_time() - time0;
+
+    base_memory = cur_memory;
+    max_memory  = cur_memory;
+
+    error = FT_TS_New_Face( library, filename, 0, &face );
+    if ( error )
+      return 1;
+
+    open_memory = max_memory - base_memory;
+
+    for ( gindex = 0; gindex < face->num_glyphs; gindex++ )
+      (void)FT_TS_Load_Glyph( face, (FT_TS_UInt)gindex, FT_TS_LOAD_NO_SCALE );
+
+    glyph_memory = max_memory - base_memory;
+
+    FT_TS_Done_Face( face );
+
+    printf( "%s: open %7.3f ms (%ld opens),"
+            " peak memory %ld KByte (%ld KByte with all glyphs loaded)\n",
+            filename,
+            (double)time0 / 10.0 / (double)repeat,
+            repeat,
+            open_memory / 1024,
+            glyph_memory / 1024 );
+
+    return 0;
+  }
+
+
+  int  main( int  argc, char**  argv )
+  {
+    FT_TS_Library  library;
+    long           repeat = REPEAT;
+    int            i, status = 0;
+
+
+    if ( argc > 2 && !strcmp( argv[1], "-n" ) )
+    {
+      repeat = atol( argv[2] );
+      if ( repeat <= 0 )
+        repeat = REPEAT;
+
+      argc -= 2;
+      argv += 2;
+    }
+
+    if ( argc < 2 )
+    {
+      fprintf( stderr, "usage: test_woffopen [-n repeat] font ...\n" );
+      return 1;
+    }
+
+    if ( FT_TS_New_Library( &counting_memory, &library ) )
+    {
+      fprintf( stderr, "cannot initialize FreeType\n" );
+      return 1;
+    }
+    FT_TS_Add_Default_Modules( library );
+
+    for ( i = 1; i < argc; i++ )
+      status |= profile_open( library, argv[i], repeat );
+
+    FT_TS_Done_Library( library );
+
+    return status;
+  }
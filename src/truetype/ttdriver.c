@@ -517,6 +517,9 @@
     (FT_TS_Set_Instance_Func)       TT_Set_Named_Instance, /* set_instance        */
     (FT_TS_Set_MM_WeightVector_Func)NULL,                  /* set_mm_weightvector */
     (FT_TS_Get_MM_WeightVector_Func)NULL,                  /* get_mm_weightvector */
+    (FT_TS_New_Var_Instance_Func)   TT_New_Var_Instance,   /* new_var_instance    */
+    (FT_TS_Set_Var_Instance_Func)   TT_Set_Var_Instance,   /* set_var_instance    */
+    (FT_TS_Done_Var_Instance_Func)  TT_Done_Var_Instance,  /* done_var_instance   */
 
     (FT_TS_Get_Var_Blend_Func)      tt_get_var_blend,      /* get_var_blend       */
     (FT_TS_Done_Blend_Func)         tt_done_blend          /* done_blend          */
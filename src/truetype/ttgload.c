@@ -1597,6 +1597,205 @@
   }
 
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+
+  /* Check whether components loaded with `loader' can be cached.  Cached */
+  /* data created with different scaling values or design coordinates  */
+  /* gets discarded.                                                    */
+  static FT_TS_Bool
+  tt_loader_use_component_cache( TT_Loader  loader )
+  {
+    TT_Size  size = loader->size;
+
+    FT_TS_Fixed  x_scale, y_scale;
+    FT_TS_Bool   unscaled;
+    FT_TS_ULong  serial = 0;
+
+
+    /* hinted components depend on the bytecode state of the size */
+    if ( !size || IS_HINTED( loader->load_flags ) )
+      return FALSE;
+
+#ifdef FT_TS_CONFIG_OPTION_INCREMENTAL
+    if ( loader->face->root.internal->incremental_interface )
+      return FALSE;
+#endif
+
+    unscaled = FT_TS_BOOL( loader->load_flags & FT_TS_LOAD_NO_SCALE );
+    x_scale  = size->metrics->x_scale;
+    y_scale  = size->metrics->y_scale;
+
+#ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
+    if ( loader->face->blend )
+      serial = loader->face->blend->serial;
+#endif
+
+    if ( x_scale  != size->components_x_scale  ||
+         y_scale  != size->components_y_scale  ||
+         unscaled != size->components_unscaled ||
+         serial   != size->components_serial   )
+    {
+      tt_size_done_components( size );
+
+      size->components_x_scale  = x_scale;
+      size->components_y_scale  = y_scale;
+      size->components_unscaled = unscaled;
+      size->components_serial   = serial;
+    }
+
+    return TRUE;
+  }
+
+
+  /* Append a cached component to the glyph loader and restore the */
+  /* loader state, exactly as `load_truetype_glyph' would do.      */
+  static FT_TS_Error
+  tt_loader_load_component( TT_Loader     loader,
+                            TT_Component  component )
+  {
+    FT_TS_GlyphLoader  gloader = loader->gloader;
+    FT_TS_Outline*     outline;
+    FT_TS_Error        error;
+
+
+    error = FT_TS_GLYPHLOADER_CHECK_POINTS( gloader,
+                                            component->n_points + 4,
+                                            component->n_contours );
+    if ( error )
+      return error;
+
+    outline = &gloader->current.outline;
+
+    FT_TS_ARRAY_COPY( outline->points,
+                      component->points,
+                      component->n_points + 4 );
+    FT_TS_ARRAY_COPY( outline->tags,
+                      component->tags,
+                      component->n_points + 4 );
+    FT_TS_ARRAY_COPY( outline->contours,
+                      component->contours,
+                      component->n_contours );
+
+    outline->n_points   = component->n_points;
+    outline->n_contours = component->n_contours;
+
+    if ( component->overlap )
+      gloader->base.outline.flags |= FT_TS_OUTLINE_OVERLAP;
+
+    loader->glyph->control_len  = 0;
+    loader->glyph->control_data = NULL;
+
+    loader->byte_len     = component->byte_len;
+    loader->n_contours   = component->n_contours;
+    loader->bbox         = component->bbox;
+    loader->left_bearing = component->left_bearing;
+    loader->advance      = component->advance;
+    loader->top_bearing  = component->top_bearing;
+    loader->vadvance     = component->vadvance;
+    loader->pp1          = component->pp1;
+    loader->pp2          = component->pp2;
+    loader->pp3          = component->pp3;
+    loader->pp4          = component->pp4;
+
+#ifdef TT_CONFIG_OPTION_GX_VAR_SUPPORT
+    /* otherwise the component leaves the linear advance of its parent */
+    /* untouched; see `TT_Process_Simple_Glyph'                        */
+    if ( !IS_DEFAULT_INSTANCE( FT_TS_FACE( loader->face ) )              &&
+         !( loader->face->variation_support & TT_FACE_FLAG_VAR_HADVANCE ) )
+      loader->linear = component->linear;
+#endif
+
+    FT_TS_GlyphLoader_Add( gloader );
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* Store the simple glyph just processed in the component cache; */
+  /* failures are silently ignored.                                */
+  static void
+  tt_loader_save_component( TT_Loader   loader,
+                            FT_TS_Bool  overlap )
+  {
+    TT_Size         size    = loader->size;
+    FT_TS_Memory    memory  = loader->face->root.memory;
+    FT_TS_Outline*  outline = &loader->gloader->current.outline;
+    FT_TS_Error     error;
+
+    TT_Component  component;
+    FT_TS_ULong   n_points;
+    FT_TS_ULong   n_contours;
+    FT_TS_ULong   len;
+
+
+    n_points   = (FT_TS_ULong)outline->n_points + 4;
+    n_contours = (FT_TS_ULong)outline->n_contours;
+
+    len = sizeof ( TT_ComponentRec )         +
+          n_points * sizeof ( FT_TS_Vector ) +
+          n_contours * sizeof ( FT_TS_Short ) +
+          n_points;
+
+    if ( size->components_size + len > TT_CONFIG_COMPONENT_CACHE_MAX_SIZE )
+      return;
+
+    if ( !size->components )
+    {
+      if ( FT_TS_QNEW( size->components ) )
+        return;
+
+      if ( ft_hash_num_init( size->components, memory ) )
+      {
+        FT_TS_FREE( size->components );
+        return;
+      }
+    }
+
+    if ( FT_TS_QALLOC( component, len ) )
+      return;
+
+    /* `points' has the strictest alignment requirements */
+    component->points   = (FT_TS_Vector*)( component + 1 );
+    component->contours = (FT_TS_Short*)( component->points + n_points );
+    component->tags     = (FT_TS_Byte*)( component->contours + n_contours );
+
+    FT_TS_ARRAY_COPY( component->points, outline->points, n_points );
+    FT_TS_ARRAY_COPY( component->contours, outline->contours, n_contours );
+    FT_TS_ARRAY_COPY( component->tags, outline->tags, n_points );
+
+    component->n_points   = outline->n_points;
+    component->n_contours = outline->n_contours;
+    component->overlap    = overlap;
+
+    component->byte_len     = loader->byte_len;
+    component->bbox         = loader->bbox;
+    component->left_bearing = loader->left_bearing;
+    component->advance      = loader->advance;
+    component->linear       = loader->linear;
+    component->top_bearing  = loader->top_bearing;
+    component->vadvance     = loader->vadvance;
+    component->pp1          = loader->pp1;
+    component->pp2          = loader->pp2;
+    component->pp3          = loader->pp3;
+    component->pp4          = loader->pp4;
+
+    if ( ft_hash_num_insert( (FT_TS_Int)loader->glyph_index,
+                             (size_t)component,
+                             size->components,
+                             memory ) )
+    {
+      FT_TS_FREE( component );
+      return;
+    }
+
+    component->next         = size->component_list;
+    size->component_list    = component;
+    size->components_size  += len;
+  }
+
+#endif /* TT_CONFIG_OPTION_COMPONENT_CACHE */
+
+
   /**************************************************************************
    *
    * @Function:
@@ -1620,6 +1819,10 @@
 
     FT_TS_Bool  opened_frame = 0;
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+    FT_TS_Bool  use_cache = FALSE;
+#endif
+
 #ifdef FT_TS_CONFIG_OPTION_INCREMENTAL
     FT_TS_StreamRec    inc_stream;
     FT_TS_Data         glyph_data;
@@ -1651,6 +1854,27 @@
 
     loader->glyph_index = glyph_index;
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+    /* a component of a composite glyph might be cached */
+    if ( recurse_count && !header_only )
+    {
+      use_cache = tt_loader_use_component_cache( loader );
+
+      if ( use_cache && loader->size->components )
+      {
+        size_t*  value = ft_hash_num_lookup( (FT_TS_Int)glyph_index,
+                                             loader->size->components );
+
+
+        if ( value )
+        {
+          error = tt_loader_load_component( loader, (TT_Component)*value );
+          goto Exit;
+        }
+      }
+    }
+#endif
+
     if ( loader->load_flags & FT_TS_LOAD_NO_SCALE )
     {
       x_scale = 0x10000L;
@@ -1858,7 +2082,24 @@
 
     if ( loader->n_contours > 0 )
     {
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+      /* we need to know whether this glyph sets the overlap flag */
+      FT_TS_Int   outline_flags = gloader->base.outline.flags;
+      FT_TS_Bool  overlap;
+
+
+      gloader->base.outline.flags &= ~FT_TS_OUTLINE_OVERLAP;
+#endif
+
       error = face->read_simple_glyph( loader );
+
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+      overlap = FT_TS_BOOL( gloader->base.outline.flags &
+                            FT_TS_OUTLINE_OVERLAP );
+
+      gloader->base.outline.flags |= outline_flags;
+#endif
+
       if ( error )
         goto Exit;
 
@@ -1870,6 +2111,11 @@
       if ( error )
         goto Exit;
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+      if ( use_cache )
+        tt_loader_save_component( loader, overlap );
+#endif
+
       FT_TS_GlyphLoader_Add( gloader );
     }
 
@@ -913,6 +913,17 @@
         goto Exit;
     }
 
+    /* the cache of per-glyph deltas is optional; */
+    /* we ignore allocation errors                */
+    table->numDeltas = (FT_TS_UInt)face->root.num_glyphs;
+    if ( FT_TS_NEW_ARRAY( table->deltasValid,
+                          ( table->numDeltas + 31 ) / 32 ) ||
+         FT_TS_QNEW_ARRAY( table->deltas, table->numDeltas ) )
+    {
+      FT_TS_FREE( table->deltasValid );
+      table->numDeltas = 0;
+    }
+
     FT_TS_TRACE2(( "loaded\n" ));
     error = FT_TS_Err_Ok;
 
@@ -945,6 +956,92 @@
   }
 
 
+  /* compute the scalar of a region for the current coordinates */
+  static FT_TS_Fixed
+  ft_var_get_region_scalar( TT_Face          face,
+                            GX_ItemVarStore  itemStore,
+                            FT_TS_UInt       regionIndex )
+  {
+    FT_TS_Fixed    scalar = 0x10000L;
+    GX_AxisCoords  axis   = itemStore->varRegionList[regionIndex].axisList;
+    FT_TS_UInt     j;
+
+
+    /* inner loop steps through axes in this region */
+    for ( j = 0; j < itemStore->axisCount; j++, axis++ )
+    {
+      /* compute the scalar contribution of this axis; */
+      /* ignore invalid ranges                         */
+      if ( axis->startCoord > axis->peakCoord ||
+           axis->peakCoord > axis->endCoord   )
+        continue;
+
+      else if ( axis->startCoord < 0 &&
+                axis->endCoord > 0   &&
+                axis->peakCoord != 0 )
+        continue;
+
+      /* peak of 0 means ignore this axis */
+      else if ( axis->peakCoord == 0 )
+        continue;
+
+      else if ( face->blend->normalizedcoords[j] == axis->peakCoord )
+        continue;
+
+      /* ignore this region if coords are out of range */
+      else if ( face->blend->normalizedcoords[j] <= axis->startCoord ||
+                face->blend->normalizedcoords[j] >= axis->endCoord   )
+      {
+        scalar = 0;
+        break;
+      }
+
+      /* cumulative product of all the axis scalars */
+      else if ( face->blend->normalizedcoords[j] < axis->peakCoord )
+        scalar =
+          FT_TS_MulDiv( scalar,
+                        face->blend->normalizedcoords[j] - axis->startCoord,
+                        axis->peakCoord - axis->startCoord );
+      else
+        scalar =
+          FT_TS_MulDiv( scalar,
+                        axis->endCoord - face->blend->normalizedcoords[j],
+                        axis->endCoord - axis->peakCoord );
+    } /* per-axis loop */
+
+    return scalar;
+  }
+
+
+  /* Compute the scalars of all regions once for the current coordinates; */
+  /* `ft_var_flush_deltas' invalidates them.  If the allocation fails we  */
+  /* compute them on the fly in `ft_var_get_item_delta'.                  */
+  static void
+  ft_var_compute_region_scalars( TT_Face          face,
+                                 GX_ItemVarStore  itemStore )
+  {
+    FT_TS_Memory  memory = FT_TS_FACE_MEMORY( face );
+    FT_TS_Error   error;
+    FT_TS_UInt    i;
+
+
+    if ( !face->blend->normalizedcoords )
+      return;
+
+    if ( !itemStore->regionScalars                               &&
+         FT_TS_QNEW_ARRAY( itemStore->regionScalars,
+                           itemStore->regionCount )              )
+      return;
+
+    for ( i = 0; i < itemStore->regionCount; i++ )
+      itemStore->regionScalars[i] = ft_var_get_region_scalar( face,
+                                                              itemStore,
+                                                              i );
+
+    itemStore->regionScalarsValid = TRUE;
+  }
+
+
   static FT_TS_Int
   ft_var_get_item_delta( TT_Face          face,
                          GX_ItemVarStore  itemStore,
@@ -954,7 +1051,7 @@
     GX_ItemVarData  varData;
     FT_TS_Short*       deltaSet;
 
-    FT_TS_UInt   master, j;
+    FT_TS_UInt   master;
     FT_TS_Fixed  netAdjustment = 0;     /* accumulated adjustment */
     FT_TS_Fixed  scaledDelta;
     FT_TS_Fixed  delta;
@@ -966,56 +1063,20 @@
     varData  = &itemStore->varData[outerIndex];
     deltaSet = &varData->deltaSet[varData->regionIdxCount * innerIndex];
 
+    if ( !itemStore->regionScalarsValid )
+      ft_var_compute_region_scalars( face, itemStore );
+
     /* outer loop steps through master designs to be blended */
     for ( master = 0; master < varData->regionIdxCount; master++ )
     {
-      FT_TS_Fixed  scalar      = 0x10000L;
       FT_TS_UInt   regionIndex = varData->regionIndices[master];
+      FT_TS_Fixed  scalar;
 
-      GX_AxisCoords  axis = itemStore->varRegionList[regionIndex].axisList;
-
-
-      /* inner loop steps through axes in this region */
-      for ( j = 0; j < itemStore->axisCount; j++, axis++ )
-      {
-        /* compute the scalar contribution of this axis; */
-        /* ignore invalid ranges                         */
-        if ( axis->startCoord > axis->peakCoord ||
-             axis->peakCoord > axis->endCoord   )
-          continue;
-
-        else if ( axis->startCoord < 0 &&
-                  axis->endCoord > 0   &&
-                  axis->peakCoord != 0 )
-          continue;
-
-        /* peak of 0 means ignore this axis */
-        else if ( axis->peakCoord == 0 )
-          continue;
-
-        else if ( face->blend->normalizedcoords[j] == axis->peakCoord )
-          continue;
-
-        /* ignore this region if coords are out of range */
-        else if ( face->blend->normalizedcoords[j] <= axis->startCoord ||
-                  face->blend->normalizedcoords[j] >= axis->endCoord   )
-        {
-          scalar = 0;
-          break;
-        }
 
-        /* cumulative product of all the axis scalars */
-        else if ( face->blend->normalizedcoords[j] < axis->peakCoord )
-          scalar =
-            FT_TS_MulDiv( scalar,
-                       face->blend->normalizedcoords[j] - axis->startCoord,
-                       axis->peakCoord - axis->startCoord );
-        else
-          scalar =
-            FT_TS_MulDiv( scalar,
-                       axis->endCoord - face->blend->normalizedcoords[j],
-                       axis->endCoord - axis->peakCoord );
-      } /* per-axis loop */
+      if ( itemStore->regionScalarsValid )
+        scalar = itemStore->regionScalars[regionIndex];
+      else
+        scalar = ft_var_get_region_scalar( face, itemStore, regionIndex );
 
       /* get the scaled delta for this region */
       delta       = FT_TS_intToFixed( deltaSet[master] );
@@ -1105,41 +1166,53 @@
     /* advance width or height adjustments are always present in an */
     /* `HVAR' or `VVAR' table; no need to test for this capability  */
 
-    if ( table->widthMap.innerIndex )
+    if ( gindex < table->numDeltas                              &&
+         ( table->deltasValid[gindex >> 5] >> ( gindex & 31 ) ) & 1 )
+      delta = table->deltas[gindex];
+    else
     {
-      FT_TS_UInt  idx = gindex;
+      if ( table->widthMap.innerIndex )
+      {
+        FT_TS_UInt  idx = gindex;
 
 
-      if ( idx >= table->widthMap.mapCount )
-        idx = table->widthMap.mapCount - 1;
+        if ( idx >= table->widthMap.mapCount )
+          idx = table->widthMap.mapCount - 1;
 
-      /* trust that HVAR parser has checked indices */
-      outerIndex = table->widthMap.outerIndex[idx];
-      innerIndex = table->widthMap.innerIndex[idx];
-    }
-    else
-    {
-      GX_ItemVarData  varData;
+        /* trust that HVAR parser has checked indices */
+        outerIndex = table->widthMap.outerIndex[idx];
+        innerIndex = table->widthMap.innerIndex[idx];
+      }
+      else
+      {
+        GX_ItemVarData  varData;
+
+
+        /* no widthMap data */
+        outerIndex = 0;
+        innerIndex = gindex;
 
+        varData = &table->itemStore.varData[outerIndex];
+        if ( gindex >= varData->itemCount )
+        {
+          FT_TS_TRACE2(( "gindex %d out of range\n", gindex ));
+          error = FT_TS_THROW( Invalid_Argument );
+          goto Exit;
+        }
+      }
 
-      /* no widthMap data */
-      outerIndex = 0;
-      innerIndex = gindex;
+      delta = ft_var_get_item_delta( face,
+                                     &table->itemStore,
+                                     outerIndex,
+                                     innerIndex );
 
-      varData = &table->itemStore.varData[outerIndex];
-      if ( gindex >= varData->itemCount )
+      if ( gindex < table->numDeltas )
       {
-        FT_TS_TRACE2(( "gindex %d out of range\n", gindex ));
-        error = FT_TS_THROW( Invalid_Argument );
-        goto Exit;
+        table->deltas[gindex]           = delta;
+        table->deltasValid[gindex >> 5] |= (FT_TS_UInt32)1 << ( gindex & 31 );
       }
     }
 
-    delta = ft_var_get_item_delta( face,
-                                   &table->itemStore,
-                                   outerIndex,
-                                   innerIndex );
-
     FT_TS_TRACE5(( "%s value %d adjusted by %d unit%s (%s)\n",
                 vertical ? "vertical height" : "horizontal width",
                 *avalue,
@@ -1172,6 +1245,35 @@
   }
 
 
+  static void
+  ft_var_flush_hvvar( GX_HVVarTable  table )
+  {
+    table->itemStore.regionScalarsValid = FALSE;
+
+    if ( table->numDeltas )
+      FT_TS_MEM_ZERO( table->deltasValid,
+                      ( table->numDeltas + 31 ) / 32 *
+                        sizeof ( FT_TS_UInt32 ) );
+  }
+
+
+  /* forget all cached data that depends on the current coordinates */
+  static void
+  ft_var_flush_deltas( GX_Blend  blend )
+  {
+    blend->serial++;
+
+    if ( blend->hvar_table )
+      ft_var_flush_hvvar( blend->hvar_table );
+
+    if ( blend->vvar_table )
+      ft_var_flush_hvvar( blend->vvar_table );
+
+    if ( blend->mvar_table )
+      blend->mvar_table->itemStore.regionScalarsValid = FALSE;
+  }
+
+
 #define GX_VALUE_SIZE  8
 
   /* all values are FT_TS_Short or FT_TS_UShort entities; */
@@ -2581,11 +2683,33 @@
   }
 
 
+#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
+
+  static FT_TS_Error
+  tt_cvt_ready_iterator( FT_TS_ListNode  node,
+                         void*        user )
+  {
+    TT_Size  size = (TT_Size)node->data;
+
+    FT_TS_UNUSED( user );
+
+
+    size->cvt_ready = -1;
+
+    return FT_TS_Err_Ok;
+  }
+
+#endif /* TT_CONFIG_OPTION_BYTECODE_INTERPRETER */
+
+
+  /* If `cvt' is non-NULL, it holds the varied `cvt' table for the new */
+  /* coordinates, which thus need not be recomputed.                   */
   static FT_TS_Error
-  tt_set_mm_blend( TT_Face    face,
+  tt_set_mm_blend( TT_Face       face,
                    FT_TS_UInt    num_coords,
                    FT_TS_Fixed*  coords,
-                   FT_TS_Bool    set_design_coords )
+                   FT_TS_Bool    set_design_coords,
+                   FT_TS_Int32*  cvt )
   {
     FT_TS_Error    error = FT_TS_Err_Ok;
     GX_Blend    blend;
@@ -2600,7 +2724,8 @@
     {
       mcvt_retain,
       mcvt_modify,
-      mcvt_load
+      mcvt_load,
+      mcvt_copy
 
     } manageCvt;
 
@@ -2737,6 +2862,8 @@
                    coords,
                    num_coords * sizeof ( FT_TS_Fixed ) );
 
+    ft_var_flush_deltas( blend );
+
     if ( set_design_coords )
       ft_var_to_design( face,
                         all_design_coords ? blend->num_axis : num_coords,
@@ -2745,6 +2872,9 @@
 
     face->doblend = TRUE;
 
+    if ( cvt && manageCvt != mcvt_retain )
+      manageCvt = mcvt_copy;
+
     if ( face->cvt )
     {
       switch ( manageCvt )
@@ -2764,6 +2894,17 @@
         error = tt_face_vary_cvt( face, face->root.stream );
         break;
 
+      case mcvt_copy:
+        /* The caller already knows the varied cvt table. */
+        FT_TS_ARRAY_COPY( face->cvt, cvt, face->cvt_size );
+
+#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
+        FT_TS_List_Iterate( &face->root.sizes_list,
+                            tt_cvt_ready_iterator,
+                            NULL );
+#endif
+        break;
+
       case mcvt_retain:
         /* The cvt table is correct for this set of coordinates. */
         break;
@@ -2815,7 +2956,7 @@
     FT_TS_Error  error;
 
 
-    error = tt_set_mm_blend( face, num_coords, coords, 1 );
+    error = tt_set_mm_blend( face, num_coords, coords, 1, NULL );
     if ( error )
       return error;
 
@@ -2876,7 +3017,7 @@
     {
       /* select default instance coordinates */
       /* if no instance is selected yet      */
-      if ( FT_TS_SET_ERROR( tt_set_mm_blend( face, 0, NULL, 1 ) ) )
+      if ( FT_TS_SET_ERROR( tt_set_mm_blend( face, 0, NULL, 1, NULL ) ) )
         return error;
     }
 
@@ -3037,7 +3178,7 @@
     FT_TS_TRACE5(( "  normalized design coordinates:\n" ));
     ft_var_to_normalized( face, num_coords, blend->coords, normalized );
 
-    error = tt_set_mm_blend( face, mmvar->num_axis, normalized, 0 );
+    error = tt_set_mm_blend( face, mmvar->num_axis, normalized, 0, NULL );
     if ( error )
       goto Exit;
 
@@ -3099,7 +3240,7 @@
     {
       /* select default instance coordinates */
       /* if no instance is selected yet      */
-      if ( FT_TS_SET_ERROR( tt_set_mm_blend( face, 0, NULL, 1 ) ) )
+      if ( FT_TS_SET_ERROR( tt_set_mm_blend( face, 0, NULL, 1, NULL ) ) )
         return error;
     }
 
@@ -3224,138 +3365,434 @@
   }
 
 
-  /*************************************************************************/
-  /*************************************************************************/
-  /*****                                                               *****/
-  /*****                     GX VAR PARSING ROUTINES                   *****/
-  /*****                                                               *****/
-  /*************************************************************************/
-  /*************************************************************************/
-
+  static void
+  ft_var_done_instance( FT_TS_Memory  memory,
+                        GX_Instance   instance )
+  {
+    FT_TS_FREE( instance->coords );
+    FT_TS_FREE( instance->normalizedcoords );
+    FT_TS_FREE( instance->cvt );
+    FT_TS_FREE( instance->hdeltas );
+    FT_TS_FREE( instance->hdeltasValid );
+    FT_TS_FREE( instance->vdeltas );
+    FT_TS_FREE( instance->vdeltasValid );
+    FT_TS_FREE( instance );
+  }
 
-#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
 
+  /* Exchange the advance delta cache of `table' with the one given by */
+  /* `deltas' and `deltasValid'.  If the latter doesn't exist yet, it  */
+  /* gets allocated if `alloc' is set; otherwise nothing happens.      */
   static FT_TS_Error
-  tt_cvt_ready_iterator( FT_TS_ListNode  node,
-                         void*        user )
+  ft_var_swap_hvvar_deltas( FT_TS_Memory     memory,
+                            GX_HVVarTable    table,
+                            FT_TS_Int*      *deltas,
+                            FT_TS_UInt32*   *deltasValid,
+                            FT_TS_Bool       alloc )
   {
-    TT_Size  size = (TT_Size)node->data;
+    FT_TS_Error    error = FT_TS_Err_Ok;
+    FT_TS_Int*     d;
+    FT_TS_UInt32*  v;
 
-    FT_TS_UNUSED( user );
 
+    if ( !table || !table->numDeltas )
+      goto Exit;
 
-    size->cvt_ready = -1;
+    if ( !*deltas )
+    {
+      if ( !alloc )
+        goto Exit;
 
-    return FT_TS_Err_Ok;
-  }
+      if ( FT_TS_NEW_ARRAY( *deltasValid, ( table->numDeltas + 31 ) / 32 ) ||
+           FT_TS_QNEW_ARRAY( *deltas, table->numDeltas )                   )
+      {
+        FT_TS_FREE( *deltasValid );
+        goto Exit;
+      }
+    }
 
-#endif /* TT_CONFIG_OPTION_BYTECODE_INTERPRETER */
+    d = table->deltas;
+    v = table->deltasValid;
 
+    table->deltas      = *deltas;
+    table->deltasValid = *deltasValid;
+
+    *deltas      = d;
+    *deltasValid = v;
+
+  Exit:
+    return error;
+  }
 
 
   /**************************************************************************
    *
    * @Function:
-   *   tt_face_vary_cvt
+   *   TT_New_Var_Instance
    *
    * @Description:
-   *   Modify the loaded cvt table according to the `cvar' table and the
-   *   font's blend.
+   *   Create a variation instance for a set of design coordinates.
    *
-   * @InOut:
+   * @Input:
    *   face ::
-   *     A handle to the target face object.
+   *     A handle to the source face.
    *
-   * @Input:
-   *   stream ::
-   *     A handle to the input stream.
+   *   num_coords ::
+   *     The number of design coordinates.
    *
-   * @Return:
-   *   FreeType error code.  0 means success.
+   *   coords ::
+   *     The design coordinates array.
    *
-   *   Most errors are ignored.  It is perfectly valid not to have a
-   *   `cvar' table even if there is a `gvar' and `fvar' table.
+   * @Output:
+   *   ainstance ::
+   *     A handle to the new instance.
+   *
+   * @Return:
+   *   FreeType error code.  0~means success.
    */
   FT_TS_LOCAL_DEF( FT_TS_Error )
-  tt_face_vary_cvt( TT_Face    face,
-                    FT_TS_Stream  stream )
+  TT_New_Var_Instance( TT_Face              face,
+                       FT_TS_UInt           num_coords,
+                       FT_TS_Fixed*         coords,
+                       FT_TS_Var_Instance  *ainstance )
   {
-#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
-
-    FT_TS_Error   error;
-    FT_TS_Memory  memory = stream->memory;
+    FT_TS_Error    error;
+    GX_Blend       blend;
+    FT_TS_MM_Var*  mmvar;
+    FT_TS_UInt     i;
+    FT_TS_Memory   memory = face->root.memory;
 
-    FT_TS_Face  root = &face->root;
+    GX_Instance  instance = NULL;
 
-    FT_TS_ULong  table_start;
-    FT_TS_ULong  table_len;
 
-    FT_TS_UInt   tupleCount;
-    FT_TS_ULong  offsetToData;
+    if ( !face->blend )
+    {
+      if ( FT_TS_SET_ERROR( TT_Get_MM_Var( face, NULL ) ) )
+        goto Exit;
+    }
 
-    FT_TS_ULong  here;
-    FT_TS_UInt   i, j;
+    blend = face->blend;
+    mmvar = blend->mmvar;
 
-    FT_TS_Fixed*  tuple_coords    = NULL;
-    FT_TS_Fixed*  im_start_coords = NULL;
-    FT_TS_Fixed*  im_end_coords   = NULL;
+    if ( num_coords > mmvar->num_axis )
+    {
+      FT_TS_TRACE2(( "TT_New_Var_Instance:"
+                     " only using first %d of %d coordinates\n",
+                     mmvar->num_axis, num_coords ));
+      num_coords = mmvar->num_axis;
+    }
 
-    GX_Blend  blend = face->blend;
+    if ( FT_TS_NEW( instance )                                          ||
+         FT_TS_NEW_ARRAY( instance->coords, mmvar->num_axis )           ||
+         FT_TS_NEW_ARRAY( instance->normalizedcoords, mmvar->num_axis ) )
+      goto Exit;
 
-    FT_TS_UInt  point_count;
-    FT_TS_UInt  spoint_count = 0;
+    instance->root.face  = FT_TS_FACE( face );
+    instance->num_coords = num_coords;
 
-    FT_TS_UShort*  sharedpoints = NULL;
-    FT_TS_UShort*  localpoints  = NULL;
-    FT_TS_UShort*  points;
+    /* complete the design coordinates the same way as */
+    /* `TT_Set_Var_Design' does                        */
+    for ( i = 0; i < num_coords; i++ )
+      instance->coords[i] = coords[i];
 
-    FT_TS_Fixed*  deltas     = NULL;
-    FT_TS_Fixed*  cvt_deltas = NULL;
+    if ( FT_TS_IS_NAMED_INSTANCE( FT_TS_FACE( face ) ) )
+    {
+      FT_TS_UInt              instance_index;
+      FT_TS_Var_Named_Style*  named_style;
 
 
-    FT_TS_TRACE2(( "CVAR " ));
+      instance_index = (FT_TS_UInt)face->root.face_index >> 16;
+      named_style    = mmvar->namedstyle + instance_index - 1;
 
-    if ( !blend )
-    {
-      FT_TS_TRACE2(( "\n" ));
-      FT_TS_TRACE2(( "tt_face_vary_cvt: no blend specified\n" ));
-      error = FT_TS_Err_Ok;
-      goto Exit;
+      for ( ; i < mmvar->num_axis; i++ )
+        instance->coords[i] = named_style->coords[i];
     }
-
-    if ( !face->cvt )
+    else
     {
-      FT_TS_TRACE2(( "\n" ));
-      FT_TS_TRACE2(( "tt_face_vary_cvt: no `cvt ' table\n" ));
-      error = FT_TS_Err_Ok;
-      goto Exit;
+      for ( ; i < mmvar->num_axis; i++ )
+        instance->coords[i] = mmvar->axis[i].def;
     }
 
-    error = face->goto_table( face, TTAG_cvar, stream, &table_len );
-    if ( error )
-    {
-      FT_TS_TRACE2(( "is missing\n" ));
+    if ( !blend->avar_loaded )
+      ft_var_load_avar( face );
 
-      error = FT_TS_Err_Ok;
-      goto Exit;
-    }
+    FT_TS_TRACE5(( "TT_New_Var_Instance:\n" ));
+    FT_TS_TRACE5(( "  normalized design coordinates:\n" ));
+    ft_var_to_normalized( face,
+                          num_coords,
+                          instance->coords,
+                          instance->normalizedcoords );
 
-    if ( FT_TS_FRAME_ENTER( table_len ) )
-    {
-      error = FT_TS_Err_Ok;
-      goto Exit;
-    }
+    instance->next   = blend->instances;
+    blend->instances = instance;
 
-    table_start = FT_TS_Stream_FTell( stream );
-    if ( FT_TS_GET_LONG() != 0x00010000L )
-    {
-      FT_TS_TRACE2(( "bad table version\n" ));
+    *ainstance = &instance->root;
+    instance   = NULL;
 
-      error = FT_TS_Err_Ok;
-      goto FExit;
-    }
+  Exit:
+    if ( instance )
+      ft_var_done_instance( memory, instance );
 
-    FT_TS_TRACE2(( "loaded\n" ));
+    return error;
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   TT_Set_Var_Instance
+   *
+   * @Description:
+   *   Activate a variation instance.  The data derived from the
+   *   coordinates of the currently active instance is kept in the latter.
+   *
+   * @InOut:
+   *   face ::
+   *     A handle to the source face.
+   *
+   * @Input:
+   *   instance ::
+   *     The instance to activate.
+   *
+   * @Return:
+   *   FreeType error code.  0~means success, -1~means `no change'.
+   */
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  TT_Set_Var_Instance( TT_Face             face,
+                       FT_TS_Var_Instance  ainstance )
+  {
+    FT_TS_Error    error;
+    GX_Blend       blend    = face->blend;
+    FT_TS_MM_Var*  mmvar    = blend->mmvar;
+    FT_TS_Memory   memory   = face->root.memory;
+    GX_Instance    instance = (GX_Instance)ainstance;
+    GX_Instance    active;
+
+    FT_TS_Bool  no_change = FALSE;
+
+
+    /* keep the advance deltas computed for the active instance */
+    active = (GX_Instance)face->root.internal->var_instance;
+    if ( active )
+    {
+      if ( FT_TS_SET_ERROR( ft_var_swap_hvvar_deltas( memory,
+                                                      blend->hvar_table,
+                                                      &active->hdeltas,
+                                                      &active->hdeltasValid,
+                                                      TRUE ) )               ||
+           FT_TS_SET_ERROR( ft_var_swap_hvvar_deltas( memory,
+                                                      blend->vvar_table,
+                                                      &active->vdeltas,
+                                                      &active->vdeltasValid,
+                                                      TRUE ) )               )
+        goto Exit;
+
+      /* the buffers we got in exchange hold stale data */
+      if ( blend->hvar_table )
+        ft_var_flush_hvvar( blend->hvar_table );
+      if ( blend->vvar_table )
+        ft_var_flush_hvvar( blend->vvar_table );
+    }
+
+    error = tt_set_mm_blend( face,
+                             mmvar->num_axis,
+                             instance->normalizedcoords,
+                             0,
+                             instance->cvt );
+    if ( error == -1 )
+    {
+      no_change = TRUE;
+      error     = FT_TS_Err_Ok;
+    }
+    else if ( error )
+      goto Exit;
+
+    FT_TS_ARRAY_COPY( blend->coords, instance->coords, mmvar->num_axis );
+
+    if ( instance->num_coords )
+      face->root.face_flags |= FT_TS_FACE_FLAG_VARIATION;
+    else
+      face->root.face_flags &= ~FT_TS_FACE_FLAG_VARIATION;
+
+    /* reuse the advance deltas computed while the instance was active */
+    (void)ft_var_swap_hvvar_deltas( memory,
+                                    blend->hvar_table,
+                                    &instance->hdeltas,
+                                    &instance->hdeltasValid,
+                                    FALSE );
+    (void)ft_var_swap_hvvar_deltas( memory,
+                                    blend->vvar_table,
+                                    &instance->vdeltas,
+                                    &instance->vdeltasValid,
+                                    FALSE );
+
+    /* remember the varied cvt table; an allocation error is not fatal */
+    if ( !instance->cvt && face->cvt && face->cvt_size )
+    {
+      if ( !FT_TS_QNEW_ARRAY( instance->cvt, face->cvt_size ) )
+        FT_TS_ARRAY_COPY( instance->cvt, face->cvt, face->cvt_size );
+
+      error = FT_TS_Err_Ok;
+    }
+
+    if ( no_change )
+      error = -1;
+
+  Exit:
+    return error;
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   TT_Done_Var_Instance
+   *
+   * @Description:
+   *   Destroy a variation instance.
+   *
+   * @Input:
+   *   instance ::
+   *     The instance to destroy.
+   */
+  FT_TS_LOCAL_DEF( void )
+  TT_Done_Var_Instance( FT_TS_Var_Instance  ainstance )
+  {
+    GX_Instance   instance = (GX_Instance)ainstance;
+    TT_Face       face     = (TT_Face)ainstance->face;
+    FT_TS_Memory  memory   = face->root.memory;
+
+    GX_Instance*  pinstance;
+
+
+    for ( pinstance = &face->blend->instances;
+          *pinstance;
+          pinstance = &(*pinstance)->next )
+    {
+      if ( *pinstance == instance )
+      {
+        *pinstance = instance->next;
+        break;
+      }
+    }
+
+    ft_var_done_instance( memory, instance );
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                     GX VAR PARSING ROUTINES                   *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_face_vary_cvt
+   *
+   * @Description:
+   *   Modify the loaded cvt table according to the `cvar' table and the
+   *   font's blend.
+   *
+   * @InOut:
+   *   face ::
+   *     A handle to the target face object.
+   *
+   * @Input:
+   *   stream ::
+   *     A handle to the input stream.
+   *
+   * @Return:
+   *   FreeType error code.  0 means success.
+   *
+   *   Most errors are ignored.  It is perfectly valid not to have a
+   *   `cvar' table even if there is a `gvar' and `fvar' table.
+   */
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  tt_face_vary_cvt( TT_Face    face,
+                    FT_TS_Stream  stream )
+  {
+#ifdef TT_CONFIG_OPTION_BYTECODE_INTERPRETER
+
+    FT_TS_Error   error;
+    FT_TS_Memory  memory = stream->memory;
+
+    FT_TS_Face  root = &face->root;
+
+    FT_TS_ULong  table_start;
+    FT_TS_ULong  table_len;
+
+    FT_TS_UInt   tupleCount;
+    FT_TS_ULong  offsetToData;
+
+    FT_TS_ULong  here;
+    FT_TS_UInt   i, j;
+
+    FT_TS_Fixed*  tuple_coords    = NULL;
+    FT_TS_Fixed*  im_start_coords = NULL;
+    FT_TS_Fixed*  im_end_coords   = NULL;
+
+    GX_Blend  blend = face->blend;
+
+    FT_TS_UInt  point_count;
+    FT_TS_UInt  spoint_count = 0;
+
+    FT_TS_UShort*  sharedpoints = NULL;
+    FT_TS_UShort*  localpoints  = NULL;
+    FT_TS_UShort*  points;
+
+    FT_TS_Fixed*  deltas     = NULL;
+    FT_TS_Fixed*  cvt_deltas = NULL;
+
+
+    FT_TS_TRACE2(( "CVAR " ));
+
+    if ( !blend )
+    {
+      FT_TS_TRACE2(( "\n" ));
+      FT_TS_TRACE2(( "tt_face_vary_cvt: no blend specified\n" ));
+      error = FT_TS_Err_Ok;
+      goto Exit;
+    }
+
+    if ( !face->cvt )
+    {
+      FT_TS_TRACE2(( "\n" ));
+      FT_TS_TRACE2(( "tt_face_vary_cvt: no `cvt ' table\n" ));
+      error = FT_TS_Err_Ok;
+      goto Exit;
+    }
+
+    error = face->goto_table( face, TTAG_cvar, stream, &table_len );
+    if ( error )
+    {
+      FT_TS_TRACE2(( "is missing\n" ));
+
+      error = FT_TS_Err_Ok;
+      goto Exit;
+    }
+
+    if ( FT_TS_FRAME_ENTER( table_len ) )
+    {
+      error = FT_TS_Err_Ok;
+      goto Exit;
+    }
+
+    table_start = FT_TS_Stream_FTell( stream );
+    if ( FT_TS_GET_LONG() != 0x00010000L )
+    {
+      FT_TS_TRACE2(( "bad table version\n" ));
+
+      error = FT_TS_Err_Ok;
+      goto FExit;
+    }
+
+    FT_TS_TRACE2(( "loaded\n" ));
 
     if ( FT_TS_NEW_ARRAY( tuple_coords, blend->num_axis )    ||
          FT_TS_NEW_ARRAY( im_start_coords, blend->num_axis ) ||
@@ -3655,64 +4092,88 @@
 
   /* modeled after `af_iup_interp', `_iup_worker_interpolate', and   */
   /* `Ins_IUP' with spec differences in handling ill-defined cases.  */
+
+  /* Both coordinates are handled in a single pass over the points;  */
+  /* the scaling factors are only computed if actually needed.       */
   static void
-  tt_delta_interpolate( int         p1,
-                        int         p2,
-                        int         ref1,
-                        int         ref2,
+  tt_delta_interpolate( int            p1,
+                        int            p2,
+                        int            ref1,
+                        int            ref2,
                         FT_TS_Vector*  in_points,
                         FT_TS_Vector*  out_points )
   {
     int  p, i;
 
-    FT_TS_Pos  out, in1, in2, out1, out2, d1, d2;
+    FT_TS_Pos    in1[2], in2[2], out1[2], out2[2], d1[2], d2[2];
+    FT_TS_Fixed  scale[2];
+    FT_TS_Bool   scale_valid[2];
+    FT_TS_Bool   interpolate[2];
 
 
     if ( p1 > p2 )
       return;
 
-    /* handle both horizontal and vertical coordinates */
     for ( i = 0; i <= 1; i++ )
     {
-      /* shift array pointers so that we can access `foo.y' as `foo.x' */
-      in_points  = (FT_TS_Vector*)( (FT_TS_Pos*)in_points + i );
-      out_points = (FT_TS_Vector*)( (FT_TS_Pos*)out_points + i );
+      /* `in[2 * n]' is either `in_points[n].x' or `in_points[n].y' */
+      FT_TS_Pos*  in  = (FT_TS_Pos*)in_points + i;
+      FT_TS_Pos*  out = (FT_TS_Pos*)out_points + i;
+
 
-      if ( in_points[ref1].x > in_points[ref2].x )
+      if ( in[2 * ref1] > in[2 * ref2] )
       {
         p    = ref1;
         ref1 = ref2;
         ref2 = p;
       }
 
-      in1  = in_points[ref1].x;
-      in2  = in_points[ref2].x;
-      out1 = out_points[ref1].x;
-      out2 = out_points[ref2].x;
-      d1   = out1 - in1;
-      d2   = out2 - in2;
+      in1[i]  = in[2 * ref1];
+      in2[i]  = in[2 * ref2];
+      out1[i] = out[2 * ref1];
+      out2[i] = out[2 * ref2];
+      d1[i]   = out1[i] - in1[i];
+      d2[i]   = out2[i] - in2[i];
 
       /* If the reference points have the same coordinate but different */
       /* delta, inferred delta is zero.  Otherwise interpolate.         */
-      if ( in1 != in2 || out1 == out2 )
+      interpolate[i] = in1[i] != in2[i] || out1[i] == out2[i];
+      scale_valid[i] = 0;
+      scale[i]       = 0;
+    }
+
+    for ( p = p1; p <= p2; p++ )
+    {
+      FT_TS_Pos*  in  = (FT_TS_Pos*)( in_points + p );
+      FT_TS_Pos*  out = (FT_TS_Pos*)( out_points + p );
+
+
+      for ( i = 0; i <= 1; i++ )
       {
-        FT_TS_Fixed  scale = in1 != in2 ? FT_TS_DivFix( out2 - out1, in2 - in1 )
-                                     : 0;
+        FT_TS_Pos  o = in[i];
 
 
-        for ( p = p1; p <= p2; p++ )
-        {
-          out = in_points[p].x;
+        if ( !interpolate[i] )
+          continue;
 
-          if ( out <= in1 )
-            out += d1;
-          else if ( out >= in2 )
-            out += d2;
-          else
-            out = out1 + FT_TS_MulFix( out - in1, scale );
+        if ( o <= in1[i] )
+          o += d1[i];
+        else if ( o >= in2[i] )
+          o += d2[i];
+        else
+        {
+          /* we only get here if `in1[i] < in2[i]' */
+          if ( !scale_valid[i] )
+          {
+            scale[i]       = FT_TS_DivFix( out2[i] - out1[i],
+                                           in2[i] - in1[i] );
+            scale_valid[i] = 1;
+          }
 
-          out_points[p].x = out;
+          o = out1[i] + FT_TS_MulFix( o - in1[i], scale[i] );
         }
+
+        out[i] = o;
       }
     }
   }
@@ -3813,119 +4274,78 @@
   }
 
 
-  /**************************************************************************
-   *
-   * @Function:
-   *   TT_Vary_Apply_Glyph_Deltas
-   *
-   * @Description:
-   *   Apply the appropriate deltas to the current glyph.
-   *
-   * @Input:
-   *   face ::
-   *     A handle to the target face object.
-   *
-   *   glyph_index ::
-   *     The index of the glyph being modified.
-   *
-   *   n_points ::
-   *     The number of the points in the glyph, including
-   *     phantom points.
-   *
-   * @InOut:
-   *   outline ::
-   *     The outline to change.
-   *
-   * @Output:
-   *   unrounded ::
-   *     An array with `n_points' elements that is filled with unrounded
-   *     point coordinates (in 26.6 format).
-   *
-   * @Return:
-   *   FreeType error code.  0 means success.
-   */
-  FT_TS_LOCAL_DEF( FT_TS_Error )
-  TT_Vary_Apply_Glyph_Deltas( TT_Face      face,
-                              FT_TS_UInt      glyph_index,
-                              FT_TS_Outline*  outline,
-                              FT_TS_Vector*   unrounded,
-                              FT_TS_UInt      n_points )
+  static void
+  ft_var_done_glyph_var( FT_TS_Memory  memory,
+                         GX_GlyphVar   glyphvar )
   {
-    FT_TS_Error   error;
-    FT_TS_Stream  stream = face->root.stream;
-    FT_TS_Memory  memory = stream->memory;
+    FT_TS_UInt  i;
 
-    FT_TS_Vector*  points_org = NULL;  /* coordinates in 16.16 format */
-    FT_TS_Vector*  points_out = NULL;  /* coordinates in 16.16 format */
-    FT_TS_Bool*    has_delta  = NULL;
 
-    FT_TS_ULong  glyph_start;
+    if ( !glyphvar )
+      return;
 
-    FT_TS_UInt   tupleCount;
-    FT_TS_ULong  offsetToData;
-    FT_TS_ULong  dataSize;
+    if ( glyphvar->tuples )
+    {
+      for ( i = 0; i < glyphvar->num_tuples; i++ )
+      {
+        GX_GlyphTuple  tuple = &glyphvar->tuples[i];
 
-    FT_TS_ULong  here;
-    FT_TS_UInt   i, j;
 
-    FT_TS_Fixed*  tuple_coords    = NULL;
-    FT_TS_Fixed*  im_start_coords = NULL;
-    FT_TS_Fixed*  im_end_coords   = NULL;
-
-    GX_Blend  blend = face->blend;
+        if ( tuple->points != glyphvar->sharedpoints )
+          FT_TS_FREE( tuple->points );
+        FT_TS_FREE( tuple->deltas );
+      }
+    }
 
-    FT_TS_UInt  point_count;
-    FT_TS_UInt  spoint_count = 0;
+    FT_TS_FREE( glyphvar->tuples );
+    FT_TS_FREE( glyphvar->sharedpoints );
+    FT_TS_FREE( glyphvar->coords );
+    FT_TS_FREE( glyphvar->scalars );
+    FT_TS_FREE( glyphvar );
+  }
 
-    FT_TS_UShort*  sharedpoints = NULL;
-    FT_TS_UShort*  localpoints  = NULL;
-    FT_TS_UShort*  points;
 
-    FT_TS_Fixed*  deltas_x       = NULL;
-    FT_TS_Fixed*  deltas_y       = NULL;
-    FT_TS_Fixed*  point_deltas_x = NULL;
-    FT_TS_Fixed*  point_deltas_y = NULL;
+  /* Decode the variation data of a glyph, which must exist.  Contrary */
+  /* to the old code, which only read the data of tuples applying to    */
+  /* the current coordinates, all tuples are decoded so that the result */
+  /* can be cached and reused for other coordinates.                   */
+  static FT_TS_Error
+  ft_var_load_glyph_var( TT_Face       face,
+                         FT_TS_UInt    glyph_index,
+                         FT_TS_UInt    n_points,
+                         GX_GlyphVar  *aglyphvar )
+  {
+    FT_TS_Error   error;
+    FT_TS_Stream  stream = face->root.stream;
+    FT_TS_Memory  memory = stream->memory;
+    GX_Blend      blend  = face->blend;
 
+    GX_GlyphVar    glyphvar     = NULL;
+    FT_TS_UShort*  sharedpoints = NULL;
+    FT_TS_UInt     spoint_count = 0;
 
-    if ( !face->doblend || !blend )
-      return FT_TS_THROW( Invalid_Argument );
+    FT_TS_ULong  glyph_start;
 
-    for ( i = 0; i < n_points; i++ )
-    {
-      unrounded[i].x = INT_TO_F26DOT6( outline->points[i].x );
-      unrounded[i].y = INT_TO_F26DOT6( outline->points[i].y );
-    }
+    FT_TS_UInt   tupleCount;
+    FT_TS_ULong  offsetToData;
+    FT_TS_ULong  dataSize;
 
-    if ( glyph_index >= blend->gv_glyphcnt      ||
-         blend->glyphoffsets[glyph_index] ==
-           blend->glyphoffsets[glyph_index + 1] )
-    {
-      FT_TS_TRACE2(( "TT_Vary_Apply_Glyph_Deltas:"
-                  " no variation data for glyph %d\n", glyph_index ));
-      return FT_TS_Err_Ok;
-    }
+    FT_TS_ULong  here;
+    FT_TS_UInt   num_coords;
+    FT_TS_UInt   i, j;
 
-    if ( FT_TS_NEW_ARRAY( points_org, n_points ) ||
-         FT_TS_NEW_ARRAY( points_out, n_points ) ||
-         FT_TS_NEW_ARRAY( has_delta, n_points )  )
-      goto Fail1;
 
     dataSize = blend->glyphoffsets[glyph_index + 1] -
                  blend->glyphoffsets[glyph_index];
 
     if ( FT_TS_STREAM_SEEK( blend->glyphoffsets[glyph_index] ) ||
          FT_TS_FRAME_ENTER( dataSize )                         )
-      goto Fail1;
+      return error;
 
     glyph_start = FT_TS_Stream_FTell( stream );
 
     /* each set of glyph variation data is formatted similarly to `cvar' */
 
-    if ( FT_TS_NEW_ARRAY( tuple_coords, blend->num_axis )    ||
-         FT_TS_NEW_ARRAY( im_start_coords, blend->num_axis ) ||
-         FT_TS_NEW_ARRAY( im_end_coords, blend->num_axis )   )
-      goto Fail2;
-
     tupleCount   = FT_TS_GET_USHORT();
     offsetToData = FT_TS_GET_USHORT();
 
@@ -3937,7 +4357,7 @@
                   " invalid glyph variation array header\n" ));
 
       error = FT_TS_THROW( Invalid_Table );
-      goto Fail2;
+      goto Exit;
     }
 
     offsetToData += glyph_start;
@@ -3956,78 +4376,83 @@
       FT_TS_Stream_SeekSet( stream, here );
     }
 
-    FT_TS_TRACE5(( "gvar: there %s %d tuple%s:\n",
-                ( tupleCount & GX_TC_TUPLE_COUNT_MASK ) == 1 ? "is" : "are",
-                tupleCount & GX_TC_TUPLE_COUNT_MASK,
-                ( tupleCount & GX_TC_TUPLE_COUNT_MASK ) == 1 ? "" : "s" ));
+    tupleCount &= GX_TC_TUPLE_COUNT_MASK;
+    num_coords  = 3 * blend->num_axis;
 
-    if ( FT_TS_NEW_ARRAY( point_deltas_x, n_points ) ||
-         FT_TS_NEW_ARRAY( point_deltas_y, n_points ) )
-      goto Fail3;
-
-    for ( j = 0; j < n_points; j++ )
+    if ( FT_TS_NEW( glyphvar ) )
     {
-      points_org[j].x = FT_TS_intToFixed( outline->points[j].x );
-      points_org[j].y = FT_TS_intToFixed( outline->points[j].y );
+      if ( sharedpoints != ALL_POINTS )
+        FT_TS_FREE( sharedpoints );
+      goto Exit;
     }
 
-    for ( i = 0; i < ( tupleCount & GX_TC_TUPLE_COUNT_MASK ); i++ )
+    if ( sharedpoints != ALL_POINTS )
+      glyphvar->sharedpoints = sharedpoints;
+
+    if ( FT_TS_NEW_ARRAY( glyphvar->tuples, tupleCount )               ||
+         FT_TS_NEW_ARRAY( glyphvar->coords, tupleCount * num_coords ) ||
+         FT_TS_NEW_ARRAY( glyphvar->scalars, tupleCount )              )
+      goto Exit;
+
+    glyphvar->n_points   = n_points;
+    glyphvar->num_tuples = tupleCount;
+    glyphvar->size       = sizeof ( GX_GlyphVarRec ) +
+                           tupleCount * ( sizeof ( GX_GlyphTupleRec ) +
+                                          ( num_coords + 1 ) *
+                                            sizeof ( FT_TS_Fixed ) );
+    if ( glyphvar->sharedpoints )
+      glyphvar->size += spoint_count * sizeof ( FT_TS_UShort );
+
+    for ( i = 0; i < tupleCount; i++ )
     {
-      FT_TS_UInt   tupleDataSize;
-      FT_TS_UInt   tupleIndex;
-      FT_TS_Fixed  apply;
+      GX_GlyphTuple  tuple = &glyphvar->tuples[i];
 
+      FT_TS_UInt     tupleDataSize;
+      FT_TS_UShort*  points;
+      FT_TS_UShort*  localpoints = NULL;
+      FT_TS_UInt     point_count;
+      FT_TS_UInt     delta_count;
+      FT_TS_Fixed*   deltas_x;
+      FT_TS_Fixed*   deltas_y;
 
-      FT_TS_TRACE6(( "  tuple %d:\n", i ));
 
       tupleDataSize = FT_TS_GET_USHORT();
-      tupleIndex    = FT_TS_GET_USHORT();
+      tuple->flags  = FT_TS_GET_USHORT();
+      tuple->coords = glyphvar->coords + i * num_coords;
 
-      if ( tupleIndex & GX_TI_EMBEDDED_TUPLE_COORD )
+      if ( tuple->flags & GX_TI_EMBEDDED_TUPLE_COORD )
       {
         for ( j = 0; j < blend->num_axis; j++ )
-          tuple_coords[j] = FT_TS_fdot14ToFixed( FT_TS_GET_SHORT() );
+          tuple->coords[j] = FT_TS_fdot14ToFixed( FT_TS_GET_SHORT() );
       }
-      else if ( ( tupleIndex & GX_TI_TUPLE_INDEX_MASK ) >= blend->tuplecount )
+      else if ( ( tuple->flags & GX_TI_TUPLE_INDEX_MASK ) >=
+                  blend->tuplecount                         )
       {
         FT_TS_TRACE2(( "TT_Vary_Apply_Glyph_Deltas:"
                     " invalid tuple index\n" ));
 
         error = FT_TS_THROW( Invalid_Table );
-        goto Fail3;
+        goto Exit;
       }
       else
         FT_TS_MEM_COPY(
-          tuple_coords,
+          tuple->coords,
           blend->tuplecoords +
-            ( tupleIndex & GX_TI_TUPLE_INDEX_MASK ) * blend->num_axis,
+            ( tuple->flags & GX_TI_TUPLE_INDEX_MASK ) * blend->num_axis,
           blend->num_axis * sizeof ( FT_TS_Fixed ) );
 
-      if ( tupleIndex & GX_TI_INTERMEDIATE_TUPLE )
+      /* start and end coordinates follow the peak coordinates */
+      if ( tuple->flags & GX_TI_INTERMEDIATE_TUPLE )
       {
-        for ( j = 0; j < blend->num_axis; j++ )
-          im_start_coords[j] = FT_TS_fdot14ToFixed( FT_TS_GET_SHORT() );
-        for ( j = 0; j < blend->num_axis; j++ )
-          im_end_coords[j] = FT_TS_fdot14ToFixed( FT_TS_GET_SHORT() );
-      }
-
-      apply = ft_var_apply_tuple( blend,
-                                  (FT_TS_UShort)tupleIndex,
-                                  tuple_coords,
-                                  im_start_coords,
-                                  im_end_coords );
-
-      if ( apply == 0 )              /* tuple isn't active for our blend */
-      {
-        offsetToData += tupleDataSize;
-        continue;
+        for ( j = blend->num_axis; j < num_coords; j++ )
+          tuple->coords[j] = FT_TS_fdot14ToFixed( FT_TS_GET_SHORT() );
       }
 
       here = FT_TS_Stream_FTell( stream );
 
       FT_TS_Stream_SeekSet( stream, offsetToData );
 
-      if ( tupleIndex & GX_TI_PRIVATE_POINT_NUMBERS )
+      if ( tuple->flags & GX_TI_PRIVATE_POINT_NUMBERS )
       {
         localpoints = ft_var_readpackedpoints( stream,
                                                blend->gvar_size,
@@ -4040,98 +4465,310 @@
         point_count = spoint_count;
       }
 
+      delta_count = point_count == 0 ? n_points : point_count;
+
       deltas_x = ft_var_readpackeddeltas( stream,
                                           blend->gvar_size,
-                                          point_count == 0 ? n_points
-                                                           : point_count );
+                                          delta_count );
       deltas_y = ft_var_readpackeddeltas( stream,
                                           blend->gvar_size,
-                                          point_count == 0 ? n_points
-                                                           : point_count );
+                                          delta_count );
 
       if ( !points || !deltas_y || !deltas_x )
         ; /* failure, ignore it */
 
-      else if ( points == ALL_POINTS )
+      else if ( FT_TS_QNEW_ARRAY( tuple->deltas, 2 * delta_count ) )
       {
-#ifdef FT_TS_DEBUG_LEVEL_TRACE
-        int  count = 0;
-#endif
-
+        if ( localpoints != ALL_POINTS )
+          FT_TS_FREE( localpoints );
+        FT_TS_FREE( deltas_x );
+        FT_TS_FREE( deltas_y );
 
-        FT_TS_TRACE7(( "    point deltas:\n" ));
+        goto Exit;
+      }
 
-        /* this means that there are deltas for every point in the glyph */
-        for ( j = 0; j < n_points; j++ )
+      else
+      {
+        /* deltas are stored as integers in the font */
+        for ( j = 0; j < delta_count; j++ )
         {
-          FT_TS_Fixed  old_point_delta_x = point_deltas_x[j];
-          FT_TS_Fixed  old_point_delta_y = point_deltas_y[j];
-
-          FT_TS_Fixed  point_delta_x = FT_TS_MulFix( deltas_x[j], apply );
-          FT_TS_Fixed  point_delta_y = FT_TS_MulFix( deltas_y[j], apply );
+          tuple->deltas[j] =
+            (FT_TS_Short)FT_TS_fixedToInt( deltas_x[j] );
+          tuple->deltas[delta_count + j] =
+            (FT_TS_Short)FT_TS_fixedToInt( deltas_y[j] );
+        }
 
+        glyphvar->size += 2 * delta_count * sizeof ( FT_TS_Short );
 
-          if ( j < n_points - 4 )
-          {
-            point_deltas_x[j] = old_point_delta_x + point_delta_x;
-            point_deltas_y[j] = old_point_delta_y + point_delta_y;
-          }
-          else
-          {
-            /* To avoid double adjustment of advance width or height, */
-            /* adjust phantom points only if there is no HVAR or VVAR */
-            /* support, respectively.                                 */
-            if ( j == ( n_points - 4 )        &&
-                 !( face->variation_support &
-                    TT_FACE_FLAG_VAR_LSB    ) )
-              point_deltas_x[j] = old_point_delta_x + point_delta_x;
-
-            else if ( j == ( n_points - 3 )          &&
-                      !( face->variation_support   &
-                         TT_FACE_FLAG_VAR_HADVANCE ) )
-              point_deltas_x[j] = old_point_delta_x + point_delta_x;
-
-            else if ( j == ( n_points - 2 )        &&
-                      !( face->variation_support &
-                         TT_FACE_FLAG_VAR_TSB    ) )
-              point_deltas_y[j] = old_point_delta_y + point_delta_y;
-
-            else if ( j == ( n_points - 1 )          &&
-                      !( face->variation_support   &
-                         TT_FACE_FLAG_VAR_VADVANCE ) )
-              point_deltas_y[j] = old_point_delta_y + point_delta_y;
-          }
+        if ( points != ALL_POINTS )
+        {
+          tuple->points      = points;
+          tuple->point_count = point_count;
 
-#ifdef FT_TS_DEBUG_LEVEL_TRACE
-          if ( point_delta_x || point_delta_y )
+          if ( points == localpoints )
           {
-            FT_TS_TRACE7(( "      %d: (%f, %f) -> (%f, %f)\n",
-                        j,
-                        ( FT_TS_intToFixed( outline->points[j].x ) +
-                          old_point_delta_x ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].y ) +
-                          old_point_delta_y ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].x ) +
-                          point_deltas_x[j] ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].y ) +
-                          point_deltas_y[j] ) / 65536.0 ));
-            count++;
+            glyphvar->size += point_count * sizeof ( FT_TS_UShort );
+            localpoints     = NULL;   /* now owned by `tuple' */
           }
-#endif
         }
+      }
 
-#ifdef FT_TS_DEBUG_LEVEL_TRACE
-        if ( !count )
-          FT_TS_TRACE7(( "      none\n" ));
+      if ( localpoints != ALL_POINTS )
+        FT_TS_FREE( localpoints );
+      FT_TS_FREE( deltas_x );
+      FT_TS_FREE( deltas_y );
+
+      offsetToData += tupleDataSize;
+
+      FT_TS_Stream_SeekSet( stream, here );
+    }
+
+  Exit:
+    FT_TS_FRAME_EXIT();
+
+    if ( error )
+      ft_var_done_glyph_var( memory, glyphvar );
+    else
+      *aglyphvar = glyphvar;
+
+    return error;
+  }
+
+
+  /* Return the decoded variation data of a glyph, either from the cache */
+  /* or by decoding it.  In the latter case, the data is added to the    */
+  /* cache if possible; `*acached' tells whether the caller must free    */
+  /* the returned object.                                                */
+  static FT_TS_Error
+  ft_var_get_glyph_var( TT_Face       face,
+                        FT_TS_UInt    glyph_index,
+                        FT_TS_UInt    n_points,
+                        GX_GlyphVar  *aglyphvar,
+                        FT_TS_Bool   *acached )
+  {
+    FT_TS_Error  error;
+    GX_GlyphVar  glyphvar = NULL;
+
+#ifdef TT_CONFIG_OPTION_GVAR_CACHE
+    GX_Blend      blend  = face->blend;
+    FT_TS_Memory  memory = face->root.memory;
 #endif
+
+
+    *aglyphvar = NULL;
+    *acached   = FALSE;
+
+#ifdef TT_CONFIG_OPTION_GVAR_CACHE
+    if ( blend->glyphvars )
+    {
+      glyphvar = blend->glyphvars[glyph_index];
+
+      if ( glyphvar && glyphvar->n_points == n_points )
+      {
+        *aglyphvar = glyphvar;
+        *acached   = TRUE;
+
+        return FT_TS_Err_Ok;
       }
+    }
+#endif
+
+    error = ft_var_load_glyph_var( face, glyph_index, n_points, &glyphvar );
+    if ( error )
+      return error;
+
+    *aglyphvar = glyphvar;
+
+#ifdef TT_CONFIG_OPTION_GVAR_CACHE
+    /* the cache is optional; we ignore allocation errors */
+    if ( !blend->glyphvars                                        &&
+         blend->gv_glyphcnt * sizeof ( GX_GlyphVar ) <=
+           TT_CONFIG_GVAR_CACHE_MAX_SIZE                          &&
+         !FT_TS_NEW_ARRAY( blend->glyphvars, blend->gv_glyphcnt ) )
+      blend->glyphvars_size = blend->gv_glyphcnt * sizeof ( GX_GlyphVar );
+
+    if ( blend->glyphvars                                    &&
+         !blend->glyphvars[glyph_index]                      &&
+         blend->glyphvars_size + glyphvar->size <=
+           TT_CONFIG_GVAR_CACHE_MAX_SIZE                     )
+    {
+      blend->glyphvars[glyph_index]  = glyphvar;
+      blend->glyphvars_size         += glyphvar->size;
+
+      *acached = TRUE;
+    }
+#endif
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* compute the scalars of all tuples for the current coordinates */
+  static void
+  ft_var_compute_tuple_scalars( GX_Blend     blend,
+                                GX_GlyphVar  glyphvar )
+  {
+    FT_TS_UInt  i;
+
 
+    for ( i = 0; i < glyphvar->num_tuples; i++ )
+    {
+      GX_GlyphTuple  tuple = &glyphvar->tuples[i];
+
+
+      FT_TS_TRACE6(( "  tuple %d:\n", i ));
+
+      glyphvar->scalars[i] =
+        ft_var_apply_tuple( blend,
+                            tuple->flags,
+                            tuple->coords,
+                            tuple->coords + blend->num_axis,
+                            tuple->coords + 2 * blend->num_axis );
+    }
+
+    glyphvar->serial = blend->serial;
+  }
+
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   TT_Vary_Apply_Glyph_Deltas
+   *
+   * @Description:
+   *   Apply the appropriate deltas to the current glyph.
+   *
+   * @Input:
+   *   face ::
+   *     A handle to the target face object.
+   *
+   *   glyph_index ::
+   *     The index of the glyph being modified.
+   *
+   *   n_points ::
+   *     The number of the points in the glyph, including
+   *     phantom points.
+   *
+   * @InOut:
+   *   outline ::
+   *     The outline to change.
+   *
+   * @Output:
+   *   unrounded ::
+   *     An array with `n_points' elements that is filled with unrounded
+   *     point coordinates (in 26.6 format).
+   *
+   * @Return:
+   *   FreeType error code.  0 means success.
+   */
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  TT_Vary_Apply_Glyph_Deltas( TT_Face      face,
+                              FT_TS_UInt      glyph_index,
+                              FT_TS_Outline*  outline,
+                              FT_TS_Vector*   unrounded,
+                              FT_TS_UInt      n_points )
+  {
+    FT_TS_Error   error;
+    FT_TS_Memory  memory = face->root.memory;
+
+    FT_TS_Vector*  points_org = NULL;  /* coordinates in 16.16 format */
+    FT_TS_Vector*  points_out = NULL;  /* coordinates in 16.16 format */
+    FT_TS_Bool*    has_delta  = NULL;
+
+    FT_TS_UInt  i, j;
+
+    GX_Blend     blend    = face->blend;
+    GX_GlyphVar  glyphvar = NULL;
+    FT_TS_Bool   cached   = FALSE;
+
+    FT_TS_Fixed*  point_deltas_x = NULL;
+    FT_TS_Fixed*  point_deltas_y = NULL;
+
+
+    if ( !face->doblend || !blend )
+      return FT_TS_THROW( Invalid_Argument );
+
+    for ( i = 0; i < n_points; i++ )
+    {
+      unrounded[i].x = INT_TO_F26DOT6( outline->points[i].x );
+      unrounded[i].y = INT_TO_F26DOT6( outline->points[i].y );
+    }
+
+    if ( glyph_index >= blend->gv_glyphcnt      ||
+         blend->glyphoffsets[glyph_index] ==
+           blend->glyphoffsets[glyph_index + 1] )
+    {
+      FT_TS_TRACE2(( "TT_Vary_Apply_Glyph_Deltas:"
+                  " no variation data for glyph %d\n", glyph_index ));
+      return FT_TS_Err_Ok;
+    }
+
+    error = ft_var_get_glyph_var( face,
+                                  glyph_index,
+                                  n_points,
+                                  &glyphvar,
+                                  &cached );
+    if ( error )
+      return error;
+
+    FT_TS_TRACE5(( "gvar: there %s %d tuple%s:\n",
+                glyphvar->num_tuples == 1 ? "is" : "are",
+                glyphvar->num_tuples,
+                glyphvar->num_tuples == 1 ? "" : "s" ));
+
+    /* the tuple scalars only change with the coordinates */
+    if ( glyphvar->serial != blend->serial )
+      ft_var_compute_tuple_scalars( blend, glyphvar );
+
+    if ( FT_TS_NEW_ARRAY( point_deltas_x, n_points ) ||
+         FT_TS_NEW_ARRAY( point_deltas_y, n_points ) )
+      goto Exit;
+
+    for ( i = 0; i < glyphvar->num_tuples; i++ )
+    {
+      GX_GlyphTuple  tuple = &glyphvar->tuples[i];
+      FT_TS_Fixed    apply = glyphvar->scalars[i];
+
+      FT_TS_Short*  deltas_x = tuple->deltas;
+      FT_TS_Short*  deltas_y;
+
+
+      /* tuple isn't active for our blend, or its data is invalid */
+      if ( apply == 0 || !deltas_x )
+        continue;
+
+      /* Since the deltas are integers and `apply' is in the range */
+      /* ]0;1], `delta * apply' is exactly what `FT_TS_MulFix'     */
+      /* would return for the delta in 16.16 format.               */
+
+      if ( !tuple->point_count )
+      {
+        /* this means that there are deltas for every point in the glyph */
+        deltas_y = deltas_x + n_points;
+
+        for ( j = 0; j < n_points; j++ )
+        {
+          point_deltas_x[j] += deltas_x[j] * apply;
+          point_deltas_y[j] += deltas_y[j] * apply;
+        }
+      }
       else
       {
-#ifdef FT_TS_DEBUG_LEVEL_TRACE
-        int  count = 0;
-#endif
+        deltas_y = deltas_x + tuple->point_count;
+
+        if ( !points_org )
+        {
+          if ( FT_TS_NEW_ARRAY( points_org, n_points ) ||
+               FT_TS_NEW_ARRAY( points_out, n_points ) ||
+               FT_TS_NEW_ARRAY( has_delta, n_points )  )
+            goto Exit;
 
+          for ( j = 0; j < n_points; j++ )
+          {
+            points_org[j].x = FT_TS_intToFixed( outline->points[j].x );
+            points_org[j].y = FT_TS_intToFixed( outline->points[j].y );
+          }
+        }
 
         /* we have to interpolate the missing deltas similar to the */
         /* IUP bytecode instruction                                 */
@@ -4141,9 +4778,9 @@
           points_out[j] = points_org[j];
         }
 
-        for ( j = 0; j < point_count; j++ )
+        for ( j = 0; j < tuple->point_count; j++ )
         {
-          FT_TS_UShort  idx = points[j];
+          FT_TS_UShort  idx = tuple->points[j];
 
 
           if ( idx >= n_points )
@@ -4151,8 +4788,8 @@
 
           has_delta[idx] = TRUE;
 
-          points_out[idx].x += FT_TS_MulFix( deltas_x[j], apply );
-          points_out[idx].y += FT_TS_MulFix( deltas_y[j], apply );
+          points_out[idx].x += deltas_x[j] * apply;
+          points_out[idx].y += deltas_y[j] * apply;
         }
 
         /* no need to handle phantom points here,      */
@@ -4162,81 +4799,65 @@
                                points_org,
                                has_delta );
 
-        FT_TS_TRACE7(( "    point deltas:\n" ));
-
         for ( j = 0; j < n_points; j++ )
         {
-          FT_TS_Fixed  old_point_delta_x = point_deltas_x[j];
-          FT_TS_Fixed  old_point_delta_y = point_deltas_y[j];
-
-          FT_TS_Pos  point_delta_x = points_out[j].x - points_org[j].x;
-          FT_TS_Pos  point_delta_y = points_out[j].y - points_org[j].y;
-
+          point_deltas_x[j] += points_out[j].x - points_org[j].x;
+          point_deltas_y[j] += points_out[j].y - points_org[j].y;
+        }
+      }
+    }
 
-          if ( j < n_points - 4 )
-          {
-            point_deltas_x[j] = old_point_delta_x + point_delta_x;
-            point_deltas_y[j] = old_point_delta_y + point_delta_y;
-          }
-          else
-          {
-            /* To avoid double adjustment of advance width or height, */
-            /* adjust phantom points only if there is no HVAR or VVAR */
-            /* support, respectively.                                 */
-            if ( j == ( n_points - 4 )        &&
-                 !( face->variation_support &
-                    TT_FACE_FLAG_VAR_LSB    ) )
-              point_deltas_x[j] = old_point_delta_x + point_delta_x;
-
-            else if ( j == ( n_points - 3 )          &&
-                      !( face->variation_support   &
-                         TT_FACE_FLAG_VAR_HADVANCE ) )
-              point_deltas_x[j] = old_point_delta_x + point_delta_x;
-
-            else if ( j == ( n_points - 2 )        &&
-                      !( face->variation_support &
-                         TT_FACE_FLAG_VAR_TSB    ) )
-              point_deltas_y[j] = old_point_delta_y + point_delta_y;
-
-            else if ( j == ( n_points - 1 )          &&
-                      !( face->variation_support   &
-                         TT_FACE_FLAG_VAR_VADVANCE ) )
-              point_deltas_y[j] = old_point_delta_y + point_delta_y;
-          }
+    /* Phantom points only move along their own direction.  To avoid */
+    /* double adjustment of advance width or height, adjust them only */
+    /* if there is no HVAR or VVAR support, respectively.             */
+    if ( n_points >= 4 )
+    {
+      FT_TS_Fixed*  phantom_x = point_deltas_x + n_points - 4;
+      FT_TS_Fixed*  phantom_y = point_deltas_y + n_points - 4;
+
+
+      phantom_y[0] = 0;
+      phantom_y[1] = 0;
+      phantom_x[2] = 0;
+      phantom_x[3] = 0;
+
+      if ( face->variation_support & TT_FACE_FLAG_VAR_LSB )
+        phantom_x[0] = 0;
+      if ( face->variation_support & TT_FACE_FLAG_VAR_HADVANCE )
+        phantom_x[1] = 0;
+      if ( face->variation_support & TT_FACE_FLAG_VAR_TSB )
+        phantom_y[2] = 0;
+      if ( face->variation_support & TT_FACE_FLAG_VAR_VADVANCE )
+        phantom_y[3] = 0;
+    }
 
 #ifdef FT_TS_DEBUG_LEVEL_TRACE
-          if ( point_delta_x || point_delta_y )
-          {
-            FT_TS_TRACE7(( "      %d: (%f, %f) -> (%f, %f)\n",
-                        j,
-                        ( FT_TS_intToFixed( outline->points[j].x ) +
-                          old_point_delta_x ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].y ) +
-                          old_point_delta_y ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].x ) +
-                          point_deltas_x[j] ) / 65536.0,
-                        ( FT_TS_intToFixed( outline->points[j].y ) +
-                          point_deltas_y[j] ) / 65536.0 ));
-            count++;
-          }
-#endif
-        }
+    {
+      int  count = 0;
 
-#ifdef FT_TS_DEBUG_LEVEL_TRACE
-        if ( !count )
-          FT_TS_TRACE7(( "      none\n" ));
-#endif
-      }
 
-      if ( localpoints != ALL_POINTS )
-        FT_TS_FREE( localpoints );
-      FT_TS_FREE( deltas_x );
-      FT_TS_FREE( deltas_y );
+      FT_TS_TRACE7(( "    point deltas:\n" ));
 
-      offsetToData += tupleDataSize;
+      for ( j = 0; j < n_points; j++ )
+      {
+        if ( point_deltas_x[j] || point_deltas_y[j] )
+        {
+          FT_TS_TRACE7(( "      %d: (%f, %f) -> (%f, %f)\n",
+                      j,
+                      FT_TS_intToFixed( outline->points[j].x ) / 65536.0,
+                      FT_TS_intToFixed( outline->points[j].y ) / 65536.0,
+                      ( FT_TS_intToFixed( outline->points[j].x ) +
+                        point_deltas_x[j] ) / 65536.0,
+                      ( FT_TS_intToFixed( outline->points[j].y ) +
+                        point_deltas_y[j] ) / 65536.0 ));
+          count++;
+        }
+      }
 
-      FT_TS_Stream_SeekSet( stream, here );
+      if ( !count )
+        FT_TS_TRACE7(( "      none\n" ));
     }
+#endif
 
     FT_TS_TRACE5(( "\n" ));
 
@@ -4249,24 +4870,17 @@
       outline->points[i].y += FT_TS_fixedToInt( point_deltas_y[i] );
     }
 
-  Fail3:
+  Exit:
     FT_TS_FREE( point_deltas_x );
     FT_TS_FREE( point_deltas_y );
 
-  Fail2:
-    if ( sharedpoints != ALL_POINTS )
-      FT_TS_FREE( sharedpoints );
-    FT_TS_FREE( tuple_coords );
-    FT_TS_FREE( im_start_coords );
-    FT_TS_FREE( im_end_coords );
-
-    FT_TS_FRAME_EXIT();
-
-  Fail1:
     FT_TS_FREE( points_org );
     FT_TS_FREE( points_out );
     FT_TS_FREE( has_delta );
 
+    if ( !cached )
+      ft_var_done_glyph_var( memory, glyphvar );
+
     return error;
   }
 
@@ -4339,6 +4953,8 @@
 
       FT_TS_FREE( itemStore->varRegionList );
     }
+
+    FT_TS_FREE( itemStore->regionScalars );
   }
 
 
@@ -4384,6 +5000,8 @@
 
         FT_TS_FREE( blend->hvar_table->widthMap.innerIndex );
         FT_TS_FREE( blend->hvar_table->widthMap.outerIndex );
+        FT_TS_FREE( blend->hvar_table->deltas );
+        FT_TS_FREE( blend->hvar_table->deltasValid );
         FT_TS_FREE( blend->hvar_table );
       }
 
@@ -4394,6 +5012,8 @@
 
         FT_TS_FREE( blend->vvar_table->widthMap.innerIndex );
         FT_TS_FREE( blend->vvar_table->widthMap.outerIndex );
+        FT_TS_FREE( blend->vvar_table->deltas );
+        FT_TS_FREE( blend->vvar_table->deltasValid );
         FT_TS_FREE( blend->vvar_table );
       }
 
@@ -4406,6 +5026,27 @@
         FT_TS_FREE( blend->mvar_table );
       }
 
+      if ( blend->glyphvars )
+      {
+        for ( i = 0; i < blend->gv_glyphcnt; i++ )
+          ft_var_done_glyph_var( memory, blend->glyphvars[i] );
+
+        FT_TS_FREE( blend->glyphvars );
+      }
+
+      while ( blend->instances )
+      {
+        GX_Instance  instance = blend->instances;
+
+
+        blend->instances = instance->next;
+
+        if ( instance->root.autohint.finalizer )
+          instance->root.autohint.finalizer( instance->root.autohint.data );
+
+        ft_var_done_instance( memory, instance );
+      }
+
       FT_TS_FREE( blend->tuplecoords );
       FT_TS_FREE( blend->glyphoffsets );
       FT_TS_FREE( blend );
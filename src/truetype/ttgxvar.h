@@ -20,6 +20,8 @@
 #define TTGXVAR_H_
 
 
+#include <freetype/ftmm.h>
+#include <freetype/internal/services/svmm.h>
 #include "ttobjs.h"
 
 
@@ -101,6 +103,9 @@ FT_TS_BEGIN_HEADER
     FT_TS_UInt       regionCount;          /* total number of regions defined */
     GX_VarRegion  varRegionList;
 
+    FT_TS_Fixed*     regionScalars;        /* region scalars for the current */
+    FT_TS_Bool       regionScalarsValid;   /* coordinates, built on demand   */
+
   } GX_ItemVarStoreRec, *GX_ItemVarStore;
 
 
@@ -126,6 +131,11 @@ FT_TS_BEGIN_HEADER
     GX_ItemVarStoreRec    itemStore;        /* Item Variation Store  */
     GX_DeltaSetIdxMapRec  widthMap;         /* Advance Width Mapping */
 
+    /* advance deltas for the current coordinates, indexed by glyph */
+    FT_TS_UInt               numDeltas;
+    FT_TS_Int*               deltas;
+    FT_TS_UInt32*            deltasValid;   /* bitmap of computed entries */
+
 #if 0
     GX_DeltaSetIdxMapRec  lsbMap;           /* not implemented */
     GX_DeltaSetIdxMapRec  rsbMap;           /* not implemented */
@@ -208,6 +218,151 @@ FT_TS_BEGIN_HEADER
   } GX_MVarTableRec, *GX_MVarTable;
 
 
+  /**************************************************************************
+   *
+   * @Struct:
+   *   GX_GlyphTupleRec
+   *
+   * @Description:
+   *   A decoded tuple variation of a glyph from the `gvar' table.
+   *
+   * @Fields:
+   *   flags ::
+   *     The `tupleIndex' field of the tuple variation header.
+   *
+   *   coords ::
+   *     The peak coordinates of the tuple, followed by the start and end
+   *     coordinates of intermediate tuples (`num_axis' values each).
+   *
+   *   point_count ::
+   *     The number of points with deltas; zero means all points.
+   *
+   *   points ::
+   *     The point numbers (`NULL' if `point_count' is zero).
+   *
+   *   deltas ::
+   *     The x~deltas of the points, followed by the y~deltas.  This is
+   *     `NULL' if the data was invalid; the tuple is then ignored.
+   */
+  typedef struct  GX_GlyphTupleRec_
+  {
+    FT_TS_UShort   flags;
+    FT_TS_Fixed*   coords;
+    FT_TS_UInt     point_count;
+    FT_TS_UShort*  points;
+    FT_TS_Short*   deltas;
+
+  } GX_GlyphTupleRec, *GX_GlyphTuple;
+
+
+  /**************************************************************************
+   *
+   * @Struct:
+   *   GX_GlyphVarRec
+   *
+   * @Description:
+   *   The decoded `gvar' data of a glyph.
+   *
+   * @Fields:
+   *   n_points ::
+   *     The number of points (including phantom points) the data was
+   *     decoded for.
+   *
+   *   num_tuples ::
+   *     The number of tuples.
+   *
+   *   tuples ::
+   *     The tuple array.
+   *
+   *   sharedpoints ::
+   *     The shared point numbers the `points' fields of the tuples may
+   *     point to.
+   *
+   *   coords ::
+   *     The array the `coords' fields of the tuples point into.
+   *
+   *   scalars ::
+   *     The scalars of the tuples for the coordinates identified by
+   *     `serial'.
+   *
+   *   serial ::
+   *     The value of the `serial' field in @GX_BlendRec when `scalars'
+   *     was computed; zero if never.
+   *
+   *   size ::
+   *     The number of bytes allocated for this object.
+   */
+  typedef struct  GX_GlyphVarRec_
+  {
+    FT_TS_UInt     n_points;
+    FT_TS_UInt     num_tuples;
+    GX_GlyphTuple  tuples;
+    FT_TS_UShort*  sharedpoints;
+    FT_TS_Fixed*   coords;
+
+    FT_TS_Fixed*   scalars;
+    FT_TS_ULong    serial;
+
+    FT_TS_ULong    size;
+
+  } GX_GlyphVarRec, *GX_GlyphVar;
+
+
+  /**************************************************************************
+   *
+   * @Struct:
+   *   GX_InstanceRec
+   *
+   * @Description:
+   *   A variation instance as created by `FT_TS_New_Var_Instance'.
+   *
+   * @Fields:
+   *   root ::
+   *     The driver-independent part.
+   *
+   *   next ::
+   *     The next instance of the same face.
+   *
+   *   num_coords ::
+   *     The number of design coordinates passed by the user; it controls
+   *     the `FT_TS_FACE_FLAG_VARIATION' flag.
+   *
+   *   coords ::
+   *     The design coordinates, completed for all axes.
+   *
+   *   normalizedcoords ::
+   *     The corresponding normalized coordinates.
+   *
+   *   cvt ::
+   *     A copy of the varied `cvt' table, taken the first time the
+   *     instance gets activated.
+   *
+   *   hdeltas ::
+   *   hdeltasValid ::
+   *   vdeltas ::
+   *   vdeltasValid ::
+   *     The advance delta caches of the `HVAR' and `VVAR' tables while
+   *     the instance is not active (see @GX_HVVarTableRec).
+   */
+  typedef struct  GX_InstanceRec_
+  {
+    FT_TS_Var_InstanceRec    root;
+    struct GX_InstanceRec_*  next;
+
+    FT_TS_UInt     num_coords;
+    FT_TS_Fixed*   coords;
+    FT_TS_Fixed*   normalizedcoords;
+
+    FT_TS_Int32*   cvt;
+
+    FT_TS_Int*     hdeltas;
+    FT_TS_UInt32*  hdeltasValid;
+    FT_TS_Int*     vdeltas;
+    FT_TS_UInt32*  vdeltasValid;
+
+  } GX_InstanceRec, *GX_Instance;
+
+
   /**************************************************************************
    *
    * @Struct:
@@ -296,6 +451,19 @@ FT_TS_BEGIN_HEADER
    *
    *   gvar_size ::
    *     The size of the `gvar' table.
+   *
+   *   glyphvars ::
+   *     An array of `gv_glyphcnt' elements, holding the decoded `gvar'
+   *     data of glyphs that have already been loaded.
+   *
+   *   glyphvars_size ::
+   *     The number of bytes used by `glyphvars'.
+   *
+   *   serial ::
+   *     A counter incremented each time the coordinates change.
+   *
+   *   instances ::
+   *     A linked list of all variation instances of the face.
    */
   typedef struct  GX_BlendRec_
   {
@@ -332,6 +500,13 @@ FT_TS_BEGIN_HEADER
 
     FT_TS_ULong        gvar_size;
 
+    GX_GlyphVar*    glyphvars;
+    FT_TS_ULong        glyphvars_size;
+
+    FT_TS_ULong        serial;
+
+    GX_Instance     instances;
+
   } GX_BlendRec;
 
 
@@ -406,6 +581,19 @@ FT_TS_BEGIN_HEADER
   TT_Set_Named_Instance( TT_Face  face,
                          FT_TS_UInt  instance_index );
 
+  FT_TS_LOCAL( FT_TS_Error )
+  TT_New_Var_Instance( TT_Face              face,
+                       FT_TS_UInt           num_coords,
+                       FT_TS_Fixed*         coords,
+                       FT_TS_Var_Instance  *ainstance );
+
+  FT_TS_LOCAL( FT_TS_Error )
+  TT_Set_Var_Instance( TT_Face             face,
+                       FT_TS_Var_Instance  instance );
+
+  FT_TS_LOCAL( void )
+  TT_Done_Var_Instance( FT_TS_Var_Instance  instance );
+
   FT_TS_LOCAL( FT_TS_Error )
   tt_face_vary_cvt( TT_Face    face,
                     FT_TS_Stream  stream );
@@ -6872,22 +6872,25 @@
                      FT_TS_UInt     p2,
                      FT_TS_UInt     p )
   {
+    FT_TS_Vector*  curs = worker->curs;
     FT_TS_UInt     i;
     FT_TS_F26Dot6  dx;
 
 
-    dx = SUB_LONG( worker->curs[p].x, worker->orgs[p].x );
+    dx = SUB_LONG( curs[p].x, worker->orgs[p].x );
     if ( dx != 0 )
     {
       for ( i = p1; i < p; i++ )
-        worker->curs[i].x = ADD_LONG( worker->curs[i].x, dx );
+        curs[i].x = ADD_LONG( curs[i].x, dx );
 
       for ( i = p + 1; i <= p2; i++ )
-        worker->curs[i].x = ADD_LONG( worker->curs[i].x, dx );
+        curs[i].x = ADD_LONG( curs[i].x, dx );
     }
   }
 
 
+  /* The loops below use local copies of the array pointers; otherwise */
+  /* the compiler has to reload them from `worker' after each store.   */
   static void
   _iup_worker_interpolate( IUP_Worker  worker,
                            FT_TS_UInt     p1,
@@ -6895,6 +6898,10 @@
                            FT_TS_UInt     ref1,
                            FT_TS_UInt     ref2 )
   {
+    FT_TS_Vector*  orgs = worker->orgs;
+    FT_TS_Vector*  curs = worker->curs;
+    FT_TS_Vector*  orus = worker->orus;
+
     FT_TS_UInt     i;
     FT_TS_F26Dot6  orus1, orus2, org1, org2, cur1, cur2, delta1, delta2;
 
@@ -6906,8 +6913,8 @@
          BOUNDS( ref2, worker->max_points ) )
       return;
 
-    orus1 = worker->orus[ref1].x;
-    orus2 = worker->orus[ref2].x;
+    orus1 = orus[ref1].x;
+    orus2 = orus[ref2].x;
 
     if ( orus1 > orus2 )
     {
@@ -6924,10 +6931,10 @@
       ref2  = tmp_r;
     }
 
-    org1   = worker->orgs[ref1].x;
-    org2   = worker->orgs[ref2].x;
-    cur1   = worker->curs[ref1].x;
-    cur2   = worker->curs[ref2].x;
+    org1   = orgs[ref1].x;
+    org2   = orgs[ref2].x;
+    cur1   = curs[ref1].x;
+    cur2   = curs[ref2].x;
     delta1 = SUB_LONG( cur1, org1 );
     delta2 = SUB_LONG( cur2, org2 );
 
@@ -6937,7 +6944,7 @@
       /* trivial snap or shift of untouched points */
       for ( i = p1; i <= p2; i++ )
       {
-        FT_TS_F26Dot6  x = worker->orgs[i].x;
+        FT_TS_F26Dot6  x = orgs[i].x;
 
 
         if ( x <= org1 )
@@ -6949,19 +6956,19 @@
         else
           x = cur1;
 
-        worker->curs[i].x = x;
+        curs[i].x = x;
       }
     }
     else
     {
-      FT_TS_Fixed  scale       = 0;
-      FT_TS_Bool   scale_valid = 0;
+      FT_TS_Fixed  scale = 0;
 
 
-      /* interpolation */
+      /* interpolation; as long as the points lie outside of the */
+      /* reference range there is no need to compute `scale'    */
       for ( i = p1; i <= p2; i++ )
       {
-        FT_TS_F26Dot6  x = worker->orgs[i].x;
+        FT_TS_F26Dot6  x = orgs[i].x;
 
 
         if ( x <= org1 )
@@ -6972,18 +6979,31 @@
 
         else
         {
-          if ( !scale_valid )
-          {
-            scale_valid = 1;
-            scale       = FT_TS_DivFix( SUB_LONG( cur2, cur1 ),
-                                     SUB_LONG( orus2, orus1 ) );
-          }
+          scale = FT_TS_DivFix( SUB_LONG( cur2, cur1 ),
+                             SUB_LONG( orus2, orus1 ) );
+          break;
+        }
+
+        curs[i].x = x;
+      }
+
+      for ( ; i <= p2; i++ )
+      {
+        FT_TS_F26Dot6  x = orgs[i].x;
+
 
+        if ( x <= org1 )
+          x = ADD_LONG( x, delta1 );
+
+        else if ( x >= org2 )
+          x = ADD_LONG( x, delta2 );
+
+        else
           x = ADD_LONG( cur1,
-                        FT_TS_MulFix( SUB_LONG( worker->orus[i].x, orus1 ),
+                        FT_TS_MulFix( SUB_LONG( orus[i].x, orus1 ),
                                    scale ) );
-        }
-        worker->curs[i].x = x;
+
+        curs[i].x = x;
       }
     }
   }
@@ -7010,6 +7030,8 @@
     FT_TS_UInt   point;         /* current point   */
     FT_TS_Short  contour;       /* current contour */
 
+    FT_TS_Byte*  tags = exc->pts.tags;
+
 
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_MINIMAL
     /* See `ttinterp.h' for details on backward compatibility mode.  */
@@ -7069,7 +7091,7 @@
       if ( BOUNDS( end_point, exc->pts.n_points ) )
         end_point = exc->pts.n_points - 1;
 
-      while ( point <= end_point && ( exc->pts.tags[point] & mask ) == 0 )
+      while ( point <= end_point && ( tags[point] & mask ) == 0 )
         point++;
 
       if ( point <= end_point )
@@ -7081,7 +7103,7 @@
 
         while ( point <= end_point )
         {
-          if ( ( exc->pts.tags[point] & mask ) != 0 )
+          if ( ( tags[point] & mask ) != 0 )
           {
             _iup_worker_interpolate( &V,
                                      cur_touched + 1,
@@ -1330,10 +1330,55 @@
     tt_size_done_bytecode( ttsize );
 #endif
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+    tt_size_done_components( size );
+#endif
+
     size->ttmetrics.valid = FALSE;
   }
 
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+
+  /**************************************************************************
+   *
+   * @Function:
+   *   tt_size_done_components
+   *
+   * @Description:
+   *   Discard all cached composite glyph components of a size.
+   *
+   * @Input:
+   *   size ::
+   *     A handle to the target size object.
+   */
+  FT_TS_LOCAL_DEF( void )
+  tt_size_done_components( TT_Size  size )
+  {
+    FT_TS_Memory  memory = size->root.face->memory;
+
+
+    while ( size->component_list )
+    {
+      TT_Component  component = size->component_list;
+
+
+      size->component_list = component->next;
+      FT_TS_FREE( component );
+    }
+
+    if ( size->components )
+    {
+      ft_hash_num_free( size->components, memory );
+      FT_TS_FREE( size->components );
+    }
+
+    size->components_size = 0;
+  }
+
+#endif /* TT_CONFIG_OPTION_COMPONENT_CACHE */
+
+
   /**************************************************************************
    *
    * @Function:
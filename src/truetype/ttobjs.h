@@ -22,6 +22,7 @@
 
 #include <freetype/internal/ftobjs.h>
 #include <freetype/internal/tttypes.h>
+#include <freetype/internal/fthash.h>
 
 
 FT_TS_BEGIN_HEADER
@@ -267,6 +268,43 @@ FT_TS_BEGIN_HEADER
   } TT_Size_Metrics;
 
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+
+  /**************************************************************************
+   *
+   * A scaled simple glyph, cached for use as a composite glyph component.
+   * Besides the outline (including the four phantom points) it holds the
+   * fields of `TT_LoaderRec' that loading the glyph sets, so that a cache
+   * hit leaves the loader in the same state as a real load.
+   */
+  typedef struct  TT_ComponentRec_
+  {
+    struct TT_ComponentRec_*  next;
+
+    FT_TS_Short    n_points;      /* without phantom points */
+    FT_TS_Short    n_contours;
+    FT_TS_Vector*  points;
+    FT_TS_Byte*    tags;
+    FT_TS_Short*   contours;
+    FT_TS_Bool     overlap;       /* `OVERLAP_SIMPLE' flag of first point */
+
+    FT_TS_UInt     byte_len;
+    FT_TS_BBox     bbox;
+    FT_TS_Int      left_bearing;
+    FT_TS_Int      advance;
+    FT_TS_Int      linear;        /* only valid for variation deltas */
+    FT_TS_Int      top_bearing;
+    FT_TS_Int      vadvance;
+    FT_TS_Vector   pp1;
+    FT_TS_Vector   pp2;
+    FT_TS_Vector   pp3;
+    FT_TS_Vector   pp4;
+
+  } TT_ComponentRec, *TT_Component;
+
+#endif /* TT_CONFIG_OPTION_COMPONENT_CACHE */
+
+
   /**************************************************************************
    *
    * TrueType size class.
@@ -320,6 +358,20 @@ FT_TS_BEGIN_HEADER
 
 #endif /* TT_USE_BYTECODE_INTERPRETER */
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+
+    /* the cached components are valid for this scaling, the `NO_SCALE' */
+    /* load flag, and the blend's serial number                         */
+    FT_TS_Hash            components;      /* glyph index -> TT_Component */
+    TT_Component       component_list;
+    FT_TS_ULong           components_size;
+    FT_TS_Fixed           components_x_scale;
+    FT_TS_Fixed           components_y_scale;
+    FT_TS_Bool            components_unscaled;
+    FT_TS_ULong           components_serial;
+
+#endif
+
   } TT_SizeRec;
 
 
@@ -392,6 +444,11 @@ FT_TS_BEGIN_HEADER
   tt_size_reset( TT_Size  size,
                  FT_TS_Bool  only_height );
 
+#ifdef TT_CONFIG_OPTION_COMPONENT_CACHE
+  FT_TS_LOCAL( void )
+  tt_size_done_components( TT_Size  size );
+#endif
+
 
   /**************************************************************************
    *
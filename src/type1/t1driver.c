@@ -72,19 +72,10 @@
   t1_get_name_index( T1_Face           face,
                      const FT_TS_String*  glyph_name )
   {
-    FT_TS_Int  i;
+    FT_TS_Int  idx = T1_Get_Glyph_Name_Index( face, glyph_name );
 
 
-    for ( i = 0; i < face->type1.num_glyphs; i++ )
-    {
-      FT_TS_String*  gname = face->type1.glyph_names[i];
-
-
-      if ( !ft_strcmp( glyph_name, gname ) )
-        return (FT_TS_UInt)i;
-    }
-
-    return 0;
+    return idx >= 0 ? (FT_TS_UInt)idx : 0;
   }
 
 
@@ -131,6 +122,9 @@
     (FT_TS_Set_Instance_Func)       T1_Reset_MM_Blend,      /* set_instance        */
     (FT_TS_Set_MM_WeightVector_Func)T1_Set_MM_WeightVector, /* set_mm_weightvector */
     (FT_TS_Get_MM_WeightVector_Func)T1_Get_MM_WeightVector, /* get_mm_weightvector */
+    (FT_TS_New_Var_Instance_Func)   NULL,                   /* new_var_instance    */
+    (FT_TS_Set_Var_Instance_Func)   NULL,                   /* set_var_instance    */
+    (FT_TS_Done_Var_Instance_Func)  NULL,                   /* done_var_instance   */
 
     (FT_TS_Get_Var_Blend_Func)      NULL,                   /* get_var_blend       */
     (FT_TS_Done_Blend_Func)         T1_Done_Blend           /* done_blend          */
@@ -754,7 +748,7 @@
       FT_TS_MODULE_DRIVER_SCALABLE   |
       FT_TS_MODULE_DRIVER_HAS_HINTER,
 
-      sizeof ( PS_DriverRec ),
+      sizeof ( T1_DriverRec ),
 
       "type1",
       0x10000L,
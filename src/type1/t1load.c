@@ -69,6 +69,7 @@
 #include <freetype/internal/fthash.h>
 
 #include "t1load.h"
+#include "t1objs.h"
 #include "t1errors.h"
 
 
@@ -1393,6 +1394,17 @@
   }
 
 
+  /* Is the binary data at `base' part of the private dictionary?    */
+  /* Unlike the base dictionary (which can be part of a memory-based */
+  /* stream), the private dictionary is always writable.             */
+#define T1_IN_PRIVATE_DICT( parser, base, size )                          \
+          ( (parser)->private_dict                                    &&  \
+            (base) >= (parser)->private_dict                          &&  \
+            (base) <= (parser)->private_dict + (parser)->private_len  &&  \
+            (size) <= (FT_TS_ULong)( (parser)->private_dict             +  \
+                                     (parser)->private_len - (base) ) )
+
+
   /* We now define the routines to handle the `/Encoding', `/Subrs', */
   /* and `/CharStrings' dictionaries.                                */
 
@@ -1867,15 +1879,29 @@
           goto Fail;
         }
 
-        /* t1_decrypt() shouldn't write to base -- make temporary copy */
-        if ( FT_TS_QALLOC( temp, size ) )
-          goto Fail;
-        FT_TS_MEM_COPY( temp, base, size );
-        psaux->t1_decrypt( temp, size, 4330 );
-        size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
-        error = T1_Add_Table( table, (FT_TS_Int)idx,
-                              temp + face->type1.private_dict.lenIV, size );
-        FT_TS_FREE( temp );
+        if ( T1_IN_PRIVATE_DICT( parser, base, size ) )
+        {
+          /* the private dictionary is our own copy; decrypt in place */
+          if ( !parser->charstrings_decrypted )
+            psaux->t1_decrypt( base, size, 4330 );
+          size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
+          error = T1_Add_Table( table, (FT_TS_Int)idx,
+                                base + face->type1.private_dict.lenIV,
+                                size );
+        }
+        else
+        {
+          /* t1_decrypt() shouldn't write to base -- make temporary copy */
+          if ( FT_TS_QALLOC( temp, size ) )
+            goto Fail;
+          FT_TS_MEM_COPY( temp, base, size );
+          psaux->t1_decrypt( temp, size, 4330 );
+          size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
+          error = T1_Add_Table( table, (FT_TS_Int)idx,
+                                temp + face->type1.private_dict.lenIV,
+                                size );
+          FT_TS_FREE( temp );
+        }
       }
       else
         error = T1_Add_Table( table, (FT_TS_Int)idx, base, size );
@@ -2077,15 +2103,29 @@
             goto Fail;
           }
 
-          /* t1_decrypt() shouldn't write to base -- make temporary copy */
-          if ( FT_TS_QALLOC( temp, size ) )
-            goto Fail;
-          FT_TS_MEM_COPY( temp, base, size );
-          psaux->t1_decrypt( temp, size, 4330 );
-          size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
-          error = T1_Add_Table( code_table, n,
-                                temp + face->type1.private_dict.lenIV, size );
-          FT_TS_FREE( temp );
+          if ( T1_IN_PRIVATE_DICT( parser, base, size ) )
+          {
+            /* the private dictionary is our own copy; decrypt in place */
+            if ( !parser->charstrings_decrypted )
+              psaux->t1_decrypt( base, size, 4330 );
+            size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
+            error = T1_Add_Table( code_table, n,
+                                  base + face->type1.private_dict.lenIV,
+                                  size );
+          }
+          else
+          {
+            /* t1_decrypt() shouldn't write to base -- make temporary copy */
+            if ( FT_TS_QALLOC( temp, size ) )
+              goto Fail;
+            FT_TS_MEM_COPY( temp, base, size );
+            psaux->t1_decrypt( temp, size, 4330 );
+            size -= (FT_TS_ULong)face->type1.private_dict.lenIV;
+            error = T1_Add_Table( code_table, n,
+                                  temp + face->type1.private_dict.lenIV,
+                                  size );
+            FT_TS_FREE( temp );
+          }
         }
         else
           error = T1_Add_Table( code_table, n, base, size );
@@ -2505,6 +2545,38 @@
   }
 
 
+  static const char*
+  t1_get_glyph_name_string( void*       object,
+                            FT_TS_UInt  idx )
+  {
+    T1_Font  type1 = (T1_Font)object;
+
+
+    return type1->glyph_names[idx];
+  }
+
+
+  /* Return the index of the first glyph called `glyph_name`, or -1 if */
+  /* there is none.                                                   */
+  FT_TS_LOCAL_DEF( FT_TS_Int )
+  T1_Get_Glyph_Name_Index( T1_Face              face,
+                           const FT_TS_String*  glyph_name )
+  {
+    T1_Font  type1 = &face->type1;
+
+
+    if ( !type1->glyph_names || type1->num_glyphs <= 0 )
+      return -1;
+
+    return (FT_TS_Int)ft_hash_name_index( &type1->glyph_names_hash,
+                                          glyph_name,
+                                          (FT_TS_UInt)type1->num_glyphs,
+                                          t1_get_glyph_name_string,
+                                          type1,
+                                          face->root.memory );
+  }
+
+
   FT_TS_LOCAL_DEF( FT_TS_Error )
   T1_Open_Face( T1_Face  face )
   {
@@ -2538,6 +2610,10 @@
     if ( error )
       goto Exit;
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    parser->dict_cache = &( (T1_Driver)face->root.driver )->dict_cache;
+#endif
+
     FT_TS_TRACE4(( " top dictionary:\n" ));
     error = parse_dict( face, &loader,
                         parser->base_dict, parser->base_len );
@@ -2690,29 +2766,25 @@
         type1->encoding.char_index[charcode] = 0;
         type1->encoding.char_name [charcode] = ".notdef";
 
-        if ( char_name )
-          for ( idx = 0; idx < type1->num_glyphs; idx++ )
-          {
-            const FT_TS_String*  glyph_name = type1->glyph_names[idx];
+        idx = T1_Get_Glyph_Name_Index( face, char_name );
+        if ( idx >= 0 )
+        {
+          const FT_TS_String*  glyph_name = type1->glyph_names[idx];
 
 
-            if ( ft_strcmp( char_name, glyph_name ) == 0 )
-            {
-              type1->encoding.char_index[charcode] = (FT_TS_UShort)idx;
-              type1->encoding.char_name [charcode] = glyph_name;
+          type1->encoding.char_index[charcode] = (FT_TS_UShort)idx;
+          type1->encoding.char_name [charcode] = glyph_name;
 
-              /* Change min/max encoded char only if glyph name is */
-              /* not /.notdef                                      */
-              if ( ft_strcmp( ".notdef", glyph_name ) != 0 )
-              {
-                if ( charcode < min_char )
-                  min_char = charcode;
-                if ( charcode >= max_char )
-                  max_char = charcode + 1;
-              }
-              break;
-            }
+          /* Change min/max encoded char only if glyph name is */
+          /* not /.notdef                                      */
+          if ( ft_strcmp( ".notdef", glyph_name ) != 0 )
+          {
+            if ( charcode < min_char )
+              min_char = charcode;
+            if ( charcode >= max_char )
+              max_char = charcode + 1;
           }
+        }
       }
 
       type1->encoding.code_first = min_char;
@@ -2738,6 +2810,11 @@
       priv->blue_fuzz = 1;
     }
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    if ( !error )
+      T1_Cache_Private_Dict( parser );
+#endif
+
   Exit:
     t1_done_loader( &loader );
     return error;
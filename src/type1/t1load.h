@@ -63,6 +63,10 @@ FT_TS_BEGIN_HEADER
   FT_TS_LOCAL( FT_TS_Error )
   T1_Open_Face( T1_Face  face );
 
+  FT_TS_LOCAL( FT_TS_Int )
+  T1_Get_Glyph_Name_Index( T1_Face              face,
+                           const FT_TS_String*  glyph_name );
+
 #ifndef T1_CONFIG_OPTION_NO_MM_SUPPORT
 
   FT_TS_LOCAL( FT_TS_Error )
@@ -246,6 +246,9 @@
     FT_TS_FREE( type1->charstrings );
     FT_TS_FREE( type1->glyph_names );
 
+    ft_hash_str_free( type1->glyph_names_hash, memory );
+    FT_TS_FREE( type1->glyph_names_hash );
+
     FT_TS_FREE( type1->subrs );
     FT_TS_FREE( type1->subrs_len );
 
@@ -646,7 +649,12 @@
   FT_TS_LOCAL_DEF( void )
   T1_Driver_Done( FT_TS_Module  driver )
   {
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    T1_Done_Dict_Cache( &( (T1_Driver)driver )->dict_cache,
+                        driver->memory );
+#else
     FT_TS_UNUSED( driver );
+#endif
   }
 
 
@@ -24,6 +24,9 @@
 #include <freetype/internal/ftobjs.h>
 #include FT_TS_CONFIG_CONFIG_H
 #include <freetype/internal/t1types.h>
+#include <freetype/internal/psaux.h>
+
+#include "t1parse.h"
 
 
 FT_TS_BEGIN_HEADER
@@ -145,6 +148,26 @@ FT_TS_BEGIN_HEADER
   FT_TS_LOCAL( void )
   T1_GlyphSlot_Done( FT_TS_GlyphSlot  slot );
 
+  /**************************************************************************
+   *
+   * @Type:
+   *   T1_DriverRec
+   *
+   * @Description:
+   *   Type 1 driver record.  It extends the driver record shared by all
+   *   PostScript font drivers.
+   */
+  typedef struct  T1_DriverRec_
+  {
+    PS_DriverRec     root;
+
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    T1_DictCacheRec  dict_cache;
+#endif
+
+  } T1_DriverRec, *T1_Driver;
+
+
   FT_TS_LOCAL( FT_TS_Error )
   T1_Driver_Init( FT_TS_Module  driver );
 
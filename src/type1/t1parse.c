@@ -131,6 +131,170 @@
   }
 
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+
+  /*
+   * The dictionary cache maps the font data (the base dictionary and, for
+   * PFB files, the private dictionary segments) to the decrypted private
+   * dictionary, with all subroutines and charstrings decrypted in place.
+   * Entries are found by a hash value computed from a sample of the data,
+   * then compared in full.
+   */
+
+  typedef struct  T1_DictCacheEntryRec_
+  {
+    FT_TS_MruNodeRec  node;
+
+    FT_TS_Byte*       key;
+    FT_TS_ULong       key_len;
+    FT_TS_Byte*       dict;
+    FT_TS_ULong       dict_len;
+
+  } T1_DictCacheEntryRec;
+
+
+  /* the font data `a` + `b`, as looked for by `t1_dict_cache_compare` */
+  typedef struct  T1_DictCacheKeyRec_
+  {
+    const FT_TS_Byte*  a;
+    FT_TS_ULong        a_len;
+    const FT_TS_Byte*  b;
+    FT_TS_ULong        b_len;
+
+  } T1_DictCacheKeyRec;
+
+
+  static FT_TS_Bool
+  t1_dict_cache_compare( FT_TS_MruNode  node,
+                         const void*    key_ )
+  {
+    T1_DictCacheEntry          entry = (T1_DictCacheEntry)node;
+    const T1_DictCacheKeyRec*  key   = (const T1_DictCacheKeyRec*)key_;
+
+
+    return entry->key_len == key->a_len + key->b_len                &&
+           ft_memcmp( entry->key, key->a, key->a_len ) == 0         &&
+           ( !key->b_len                                          ||
+             ft_memcmp( entry->key + key->a_len,
+                        key->b,
+                        key->b_len ) == 0                         );
+  }
+
+
+  static void
+  t1_dict_cache_entry_free( FT_TS_MruNode  node,
+                            FT_TS_Memory   memory )
+  {
+    T1_DictCacheEntry  entry = (T1_DictCacheEntry)node;
+
+
+    FT_TS_FREE( entry->key );
+    FT_TS_FREE( entry );
+  }
+
+
+  /* Look up the font data `a` + `b` in the dictionary cache.  If it */
+  /* isn't found, make a copy of the data that can serve as the key  */
+  /* of a new entry (see `T1_Cache_Private_Dict`).                   */
+  static T1_DictCacheEntry
+  t1_dict_cache_lookup( T1_Parser          parser,
+                        const FT_TS_Byte*  a,
+                        FT_TS_ULong        a_len,
+                        const FT_TS_Byte*  b,
+                        FT_TS_ULong        b_len )
+  {
+    T1_DictCache  cache  = parser->dict_cache;
+    FT_TS_Memory  memory = parser->root.memory;
+    FT_TS_Error   error;
+
+    T1_DictCacheEntry   entry;
+    T1_DictCacheKeyRec  key;
+    FT_TS_UInt32        hash;
+
+
+    if ( !cache )
+      return NULL;
+
+    key.a     = a;
+    key.a_len = a_len;
+    key.b     = b;
+    key.b_len = b_len;
+
+    hash  = ft_hash_data( 2166136261UL, a, a_len );
+    hash  = ft_hash_data( hash, b, b_len );
+    entry = (T1_DictCacheEntry)ft_mru_lookup( cache,
+                                              hash,
+                                              t1_dict_cache_compare,
+                                              &key );
+    if ( entry )
+      return entry;
+
+    /* the decrypted dictionary is never larger than the font data */
+    if ( 2 * ( a_len + b_len ) + sizeof ( T1_DictCacheEntryRec ) <=
+           T1_CONFIG_DICT_CACHE_MAX_SIZE                          &&
+         !FT_TS_QALLOC( parser->cache_key, a_len + b_len )         )
+    {
+      FT_TS_MEM_COPY( parser->cache_key, a, a_len );
+      if ( b_len )
+        FT_TS_MEM_COPY( parser->cache_key + a_len, b, b_len );
+
+      parser->cache_key_len = a_len + b_len;
+      parser->cache_hash    = hash;
+    }
+
+    return NULL;
+  }
+
+
+  /* Add the private dictionary of a successfully loaded font to */
+  /* the dictionary cache, discarding old entries if necessary.  */
+  FT_TS_LOCAL_DEF( void )
+  T1_Cache_Private_Dict( T1_Parser  parser )
+  {
+    T1_DictCache  cache  = parser->dict_cache;
+    FT_TS_Memory  memory = parser->root.memory;
+    FT_TS_Error   error;
+
+    T1_DictCacheEntry  entry;
+
+
+    if ( !cache || !parser->cache_key )
+      return;
+
+    if ( FT_TS_QALLOC( entry, sizeof ( T1_DictCacheEntryRec ) +
+                                parser->private_len             ) )
+      return;
+
+    entry->node.hash = parser->cache_hash;
+    entry->node.size = sizeof ( T1_DictCacheEntryRec ) +
+                       parser->cache_key_len + parser->private_len;
+    entry->key       = parser->cache_key;
+    entry->key_len   = parser->cache_key_len;
+    entry->dict      = (FT_TS_Byte*)( entry + 1 );
+    entry->dict_len  = parser->private_len;
+
+    FT_TS_MEM_COPY( entry->dict, parser->private_dict, parser->private_len );
+
+    parser->cache_key = NULL;
+
+    ft_mru_add( cache,
+                &entry->node,
+                T1_CONFIG_DICT_CACHE_MAX_SIZE,
+                t1_dict_cache_entry_free,
+                memory );
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  T1_Done_Dict_Cache( T1_DictCache  cache,
+                      FT_TS_Memory  memory )
+  {
+    ft_mru_done( cache, t1_dict_cache_entry_free, memory );
+  }
+
+#endif /* T1_CONFIG_OPTION_DICT_CACHE */
+
+
   FT_TS_LOCAL_DEF( FT_TS_Error )
   T1_New_Parser( T1_Parser      parser,
                  FT_TS_Stream      stream,
@@ -153,6 +317,15 @@
     parser->in_memory    = 0;
     parser->single_block = 0;
 
+    parser->charstrings_decrypted = 0;
+
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    parser->dict_cache    = NULL;
+    parser->cache_key     = NULL;
+    parser->cache_key_len = 0;
+    parser->cache_hash    = 0;
+#endif
+
     /* check the header format */
     error = check_type1_format( stream, "%!PS-AdobeFont", 14 );
     if ( error )
@@ -248,6 +421,10 @@
     /* always free the private dictionary */
     FT_TS_FREE( parser->private_dict );
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    FT_TS_FREE( parser->cache_key );
+#endif
+
     /* free the base dictionary only when we have a disk stream */
     if ( !parser->in_memory )
       FT_TS_FREE( parser->base_dict );
@@ -265,6 +442,10 @@
     FT_TS_Error   error  = FT_TS_Err_Ok;
     FT_TS_ULong   size;
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    T1_DictCacheEntry  entry;
+#endif
+
 
     if ( parser->in_pfb )
     {
@@ -322,6 +503,22 @@
 
         parser->private_len += size;
       }
+
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+      entry = t1_dict_cache_lookup( parser,
+                                    parser->base_dict,
+                                    parser->base_len,
+                                    parser->private_dict,
+                                    parser->private_len );
+      if ( entry )
+      {
+        /* decryption doesn't change the size */
+        FT_TS_MEM_COPY( parser->private_dict, entry->dict, entry->dict_len );
+
+        parser->charstrings_decrypted = 1;
+        goto Cached;
+      }
+#endif
     }
     else
     {
@@ -337,6 +534,40 @@
       FT_TS_Bool     test_cr;
 
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+      entry = t1_dict_cache_lookup( parser,
+                                    parser->base_dict,
+                                    parser->base_len,
+                                    NULL,
+                                    0 );
+      if ( entry )
+      {
+        /* as below, but the dictionary is never larger than the data */
+        /* following `eexec'                                          */
+        if ( parser->in_memory )
+        {
+          if ( FT_TS_QALLOC( parser->private_dict, entry->dict_len + 1 ) )
+            goto Fail;
+        }
+        else
+        {
+          parser->single_block = 1;
+          parser->private_dict = parser->base_dict;
+          parser->base_dict    = NULL;
+          parser->base_len     = 0;
+        }
+
+        FT_TS_MEM_COPY( parser->private_dict, entry->dict, entry->dict_len );
+        parser->private_len = entry->dict_len;
+
+        /* put a safeguard */
+        parser->private_dict[parser->private_len] = '\0';
+
+        parser->charstrings_decrypted = 1;
+        goto Cached;
+      }
+#endif
+
     Again:
       for (;;)
       {
@@ -511,6 +742,9 @@
     parser->private_dict[2] = ' ';
     parser->private_dict[3] = ' ';
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+  Cached:
+#endif
     parser->root.base   = parser->private_dict;
     parser->root.cursor = parser->private_dict;
     parser->root.limit  = parser->root.cursor + parser->private_len;
@@ -22,11 +22,23 @@
 
 #include <freetype/internal/t1types.h>
 #include <freetype/internal/ftstream.h>
+#include <freetype/internal/fthash.h>
 
 
 FT_TS_BEGIN_HEADER
 
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+
+  typedef struct  T1_DictCacheEntryRec_*  T1_DictCacheEntry;
+
+  /* the cache of decrypted private dictionaries, owned by the driver */
+  typedef FT_TS_MruListRec  T1_DictCacheRec;
+  typedef FT_TS_MruList     T1_DictCache;
+
+#endif
+
+
   /**************************************************************************
    *
    * @Struct:
@@ -65,6 +77,23 @@ FT_TS_BEGIN_HEADER
    *   single_block ::
    *     A boolean.  Indicates that the private dictionary
    *     is stored in lieu of the base dictionary.
+   *
+   *   charstrings_decrypted ::
+   *     A boolean.  Indicates that the subroutines and charstrings
+   *     within the private dictionary are already decrypted.
+   *
+   *   dict_cache ::
+   *     The cache of decrypted private dictionaries, or NULL.
+   *
+   *   cache_key ::
+   *     A copy of the font data, to be used as the key for a new
+   *     cache entry.  NULL if the font data shouldn't be cached.
+   *
+   *   cache_key_len ::
+   *     The length in bytes of `cache_key`.
+   *
+   *   cache_hash ::
+   *     The hash value of `cache_key`.
    */
   typedef struct  T1_ParserRec_
   {
@@ -81,6 +110,15 @@ FT_TS_BEGIN_HEADER
     FT_TS_Bool       in_memory;
     FT_TS_Bool       single_block;
 
+    FT_TS_Bool       charstrings_decrypted;
+
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+    T1_DictCache     dict_cache;
+    FT_TS_Byte*      cache_key;
+    FT_TS_ULong      cache_key_len;
+    FT_TS_UInt32     cache_hash;
+#endif
+
   } T1_ParserRec, *T1_Parser;
 
 
@@ -128,6 +166,17 @@ FT_TS_BEGIN_HEADER
   FT_TS_LOCAL( void )
   T1_Finalize_Parser( T1_Parser  parser );
 
+#ifdef T1_CONFIG_OPTION_DICT_CACHE
+
+  FT_TS_LOCAL( void )
+  T1_Cache_Private_Dict( T1_Parser  parser );
+
+  FT_TS_LOCAL( void )
+  T1_Done_Dict_Cache( T1_DictCache  cache,
+                      FT_TS_Memory  memory );
+
+#endif
+
 
 FT_TS_END_HEADER
 
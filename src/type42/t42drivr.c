@@ -72,20 +72,14 @@
   t42_get_name_index( T42_Face          face,
                       const FT_TS_String*  glyph_name )
   {
-    FT_TS_Int  i;
+    FT_TS_Int  idx = T42_Get_Glyph_Name_Index( face, glyph_name );
 
 
-    for ( i = 0; i < face->type1.num_glyphs; i++ )
-    {
-      FT_TS_String*  gname = face->type1.glyph_names[i];
-
-
-      if ( glyph_name[0] == gname[0] && !ft_strcmp( glyph_name, gname ) )
-        return (FT_TS_UInt)ft_strtol( (const char *)face->type1.charstrings[i],
-                                   NULL, 10 );
-    }
+    if ( idx < 0 )
+      return 0;
 
-    return 0;
+    return (FT_TS_UInt)ft_strtol( (const char *)face->type1.charstrings[idx],
+                               NULL, 10 );
   }
 
 
@@ -28,6 +28,38 @@
 #define FT_TS_COMPONENT  t42
 
 
+  static const char*
+  t42_get_glyph_name_string( void*       object,
+                             FT_TS_UInt  idx )
+  {
+    T1_Font  type1 = (T1_Font)object;
+
+
+    return type1->glyph_names[idx];
+  }
+
+
+  /* Return the index of the first glyph called `glyph_name`, or -1 if */
+  /* there is none.                                                   */
+  FT_TS_LOCAL_DEF( FT_TS_Int )
+  T42_Get_Glyph_Name_Index( T42_Face             face,
+                            const FT_TS_String*  glyph_name )
+  {
+    T1_Font  type1 = &face->type1;
+
+
+    if ( !type1->glyph_names || type1->num_glyphs <= 0 )
+      return -1;
+
+    return (FT_TS_Int)ft_hash_name_index( &type1->glyph_names_hash,
+                                          glyph_name,
+                                          (FT_TS_UInt)type1->num_glyphs,
+                                          t42_get_glyph_name_string,
+                                          type1,
+                                          face->root.memory );
+  }
+
+
   static FT_TS_Error
   T42_Open_Face( T42_Face  face )
   {
@@ -120,29 +152,25 @@
         type1->encoding.char_index[charcode] = 0;
         type1->encoding.char_name [charcode] = ".notdef";
 
-        if ( char_name )
-          for ( idx = 0; idx < type1->num_glyphs; idx++ )
-          {
-            const FT_TS_String*  glyph_name = type1->glyph_names[idx];
+        idx = T42_Get_Glyph_Name_Index( face, char_name );
+        if ( idx >= 0 )
+        {
+          const FT_TS_String*  glyph_name = type1->glyph_names[idx];
 
 
-            if ( ft_strcmp( char_name, glyph_name ) == 0 )
-            {
-              type1->encoding.char_index[charcode] = (FT_TS_UShort)idx;
-              type1->encoding.char_name [charcode] = glyph_name;
-
-              /* Change min/max encoded char only if glyph name is */
-              /* not /.notdef                                      */
-              if ( ft_strcmp( ".notdef", glyph_name ) != 0 )
-              {
-                if ( charcode < min_char )
-                  min_char = charcode;
-                if ( charcode >= max_char )
-                  max_char = charcode + 1;
-              }
-              break;
-            }
+          type1->encoding.char_index[charcode] = (FT_TS_UShort)idx;
+          type1->encoding.char_name [charcode] = glyph_name;
+
+          /* Change min/max encoded char only if glyph name is */
+          /* not /.notdef                                      */
+          if ( ft_strcmp( ".notdef", glyph_name ) != 0 )
+          {
+            if ( charcode < min_char )
+              min_char = charcode;
+            if ( charcode >= max_char )
+              max_char = charcode + 1;
           }
+        }
       }
 
       type1->encoding.code_first = min_char;
@@ -433,6 +461,9 @@
     FT_TS_FREE( type1->charstrings );
     FT_TS_FREE( type1->glyph_names );
 
+    ft_hash_str_free( type1->glyph_names_hash, memory );
+    FT_TS_FREE( type1->glyph_names_hash );
+
     FT_TS_FREE( type1->charstrings_block );
     FT_TS_FREE( type1->glyph_names_block );
 
@@ -74,6 +74,11 @@ FT_TS_BEGIN_HEADER
   T42_Face_Done( FT_TS_Face  face );
 
 
+  FT_TS_LOCAL( FT_TS_Int )
+  T42_Get_Glyph_Name_Index( T42_Face             face,
+                            const FT_TS_String*  glyph_name );
+
+
   FT_TS_LOCAL( FT_TS_Error )
   T42_Size_Init( FT_TS_Size  size );
 
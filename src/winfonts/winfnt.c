@@ -690,7 +690,7 @@
     (FT_TS_CMap_CharIndexFunc)fnt_cmap_char_index,
     (FT_TS_CMap_CharNextFunc) fnt_cmap_char_next,
 
-    NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL
   };
 
   static FT_TS_CMap_Class const  fnt_cmap_class = &fnt_cmap_class_rec;